@@ -0,0 +1,372 @@
+/// ------------------------------------------
+/// @file matrix_bench.cpp
+///
+/// @brief Performance suite for the matrix, factorization and polynomial routines
+///
+/// Each benchmark is parameterized by size and element type. Rates are reported as
+/// FLOP/s (nominal operation counts, a complex multiply add counted as 8 real flops)
+/// and bytes/s (operands read plus results written once). Build the matrix_bench
+/// target and run with --benchmark_format=json, or build bench_json to write
+/// matrix_bench.json into the build directory
+/// ------------------------------------------
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "../inc/Matrix.h"
+#include "../inc/Batch.h"
+#include "../inc/Vector.h"
+#include "../inc/Complex.h"
+#include "../inc/Poly.h"
+#include "../inc/Scalar.h"
+
+namespace
+{
+    /// @brief real flops per multiply add of T, relative to a real multiply add
+    template <typename T>
+    constexpr double c_flop_scale = scalar_is_complex_v<T> ? 4.0 : 1.0;
+
+    ///--------------------------------------------------------
+    /// @brief Random value with components in [-1, 1]
+    template <typename T>
+    T random_scalar(std::mt19937& gen)
+    {
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        const double real = dist(gen);
+        const double imag = dist(gen);
+        return scalar_from_complex<T>(Complex_C_t(real, imag));
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Random square matrix, diagonally dominant so the factorizations are well conditioned
+    template <typename T>
+    Matrix<T> random_matrix(const size_t& len)
+    {
+        std::mt19937 gen(len);
+        Matrix<T> outMat(len, len);
+        for (size_t i = 0; i < len; i++)
+        {
+            for (size_t j = 0; j < len; j++)
+            {
+                outMat(i, j) = random_scalar<T>(gen);
+            }
+            outMat(i, i) = outMat(i, i) + scalar_from_complex<T>(Complex_C_t((double) len, 0.0));
+        }
+        return outMat;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Random vector
+    template <typename T>
+    Vector<T> random_vector(const size_t& len)
+    {
+        std::mt19937 gen(len + 1);
+        Vector<T> outVec(len);
+        for (size_t i = 0; i < len; i++)
+        {
+            outVec.get_data()[i] = random_scalar<T>(gen);
+        }
+        return outVec;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Random monic factors x - r with roots in the unit square
+    std::vector<Poly_factor_t> random_factors(const size_t& count)
+    {
+        std::mt19937 gen(count);
+        std::vector<Poly_factor_t> factors(count);
+        for (Poly_factor_t& factor : factors)
+        {
+            factor = {1.0, -random_scalar<Complex_C_t>(gen)};
+        }
+        return factors;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Records the rates of one benchmark run
+    ///
+    /// @param state benchmark state
+    /// @param flops floating point operations per iteration
+    /// @param bytes bytes moved per iteration
+    void set_rates(benchmark::State& state, const double& flops, const double& bytes)
+    {
+        state.counters["FLOP/s"] = benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+        state.SetComplexityN(state.range(0));
+    }
+}
+
+// ------------------------------------------ matrix
+
+template <typename T>
+void BM_Multiply(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> lmat = random_matrix<T>(n);
+    const Matrix<T> rmat = random_matrix<T>(n);
+
+    for (auto _ : state)
+    {
+        Matrix<T> product = lmat % rmat;
+        benchmark::DoNotOptimize(product.get_data());
+    }
+
+    set_rates(state, 2.0 * n * n * n * c_flop_scale<T>, 3.0 * n * n * sizeof(T));
+}
+
+/// @brief BM_Multiply with Strassen-Winograd off, the baseline for its sizes
+template <typename T>
+void BM_MultiplyClassical(benchmark::State& state)
+{
+    strassen_set_enabled(false);
+    BM_Multiply<T>(state);
+    strassen_set_enabled(true);
+}
+
+template <typename T>
+void BM_Transpose(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> mat = random_matrix<T>(n);
+
+    for (auto _ : state)
+    {
+        Matrix<T> trans = mat.transpose();
+        benchmark::DoNotOptimize(trans.get_data());
+    }
+
+    set_rates(state, 0, 2.0 * n * n * sizeof(T));
+}
+
+template <typename T>
+void BM_Determinant(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> mat = random_matrix<T>(n);
+
+    for (auto _ : state)
+    {
+        T det = mat.determinant();
+        benchmark::DoNotOptimize(det);
+    }
+
+    set_rates(state, 2.0 / 3.0 * n * n * n * c_flop_scale<T>, n * n * sizeof(T));
+}
+
+template <typename T>
+void BM_Inverse(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    Matrix<T> mat = random_matrix<T>(n);
+
+    for (auto _ : state)
+    {
+        Matrix<T> inv = mat.inverse();
+        benchmark::DoNotOptimize(inv.get_data());
+    }
+
+    set_rates(state, 2.0 * n * n * n * c_flop_scale<T>, 2.0 * n * n * sizeof(T));
+}
+
+template <typename T>
+void BM_QR(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> mat = random_matrix<T>(n);
+
+    for (auto _ : state)
+    {
+        std::pair<Matrix<T>, Matrix<T>> qr = mat.qr_decompose();
+        benchmark::DoNotOptimize(qr.first.get_data());
+    }
+
+    // 4/3 n^3 for R, the same again to form Q
+    set_rates(state, 8.0 / 3.0 * n * n * n * c_flop_scale<T>, 3.0 * n * n * sizeof(T));
+}
+
+template <typename T>
+void BM_Eigenvalues(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> mat = random_matrix<T>(n);
+
+    for (auto _ : state)
+    {
+        std::vector<T> values = mat.eigenvalues();
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    // nominal count, 10/3 n^3 for the Hessenberg reduction and ~2 QR sweeps per eigenvalue
+    set_rates(state, 10.0 * n * n * n * c_flop_scale<T>, n * n * sizeof(T));
+}
+
+template <typename T>
+void BM_RREF(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> mat = random_matrix<T>(n);
+    const Vector<T> rhs = random_vector<T>(n);
+
+    for (auto _ : state)
+    {
+        Matrix<T> reduced = mat.RREF(rhs);
+        benchmark::DoNotOptimize(reduced.get_data());
+    }
+
+    // full Gauss-Jordan elimination of the augmented matrix
+    set_rates(state, 1.0 * n * n * n * c_flop_scale<T>, 2.0 * n * (n + 1) * sizeof(T));
+}
+
+template <typename T>
+void BM_SolveLU(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> mat = random_matrix<T>(n);
+    const Vector<T> rhs = random_vector<T>(n);
+
+    for (auto _ : state)
+    {
+        Vector<T> x = LU<T>(mat).solve(rhs);
+        benchmark::DoNotOptimize(x.get_data());
+    }
+
+    set_rates(state, 2.0 / 3.0 * n * n * n * c_flop_scale<T>, n * n * sizeof(T));
+}
+
+template <typename T>
+void BM_SolveRefined(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix<T> mat = random_matrix<T>(n);
+    const Vector<T> rhs = random_vector<T>(n);
+
+    Refine_Result_t result;
+    for (auto _ : state)
+    {
+        Vector<T> x(n);
+        result = Refined_Solver<T>(mat).solve(rhs, x);
+        benchmark::DoNotOptimize(x.get_data());
+    }
+
+    // nominal count of the full precision factorization it stands in for
+    set_rates(state, 2.0 / 3.0 * n * n * n * c_flop_scale<T>, n * n * sizeof(T));
+    state.counters["steps"] = (double) result.m_iterations;
+    state.counters["backward_error"] = result.m_backward_error;
+}
+
+// ------------------------------------------ batched
+
+/// @brief matrices per batch in the batched benchmarks, the range argument is the matrix size
+#define MATRIX_BENCH_BATCH 4096
+
+template <typename T>
+void BM_BatchDeterminant(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix_Batch<T> batch(std::vector<Matrix<T>>(MATRIX_BENCH_BATCH, random_matrix<T>(n)));
+
+    for (auto _ : state)
+    {
+        std::vector<T> dets = batch.determinant();
+        benchmark::DoNotOptimize(dets.data());
+    }
+
+    set_rates(state, MATRIX_BENCH_BATCH * 2.0 / 3.0 * n * n * n * c_flop_scale<T>, MATRIX_BENCH_BATCH * n * n * sizeof(T));
+}
+
+template <typename T>
+void BM_BatchInverse(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Matrix_Batch<T> batch(std::vector<Matrix<T>>(MATRIX_BENCH_BATCH, random_matrix<T>(n)));
+
+    for (auto _ : state)
+    {
+        Matrix_Batch<T> inv = batch.inverse();
+        benchmark::DoNotOptimize(inv.plane(0, 0));
+    }
+
+    set_rates(state, MATRIX_BENCH_BATCH * 2.0 * n * n * n * c_flop_scale<T>, MATRIX_BENCH_BATCH * 2.0 * n * n * sizeof(T));
+}
+
+void BM_FactorizePolyBatch(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const std::vector<Poly_Coeff_t> polys(MATRIX_BENCH_BATCH, CompressFactors(random_factors(n)));
+
+    for (auto _ : state)
+    {
+        std::vector<std::vector<Poly_factor_t>> factors = FactorizePolyBatch(polys);
+        benchmark::DoNotOptimize(factors.data());
+    }
+
+    set_rates(state, MATRIX_BENCH_BATCH * 4.0 * 4.0 * n * n, MATRIX_BENCH_BATCH * (2.0 * n + 1) * sizeof(Complex_C_t));
+}
+
+// ------------------------------------------ polynomial
+
+void BM_CompressFactors(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const std::vector<Poly_factor_t> factors = random_factors(n);
+
+    for (auto _ : state)
+    {
+        Poly_Coeff_t poly = CompressFactors(factors);
+        benchmark::DoNotOptimize(poly.data());
+    }
+
+    // quadratic expansion count
+    set_rates(state, 4.0 * n * n, (2.0 * n + 1) * sizeof(Complex_C_t));
+}
+
+void BM_FactorizePoly(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const Poly_Coeff_t poly = CompressFactors(random_factors(n));
+
+    for (auto _ : state)
+    {
+        std::vector<Poly_factor_t> factors = FactorizePoly(poly);
+        benchmark::DoNotOptimize(factors.data());
+    }
+
+    // nominal count of one sweep (n evaluations of p, p' and the n repulsion terms), iterations vary
+    set_rates(state, 4.0 * 4.0 * n * n, (2.0 * n + 1) * sizeof(Complex_C_t));
+}
+
+// ------------------------------------------ registration
+
+// Complex_P_t does trig per operation, so it stops at smaller sizes
+#define MATRIX_BENCH_TYPES(bench, maxReal, maxComplex, maxPolar)                                    \
+    BENCHMARK_TEMPLATE(bench, double)->RangeMultiplier(2)->Range(2, maxReal)->Complexity();          \
+    BENCHMARK_TEMPLATE(bench, float)->RangeMultiplier(2)->Range(2, maxReal)->Complexity();           \
+    BENCHMARK_TEMPLATE(bench, Complex_C_t)->RangeMultiplier(2)->Range(2, maxComplex)->Complexity();  \
+    BENCHMARK_TEMPLATE(bench, Complex_P_t)->RangeMultiplier(2)->Range(2, maxPolar)->Complexity()
+
+MATRIX_BENCH_TYPES(BM_Multiply, 4096, 2048, 128);
+BENCHMARK_TEMPLATE(BM_MultiplyClassical, double)->RangeMultiplier(2)->Range(1024, 4096)->Complexity();
+BENCHMARK_TEMPLATE(BM_MultiplyClassical, float)->RangeMultiplier(2)->Range(1024, 4096)->Complexity();
+MATRIX_BENCH_TYPES(BM_Transpose, 4096, 4096, 4096);
+MATRIX_BENCH_TYPES(BM_Determinant, 4096, 2048, 256);
+MATRIX_BENCH_TYPES(BM_Inverse, 2048, 1024, 128);
+MATRIX_BENCH_TYPES(BM_QR, 2048, 1024, 128);
+MATRIX_BENCH_TYPES(BM_Eigenvalues, 512, 256, 64);
+MATRIX_BENCH_TYPES(BM_RREF, 512, 256, 64);
+
+BENCHMARK_TEMPLATE(BM_SolveLU, double)->RangeMultiplier(2)->Range(2, 2048)->Complexity();
+BENCHMARK_TEMPLATE(BM_SolveRefined, double)->RangeMultiplier(2)->Range(2, 2048)->Complexity();
+
+BENCHMARK_TEMPLATE(BM_BatchDeterminant, double)->DenseRange(2, 8)->Complexity();
+BENCHMARK_TEMPLATE(BM_BatchDeterminant, float)->DenseRange(2, 8)->Complexity();
+BENCHMARK_TEMPLATE(BM_BatchInverse, double)->DenseRange(2, 8)->Complexity();
+BENCHMARK_TEMPLATE(BM_BatchInverse, float)->DenseRange(2, 8)->Complexity();
+BENCHMARK_TEMPLATE(BM_BatchInverse, Complex_C_t)->DenseRange(2, 8)->Complexity();
+BENCHMARK(BM_FactorizePolyBatch)->DenseRange(2, 8)->Complexity();
+
+BENCHMARK(BM_CompressFactors)->RangeMultiplier(2)->Range(2, 4096)->Complexity();
+BENCHMARK(BM_FactorizePoly)->RangeMultiplier(2)->Range(2, 512)->Complexity();
+
+BENCHMARK_MAIN();
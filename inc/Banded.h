@@ -0,0 +1,578 @@
+/// ------------------------------------------
+/// @file Banded.h
+///
+/// @brief Header/Source file for banded matrices and their partial pivoting LU factorization
+///
+/// A Banded_Matrix with kl sub and ku super diagonals stores each row's band
+/// contiguously, kl + ku + 1 values per row, element (i,j) at i * (kl + ku + 1) + (j - i + kl).
+/// Banded_LU widens the rows by kl to hold the fill the row interchanges bring in,
+/// and keeps L unpermuted with the interchanges as a pivot list (as LINPACK's gbfa),
+/// so factorizing and solving cost O(n kl (kl + ku)) rather than O(n^3)
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Scalar.h"
+#include "Storage.h"
+
+template <typename T> class Banded_LU;
+
+/// @brief Templated class for square matrices that are zero outside a band around the diagonal
+template <typename T>
+class Banded_Matrix
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, zero filled
+        ///
+        /// @param len order of the matrix
+        /// @param lower number of sub diagonals (kl)
+        /// @param upper number of super diagonals (ku)
+        ///
+        /// @throws std::invalid_argument if len < 1
+        Banded_Matrix(const size_t& len, const size_t& lower, const size_t& upper)
+            : m_len(len), m_lower(std::min(lower, len - 1)), m_upper(std::min(upper, len - 1))
+        {
+            if (len < 1)
+            {
+                throw std::invalid_argument("Cols/Rows of a matrix must be above 0");
+            }
+
+            m_data.assign(m_len * _width(), (T) 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, copies the band of a square matrix, elements outside it are dropped
+        ///
+        /// @param mat square matrix
+        /// @param lower number of sub diagonals (kl)
+        /// @param upper number of super diagonals (ku)
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Banded_Matrix(const Matrix<T>& mat, const size_t& lower, const size_t& upper)
+            : Banded_Matrix(mat.getRowCount(), lower, upper)
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to be banded");
+            }
+
+            for (size_t i = 0; i < m_len; i++)
+            {
+                for (size_t j = _first(i); j < _last(i); j++)
+                {
+                    m_data[_index(i, j)] = mat.get_data()[i * m_len + j];
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows
+        size_t getRowCount() const
+        {
+            return m_len;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns
+        size_t getColCount() const
+        {
+            return m_len;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of sub diagonals
+        ///
+        /// @return kl
+        size_t getLowerBandwidth() const
+        {
+            return m_lower;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of super diagonals
+        ///
+        /// @return ku
+        size_t getUpperBandwidth() const
+        {
+            return m_upper;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is (row, col) inside the band?
+        ///
+        /// @return true if the element can be non-zero
+        bool inBand(const size_t& row, const size_t& col) const
+        {
+            return row < m_len && col < m_len && col + m_lower >= row && col <= row + m_upper;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the value at (row, col), zero outside the band
+        ///
+        /// @param row row location of the value
+        /// @param col column location of the value
+        ///
+        /// @return value at (row, col)
+        ///
+        /// @throws std::invalid_argument if (row, col) is outside the matrix
+        T get(const size_t& row, const size_t& col) const
+        {
+            if (row >= m_len || col >= m_len)
+            {
+                throw std::invalid_argument("Index out of range");
+            }
+            return inBand(row, col) ? m_data[_index(row, col)] : (T) 0;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Set the value at (row, col)
+        ///
+        /// @param row row location of the value
+        /// @param col column location of the value
+        /// @param val value to set
+        ///
+        /// @throws std::invalid_argument if (row, col) is outside the band
+        void set(const size_t& row, const size_t& col, const T& val)
+        {
+            if (!inBand(row, col))
+            {
+                throw std::invalid_argument("Element outside the band");
+            }
+            m_data[_index(row, col)] = val;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the band storage, kl + ku + 1 values per row, row i starting at column i - kl
+        ///
+        /// @return first stored element
+        const T* get_data() const
+        {
+            return m_data.data();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Expands to a dense matrix
+        ///
+        /// @return dense matrix
+        Matrix<T> toMatrix() const
+        {
+            Matrix<T> outMat(m_len, m_len);
+            outMat.block(0, 0, m_len, m_len).fill((T) 0);
+            for (size_t i = 0; i < m_len; i++)
+            {
+                for (size_t j = _first(i); j < _last(i); j++)
+                {
+                    outMat(i, j) = m_data[_index(i, j)];
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product with a vector, only the band is read
+        ///
+        /// @param vec n long vector
+        ///
+        /// @return product vector
+        ///
+        /// @throws std::invalid_argument if vec is not n long
+        Vector<T> operator%(const Vector<T>& vec) const
+        {
+            if (vec.size() != m_len)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            const T* x = vec.get_data();
+            Vector<T> outVec(m_len);
+            for (size_t i = 0; i < m_len; i++)
+            {
+                T sum = (T) 0;
+                for (size_t j = _first(i); j < _last(i); j++)
+                {
+                    sum += m_data[_index(i, j)] * x[j];
+                }
+                outVec.get_data()[i] = sum;
+            }
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product with a dense matrix, only the band is read
+        ///
+        /// @param mat (n,p) matrix
+        ///
+        /// @return (n,p) product
+        ///
+        /// @throws std::invalid_argument if mat does not have n rows
+        Matrix<T> operator%(const Matrix<T>& mat) const
+        {
+            if (mat.getRowCount() != m_len)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            const size_t p = mat.getColCount();
+            const T* b = mat.get_data();
+            Matrix<T> outMat(m_len, p);
+            T* c = outMat.get_data();
+
+            parallel_for(0, m_len, parallel_grain(_width() * p), [&](size_t from, size_t to)
+            {
+                for (size_t i = from; i < to; i++)
+                {
+                    T* ci = c + i * p;
+                    std::fill(ci, ci + p, (T) 0);
+                    for (size_t j = _first(i); j < _last(i); j++)
+                    {
+                        const T aij = m_data[_index(i, j)];
+                        const T* bj = b + j * p;
+                        for (size_t k = 0; k < p; k++)
+                        {
+                            ci[k] += aij * bj[k];
+                        }
+                    }
+                }
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Factorizes PA = LU within the band
+        ///
+        /// @return LU factorization, check isSingular()
+        Banded_LU<T> lu() const
+        {
+            return Banded_LU<T>(*this);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant with a banded LU factorization
+        ///
+        /// @return determinant of the matrix
+        T determinant() const
+        {
+            return Banded_LU<T>(*this).determinant();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x with a banded LU factorization
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            return Banded_LU<T>(*this).solve(solutions);
+        };
+
+    private:
+        /// @brief order of the matrix
+        size_t m_len;
+
+        /// @brief sub diagonals
+        size_t m_lower;
+
+        /// @brief super diagonals
+        size_t m_upper;
+
+        /// @brief band rows, see the file description
+        Storage_Vector_t<T> m_data;
+
+        /// @brief values stored per row
+        size_t _width() const
+        {
+            return m_lower + m_upper + 1;
+        };
+
+        /// @brief first column of row i inside the band
+        size_t _first(const size_t& i) const
+        {
+            return (i > m_lower) ? i - m_lower : 0;
+        };
+
+        /// @brief one past the last column of row i inside the band
+        size_t _last(const size_t& i) const
+        {
+            return std::min(m_len, i + m_upper + 1);
+        };
+
+        /// @brief storage index of an element inside the band
+        size_t _index(const size_t& i, const size_t& j) const
+        {
+            return i * _width() + (j + m_lower - i);
+        };
+};
+
+/// @brief Templated class for factorizing a banded matrix with partial pivoting and solving with it
+template <typename T>
+class Banded_LU
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes the given banded matrix
+        ///
+        /// @note singular matrices are still factorized, isSingular() will report them
+        /// and any solve call will throw
+        ///
+        /// @param mat banded matrix to factorize
+        Banded_LU(const Banded_Matrix<T>& mat)
+            : m_len(mat.getRowCount()), m_lower(mat.getLowerBandwidth()), m_upper(mat.getUpperBandwidth()),
+              m_pivots(mat.getRowCount())
+        {
+            // copy into the wider rows, the extra kl values per row start out zero
+            m_data.assign(m_len * _width(), (T) 0);
+            const size_t inWidth = m_lower + m_upper + 1;
+            for (size_t i = 0; i < m_len; i++)
+            {
+                std::copy(mat.get_data() + i * inWidth, mat.get_data() + (i + 1) * inWidth, m_data.data() + i * _width());
+            }
+
+            _factorize();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is the factorized matrix singular (exactly zero pivot found)?
+        ///
+        /// @return true if matrix has no inverse
+        bool isSingular() const
+        {
+            return m_singular;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the row interchanges, row k was swapped with row getPivots()[k] at step k
+        ///
+        /// @return pivot list
+        const std::vector<size_t>& getPivots() const
+        {
+            return m_pivots;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant, product of the U diagonal and interchange sign
+        ///
+        /// @return determinant of the factorized matrix
+        T determinant() const
+        {
+            int sign = 1;
+            T det = (T) 1;
+            for (size_t k = 0; k < m_len; k++)
+            {
+                det *= m_data[_index(k, k)];
+                sign = (m_pivots[k] != k) ? -sign : sign;
+            }
+            return det * (T) sign;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            if (solutions.size() != m_len)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Vector<T> outVec(m_len);
+            std::copy(solutions.get_data(), solutions.get_data() + m_len, outVec.get_data());
+            _solve_in_place(outVec.get_data(), 1);
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B for X, each column of B is a separate right hand side
+        ///
+        /// @param solutions right hand side matrix B, must have as many rows as A
+        ///
+        /// @return matrix X
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Matrix<T> solve(const Matrix<T>& solutions) const
+        {
+            if (solutions.getRowCount() != m_len)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Matrix<T> outMat = solutions;
+            _solve_in_place(outMat.get_data(), outMat.getColCount());
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the inverse of the factorized matrix (dense)
+        ///
+        /// @return the inverse matrix
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        Matrix<T> inverse() const
+        {
+            return solve(Matrix<T>::identity(m_len));
+        };
+
+    private:
+        /// @brief order of the matrix
+        size_t m_len;
+
+        /// @brief sub diagonals
+        size_t m_lower;
+
+        /// @brief super diagonals of the input, U has up to kl + ku
+        size_t m_upper;
+
+        /// @brief interchange made at each step
+        std::vector<size_t> m_pivots;
+
+        /// @brief widened band rows holding L below the diagonal and U from it
+        Storage_Vector_t<T> m_data;
+
+        /// @brief set if an exactly zero pivot was found
+        bool m_singular = false;
+
+        /// @brief values stored per row, room for U's kl extra super diagonals
+        size_t _width() const
+        {
+            return 2 * m_lower + m_upper + 1;
+        };
+
+        /// @brief storage index of (i,j), i - kl <= j <= i + kl + ku
+        size_t _index(const size_t& i, const size_t& j) const
+        {
+            return i * _width() + (j + m_lower - i);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Right looking factorization within the band, rows interchanged physically
+        void _factorize()
+        {
+            for (size_t k = 0; k < m_len; k++)
+            {
+                const size_t rowEnd = std::min(m_len, k + m_lower + 1);
+                const size_t colEnd = std::min(m_len, k + m_lower + m_upper + 1);
+
+                // largest magnitude pivot in column k, at most kl rows below
+                size_t pivotRow = k;
+                double pivotAbs = scalar_abs(m_data[_index(k, k)]);
+                for (size_t i = k + 1; i < rowEnd; i++)
+                {
+                    const double curAbs = scalar_abs(m_data[_index(i, k)]);
+                    if (curAbs > pivotAbs)
+                    {
+                        pivotAbs = curAbs;
+                        pivotRow = i;
+                    }
+                }
+
+                m_pivots[k] = pivotRow;
+                if (pivotAbs == 0)
+                {
+                    m_singular = true;
+                    continue;
+                }
+
+                if (pivotRow != k)
+                {
+                    for (size_t j = k; j < colEnd; j++)
+                    {
+                        std::swap(m_data[_index(k, j)], m_data[_index(pivotRow, j)]);
+                    }
+                }
+
+                const T pivot = m_data[_index(k, k)];
+                for (size_t i = k + 1; i < rowEnd; i++)
+                {
+                    const T factor = m_data[_index(i, k)] / pivot;
+                    m_data[_index(i, k)] = factor;
+                    if (factor == (T) 0)
+                    {
+                        continue;
+                    }
+
+                    // both rows are contiguous over the update columns
+                    T* row = m_data.data() + _index(i, k + 1);
+                    const T* pivotRowData = m_data.data() + _index(k, k + 1);
+                    for (size_t j = 0; j + k + 1 < colEnd; j++)
+                    {
+                        row[j] -= factor * pivotRowData[j];
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies the interchanges and L as it goes, then back substitutes U
+        ///
+        /// @param x right hand sides, row major with nrhs columns, overwritten with the solutions
+        /// @param nrhs number of right hand sides
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        void _solve_in_place(T* x, const size_t& nrhs) const
+        {
+            if (m_singular)
+            {
+                throw std::invalid_argument("Matrix is singular, no unique solution exists");
+            }
+
+            for (size_t k = 0; k < m_len; k++)
+            {
+                T* xk = x + k * nrhs;
+                if (m_pivots[k] != k)
+                {
+                    std::swap_ranges(xk, xk + nrhs, x + m_pivots[k] * nrhs);
+                }
+
+                const size_t rowEnd = std::min(m_len, k + m_lower + 1);
+                for (size_t i = k + 1; i < rowEnd; i++)
+                {
+                    const T l = m_data[_index(i, k)];
+                    T* xi = x + i * nrhs;
+                    for (size_t r = 0; r < nrhs; r++)
+                    {
+                        xi[r] -= l * xk[r];
+                    }
+                }
+            }
+
+            for (size_t i = m_len; i-- > 0;)
+            {
+                T* xi = x + i * nrhs;
+                const size_t colEnd = std::min(m_len, i + m_lower + m_upper + 1);
+                for (size_t j = i + 1; j < colEnd; j++)
+                {
+                    const T u = m_data[_index(i, j)];
+                    const T* xj = x + j * nrhs;
+                    for (size_t r = 0; r < nrhs; r++)
+                    {
+                        xi[r] -= u * xj[r];
+                    }
+                }
+
+                const T diag = m_data[_index(i, i)];
+                for (size_t r = 0; r < nrhs; r++)
+                {
+                    xi[r] = xi[r] / diag;
+                }
+            }
+        };
+};
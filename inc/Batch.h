@@ -0,0 +1,964 @@
+/// ------------------------------------------
+/// @file Batch.h
+///
+/// @brief Header/Source file for batches of same shaped small matrices in interleaved storage
+///
+/// A Matrix_Batch holds count (rows, cols) matrices batch minor: element (i,j) of every
+/// matrix sits in one contiguous plane, so entry b of the batch is lane b of each plane.
+/// Every operation walks the matrix elements in the outer loops and the lanes in the
+/// innermost, the same instruction sequence runs on each lane, one SIMD register of lanes
+/// of a real type at a time in a GCC vector extension value (see Gemm.h). Pivoting and other
+/// per matrix decisions are blends, not branches. The batch is split into BATCH_CHUNK
+/// lane chunks that run across the thread pool
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Matrix.h"
+#include "Eigen.h"
+#include "Scalar.h"
+#include "Storage.h"
+#include "Thread_Pool.h"
+#include "Complex_C.h"
+
+/// Lanes processed together by one task, small enough for the chunk's planes to stay in cache
+#ifndef BATCH_CHUNK
+#define BATCH_CHUNK 256
+#endif
+
+/// Planes are padded to a multiple of this many lanes, a whole number of lane packs
+#define BATCH_LANE_ALIGN 16
+
+// one lane pack of a real type fills a SIMD register of the target
+#if defined(__AVX512F__)
+#define BATCH_PACK_BYTES 64
+#elif defined(__AVX__)
+#define BATCH_PACK_BYTES 32
+#else
+#define BATCH_PACK_BYTES 16
+#endif
+
+static_assert(BATCH_CHUNK % BATCH_LANE_ALIGN == 0, "BATCH_CHUNK must be a multiple of BATCH_LANE_ALIGN");
+
+/// @brief Lane pack the batch kernels step through planes with, a single lane for types without a vector form
+/// Masks come from comparing magnitudes and are combined with | and &
+template <typename T, typename = void>
+struct Batch_Lanes_t
+{
+    typedef T Pack_t;
+    typedef double Mag_t;
+    static constexpr size_t WIDTH = 1;
+
+    static Pack_t load(const T* src) { return *src; }
+    static void store(T* dst, const Pack_t& val) { *dst = val; }
+    static Pack_t splat(const T& val) { return val; }
+    static Mag_t splat_mag(const double& val) { return val; }
+    static Mag_t magnitude(const Pack_t& val) { return scalar_abs(val); }
+
+    template <typename M, typename V>
+    static V select(const M& mask, const V& a, const V& b) { return mask ? a : b; }
+};
+
+#if defined(__GNUC__)
+/// @brief One SIMD register of float or double lanes in a vector extension value
+template <typename T>
+struct Batch_Lanes_t<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    typedef T Pack_t __attribute__((vector_size(BATCH_PACK_BYTES)));
+    typedef Pack_t Mag_t;
+    static constexpr size_t WIDTH = BATCH_PACK_BYTES / sizeof(T);
+
+    static Pack_t load(const T* src) { Pack_t val; memcpy(&val, src, sizeof(Pack_t)); return val; }
+    static void store(T* dst, const Pack_t& val) { memcpy(dst, &val, sizeof(Pack_t)); }
+    static Pack_t splat(const T& val) { return Pack_t{} + val; }
+    static Mag_t splat_mag(const double& val) { return Pack_t{} + (T) val; }
+    static Mag_t magnitude(const Pack_t& val) { return (val < splat(0)) ? -val : val; }
+
+    template <typename M, typename V>
+    static V select(const M& mask, const V& a, const V& b) { return mask ? a : b; }
+};
+#endif
+
+/// @brief Templated batch of same shaped matrices stored interleaved, one lane per matrix
+template <typename T>
+class Matrix_Batch
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, zero filled batch
+        ///
+        /// @param count number of matrices
+        /// @param rows rows of each matrix
+        /// @param cols columns of each matrix
+        ///
+        /// @throws std::invalid_argument if count/rows/cols < 1
+        Matrix_Batch(const size_t& count, const size_t& rows, const size_t& cols)
+        {
+            if (count < 1 || rows < 1 || cols < 1)
+            {
+                throw std::invalid_argument("Count/Cols/Rows of a matrix batch must be above 0");
+            }
+
+            m_count = count;
+            m_rows = rows;
+            m_cols = cols;
+            m_stride = (count + BATCH_LANE_ALIGN - 1) / BATCH_LANE_ALIGN * BATCH_LANE_ALIGN;
+            m_data.assign(m_stride * rows * cols, (T) 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, interleaves a list of same shaped matrices
+        ///
+        /// @param mats matrices, entry b of the batch is mats[b]
+        ///
+        /// @throws std::invalid_argument if the list is empty or the shapes differ
+        Matrix_Batch(const std::vector<Matrix<T>>& mats)
+            : Matrix_Batch(mats.size(), mats.empty() ? 0 : mats[0].getRowCount(), mats.empty() ? 0 : mats[0].getColCount())
+        {
+            for (size_t b = 0; b < m_count; b++)
+            {
+                set(b, mats[b]);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of matrices in the batch
+        ///
+        /// @return batch size
+        size_t getCount() const
+        {
+            return m_count;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows of each matrix
+        ///
+        /// @return number of rows
+        size_t getRowCount() const
+        {
+            return m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns of each matrix
+        ///
+        /// @return number of columns
+        size_t getColCount() const
+        {
+            return m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the distance between planes' lane 0, count rounded up to BATCH_LANE_ALIGN
+        ///
+        /// @return plane stride in elements
+        size_t getStride() const
+        {
+            return m_stride;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the plane of element (i,j), lane b is element (i,j) of matrix b
+        ///
+        /// @param row element row
+        /// @param col element column
+        ///
+        /// @return first lane of the plane
+        T* plane(const size_t& row, const size_t& col)
+        {
+            return m_data.data() + (row * m_cols + col) * m_stride;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the plane of element (i,j), lane b is element (i,j) of matrix b
+        ///
+        /// @param row element row
+        /// @param col element column
+        ///
+        /// @return first lane of the plane
+        const T* plane(const size_t& row, const size_t& col) const
+        {
+            return m_data.data() + (row * m_cols + col) * m_stride;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Element access, unchecked unless MATRIX_BOUNDS_CHECK is set
+        ///
+        /// @param index matrix in the batch
+        /// @param row element row
+        /// @param col element column
+        ///
+        /// @return reference to the element
+        T& operator()(const size_t& index, const size_t& row, const size_t& col)
+        {
+#if MATRIX_BOUNDS_CHECK
+            _check_index(index, row, col);
+#endif
+            return plane(row, col)[index];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Element access, unchecked unless MATRIX_BOUNDS_CHECK is set
+        ///
+        /// @param index matrix in the batch
+        /// @param row element row
+        /// @param col element column
+        ///
+        /// @return the element
+        const T& operator()(const size_t& index, const size_t& row, const size_t& col) const
+        {
+#if MATRIX_BOUNDS_CHECK
+            _check_index(index, row, col);
+#endif
+            return plane(row, col)[index];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies one matrix out of the batch
+        ///
+        /// @param index matrix in the batch
+        ///
+        /// @return the matrix
+        ///
+        /// @throws std::invalid_argument if index is out of range
+        Matrix<T> get(const size_t& index) const
+        {
+            _check_index(index, 0, 0);
+
+            Matrix<T> outMat(m_rows, m_cols);
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < m_cols; j++)
+                {
+                    outMat(i, j) = plane(i, j)[index];
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies one matrix into the batch
+        ///
+        /// @param index matrix in the batch
+        /// @param mat matrix of the batch's shape
+        ///
+        /// @throws std::invalid_argument if index is out of range or the shape differs
+        void set(const size_t& index, const Matrix<T>& mat)
+        {
+            _check_index(index, 0, 0);
+            if (mat.getRowCount() != m_rows || mat.getColCount() != m_cols)
+            {
+                throw std::invalid_argument("Matrix must have the shape of the batch");
+            }
+
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < m_cols; j++)
+                {
+                    plane(i, j)[index] = mat(i, j);
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product of each pair of matrices
+        ///
+        /// @param rhs batch of (p,n) matrices, same count
+        ///
+        /// @return batch of (m,n) products
+        ///
+        /// @throws std::invalid_argument if the counts or dimensions do not match
+        Matrix_Batch operator%(const Matrix_Batch& rhs) const
+        {
+            if (m_cols != rhs.m_rows)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+            _check_count(rhs);
+
+            Matrix_Batch outBatch(m_count, m_rows, rhs.m_cols);
+            _for_chunks([&](const size_t& from, const size_t& len)
+            {
+                for (size_t i = 0; i < m_rows; i++)
+                {
+                    for (size_t j = 0; j < rhs.m_cols; j++)
+                    {
+                        T* out = outBatch.plane(i, j) + from;
+                        for (size_t k = 0; k < m_cols; k++)
+                        {
+                            _lanes_fma(_lanes(len), out, plane(i, k) + from, rhs.plane(k, j) + from);
+                        }
+                    }
+                }
+            });
+            return outBatch;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant of every matrix
+        /// Up to 3x3 by cofactor expansion as Matrix::determinant, above by partial pivoting elimination
+        ///
+        /// @return determinants, entry b belongs to matrix b
+        ///
+        /// @throws std::invalid_argument if the matrices are not square
+        std::vector<T> determinant() const
+        {
+            if (m_rows != m_cols)
+            {
+                throw std::invalid_argument("Matrix must be square to have a determinant");
+            }
+
+            std::vector<T> dets(m_count);
+            _for_chunks([&](const size_t& from, const size_t& len)
+            {
+                const size_t lanes = _lanes(len);
+                Storage_Vector_t<T> chunkDets(lanes, (T) 1);
+                if (m_rows <= 3)
+                {
+                    _det_small(from, lanes, chunkDets.data());
+                }
+                else
+                {
+                    // eliminate a copy one lane pack at a time, the U diagonal accumulates into the determinant
+                    Storage_Vector_t<T> work(m_rows * m_cols * L::WIDTH);
+                    for (size_t p = 0; p < lanes; p += L::WIDTH)
+                    {
+                        _load(from + p, work.data(), m_cols);
+                        _eliminate(work.data(), m_cols, m_rows, false, chunkDets.data() + p);
+                    }
+                }
+                std::copy_n(chunkDets.data(), len, dets.data() + from);
+            });
+            return dets;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the inverse of every matrix
+        /// Up to 3x3 by the adjugate, above by Gauss-Jordan elimination with partial pivoting
+        ///
+        /// @return batch of inverses
+        ///
+        /// @throws std::invalid_argument if the matrices are not square or any is singular
+        Matrix_Batch inverse() const
+        {
+            if (m_rows != m_cols)
+            {
+                throw std::invalid_argument("Matrix must be square to have an inverse");
+            }
+
+            const size_t n = m_rows;
+            Matrix_Batch outBatch(m_count, n, n);
+            std::atomic<size_t> singular{m_count};
+
+            _for_chunks([&](const size_t& from, const size_t& len)
+            {
+                const size_t lanes = _lanes(len);
+                Storage_Vector_t<T> dets(lanes, (T) 1);
+                if (n <= 3)
+                {
+                    _inverse_small(from, lanes, outBatch, dets.data());
+                }
+                else
+                {
+                    // [A | I] reduced to [I | A^-1], one lane pack at a time
+                    Storage_Vector_t<T> work(n * 2 * n * L::WIDTH);
+                    for (size_t p = 0; p < lanes; p += L::WIDTH)
+                    {
+                        _load(from + p, work.data(), 2 * n);
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            for (size_t j = n; j < 2 * n; j++)
+                            {
+                                L::store(work.data() + (i * 2 * n + j) * L::WIDTH, L::splat((T) (j - n == i)));
+                            }
+                        }
+
+                        _eliminate(work.data(), 2 * n, n, true, dets.data() + p);
+
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            for (size_t j = 0; j < n; j++)
+                            {
+                                L::store(outBatch.plane(i, j) + from + p, L::load(work.data() + (i * 2 * n + n + j) * L::WIDTH));
+                            }
+                        }
+                    }
+                }
+
+                for (size_t l = 0; l < len; l++)
+                {
+                    if (dets[l] == (T) 0)
+                    {
+                        size_t first = singular.load();
+                        while (from + l < first && !singular.compare_exchange_weak(first, from + l))
+                        {
+                        }
+                        break;
+                    }
+                }
+            });
+
+            if (singular.load() != m_count)
+            {
+                throw std::invalid_argument("Matrix determinant is zero, no inverse exists (batch entry " +
+                                            std::to_string(singular.load()) + ")");
+            }
+            return outBatch;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Performs QR decomposition on every matrix with Householder reflections
+        /// Same reflector convention as QR.h, for (m,n) matrices Q is (m,k) and R is (k,n), with k = min(m,n)
+        ///
+        /// @return Pair of <Q, R> batches
+        /// Q will be under .first, R under .second
+        std::pair<Matrix_Batch, Matrix_Batch> qr_decompose() const
+        {
+            const size_t m = m_rows;
+            const size_t n = m_cols;
+            const size_t k = std::min(m, n);
+
+            std::pair<Matrix_Batch, Matrix_Batch> outPair(Matrix_Batch(m_count, m, k), Matrix_Batch(m_count, k, n));
+            _for_chunks([&](const size_t& from, const size_t& len)
+            {
+                // one lane pack at a time, element (i,j) of a work area at (i * ld + j) * W
+                constexpr size_t W = L::WIDTH;
+                Storage_Vector_t<T> work(m * n * W);
+                Storage_Vector_t<T> tau(k * W);
+                Storage_Vector_t<T> q(m * k * W);
+
+                const auto at = [&](T* base, const size_t& ld, const size_t& i, const size_t& j)
+                {
+                    return base + (i * ld + j) * W;
+                };
+
+                for (size_t p = 0; p < _lanes(len); p += W)
+                {
+                    _load(from + p, work.data(), n);
+                    for (size_t c = 0; c < k; c++)
+                    {
+                        _householder(m - c, at(work.data(), n, c, c), n * W, tau.data() + c * W);
+
+                        // apply H^H = I - conj(tau) v v^H to the columns right of c
+                        for (size_t j = c + 1; j < n; j++)
+                        {
+                            _reflect(m - c, at(work.data(), n, c, c), n * W, tau.data() + c * W, true,
+                                     at(work.data(), n, c, j), n * W);
+                        }
+                    }
+
+                    // Q = H_1 ... H_k applied to the first k columns of I, last reflector first
+                    std::fill(q.begin(), q.end(), (T) 0);
+                    for (size_t i = 0; i < k; i++)
+                    {
+                        L::store(at(q.data(), k, i, i), L::splat((T) 1));
+                    }
+                    for (size_t c = k; c-- > 0;)
+                    {
+                        for (size_t j = c; j < k; j++)
+                        {
+                            _reflect(m - c, at(work.data(), n, c, c), n * W, tau.data() + c * W, false,
+                                     at(q.data(), k, c, j), k * W);
+                        }
+                    }
+
+                    for (size_t i = 0; i < m; i++)
+                    {
+                        for (size_t j = 0; j < k; j++)
+                        {
+                            L::store(outPair.first.plane(i, j) + from + p, L::load(at(q.data(), k, i, j)));
+                        }
+                    }
+                    for (size_t i = 0; i < k; i++)
+                    {
+                        for (size_t j = i; j < n; j++)
+                        {
+                            L::store(outPair.second.plane(i, j) + from + p, L::load(at(work.data(), n, i, j)));
+                        }
+                    }
+                }
+            });
+            return outPair;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the eigenvalues of every matrix as complex numbers
+        /// Real 2x2 matrices use the closed form lane by lane, larger (or complex) matrices
+        /// run the Eigen_Solver per matrix, chunks still spread over the thread pool
+        ///
+        /// @return (n,1) batch, column b lists the eigenvalues of matrix b (convergence not guarenteed)
+        ///
+        /// @throws std::invalid_argument if the matrices are not square
+        Matrix_Batch<Complex_C_t> eigenvalues_complex() const
+        {
+            if (m_rows != m_cols)
+            {
+                throw std::invalid_argument("Matrix must be square to have eigenvalues");
+            }
+
+            const size_t n = m_rows;
+            Matrix_Batch<Complex_C_t> outBatch(m_count, n, 1);
+            _for_chunks([&](const size_t& from, const size_t& len)
+            {
+                if (n == 1)
+                {
+                    for (size_t l = 0; l < len; l++)
+                    {
+                        outBatch.plane(0, 0)[from + l] = Complex_C_t(scalar_real(plane(0, 0)[from + l]), scalar_imag(plane(0, 0)[from + l]));
+                    }
+                    return;
+                }
+
+                if constexpr (!scalar_is_complex_v<T>)
+                {
+                    if (n == 2)
+                    {
+                        _eigen_2x2(from, len, outBatch);
+                        return;
+                    }
+                }
+
+                // iterative QR deflates at a different step in each matrix, so it does not share lanes
+                Matrix<T> mat(n, n);
+                for (size_t l = 0; l < len; l++)
+                {
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        for (size_t j = 0; j < n; j++)
+                        {
+                            mat(i, j) = plane(i, j)[from + l];
+                        }
+                    }
+
+                    const std::vector<Complex_C_t> vals = Eigen_Solver<T>(mat).result().m_values;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        outBatch.plane(i, 0)[from + l] = vals[i];
+                    }
+                }
+            });
+            return outBatch;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the eigenvalues of every matrix
+        /// Real types keep only the real component of complex eigenvalues, use
+        /// eigenvalues_complex() to see them in full
+        ///
+        /// @return (n,1) batch, column b lists the eigenvalues of matrix b (convergence not guarenteed)
+        ///
+        /// @throws std::invalid_argument if the matrices are not square
+        Matrix_Batch eigenvalues() const
+        {
+            const Matrix_Batch<Complex_C_t> vals = eigenvalues_complex();
+
+            Matrix_Batch outBatch(m_count, m_rows, 1);
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                const Complex_C_t* src = vals.plane(i, 0);
+                T* dst = outBatch.plane(i, 0);
+                for (size_t b = 0; b < m_count; b++)
+                {
+                    dst[b] = scalar_from_complex<T>(src[b]);
+                }
+            }
+            return outBatch;
+        };
+
+    private:
+        typedef Batch_Lanes_t<T> L;
+
+        size_t m_count = 0;
+        size_t m_rows = 0;
+        size_t m_cols = 0;
+
+        /// @brief distance between planes, count rounded up to BATCH_LANE_ALIGN
+        size_t m_stride = 0;
+
+        /// @brief rows * cols planes of m_stride lanes
+        Storage_Vector_t<T> m_data;
+
+        ///--------------------------------------------------------
+        /// @brief Checks an element index is inside the batch
+        ///
+        /// @throws std::invalid_argument if not
+        void _check_index(const size_t& index, const size_t& row, const size_t& col) const
+        {
+            if (index >= m_count || row >= m_rows || col >= m_cols)
+            {
+                throw std::invalid_argument("Index out of range");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Checks another batch holds as many matrices
+        ///
+        /// @throws std::invalid_argument if not
+        void _check_count(const Matrix_Batch& other) const
+        {
+            if (other.m_count != m_count)
+            {
+                throw std::invalid_argument("Batches must hold the same number of matrices");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Rounds a chunk's lane count up to whole lane packs, the planes are padded that far
+        static size_t _lanes(const size_t& len)
+        {
+            return (len + BATCH_LANE_ALIGN - 1) / BATCH_LANE_ALIGN * BATCH_LANE_ALIGN;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Runs body(from, len) over BATCH_CHUNK lane chunks on the thread pool
+        template <typename F>
+        void _for_chunks(const F& body) const
+        {
+            const size_t chunks = (m_count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+            parallel_for(0, chunks, 1, [&](size_t first, size_t last)
+            {
+                for (size_t c = first; c < last; c++)
+                {
+                    const size_t from = c * BATCH_CHUNK;
+                    body(from, std::min<size_t>(BATCH_CHUNK, m_count - from));
+                }
+            });
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies one lane pack into a packed work area, element (i,j) at (i * ld + j) * L::WIDTH
+        ///
+        /// @param from first lane of the pack
+        /// @param work work area, at least rows * ld * L::WIDTH elements
+        /// @param ld elements per work row, at least cols
+        void _load(const size_t& from, T* work, const size_t& ld) const
+        {
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < m_cols; j++)
+                {
+                    L::store(work + (i * ld + j) * L::WIDTH, L::load(plane(i, j) + from));
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief out += a * b lane by lane
+        ///
+        /// @param lanes lanes, a multiple of BATCH_LANE_ALIGN
+        static void _lanes_fma(const size_t& lanes, T* __restrict out, const T* __restrict a, const T* __restrict b)
+        {
+            for (size_t l = 0; l < lanes; l += L::WIDTH)
+            {
+                L::store(out + l, L::load(out + l) + L::load(a + l) * L::load(b + l));
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Partial pivoting elimination of one lane pack of matrices
+        /// Pivot rows are chosen per lane and exchanged with blends, so each lane follows its own pivots
+        ///
+        /// @param work (n, ld) packed work area, element (i,j) at (i * ld + j) * L::WIDTH
+        /// @param ld work columns
+        /// @param n rows (and pivot columns) to eliminate
+        /// @param jordan also eliminate above the pivots and scale pivot rows to one (Gauss-Jordan)
+        /// @param dets multiplied by each lane's pivots and interchange signs, zero for singular lanes
+        static void _eliminate(T* work, const size_t& ld, const size_t& n, const bool& jordan, T* __restrict dets)
+        {
+            typedef typename L::Pack_t Pack_t;
+            typedef typename L::Mag_t Mag_t;
+
+            const auto at = [&](const size_t& i, const size_t& j)
+            {
+                return work + (i * ld + j) * L::WIDTH;
+            };
+
+            Pack_t det = L::load(dets);
+            for (size_t c = 0; c < n; c++)
+            {
+                // per lane largest magnitude in column c at or below the diagonal
+                Mag_t best = L::magnitude(L::load(at(c, c)));
+                Mag_t pivot = L::splat_mag((double) c);
+                for (size_t r = c + 1; r < n; r++)
+                {
+                    const Mag_t cur = L::magnitude(L::load(at(r, c)));
+                    const auto better = cur > best;
+                    best = L::select(better, cur, best);
+                    pivot = L::select(better, L::splat_mag((double) r), pivot);
+                }
+
+                // exchange row c with each lane's pivot row, columns left of c are already zero below the diagonal
+                for (size_t j = c; j < ld; j++)
+                {
+                    const Pack_t top = L::load(at(c, j));
+                    Pack_t picked = top;
+                    for (size_t r = c + 1; r < n; r++)
+                    {
+                        const auto swap = pivot == L::splat_mag((double) r);
+                        const Pack_t other = L::load(at(r, j));
+                        picked = L::select(swap, other, picked);
+                        L::store(at(r, j), L::select(swap, top, other));
+                    }
+                    L::store(at(c, j), picked);
+                }
+
+                const Pack_t diag = L::load(at(c, c));
+                const auto zero = best == L::splat_mag(0);
+                const Pack_t one = L::splat((T) 1);
+                const Pack_t scale = L::select(zero, L::splat((T) 0), one / L::select(zero, one, diag));
+                det = det * L::select(pivot != L::splat_mag((double) c), -diag, diag);
+
+                if (jordan)
+                {
+                    for (size_t j = c; j < ld; j++)
+                    {
+                        L::store(at(c, j), L::load(at(c, j)) * scale);
+                    }
+                }
+
+                for (size_t r = jordan ? 0 : c + 1; r < n; r++)
+                {
+                    if (r == c)
+                    {
+                        continue;
+                    }
+
+                    // the pivot row is scaled already for Gauss-Jordan, the factor is for plain elimination
+                    const Pack_t factor = jordan ? L::load(at(r, c)) : L::load(at(r, c)) * scale;
+                    for (size_t j = c + 1; j < ld; j++)
+                    {
+                        L::store(at(r, j), L::load(at(r, j)) - factor * L::load(at(c, j)));
+                    }
+                    L::store(at(r, c), jordan ? L::splat((T) 0) : factor);
+                }
+            }
+            L::store(dets, det);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cofactor determinants of a chunk of 1x1, 2x2 or 3x3 matrices
+        ///
+        /// @param from first lane
+        /// @param lanes lanes in the chunk, a multiple of BATCH_LANE_ALIGN
+        /// @param dets output, lanes long
+        void _det_small(const size_t& from, const size_t& lanes, T* __restrict dets) const
+        {
+            const auto a = [&](const size_t& i, const size_t& j, const size_t& l)
+            {
+                return L::load(plane(i, j) + from + l);
+            };
+
+            for (size_t l = 0; l < lanes; l += L::WIDTH)
+            {
+                if (m_rows == 1)
+                {
+                    L::store(dets + l, a(0, 0, l));
+                }
+                else if (m_rows == 2)
+                {
+                    L::store(dets + l, a(0, 0, l) * a(1, 1, l) - a(1, 0, l) * a(0, 1, l));
+                }
+                else
+                {
+                    L::store(dets + l, (a(0, 0, l) * (a(1, 1, l) * a(2, 2, l) - a(2, 1, l) * a(1, 2, l)))
+                                      -(a(1, 0, l) * (a(0, 1, l) * a(2, 2, l) - a(2, 1, l) * a(0, 2, l)))
+                                      +(a(2, 0, l) * (a(0, 1, l) * a(1, 2, l) - a(1, 1, l) * a(0, 2, l))));
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adjugate inverses of a chunk of 1x1, 2x2 or 3x3 matrices
+        ///
+        /// @param from first lane
+        /// @param lanes lanes in the chunk, a multiple of BATCH_LANE_ALIGN
+        /// @param outBatch batch receiving the inverses
+        /// @param dets output determinants, lanes long, zero lanes are left unscaled
+        void _inverse_small(const size_t& from, const size_t& lanes, Matrix_Batch& outBatch, T* __restrict dets) const
+        {
+            typedef typename L::Pack_t Pack_t;
+
+            _det_small(from, lanes, dets);
+
+            const auto a = [&](const size_t& i, const size_t& j, const size_t& l)
+            {
+                return L::load(plane(i, j) + from + l);
+            };
+            const auto out = [&](const size_t& i, const size_t& j, const size_t& l)
+            {
+                return outBatch.plane(i, j) + from + l;
+            };
+
+            for (size_t l = 0; l < lanes; l += L::WIDTH)
+            {
+                const Pack_t det = L::load(dets + l);
+                const auto zero = L::magnitude(det) == L::splat_mag(0);
+                const Pack_t one = L::splat((T) 1);
+                const Pack_t scale = L::select(zero, L::splat((T) 0), one / L::select(zero, one, det));
+
+                if (m_rows == 1)
+                {
+                    L::store(out(0, 0, l), scale);
+                    continue;
+                }
+
+                if (m_rows == 2)
+                {
+                    L::store(out(0, 0, l), a(1, 1, l) * scale);
+                    L::store(out(0, 1, l), -a(0, 1, l) * scale);
+                    L::store(out(1, 0, l), -a(1, 0, l) * scale);
+                    L::store(out(1, 1, l), a(0, 0, l) * scale);
+                    continue;
+                }
+
+                // inverse(i,j) = cofactor(j,i) / det, the cyclic index form gives each cofactor its sign
+                for (size_t i = 0; i < 3; i++)
+                {
+                    for (size_t j = 0; j < 3; j++)
+                    {
+                        const Pack_t cofactor = a((j + 1) % 3, (i + 1) % 3, l) * a((j + 2) % 3, (i + 2) % 3, l)
+                                              - a((j + 1) % 3, (i + 2) % 3, l) * a((j + 2) % 3, (i + 1) % 3, l);
+                        L::store(out(i, j, l), cofactor * scale);
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Generates one Householder reflector per lane of a pack, H^H x = beta e1 (follows LAPACK xLARFG)
+        /// Lanes whose column is already reduced get tau = 0
+        ///
+        /// @param height length of x
+        /// @param x column, x[0] at x, x[i] at x + i * ld, overwritten with beta and the reflector tail
+        /// @param ld distance between elements of x
+        /// @param tau output scale factors, L::WIDTH long
+        static void _householder(const size_t& height, T* x, const size_t& ld, T* __restrict tau)
+        {
+            typedef typename L::Pack_t Pack_t;
+
+            double xnorm[L::WIDTH] = {};
+            for (size_t i = 1; i < height; i++)
+            {
+                const T* xi = x + i * ld;
+                for (size_t l = 0; l < L::WIDTH; l++)
+                {
+                    const double a = scalar_abs(xi[l]);
+                    xnorm[l] += a * a;
+                }
+            }
+
+            T scale[L::WIDTH];
+            for (size_t l = 0; l < L::WIDTH; l++)
+            {
+                const T alpha = x[l];
+                const double alphaAbs = scalar_abs(alpha);
+                const bool reduced = xnorm[l] == 0 && scalar_abs(alpha - scalar_conj(alpha)) == 0;
+
+                double beta = std::sqrt(alphaAbs * alphaAbs + xnorm[l]);
+                beta = (scalar_real(alpha) >= 0) ? -beta : beta;
+
+                const T betaT = reduced ? alpha : (T) beta;
+                tau[l] = reduced ? (T) 0 : (betaT - alpha) / betaT;
+                scale[l] = reduced ? (T) 0 : (T) 1 / (alpha - betaT);
+                x[l] = betaT;
+            }
+
+            const Pack_t factor = L::load(scale);
+            for (size_t i = 1; i < height; i++)
+            {
+                L::store(x + i * ld, L::load(x + i * ld) * factor);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies one reflector per lane of a pack to a column, y := (I - tau v v^H) y
+        ///
+        /// @param height length of v and y
+        /// @param v reflector column, leading one implied, element i at v + i * ldv
+        /// @param ldv distance between elements of v
+        /// @param tau scale factors, L::WIDTH long
+        /// @param conj use conj(tau), i.e. apply H^H
+        /// @param y column to update, element i at y + i * ldy
+        /// @param ldy distance between elements of y
+        static void _reflect(const size_t& height, const T* v, const size_t& ldv,
+                             const T* __restrict tau, const bool& conj, T* y, const size_t& ldy)
+        {
+            typedef typename L::Pack_t Pack_t;
+
+            // dot = v^H y
+            Pack_t dot = L::load(y);
+            for (size_t i = 1; i < height; i++)
+            {
+                dot += _conj(L::load(v + i * ldv)) * L::load(y + i * ldy);
+            }
+
+            const Pack_t scale = L::load(tau);
+            dot = (conj ? _conj(scale) : scale) * dot;
+            L::store(y, L::load(y) - dot);
+            for (size_t i = 1; i < height; i++)
+            {
+                L::store(y + i * ldy, L::load(y + i * ldy) - L::load(v + i * ldv) * dot);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Conjugate of a lane pack, real packs are returned as they are
+        template <typename P>
+        static P _conj(const P& val)
+        {
+            if constexpr (scalar_is_complex_v<T>)
+            {
+                return scalar_conj(val);
+            }
+            else
+            {
+                return val;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Closed form eigenvalues of a chunk of real 2x2 matrices
+        /// lambda = m +- sqrt(m^2 - det), m half the trace, the smaller root taken as det / larger to avoid cancellation
+        ///
+        /// @param from first lane
+        /// @param len lanes in the chunk
+        /// @param outBatch (2,1) batch receiving the eigenvalues
+        void _eigen_2x2(const size_t& from, const size_t& len, Matrix_Batch<Complex_C_t>& outBatch) const
+        {
+            const T* a00 = plane(0, 0) + from; const T* a01 = plane(0, 1) + from;
+            const T* a10 = plane(1, 0) + from; const T* a11 = plane(1, 1) + from;
+            Complex_C_t* first = outBatch.plane(0, 0) + from;
+            Complex_C_t* second = outBatch.plane(1, 0) + from;
+
+            for (size_t l = 0; l < len; l++)
+            {
+                const double m = 0.5 * ((double) a00[l] + (double) a11[l]);
+                const double det = (double) a00[l] * (double) a11[l] - (double) a01[l] * (double) a10[l];
+                const double disc = m * m - det;
+                const double root = std::sqrt(std::fabs(disc));
+
+                if (disc >= 0)
+                {
+                    const double big = m + std::copysign(root, m);
+                    first[l] = Complex_C_t(big, 0.0);
+                    second[l] = Complex_C_t((big != 0) ? det / big : 0.0, 0.0);
+                }
+                else
+                {
+                    first[l] = Complex_C_t(m, root);
+                    second[l] = Complex_C_t(m, -root);
+                }
+            }
+        };
+};
@@ -11,6 +11,7 @@
 
 #include "Complex_C.h"
 #include "Complex_P.h"
+#include "Complex_D.h"
 
 ///--------------------------------------------------------
 /// @brief Converts a polar complex number to cartesian form
@@ -0,0 +1,406 @@
+/// ------------------------------------------
+/// @file Complex_D.h
+///
+/// @brief Header file for the dual form complex number structure and associated
+/// functions
+///
+/// Complex_D_t holds its value in cartesian form, polar form or both, and only
+/// converts when an operation actually needs the other form. Additions work in
+/// cartesian form and multiplications/divisions in polar form when both operands
+/// already have it, so chains of either stay free of trig calls
+///
+/// @note Conversions of a const operand are never cached on it, so shared values
+/// can be read from many threads. Use cacheCartesian()/cachePolar() to keep both
+/// forms on a value that will be reused a lot
+/// ------------------------------------------
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "Complex_C.h"
+#include "Complex_P.h"
+
+/// @brief Complex number structure, lazily holds cartesian and/or polar form
+struct Complex_D_t
+{
+    /// @brief Which forms currently hold the value
+    enum Form_t : unsigned char
+    {
+        CART = 1,
+        POLAR = 2,
+        BOTH = 3
+    };
+
+    /// @brief real component, valid if m_form has CART
+    double m_real = 0;
+
+    /// @brief imaginary component, valid if m_form has CART
+    double m_imagine = 0;
+
+    /// @brief magnitude (never negative), valid if m_form has POLAR
+    double m_mag = 0;
+
+    /// @brief argument/angle in radians (not range reduced), valid if m_form has POLAR
+    double m_arg = 0;
+
+    /// @brief forms currently valid
+    Form_t m_form = BOTH;
+
+    ///--------------------------------------------------------
+    /// @brief Default constructor, zero in both forms
+    Complex_D_t() {};
+
+    ///--------------------------------------------------------
+    /// @brief Cast constructor using a real number, both forms are known without trig
+    ///
+    /// @param real real number to cast to complex
+    Complex_D_t(const double& real);
+
+    ///--------------------------------------------------------
+    /// @brief Cast constructor from a cartesian complex
+    ///
+    /// @param com cartesian complex
+    Complex_D_t(const Complex_C_t& com);
+
+    ///--------------------------------------------------------
+    /// @brief Cast constructor from a polar complex, negative magnitudes are folded into the angle
+    ///
+    /// @param com polar complex
+    Complex_D_t(const Complex_P_t& com);
+
+    ///--------------------------------------------------------
+    /// @brief Creates a complex in cartesian form
+    ///
+    /// @param real real component
+    /// @param imagine imaginary component
+    ///
+    /// @return complex holding only the cartesian form
+    static Complex_D_t cartesian(const double& real, const double& imagine);
+
+    ///--------------------------------------------------------
+    /// @brief Creates a complex in polar form
+    ///
+    /// @param mag magnitude, negative values are folded into the angle
+    /// @param arg argument in radians
+    ///
+    /// @return complex holding only the polar form
+    static Complex_D_t polar(const double& mag, const double& arg);
+
+    ///--------------------------------------------------------
+    /// @brief Is the cartesian form currently held?
+    ///
+    /// @return true if real()/imaginary() need no conversion
+    bool hasCartesian() const
+    {
+        return m_form & CART;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Is the polar form currently held?
+    ///
+    /// @return true if absolute()/argument() need no conversion
+    bool hasPolar() const
+    {
+        return m_form & POLAR;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief gets the real component, converting if only polar form is held
+    ///
+    /// @returns real component
+    double real() const;
+
+    ///--------------------------------------------------------
+    /// @brief gets the imaginary component, converting if only polar form is held
+    ///
+    /// @returns imaginary component
+    double imaginary() const;
+
+    ///--------------------------------------------------------
+    /// @brief Find the absolute value, converting if only cartesian form is held
+    ///
+    /// @return absolute value of complex number
+    double absolute() const;
+
+    ///--------------------------------------------------------
+    /// @brief Find the argument, converting if only cartesian form is held
+    ///
+    /// @return argument in radians, [-pi, pi] range
+    double argument() const;
+
+    ///--------------------------------------------------------
+    /// @brief Find the conjugate, keeps whichever forms are held
+    ///
+    /// @return conjugate of complex
+    Complex_D_t conjugate() const;
+
+    ///--------------------------------------------------------
+    /// @brief Returns the value in cartesian form
+    ///
+    /// @return cartesian complex
+    Complex_C_t toCartesian() const;
+
+    ///--------------------------------------------------------
+    /// @brief Returns the value in polar form
+    ///
+    /// @return polar complex
+    Complex_P_t toPolar() const;
+
+    ///--------------------------------------------------------
+    /// @brief Converts to and keeps the cartesian form alongside the current one
+    void cacheCartesian();
+
+    ///--------------------------------------------------------
+    /// @brief Converts to and keeps the polar form alongside the current one
+    void cachePolar();
+};
+
+///--------------------------------------------------------
+/// @brief Overload of +, adds two complex numbers together in cartesian form
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator+(const Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of +, adds a complex and real number
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return resulting complex number
+Complex_D_t operator+(const Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of +, adds a real and complex number
+///
+/// @param lreal left hand real
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator+(const double& lreal, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of +=, adds rcom to lcom
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+void operator+=(Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of +=, adds rreal to lcom
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+void operator+=(Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of -, subtracts two complex numbers in cartesian form
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator-(const Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of -, subtracts a complex and real number
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return resulting complex number
+Complex_D_t operator-(const Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of -, subtracts real number and a complex
+///
+/// @param lreal left hand real
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator-(const double& lreal, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of uniary -, inverts a complex number, keeps whichever forms are held
+///
+/// @param com complex to invert
+///
+/// @return resulting complex number
+Complex_D_t operator-(const Complex_D_t& com);
+
+///--------------------------------------------------------
+/// @brief Overload of -=, subtracts rcom from lcom
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+void operator-=(Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of -=, subtracts rreal from lcom
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+void operator-=(Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of *, multiplies two complex numbers
+/// Polar if both operands hold polar form, otherwise cartesian
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator*(const Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of *, multiplies a complex and real number, keeps whichever forms are held
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return resulting complex number
+Complex_D_t operator*(const Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of *, multiplies a real number and a complex
+///
+/// @param lreal left hand real
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator*(const double& lreal, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of *=, multiplies lcom by rcom
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+void operator*=(Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of *=, multiplies lcom by rreal
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+void operator*=(Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of /, divides two complex numbers
+/// Polar if both operands hold polar form, otherwise cartesian
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator/(const Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of /, divides a complex by a real, keeps whichever forms are held
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return resulting complex number
+Complex_D_t operator/(const Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of /, divides a real number by a complex
+///
+/// @param lreal left hand real
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_D_t operator/(const double& lreal, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of /=, divides lcom by rcom
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+void operator/=(Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of /=, divides lcom by rreal
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+void operator/=(Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of ==, are complex numbers equal?
+/// Compares in a form both hold, otherwise in cartesian form
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return equality boolean
+bool operator==(const Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of ==, are complex and real equal?
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return equality boolean
+bool operator==(const Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of ==, is a complex and a real equal?
+///
+/// @param lreal left hand real
+/// @param rcom right hand complex
+///
+/// @return equality boolean
+bool operator==(const double& lreal, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of !=, are complex numbers unequal?
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return inequality boolean
+bool operator!=(const Complex_D_t& lcom, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of !=, is a complex and a real unequal?
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return inequality boolean
+bool operator!=(const Complex_D_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of !=, is a complex and a real unequal?
+///
+/// @param lreal left hand real
+/// @param rcom right hand complex
+///
+/// @return inequality boolean
+bool operator!=(const double& lreal, const Complex_D_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of <<, outputs in cartesian form if held, otherwise polar
+///
+/// @param os output stream
+/// @param com complex number to string convert
+///
+/// @return output stream
+std::ostream& operator<<(std::ostream& os, const Complex_D_t& com);
+
+///--------------------------------------------------------
+/// @brief Raises a complex number by a real power, result is in polar form
+///
+/// @param base complex number to raise
+/// @param raise power to raise it by
+///
+/// @return raised complex number
+Complex_D_t powReal(const Complex_D_t& base, const double& raise);
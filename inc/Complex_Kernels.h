@@ -0,0 +1,244 @@
+/// ------------------------------------------
+/// @file Complex_Kernels.h
+///
+/// @brief Header file for split (structure of arrays) cartesian complex storage and
+/// the vectorised kernels that work on it
+///
+/// Complex_C_t arrays interleave {real, imaginary}, which stops the compiler
+/// vectorising across elements. The kernels here take the real and imaginary parts
+/// as separate arrays and are compiled for AVX2, AVX-512 and NEON, the best one the
+/// CPU supports is picked once at run time
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Complex_C.h"
+
+/// Columns of B packed per block by complex_gemm
+#ifndef COMPLEX_GEMM_BLOCK_NC
+#define COMPLEX_GEMM_BLOCK_NC 512
+#endif
+
+/// Depth of B packed per block by complex_gemm
+#ifndef COMPLEX_GEMM_BLOCK_KC
+#define COMPLEX_GEMM_BLOCK_KC 128
+#endif
+
+/// Elements split at a time when an interleaved array is fed to the kernels
+#ifndef COMPLEX_SPLIT_BLOCK
+#define COMPLEX_SPLIT_BLOCK 256
+#endif
+
+/// @brief Instruction sets the complex kernels are compiled for
+enum class Complex_Isa_t
+{
+    GENERIC,    // plain loops, left to the compiler
+    AVX2,       // x86 AVX2 + FMA
+    AVX512,     // x86 AVX-512F
+    NEON        // AArch64 Advanced SIMD
+};
+
+/// @brief Complex array stored as separate real and imaginary arrays
+struct Complex_Soa_t
+{
+    /// @brief real components
+    std::vector<double> m_real;
+
+    /// @brief imaginary components
+    std::vector<double> m_imagine;
+
+    ///--------------------------------------------------------
+    /// @brief Constructor, zero initialised
+    ///
+    /// @param len number of elements
+    Complex_Soa_t(const size_t& len = 0) : m_real(len, 0.0), m_imagine(len, 0.0) {};
+
+    ///--------------------------------------------------------
+    /// @brief Constructor, splits an interleaved array
+    ///
+    /// @param data first element to read
+    /// @param len number of elements
+    /// @param stride distance between elements of data
+    Complex_Soa_t(const Complex_C_t* data, const size_t& len, const size_t& stride = 1);
+
+    ///--------------------------------------------------------
+    /// @brief Returns the number of elements
+    ///
+    /// @return element count
+    size_t size() const
+    {
+        return m_real.size();
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Returns element i in cartesian form
+    ///
+    /// @param i index
+    ///
+    /// @return element i
+    Complex_C_t get(const size_t& i) const
+    {
+        return Complex_C_t{m_real[i], m_imagine[i]};
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Sets element i
+    ///
+    /// @param i index
+    /// @param com value to store
+    void set(const size_t& i, const Complex_C_t& com)
+    {
+        m_real[i] = com.m_real;
+        m_imagine[i] = com.m_imagine;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Writes the elements back out interleaved
+    ///
+    /// @param out first element to write
+    /// @param stride distance between elements of out
+    void store(Complex_C_t* out, const size_t& stride = 1) const;
+};
+
+///--------------------------------------------------------
+/// @brief Returns the instruction set the kernels currently dispatch to
+///
+/// @return active instruction set
+Complex_Isa_t complex_kernel_isa();
+
+///--------------------------------------------------------
+/// @brief Is the instruction set supported by this build and CPU?
+///
+/// @param isa instruction set to check
+///
+/// @return true if complex_kernel_set_isa(isa) would succeed
+bool complex_kernel_supported(const Complex_Isa_t& isa);
+
+///--------------------------------------------------------
+/// @brief Forces the kernels onto an instruction set, mostly for testing and benchmarks
+///
+/// @param isa instruction set to use
+///
+/// @throws std::invalid_argument if the instruction set is not supported
+void complex_kernel_set_isa(const Complex_Isa_t& isa);
+
+///--------------------------------------------------------
+/// @brief Elementwise addition, c = a + b (c may alias a or b)
+///
+/// @param len number of elements
+/// @param ar real parts of a
+/// @param ai imaginary parts of a
+/// @param br real parts of b
+/// @param bi imaginary parts of b
+/// @param cr real parts of c, written
+/// @param ci imaginary parts of c, written
+void complex_soa_add(const size_t& len, const double* ar, const double* ai,
+                     const double* br, const double* bi, double* cr, double* ci);
+
+///--------------------------------------------------------
+/// @brief Elementwise multiplication, c = a * b (c may alias a or b)
+///
+/// @param len number of elements
+/// @param ar real parts of a
+/// @param ai imaginary parts of a
+/// @param br real parts of b
+/// @param bi imaginary parts of b
+/// @param cr real parts of c, written
+/// @param ci imaginary parts of c, written
+void complex_soa_mul(const size_t& len, const double* ar, const double* ai,
+                     const double* br, const double* bi, double* cr, double* ci);
+
+///--------------------------------------------------------
+/// @brief Elementwise fused multiply add, c += a * b
+///
+/// @param len number of elements
+/// @param ar real parts of a
+/// @param ai imaginary parts of a
+/// @param br real parts of b
+/// @param bi imaginary parts of b
+/// @param cr real parts of c, updated
+/// @param ci imaginary parts of c, updated
+void complex_soa_fma(const size_t& len, const double* ar, const double* ai,
+                     const double* br, const double* bi, double* cr, double* ci);
+
+///--------------------------------------------------------
+/// @brief Scaled accumulate, y += alpha * x
+///
+/// @param len number of elements
+/// @param alpha scale factor
+/// @param xr real parts of x
+/// @param xi imaginary parts of x
+/// @param yr real parts of y, updated
+/// @param yi imaginary parts of y, updated
+void complex_soa_axpy(const size_t& len, const Complex_C_t& alpha,
+                      const double* xr, const double* xi, double* yr, double* yi);
+
+///--------------------------------------------------------
+/// @brief Unconjugated dot product, sum of a[i] * b[i]
+///
+/// @param len number of elements
+/// @param ar real parts of a
+/// @param ai imaginary parts of a
+/// @param br real parts of b
+/// @param bi imaginary parts of b
+///
+/// @return dot product
+Complex_C_t complex_soa_dot(const size_t& len, const double* ar, const double* ai,
+                            const double* br, const double* bi);
+
+///--------------------------------------------------------
+/// @brief Elementwise addition of split arrays
+///
+/// @throws std::invalid_argument if the sizes differ
+Complex_Soa_t operator+(const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa);
+
+///--------------------------------------------------------
+/// @brief Elementwise multiplication of split arrays
+///
+/// @throws std::invalid_argument if the sizes differ
+Complex_Soa_t operator*(const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa);
+
+///--------------------------------------------------------
+/// @brief Fused multiply add of split arrays, acc += lsoa * rsoa
+///
+/// @throws std::invalid_argument if the sizes differ
+void fma(Complex_Soa_t& acc, const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa);
+
+///--------------------------------------------------------
+/// @brief Unconjugated dot product of split arrays
+///
+/// @throws std::invalid_argument if the sizes differ
+Complex_C_t dot(const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa);
+
+///--------------------------------------------------------
+/// @brief Unconjugated dot product of interleaved arrays, split in blocks for the kernels
+///
+/// @param len number of elements
+/// @param a first array
+/// @param b second array
+///
+/// @return sum of a[i] * b[i]
+Complex_C_t complex_dot(const size_t& len, const Complex_C_t* a, const Complex_C_t* b);
+
+///--------------------------------------------------------
+/// @brief Complex general matrix multiply, C = A * B, same layout rules as gemm in Gemm.h
+/// Blocks of B are split into real and imaginary panels and each row of C is built
+/// with complex_soa_axpy, rows are shared out across the thread pool
+///
+/// @param m rows of A and C
+/// @param n columns of B and C
+/// @param k columns of A and rows of B
+/// @param A pointer to A
+/// @param rsa distance between rows of A
+/// @param csa distance between columns of A
+/// @param B pointer to B
+/// @param rsb distance between rows of B
+/// @param csb distance between columns of B
+/// @param C pointer to C, overwritten
+/// @param ldc row stride of C
+void complex_gemm(const size_t& m, const size_t& n, const size_t& k,
+                  const Complex_C_t* A, const size_t& rsa, const size_t& csa,
+                  const Complex_C_t* B, const size_t& rsb, const size_t& csb,
+                  Complex_C_t* C, const size_t& ldc);
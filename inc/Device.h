@@ -0,0 +1,535 @@
+/// ------------------------------------------
+/// @file Device.h
+///
+/// @brief Header file for the optional GPU backend and the device resident Device_Matrix
+///
+/// The backend is chosen when configuring (MATRIX_GPU=CUDA or HIP) and runs the
+/// vendor BLAS/LAPACK libraries on the calling thread's own stream. Built without
+/// one every device_* call is a stub: device_available() is false, so nothing is
+/// ever offloaded, and anything that needs device memory throws
+///
+/// float and double matrices of at least DEVICE_OFFLOAD_MIN_DIM (products) or
+/// DEVICE_OFFLOAD_MIN_ORDER (inverse, determinant, symmetric eigenvalues) are moved
+/// to the device and back by Matrix<T> itself. Keep data on the device between calls
+/// with Device_Matrix to avoid paying for the transfers every time
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Matrix_Fwd.h"
+
+/// Smallest m, n and k of a product offloaded by Matrix<T>::operator%
+#ifndef DEVICE_OFFLOAD_MIN_DIM
+#define DEVICE_OFFLOAD_MIN_DIM 512
+#endif
+
+/// Smallest order of a matrix whose inverse, determinant or eigenvalues are offloaded
+#ifndef DEVICE_OFFLOAD_MIN_ORDER
+#define DEVICE_OFFLOAD_MIN_ORDER 768
+#endif
+
+/// Environment variable read at start up, "0" keeps everything on the CPU
+#define DEVICE_ENABLE_ENV "MATRIX_DEVICE"
+
+/// @brief GPU backends the library can be built with
+enum class Device_Backend_t
+{
+    NONE,   // CPU only, the device_* calls are stubs
+    CUDA,   // cuBLAS and cuSOLVER
+    HIP     // hipBLAS and hipSOLVER
+};
+
+/// @brief Can T be stored and computed on the device?
+template <typename T>
+constexpr bool device_scalar_v = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+///--------------------------------------------------------
+/// @brief Returns the backend the library was built with
+///
+/// @return backend, NONE for CPU only builds
+Device_Backend_t device_backend();
+
+///--------------------------------------------------------
+/// @brief Is offloading possible, backend built, a device present and offloading enabled?
+///
+/// @return true if work may be sent to the device
+bool device_available();
+
+///--------------------------------------------------------
+/// @brief Turns automatic offloading from Matrix<T> on or off, Device_Matrix is unaffected
+/// Starts enabled unless DEVICE_ENABLE_ENV is "0"
+///
+/// @param enabled should Matrix<T> offload large calls?
+void device_set_enabled(const bool& enabled);
+
+///--------------------------------------------------------
+/// @brief Is automatic offloading from Matrix<T> enabled?
+///
+/// @return true if enabled
+bool device_enabled();
+
+///--------------------------------------------------------
+/// @brief Size heuristic for matrix products
+///
+/// @param m rows of the product
+/// @param n columns of the product
+/// @param k inner dimension
+///
+/// @return true if the product should run on the device
+bool device_offload_product(const size_t& m, const size_t& n, const size_t& k);
+
+///--------------------------------------------------------
+/// @brief Size heuristic for the factorization based calls
+///
+/// @param n order of the matrix
+///
+/// @return true if the call should run on the device
+bool device_offload_order(const size_t& n);
+
+///--------------------------------------------------------
+/// @brief Allocates device memory
+///
+/// @param bytes size of the buffer
+///
+/// @return device pointer, only usable by the device_* calls
+///
+/// @throws std::runtime_error if there is no backend or the allocation failed
+void* device_allocate(const size_t& bytes);
+
+///--------------------------------------------------------
+/// @brief Releases device memory from device_allocate, after the calling thread's queued work
+///
+/// @param ptr device pointer, nullptr is ignored
+void device_release(void* ptr) noexcept;
+
+///--------------------------------------------------------
+/// @brief Copies host memory to the device
+///
+/// @note async copies return once queued, src must stay unchanged until device_synchronize()
+///
+/// @param dst device pointer
+/// @param src host pointer
+/// @param bytes size to copy
+/// @param async queue the copy on the calling thread's stream without waiting
+///
+/// @throws std::runtime_error if the copy failed
+void device_upload(void* dst, const void* src, const size_t& bytes, const bool& async);
+
+///--------------------------------------------------------
+/// @brief Copies device memory to the host
+///
+/// @note async copies return once queued, dst must not be read until device_synchronize()
+///
+/// @param dst host pointer
+/// @param src device pointer
+/// @param bytes size to copy
+/// @param async queue the copy on the calling thread's stream without waiting
+///
+/// @throws std::runtime_error if the copy failed
+void device_download(void* dst, const void* src, const size_t& bytes, const bool& async);
+
+///--------------------------------------------------------
+/// @brief Copies device memory to device memory, queued on the calling thread's stream
+///
+/// @param dst device pointer
+/// @param src device pointer
+/// @param bytes size to copy
+///
+/// @throws std::runtime_error if the copy failed
+void device_copy(void* dst, const void* src, const size_t& bytes);
+
+///--------------------------------------------------------
+/// @brief Waits for all work queued by the calling thread
+///
+/// @throws std::runtime_error if queued work failed
+void device_synchronize();
+
+///--------------------------------------------------------
+/// @brief C = A * B on device pointers, all row major and contiguous
+///
+/// @param m rows of A and C
+/// @param n columns of B and C
+/// @param k columns of A and rows of B
+/// @param a device pointer to A
+/// @param b device pointer to B
+/// @param c device pointer to C, overwritten
+///
+/// @throws std::runtime_error if the call failed
+void device_gemm(const size_t& m, const size_t& n, const size_t& k, const float* a, const float* b, float* c);
+void device_gemm(const size_t& m, const size_t& n, const size_t& k, const double* a, const double* b, double* c);
+
+///--------------------------------------------------------
+/// @brief C = alpha A + beta B elementwise on device pointers, C may alias A or B
+///
+/// @param count number of elements
+/// @param alpha scale of A
+/// @param a device pointer to A
+/// @param beta scale of B
+/// @param b device pointer to B
+/// @param c device pointer to C, overwritten
+///
+/// @throws std::runtime_error if the call failed
+void device_axpby(const size_t& count, const float& alpha, const float* a, const float& beta, const float* b, float* c);
+void device_axpby(const size_t& count, const double& alpha, const double* a, const double& beta, const double* b, double* c);
+
+///--------------------------------------------------------
+/// @brief Inverts a square row major matrix on the device with partial pivoting LU
+///
+/// @param n order of the matrix
+/// @param a device pointer to the matrix, left factorized
+/// @param inv device pointer to the (n,n) output
+///
+/// @return false if the matrix is singular, inv is then undefined
+///
+/// @throws std::runtime_error if the call failed
+bool device_inverse(const size_t& n, float* a, float* inv);
+bool device_inverse(const size_t& n, double* a, double* inv);
+
+///--------------------------------------------------------
+/// @brief Determinant of a square row major matrix with partial pivoting LU on the device
+///
+/// @param n order of the matrix
+/// @param a device pointer to the matrix, left factorized
+///
+/// @return determinant
+///
+/// @throws std::runtime_error if the call failed
+float device_determinant(const size_t& n, float* a);
+double device_determinant(const size_t& n, double* a);
+
+///--------------------------------------------------------
+/// @brief Eigenvalues of a real symmetric matrix on the device, in ascending order
+///
+/// @param n order of the matrix
+/// @param a device pointer to the matrix, only the lower triangle is read, left overwritten
+/// @param values host pointer to n outputs
+///
+/// @throws std::runtime_error if the call failed or did not converge
+void device_eigenvalues_symmetric(const size_t& n, float* a, float* values);
+void device_eigenvalues_symmetric(const size_t& n, double* a, double* values);
+
+/// @brief Templated class for a row major matrix held in device memory
+/// Mirrors the Matrix<T> operations that have device kernels, results stay on the device
+/// until downloaded
+template <typename T>
+class Device_Matrix
+{
+    static_assert(device_scalar_v<T>, "Device_Matrix only holds float or double");
+
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, allocates uninitialized device memory
+        ///
+        /// @param rows number of rows to allocate
+        /// @param cols number of columns to allocate
+        ///
+        /// @throws std::invalid_argument if rows/cols < 1
+        /// @throws std::runtime_error if device memory could not be allocated
+        Device_Matrix(const size_t& rows, const size_t& cols)
+        {
+            if (rows < 1 || cols < 1)
+            {
+                throw std::invalid_argument("Cols/Rows of a matrix must be above 0");
+            }
+
+            m_rows = rows;
+            m_cols = cols;
+            m_data = static_cast<T*>(device_allocate(m_rows * m_cols * sizeof(T)));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, uploads a host matrix
+        ///
+        /// @param mat matrix to copy to the device
+        /// @param async return once the copy is queued, see device_upload
+        explicit Device_Matrix(const Matrix<T>& mat, const bool& async = false)
+            : Device_Matrix(mat.getRowCount(), mat.getColCount())
+        {
+            upload(mat, async);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copy constructor, copies on the device
+        ///
+        /// @param mat matrix to copy
+        Device_Matrix(const Device_Matrix& mat) : Device_Matrix(mat.m_rows, mat.m_cols)
+        {
+            device_copy(m_data, mat.m_data, m_rows * m_cols * sizeof(T));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Move constructor, takes ownership of the other matrix's device memory
+        ///
+        /// @note moved from matrix is left empty (0x0) and must only be destroyed or assigned to
+        ///
+        /// @param mat matrix to move from
+        Device_Matrix(Device_Matrix&& mat) noexcept
+            : m_data(mat.m_data), m_rows(mat.m_rows), m_cols(mat.m_cols)
+        {
+            mat.m_data = nullptr;
+            mat.m_rows = 0;
+            mat.m_cols = 0;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Destructor
+        ~Device_Matrix()
+        {
+            device_release(m_data);
+        };
+
+        /// @brief Assignment operator, copies on the device
+        /// @param mat matrix being assigned from
+        /// @return reference to assigned matrix
+        Device_Matrix& operator=(const Device_Matrix& mat)
+        {
+            if (this != &mat)
+            {
+                Device_Matrix copy(mat);
+                *this = std::move(copy);
+            }
+            return *this;
+        };
+
+        /// @brief Move assignment operator
+        /// @param mat matrix being moved from
+        /// @return reference to assigned matrix
+        Device_Matrix& operator=(Device_Matrix&& mat) noexcept
+        {
+            std::swap(m_data, mat.m_data);
+            std::swap(m_rows, mat.m_rows);
+            std::swap(m_cols, mat.m_cols);
+            return *this;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows
+        size_t getRowCount() const
+        {
+            return m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns
+        size_t getColCount() const
+        {
+            return m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the device pointer, only usable by the device_* calls
+        ///
+        /// @return first element on the device
+        T* get_data() const
+        {
+            return m_data;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies a host matrix of the same dimensions onto the device
+        ///
+        /// @param mat matrix to copy from
+        /// @param async return once the copy is queued, mat must then stay unchanged until synchronize()
+        ///
+        /// @throws std::invalid_argument if dimensions differ
+        void upload(const Matrix<T>& mat, const bool& async = false)
+        {
+            _check_dims(mat.getRowCount(), mat.getColCount());
+            device_upload(m_data, mat.get_data(), m_rows * m_cols * sizeof(T), async);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the matrix into a host matrix of the same dimensions
+        ///
+        /// @param mat matrix to copy into
+        /// @param async return once the copy is queued, mat must then not be read until synchronize()
+        ///
+        /// @throws std::invalid_argument if dimensions differ
+        void download(Matrix<T>& mat, const bool& async = false) const
+        {
+            _check_dims(mat.getRowCount(), mat.getColCount());
+            device_download(mat.get_data(), m_data, m_rows * m_cols * sizeof(T), async);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the matrix back to the host
+        ///
+        /// @return host matrix
+        Matrix<T> toMatrix() const
+        {
+            Matrix<T> outMat(m_rows, m_cols);
+            download(outMat);
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Waits for the calling thread's queued transfers and kernels
+        void synchronize() const
+        {
+            device_synchronize();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, matrix cross product on the device
+        ///
+        /// @param mat rval matrix
+        ///
+        /// @return product, on the device
+        ///
+        /// @throws std::invalid_argument if the inner dimensions differ
+        Device_Matrix operator%(const Device_Matrix& mat) const
+        {
+            if (m_cols != mat.m_rows)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            Device_Matrix outMat(m_rows, mat.m_cols);
+            device_gemm(m_rows, mat.m_cols, m_cols, m_data, mat.m_data, outMat.m_data);
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of +, elementwise on the device
+        ///
+        /// @param mat rval matrix
+        ///
+        /// @return sum, on the device
+        ///
+        /// @throws std::invalid_argument if dimensions differ
+        Device_Matrix operator+(const Device_Matrix& mat) const
+        {
+            if (mat.m_rows != m_rows || mat.m_cols != m_cols)
+            {
+                throw std::invalid_argument("Matrix addition requires matricies of same dimensions");
+            }
+            return _axpby((T) 1, mat, (T) 1);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of -, elementwise on the device
+        ///
+        /// @param mat rval matrix
+        ///
+        /// @return difference, on the device
+        ///
+        /// @throws std::invalid_argument if dimensions differ
+        Device_Matrix operator-(const Device_Matrix& mat) const
+        {
+            if (mat.m_rows != m_rows || mat.m_cols != m_cols)
+            {
+                throw std::invalid_argument("Matrix subtraction requires matricies of same dimensions");
+            }
+            return _axpby((T) 1, mat, (T) -1);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of *, scales every element on the device
+        ///
+        /// @param val scale factor
+        ///
+        /// @return scaled matrix, on the device
+        Device_Matrix operator*(const T& val) const
+        {
+            return _axpby(val, *this, (T) 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the inverse with partial pivoting LU on the device
+        ///
+        /// @return the inverse matrix, on the device
+        ///
+        /// @throws std::invalid_argument if matrix is not square or is singular
+        Device_Matrix inverse() const
+        {
+            _check_square("Matrix must be square to have an inverse");
+
+            Device_Matrix factor(*this);
+            Device_Matrix outMat(m_rows, m_cols);
+            if (!device_inverse(m_rows, factor.m_data, outMat.m_data))
+            {
+                throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant with partial pivoting LU on the device
+        ///
+        /// @return value of the determinant
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        T determinant() const
+        {
+            _check_square("Matrix must be square to have a determinant");
+
+            Device_Matrix factor(*this);
+            return device_determinant(m_rows, factor.m_data);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the eigenvalues of a symmetric matrix, only the lower triangle is read
+        ///
+        /// @return eigenvalues in ascending order
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        std::vector<T> eigenvalues_symmetric() const
+        {
+            _check_square("Matrix must be square to find eigenvalues");
+
+            Device_Matrix work(*this);
+            std::vector<T> values(m_rows);
+            device_eigenvalues_symmetric(m_rows, work.m_data, values.data());
+            return values;
+        };
+
+    private:
+        /// @brief device memory, row major
+        T* m_data = nullptr;
+
+        /// @brief the number of rows in the matrix
+        size_t m_rows = 0;
+
+        /// @brief the number of columns in the matrix
+        size_t m_cols = 0;
+
+        ///--------------------------------------------------------
+        /// @brief alpha * this + beta * mat into a new matrix, dimensions already checked
+        Device_Matrix _axpby(const T& alpha, const Device_Matrix& mat, const T& beta) const
+        {
+            Device_Matrix outMat(m_rows, m_cols);
+            device_axpby(m_rows * m_cols, alpha, m_data, beta, mat.m_data, outMat.m_data);
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @throws std::invalid_argument if the dimensions differ from this matrix
+        void _check_dims(const size_t& rows, const size_t& cols) const
+        {
+            if (rows != m_rows || cols != m_cols)
+            {
+                throw std::invalid_argument("Device transfer requires matricies of same dimensions");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @throws std::invalid_argument with err if the matrix is not square
+        void _check_square(const char* err) const
+        {
+            if (m_rows != m_cols)
+            {
+                throw std::invalid_argument(err);
+            }
+        };
+};
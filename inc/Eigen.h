@@ -0,0 +1,1206 @@
+/// ------------------------------------------
+/// @file Eigen.h
+///
+/// @brief Header/Source file for the eigenvalue solver used by Matrix<T>::eigenvalues
+///
+/// The matrix is reduced once by Householder similarity transforms, then iterated
+/// on the reduced form so each sweep is O(n^2) rather than a full QR decomposition:
+/// - real symmetric input: tridiagonal form, implicit QL with Wilkinson shifts
+/// - real general input: upper Hessenberg form, Francis double shift implicit QR,
+///   which also finds complex conjugate pairs
+/// - complex input: upper Hessenberg form, single shift QR with Wilkinson shifts
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "Matrix.h"
+#include "Scalar.h"
+#include "Reduce.h"
+#include "Complex_C.h"
+#include "Thread_Pool.h"
+#include "Profile.h"
+
+/// Max inverse iteration steps per eigenvector, each step is one O(n^2) Hessenberg solve
+#ifndef EIGEN_INVERSE_ITER
+#define EIGEN_INVERSE_ITER 4
+#endif
+
+/// @brief Templated class for reducing a square matrix and finding its eigenvalues
+template <typename T>
+class Eigen_Solver
+{
+    public:
+        /// @brief arithmetic type the solver works in, complex types work in cartesian form
+        /// and integer types in double
+        typedef std::conditional_t<scalar_is_complex_v<T>, Complex_C_t,
+                std::conditional_t<std::is_floating_point_v<T>, T, double>> Work_t;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, reduces the matrix and solves for its eigenvalues
+        ///
+        /// @param mat square matrix to solve
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Eigen_Solver(const Matrix<T>& mat) : m_n(mat.getRowCount())
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to have eigenvalues");
+            }
+
+            Profile_Scope_t profile(Profile_Op_t::EIGEN, 0, (m_n * m_n + m_n) * sizeof(Work_t));
+
+            m_reduced.resize(m_n * m_n);
+            for (size_t i = 0; i < m_n * m_n; i++)
+            {
+                if constexpr (scalar_is_complex_v<T>)
+                {
+                    m_reduced[i] = Complex_C_t{scalar_real(mat.get_data()[i]), scalar_imag(mat.get_data()[i])};
+                }
+                else
+                {
+                    m_reduced[i] = (Work_t) mat.get_data()[i];
+                }
+            }
+
+            m_tau.assign(m_n, (Work_t) 0);
+            m_result.m_values.assign(m_n, Complex_C_t{});
+            m_result.m_iterations.assign(m_n, 0);
+
+            if constexpr (!scalar_is_complex_v<T>)
+            {
+                if (_is_symmetric())
+                {
+                    m_result.m_symmetric = true;
+                    _reduce_tridiagonal();
+                    m_eps3 = _eps3();
+                    _tridiagonal_ql();
+
+                    // the iterations are O(n) each on the tridiagonal, only the reduction is counted
+                    profile.addFlops(4.0 * m_n * m_n * m_n / 3);
+                    profile.addIterations(m_result.m_total_iterations);
+                    profile.setFailed(!m_result.m_converged);
+                    return;
+                }
+            }
+
+            _reduce_hessenberg();
+            m_eps3 = _eps3();
+
+            if constexpr (scalar_is_complex_v<T>)
+            {
+                _complex_hessenberg_qr();
+            }
+            else
+            {
+                _francis_qr();
+            }
+
+            profile.addFlops(10.0 * m_n * m_n * m_n / 3);
+            profile.addIterations(m_result.m_total_iterations);
+            profile.setFailed(!m_result.m_converged);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the results of the solve
+        ///
+        /// @return eigenvalues, iteration counts and convergence status
+        const Eigen_Result_t& result() const
+        {
+            return m_result;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the reduced (Hessenberg or tridiagonal) form, row major
+        /// H = Q^H A Q, only elements on or above the sub-diagonal are meaningful
+        ///
+        /// @return reduced matrix storage
+        const std::vector<Work_t>& reduced() const
+        {
+            return m_reduced;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the side length of the solved matrix
+        ///
+        /// @return side length
+        size_t size() const
+        {
+            return m_n;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the eigenvector of one eigenvalue by shifted inverse iteration
+        /// on the reduced form, then maps it back through Q
+        ///
+        /// @param idx index of the eigenvalue in result().m_values
+        /// @param out output buffer of size() elements, receives the unit 2-norm eigenvector
+        /// with its largest component made real
+        ///
+        /// @note repeated eigenvalues of symmetric input are only kept orthogonal by eigenvectors()
+        void eigenvector(const size_t& idx, Complex_C_t* out) const
+        {
+            std::vector<Complex_C_t> lu(m_n * m_n);
+            std::vector<bool> swapped(m_n);
+            _inverse_iterate(_shift(idx), idx, {}, lu.data(), swapped, out);
+            apply_Q(out);
+            _normalize(out);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates all eigenvectors, packed as the columns of a matrix
+        /// Column j belongs to result().m_values[j]. For real types a complex conjugate
+        /// pair at j, j+1 is stored as the real part in column j and the imaginary part in
+        /// column j+1 (the eigenvector of value j+1 is their conjugate)
+        ///
+        /// @return matrix of eigenvectors
+        Matrix<T> eigenvectors() const
+        {
+            Matrix<T> outMat(m_n, m_n);
+            T* out = outMat.get_data();
+
+            // symmetric input has orthogonal eigenvectors, vectors of clustered values are
+            // orthogonalized against each other in the reduced form (as LAPACK xSTEIN)
+            const double clusterTol = 1e-3 * m_eps3 / std::numeric_limits<double>::epsilon();
+            bool clustered = false;
+            if (m_result.m_symmetric)
+            {
+                for (size_t j = 0; j < m_n && !clustered; j++)
+                {
+                    for (size_t i = 0; i < j; i++)
+                    {
+                        if ((m_result.m_values[i] - m_result.m_values[j]).absolute() < clusterTol)
+                        {
+                            clustered = true;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (!clustered)
+            {
+                // every vector is independent, so they are shared out across the pool
+                parallel_for(0, m_n, parallel_grain(4 * m_n * m_n), [&](size_t from, size_t to)
+                {
+                    std::vector<Complex_C_t> lu(m_n * m_n);
+                    std::vector<bool> swapped(m_n);
+                    std::vector<Complex_C_t> x(m_n);
+
+                    for (size_t j = from; j < to; j++)
+                    {
+                        // the conjugate half of a real pair is stored by the first half
+                        if (!scalar_is_complex_v<T> && m_result.m_values[j].m_imagine < 0)
+                        {
+                            continue;
+                        }
+
+                        _inverse_iterate(_shift(j), j, {}, lu.data(), swapped, x.data());
+                        apply_Q(x.data());
+                        _normalize(x.data());
+                        _store_column(j, x.data(), out);
+                    }
+                });
+
+                return outMat;
+            }
+
+            // clusters depend on the vectors found before them, so these run in order
+            std::vector<Complex_C_t> lu(m_n * m_n);
+            std::vector<bool> swapped(m_n);
+            std::vector<Complex_C_t> x(m_n);
+            std::vector<Complex_C_t> reducedVecs(m_n * m_n);
+            std::vector<const Complex_C_t*> cluster;
+
+            for (size_t j = 0; j < m_n; j++)
+            {
+                cluster.clear();
+                for (size_t i = 0; i < j; i++)
+                {
+                    if ((m_result.m_values[i] - m_result.m_values[j]).absolute() < clusterTol)
+                    {
+                        cluster.push_back(reducedVecs.data() + i * m_n);
+                    }
+                }
+
+                _inverse_iterate(_shift(j), j, cluster, lu.data(), swapped, x.data());
+                _normalize(x.data());
+                std::copy(x.begin(), x.end(), reducedVecs.begin() + j * m_n);
+
+                apply_Q(x.data());
+                _normalize(x.data());
+                _store_column(j, x.data(), out);
+            }
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies the reduction's Q to a vector in place, x := Q x
+        /// Maps eigenvectors of the reduced form back to eigenvectors of the input
+        ///
+        /// @param x vector of length size(), of type U (Work_t or a complex widening of it)
+        template <typename U>
+        void apply_Q(U* x) const
+        {
+            // Q = H_0 H_1 ... H_n-3, so the last reflector is applied first
+            for (size_t k = m_n < 3 ? 0 : m_n - 2; k-- > 0;)
+            {
+                const Work_t tau = m_tau[k];
+                if (tau == (Work_t) 0)
+                {
+                    continue;
+                }
+
+                // v = (1, a[k+2:, k]), x[k+1:] -= tau v (v^H x[k+1:])
+                U dot = x[k + 1];
+                for (size_t i = k + 2; i < m_n; i++)
+                {
+                    dot += (U) scalar_conj(m_reduced[i * m_n + k]) * x[i];
+                }
+
+                dot = dot * (U) tau;
+                x[k + 1] -= dot;
+                for (size_t i = k + 2; i < m_n; i++)
+                {
+                    x[i] -= (U) m_reduced[i * m_n + k] * dot;
+                }
+            }
+        };
+
+    private:
+        /// @brief side length
+        size_t m_n;
+
+        /// @brief reduced form on and above the sub-diagonal, reflectors below it
+        std::vector<Work_t> m_reduced;
+
+        /// @brief reflector scale factors, H_k = I - tau_k v_k v_k^H
+        std::vector<Work_t> m_tau;
+
+        /// @brief solve results
+        Eigen_Result_t m_result;
+
+        /// @brief inverse iteration perturbation, see _eps3
+        double m_eps3 = 0;
+
+        ///--------------------------------------------------------
+        /// @brief Magnitude of a working value, for convergence tests
+        static double _abs(const Work_t& val)
+        {
+            return scalar_abs(val);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Writes an eigenvector into column j of the output, real types split a
+        /// complex pair (positive imaginary value first) over columns j and j+1
+        ///
+        /// @param j column of the eigenvalue
+        /// @param x eigenvector, size() elements
+        /// @param out row major output storage, size() x size()
+        void _store_column(const size_t& j, const Complex_C_t* x, T* out) const
+        {
+            const bool pair = !scalar_is_complex_v<T> && j + 1 < m_n && m_result.m_values[j].m_imagine > 0;
+            for (size_t i = 0; i < m_n; i++)
+            {
+                if constexpr (scalar_is_complex_v<T>)
+                {
+                    out[i * m_n + j] = scalar_from_complex<T>(x[i]);
+                }
+                else
+                {
+                    out[i * m_n + j] = (T) x[i].m_real;
+                    if (pair)
+                    {
+                        out[i * m_n + j + 1] = (T) x[i].m_imagine;
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Perturbation used to keep inverse iteration away from exact singularity
+        ///
+        /// @return machine epsilon scaled by the 1-norm of the reduced form
+        double _eps3() const
+        {
+            double norm = 0;
+            for (size_t j = 0; j < m_n; j++)
+            {
+                double colSum = 0;
+                for (size_t i = 0; i < std::min(m_n, j + 2); i++)
+                {
+                    colSum += _abs(m_reduced[i * m_n + j]);
+                }
+                norm = std::max(norm, colSum);
+            }
+
+            if (norm == 0)
+            {
+                norm = 1;
+            }
+
+            return norm * std::numeric_limits<double>::epsilon();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Finds the inverse iteration shift for an eigenvalue, values equal to an
+        /// earlier one (to eps3) are nudged apart so repeated values get independent vectors
+        ///
+        /// @param idx index of the eigenvalue
+        ///
+        /// @return shift to use
+        Complex_C_t _shift(const size_t& idx) const
+        {
+            const double eps3 = m_eps3;
+            Complex_C_t shift = m_result.m_values[idx];
+
+            for (size_t i = 0; i < idx; i++)
+            {
+                if ((m_result.m_values[i] - shift).absolute() < eps3)
+                {
+                    shift += eps3;
+                    i = (size_t) -1;
+                }
+            }
+
+            return shift;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Shifted inverse iteration on the reduced form, solves (H - shift I) x = b
+        /// with a Hessenberg LU (O(n^2)), at least two solves are made and then repeated
+        /// until x has grown enough
+        ///
+        /// @param shift eigenvalue estimate
+        /// @param seed selects the starting vector, so nearby shifts do not start identically
+        /// @param ortho unit vectors (reduced form) to keep x orthogonal to, may be empty
+        /// @param lu scratch buffer of size()^2 elements, overwritten with the factorization
+        /// @param swapped scratch flags of size() elements, row interchanges of the factorization
+        /// @param x output buffer of size() elements, eigenvector of the reduced form
+        void _inverse_iterate(const Complex_C_t& shift, const size_t& seed, const std::vector<const Complex_C_t*>& ortho,
+                              Complex_C_t* lu, std::vector<bool>& swapped, Complex_C_t* x) const
+        {
+            const size_t n = m_n;
+            const double eps3 = m_eps3;
+
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    Complex_C_t val{};
+                    if (j + 1 >= i)
+                    {
+                        val = (Complex_C_t) m_reduced[i * n + j];
+                    }
+                    if (i == j)
+                    {
+                        val -= shift;
+                    }
+                    lu[i * n + j] = val;
+                }
+            }
+
+            // Hessenberg LU, only rows k and k+1 compete for each pivot
+            for (size_t k = 0; k + 1 < n; k++)
+            {
+                Complex_C_t* rowK = lu + k * n;
+                Complex_C_t* rowNext = lu + (k + 1) * n;
+
+                swapped[k] = rowNext[k].absolute() > rowK[k].absolute();
+                if (swapped[k])
+                {
+                    std::swap_ranges(rowK + k, rowK + n, rowNext + k);
+                }
+
+                if (rowK[k].absolute() == 0)
+                {
+                    rowK[k] = eps3;
+                }
+
+                const Complex_C_t factor = rowNext[k] / rowK[k];
+                rowNext[k] = factor;
+                for (size_t j = k + 1; j < n; j++)
+                {
+                    rowNext[j] -= factor * rowK[j];
+                }
+            }
+
+            if (lu[n * n - 1].absolute() == 0)
+            {
+                lu[n * n - 1] = eps3;
+            }
+
+            // growth at which x is accepted, b is rescaled to eps3 so this is relative to it
+            const double growTo = 0.1 / std::sqrt((double) n);
+
+            // pseudo random start in [0.5, 1) eps3, fixed per seed so results are repeatable
+            unsigned long state = 2654435761ul * (seed + 1);
+            for (size_t i = 0; i < n; i++)
+            {
+                state = state * 6364136223846793005ul + 1442695040888963407ul;
+                x[i] = eps3 * (0.5 + 0.5 * (double) (state >> 11) / (double) (1ul << 53));
+            }
+
+            for (size_t iter = 0; iter < EIGEN_INVERSE_ITER; iter++)
+            {
+                for (size_t k = 0; k + 1 < n; k++)
+                {
+                    if (swapped[k])
+                    {
+                        std::swap(x[k], x[k + 1]);
+                    }
+                    x[k + 1] -= lu[(k + 1) * n + k] * x[k];
+                }
+
+                for (size_t i = n; i-- > 0;)
+                {
+                    Complex_C_t sum = x[i];
+                    for (size_t j = i + 1; j < n; j++)
+                    {
+                        sum -= lu[i * n + j] * x[j];
+                    }
+                    x[i] = sum / lu[i * n + i];
+                }
+
+                for (const Complex_C_t* v : ortho)
+                {
+                    Complex_C_t dot{};
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        dot += v[i].conjugate() * x[i];
+                    }
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        x[i] -= dot * v[i];
+                    }
+                }
+
+                double xNorm = 0;
+                for (size_t i = 0; i < n; i++)
+                {
+                    xNorm += x[i].absolute();
+                }
+
+                const Complex_C_t scale = eps3 / xNorm;
+                for (size_t i = 0; i < n; i++)
+                {
+                    x[i] *= scale;
+                }
+
+                if (iter > 0 && xNorm >= growTo)
+                {
+                    break;
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Scales a vector to unit 2-norm with its largest component real and positive
+        ///
+        /// @param x vector of size() elements
+        void _normalize(Complex_C_t* x) const
+        {
+            double norm = 0;
+            size_t largest = 0;
+            for (size_t i = 0; i < m_n; i++)
+            {
+                const double mag = x[i].absolute();
+                norm += mag * mag;
+                if (mag > x[largest].absolute())
+                {
+                    largest = i;
+                }
+            }
+
+            if (norm == 0)
+            {
+                return;
+            }
+
+            const Complex_C_t scale = x[largest].conjugate() / (x[largest].absolute() * std::sqrt(norm));
+            for (size_t i = 0; i < m_n; i++)
+            {
+                x[i] *= scale;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Checks the (real) input for symmetry, relative to QR_CONVERGENCE_LIMIT
+        ///
+        /// @return is the matrix symmetric?
+        bool _is_symmetric() const
+        {
+            double maxAbs = 0;
+            for (size_t i = 0; i < m_n * m_n; i++)
+            {
+                maxAbs = std::max(maxAbs, _abs(m_reduced[i]));
+            }
+
+            const double tol = QR_CONVERGENCE_LIMIT * maxAbs;
+            for (size_t i = 0; i < m_n; i++)
+            {
+                for (size_t j = i + 1; j < m_n; j++)
+                {
+                    if (_abs(m_reduced[i * m_n + j] - m_reduced[j * m_n + i]) > tol)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Generates a reflector for column k below the diagonal, (follows LAPACK xLARFG)
+        /// Leaves beta in a[k+1][k], v[1:] in a[k+2:][k] and returns tau
+        ///
+        /// @param k column to reduce
+        ///
+        /// @return tau of the reflector
+        Work_t _make_reflector(const size_t& k)
+        {
+            Work_t* a = m_reduced.data();
+            const Work_t alpha = a[(k + 1) * m_n + k];
+
+            double xnorm = 0;
+            for (size_t i = k + 2; i < m_n; i++)
+            {
+                const double v = _abs(a[i * m_n + k]);
+                xnorm += v * v;
+            }
+
+            if (xnorm == 0 && scalar_imag(alpha) == 0)
+            {
+                return (Work_t) 0;
+            }
+
+            const double alphaAbs = _abs(alpha);
+            double beta = std::sqrt(alphaAbs * alphaAbs + xnorm);
+            if (scalar_real(alpha) >= 0)
+            {
+                beta = -beta;
+            }
+
+            const Work_t tau = ((Work_t) beta - alpha) / (Work_t) beta;
+            const Work_t scale = (Work_t) 1 / (alpha - (Work_t) beta);
+            for (size_t i = k + 2; i < m_n; i++)
+            {
+                a[i * m_n + k] = a[i * m_n + k] * scale;
+            }
+            a[(k + 1) * m_n + k] = (Work_t) beta;
+
+            return tau;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Reduces to upper Hessenberg form, H = Q^H A Q
+        void _reduce_hessenberg()
+        {
+            Work_t* a = m_reduced.data();
+            std::vector<Work_t> v(m_n);
+            std::vector<Work_t> w(m_n);
+
+            for (size_t k = 0; k + 2 < m_n; k++)
+            {
+                const Work_t tau = _make_reflector(k);
+                m_tau[k] = tau;
+                if (tau == (Work_t) 0)
+                {
+                    continue;
+                }
+
+                const size_t len = m_n - k - 1;
+                v[0] = (Work_t) 1;
+                for (size_t i = 1; i < len; i++)
+                {
+                    v[i] = a[(k + 1 + i) * m_n + k];
+                }
+
+                // left: rows k+1.., columns k+1.. get H^H (column k is already reduced)
+                const Work_t tauConj = scalar_conj(tau);
+                for (size_t j = k + 1; j < m_n; j++)
+                {
+                    w[j] = (Work_t) 0;
+                }
+                for (size_t i = 0; i < len; i++)
+                {
+                    const Work_t vi = scalar_conj(v[i]);
+                    const Work_t* row = a + (k + 1 + i) * m_n;
+                    for (size_t j = k + 1; j < m_n; j++)
+                    {
+                        w[j] += vi * row[j];
+                    }
+                }
+                for (size_t i = 0; i < len; i++)
+                {
+                    const Work_t factor = tauConj * v[i];
+                    Work_t* row = a + (k + 1 + i) * m_n;
+                    for (size_t j = k + 1; j < m_n; j++)
+                    {
+                        row[j] -= factor * w[j];
+                    }
+                }
+
+                // right: all rows, columns k+1.. get H
+                for (size_t i = 0; i < m_n; i++)
+                {
+                    Work_t* row = a + i * m_n + k + 1;
+                    Work_t dot = 0;
+                    for (size_t j = 0; j < len; j++)
+                    {
+                        dot += row[j] * v[j];
+                    }
+                    dot = dot * tau;
+                    for (size_t j = 0; j < len; j++)
+                    {
+                        row[j] -= dot * scalar_conj(v[j]);
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Reduces a real symmetric matrix to tridiagonal form, T = Q^T A Q
+        /// Uses the symmetric rank 2 update so only the trailing block is touched per step
+        void _reduce_tridiagonal()
+        {
+            Work_t* a = m_reduced.data();
+            std::vector<Work_t> v(m_n);
+            std::vector<Work_t> p(m_n);
+
+            for (size_t k = 0; k + 2 < m_n; k++)
+            {
+                const Work_t tau = _make_reflector(k);
+                m_tau[k] = tau;
+
+                // keep the stored form symmetric above the diagonal too
+                a[k * m_n + k + 1] = a[(k + 1) * m_n + k];
+                for (size_t j = k + 2; j < m_n; j++)
+                {
+                    a[k * m_n + j] = 0;
+                }
+
+                if (tau == (Work_t) 0)
+                {
+                    continue;
+                }
+
+                const size_t off = k + 1;
+                const size_t len = m_n - off;
+                v[0] = 1;
+                for (size_t i = 1; i < len; i++)
+                {
+                    v[i] = a[(off + i) * m_n + k];
+                }
+
+                // p = tau A22 v, w = p - (tau/2)(p.v) v, A22 -= v w^T + w v^T
+                Work_t pv = 0;
+                for (size_t i = 0; i < len; i++)
+                {
+                    const Work_t* row = a + (off + i) * m_n + off;
+                    Work_t sum = 0;
+                    for (size_t j = 0; j < len; j++)
+                    {
+                        sum += row[j] * v[j];
+                    }
+                    p[i] = tau * sum;
+                    pv += p[i] * v[i];
+                }
+
+                const Work_t alpha = -(Work_t) 0.5 * tau * pv;
+                for (size_t i = 0; i < len; i++)
+                {
+                    p[i] += alpha * v[i];
+                }
+
+                for (size_t i = 0; i < len; i++)
+                {
+                    Work_t* row = a + (off + i) * m_n + off;
+                    for (size_t j = 0; j < len; j++)
+                    {
+                        row[j] -= v[i] * p[j] + p[i] * v[j];
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the clean upper Hessenberg part of the reduced form
+        ///
+        /// @return H, zero below the sub-diagonal
+        std::vector<Work_t> _hessenberg_copy() const
+        {
+            std::vector<Work_t> h(m_n * m_n, (Work_t) 0);
+            for (size_t i = 0; i < m_n; i++)
+            {
+                for (size_t j = (i == 0 ? 0 : i - 1); j < m_n; j++)
+                {
+                    h[i * m_n + j] = m_reduced[i * m_n + j];
+                }
+            }
+            return h;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Implicit QL on the tridiagonal form (follows EISPACK tql1)
+        void _tridiagonal_ql()
+        {
+            const Work_t eps = std::numeric_limits<Work_t>::epsilon();
+            std::vector<Work_t> d(m_n);
+            std::vector<Work_t> e(m_n, 0);
+
+            for (size_t i = 0; i < m_n; i++)
+            {
+                d[i] = m_reduced[i * m_n + i];
+                if (i + 1 < m_n)
+                {
+                    e[i] = m_reduced[(i + 1) * m_n + i];
+                }
+            }
+
+            for (size_t l = 0; l < m_n; l++)
+            {
+                size_t iter = 0;
+                size_t m;
+                do
+                {
+                    // look for a small off diagonal element to split at
+                    for (m = l; m + 1 < m_n; m++)
+                    {
+                        const Work_t dd = std::abs(d[m]) + std::abs(d[m + 1]);
+                        if (std::abs(e[m]) <= eps * dd)
+                        {
+                            break;
+                        }
+                    }
+
+                    if (m == l)
+                    {
+                        break;
+                    }
+
+                    if (iter++ == MAX_QR_EIGEN_ITER)
+                    {
+                        m_result.m_converged = false;
+                        break;
+                    }
+                    m_result.m_total_iterations++;
+
+                    // Wilkinson shift from the leading 2x2
+                    Work_t g = (d[l + 1] - d[l]) / (2 * e[l]);
+                    Work_t r = std::hypot(g, (Work_t) 1);
+                    g = d[m] - d[l] + e[l] / (g + (g >= 0 ? r : -r));
+
+                    Work_t s = 1;
+                    Work_t c = 1;
+                    Work_t p = 0;
+                    bool underflow = false;
+
+                    // chase the bulge up from m to l with plane rotations
+                    for (size_t i = m; i-- > l;)
+                    {
+                        const Work_t f = s * e[i];
+                        const Work_t b = c * e[i];
+                        r = std::hypot(f, g);
+                        e[i + 1] = r;
+                        if (r == 0)
+                        {
+                            d[i + 1] -= p;
+                            e[m] = 0;
+                            underflow = true;
+                            break;
+                        }
+
+                        s = f / r;
+                        c = g / r;
+                        g = d[i + 1] - p;
+                        r = (d[i] - g) * s + 2 * c * b;
+                        p = s * r;
+                        d[i + 1] = g + p;
+                        g = c * r - b;
+                    }
+
+                    if (underflow)
+                    {
+                        continue;
+                    }
+
+                    d[l] -= p;
+                    e[l] = g;
+                    e[m] = 0;
+                }
+                while (m != l);
+
+                m_result.m_iterations[l] = iter;
+            }
+
+            for (size_t i = 0; i < m_n; i++)
+            {
+                m_result.m_values[i] = Complex_C_t{(double) d[i], 0};
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Francis double shift implicit QR on the real Hessenberg form (follows EISPACK hqr)
+        void _francis_qr()
+        {
+            std::vector<Work_t> hv = _hessenberg_copy();
+            Work_t* H = hv.data();
+            const size_t nn = m_n;
+            auto h = [&](const size_t& i, const size_t& j) -> Work_t& { return H[i * nn + j]; };
+
+            const Work_t eps = std::numeric_limits<Work_t>::epsilon();
+            Work_t exshift = 0;
+            Work_t p = 0, q = 0, r = 0, s = 0, z = 0, w, x, y;
+
+            // the copy is zero below the subdiagonal, so the whole array sums the Hessenberg part
+            const Work_t norm = (Work_t) reduce_asum(nn * nn, H);
+
+            // n is signed here as the active block shrinks past 0
+            long n = (long) nn - 1;
+            size_t iter = 0;
+
+            while (n >= 0)
+            {
+                // look for a single small sub-diagonal element
+                long l = n;
+                while (l > 0)
+                {
+                    s = std::abs(h(l - 1, l - 1)) + std::abs(h(l, l));
+                    if (s == 0)
+                    {
+                        s = norm;
+                    }
+                    if (std::abs(h(l, l - 1)) < eps * s)
+                    {
+                        break;
+                    }
+                    l--;
+                }
+
+                if (l == n)
+                {
+                    // one root found
+                    m_result.m_values[n] = Complex_C_t{(double) (h(n, n) + exshift), 0};
+                    m_result.m_iterations[n] = iter;
+                    n--;
+                    iter = 0;
+                    continue;
+                }
+
+                if (l == n - 1)
+                {
+                    // two roots found, real pair or complex conjugates
+                    w = h(n, n - 1) * h(n - 1, n);
+                    p = (h(n - 1, n - 1) - h(n, n)) / 2;
+                    q = p * p + w;
+                    z = std::sqrt(std::abs(q));
+                    x = h(n, n) + exshift;
+
+                    if (q >= 0)
+                    {
+                        z = (p >= 0) ? p + z : p - z;
+                        m_result.m_values[n - 1] = Complex_C_t{(double) (x + z), 0};
+                        m_result.m_values[n] = m_result.m_values[n - 1];
+                        if (z != 0)
+                        {
+                            m_result.m_values[n] = Complex_C_t{(double) (x - w / z), 0};
+                        }
+                    }
+                    else
+                    {
+                        m_result.m_values[n - 1] = Complex_C_t{(double) (x + p), (double) z};
+                        m_result.m_values[n] = Complex_C_t{(double) (x + p), (double) -z};
+                    }
+
+                    m_result.m_iterations[n - 1] = iter;
+                    m_result.m_iterations[n] = iter;
+                    n -= 2;
+                    iter = 0;
+                    continue;
+                }
+
+                if (iter == MAX_QR_EIGEN_ITER)
+                {
+                    // give up, report the remaining diagonal as is
+                    m_result.m_converged = false;
+                    for (long i = 0; i <= n; i++)
+                    {
+                        m_result.m_values[i] = Complex_C_t{(double) (h(i, i) + exshift), 0};
+                        m_result.m_iterations[i] = iter;
+                    }
+                    break;
+                }
+
+                // form shift
+                x = h(n, n);
+                y = h(n - 1, n - 1);
+                w = h(n, n - 1) * h(n - 1, n);
+
+                // exceptional shifts to break cycles
+                if (iter == 10 || (iter > 10 && iter % 30 == 0))
+                {
+                    exshift += x;
+                    for (long i = 0; i <= n; i++)
+                    {
+                        h(i, i) -= x;
+                    }
+                    s = std::abs(h(n, n - 1)) + std::abs(h(n - 1, n - 2));
+                    x = y = (Work_t) 0.75 * s;
+                    w = (Work_t) -0.4375 * s * s;
+                }
+
+                iter++;
+                m_result.m_total_iterations++;
+
+                // look for two consecutive small sub-diagonal elements
+                long m = n - 2;
+                while (m >= l)
+                {
+                    z = h(m, m);
+                    r = x - z;
+                    s = y - z;
+                    p = (r * s - w) / h(m + 1, m) + h(m, m + 1);
+                    q = h(m + 1, m + 1) - z - r - s;
+                    r = h(m + 2, m + 1);
+                    s = std::abs(p) + std::abs(q) + std::abs(r);
+                    p /= s;
+                    q /= s;
+                    r /= s;
+                    if (m == l)
+                    {
+                        break;
+                    }
+                    if (std::abs(h(m, m - 1)) * (std::abs(q) + std::abs(r)) <
+                        eps * (std::abs(p) * (std::abs(h(m - 1, m - 1)) + std::abs(z) + std::abs(h(m + 1, m + 1)))))
+                    {
+                        break;
+                    }
+                    m--;
+                }
+
+                for (long i = m + 2; i <= n; i++)
+                {
+                    h(i, i - 2) = 0;
+                    if (i > m + 2)
+                    {
+                        h(i, i - 3) = 0;
+                    }
+                }
+
+                // double QR step on rows l..n and columns m..n
+                for (long k = m; k <= n - 1; k++)
+                {
+                    const bool notlast = (k != n - 1);
+                    if (k != m)
+                    {
+                        p = h(k, k - 1);
+                        q = h(k + 1, k - 1);
+                        r = notlast ? h(k + 2, k - 1) : 0;
+                        x = std::abs(p) + std::abs(q) + std::abs(r);
+                        if (x == 0)
+                        {
+                            continue;
+                        }
+                        p /= x;
+                        q /= x;
+                        r /= x;
+                    }
+
+                    s = std::sqrt(p * p + q * q + r * r);
+                    if (p < 0)
+                    {
+                        s = -s;
+                    }
+                    if (s == 0)
+                    {
+                        continue;
+                    }
+
+                    if (k != m)
+                    {
+                        h(k, k - 1) = -s * x;
+                    }
+                    else if (l != m)
+                    {
+                        h(k, k - 1) = -h(k, k - 1);
+                    }
+
+                    p = p + s;
+                    x = p / s;
+                    y = q / s;
+                    z = r / s;
+                    q = q / p;
+                    r = r / p;
+
+                    // row modification
+                    for (long j = k; j <= n; j++)
+                    {
+                        p = h(k, j) + q * h(k + 1, j);
+                        if (notlast)
+                        {
+                            p = p + r * h(k + 2, j);
+                            h(k + 2, j) -= p * z;
+                        }
+                        h(k, j) -= p * x;
+                        h(k + 1, j) -= p * y;
+                    }
+
+                    // column modification
+                    const long iEnd = std::min(n, k + 3);
+                    for (long i = l; i <= iEnd; i++)
+                    {
+                        p = x * h(i, k) + y * h(i, k + 1);
+                        if (notlast)
+                        {
+                            p = p + z * h(i, k + 2);
+                            h(i, k + 2) -= p * r;
+                        }
+                        h(i, k) -= p;
+                        h(i, k + 1) -= p * q;
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Single shift QR with Wilkinson shifts on the complex Hessenberg form
+        /// Each step is applied as a sweep of plane rotations over the active block
+        void _complex_hessenberg_qr()
+        {
+            std::vector<Work_t> hv = _hessenberg_copy();
+            Work_t* H = hv.data();
+            const size_t nn = m_n;
+            auto h = [&](const size_t& i, const size_t& j) -> Work_t& { return H[i * nn + j]; };
+
+            const double eps = std::numeric_limits<double>::epsilon();
+            std::vector<Work_t> cs(nn);
+            std::vector<Work_t> sn(nn);
+
+            long hi = (long) nn - 1;
+            size_t iter = 0;
+
+            while (hi >= 0)
+            {
+                // look for a single small sub-diagonal element
+                long l = hi;
+                while (l > 0)
+                {
+                    const double s = _abs(h(l - 1, l - 1)) + _abs(h(l, l));
+                    if (_abs(h(l, l - 1)) <= eps * s)
+                    {
+                        h(l, l - 1) = 0;
+                        break;
+                    }
+                    l--;
+                }
+
+                if (l == hi)
+                {
+                    m_result.m_values[hi] = h(hi, hi);
+                    m_result.m_iterations[hi] = iter;
+                    hi--;
+                    iter = 0;
+                    continue;
+                }
+
+                if (iter == MAX_QR_EIGEN_ITER)
+                {
+                    m_result.m_converged = false;
+                    for (long i = 0; i <= hi; i++)
+                    {
+                        m_result.m_values[i] = h(i, i);
+                        m_result.m_iterations[i] = iter;
+                    }
+                    break;
+                }
+
+                iter++;
+                m_result.m_total_iterations++;
+
+                // Wilkinson shift, eigenvalue of the trailing 2x2 closest to its last element
+                Work_t mu;
+                if (iter % 10 == 0)
+                {
+                    // exceptional shift to break cycles
+                    mu = h(hi, hi) + (Work_t) (_abs(h(hi, hi - 1)) * 0.75);
+                }
+                else
+                {
+                    const Work_t a = h(hi - 1, hi - 1);
+                    const Work_t b = h(hi - 1, hi);
+                    const Work_t c = h(hi, hi - 1);
+                    const Work_t d = h(hi, hi);
+                    const Work_t half = (a - d) * 0.5;
+                    const Work_t disc = powReal(half * half + b * c, 0.5);
+                    const Work_t mu1 = (a + d) * 0.5 + disc;
+                    const Work_t mu2 = (a + d) * 0.5 - disc;
+                    mu = (_abs(mu1 - d) < _abs(mu2 - d)) ? mu1 : mu2;
+                }
+
+                for (long i = l; i <= hi; i++)
+                {
+                    h(i, i) -= mu;
+                }
+
+                // left rotations, reduce H - mu I to upper triangular R
+                for (long k = l; k < hi; k++)
+                {
+                    const Work_t x = h(k, k);
+                    const Work_t y = h(k + 1, k);
+                    const double r = std::hypot(_abs(x), _abs(y));
+                    Work_t c = 1;
+                    Work_t s = 0;
+                    if (r != 0)
+                    {
+                        c = x / r;
+                        s = y / r;
+                    }
+                    cs[k] = c;
+                    sn[k] = s;
+
+                    const Work_t cc = scalar_conj(c);
+                    const Work_t sc = scalar_conj(s);
+                    for (long j = k; j <= hi; j++)
+                    {
+                        const Work_t t1 = h(k, j);
+                        const Work_t t2 = h(k + 1, j);
+                        h(k, j) = cc * t1 + sc * t2;
+                        h(k + 1, j) = c * t2 - s * t1;
+                    }
+                }
+
+                // right rotations, form R Q which stays Hessenberg
+                for (long k = l; k < hi; k++)
+                {
+                    const Work_t c = cs[k];
+                    const Work_t s = sn[k];
+                    const Work_t cc = scalar_conj(c);
+                    const Work_t sc = scalar_conj(s);
+                    const long iEnd = std::min(hi, k + 1);
+                    for (long i = l; i <= iEnd; i++)
+                    {
+                        const Work_t t1 = h(i, k);
+                        const Work_t t2 = h(i, k + 1);
+                        h(i, k) = t1 * c + t2 * s;
+                        h(i, k + 1) = t2 * cc - t1 * sc;
+                    }
+                }
+
+                for (long i = l; i <= hi; i++)
+                {
+                    h(i, i) += mu;
+                }
+            }
+        };
+};
@@ -0,0 +1,202 @@
+/// ------------------------------------------
+/// @file Expr.h
+///
+/// @brief Header/Source file for the lazy elementwise expression layer
+/// used by Matrix and Vector
+///
+/// Wrapping an operand with lazy() makes +, -, * (elementwise), * scalar and
+/// / scalar build a small expression tree instead of a temporary, the tree is
+/// then evaluated in a single pass when assigned to a Matrix or Vector:
+///
+///     Matrix<double> res = lazy(a) + lazy(b) - lazy(c) * 2.0;
+///
+/// @note Expressions hold pointers to the data of their operands, they must be
+/// evaluated before any operand goes out of scope (do not store them in auto)
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <cstddef>
+
+#include "Thread_Pool.h"
+#include "Matrix_Fwd.h"
+
+template <typename T> class Vector;
+
+/// @brief Base of all lazy expressions, E is the concrete node type
+template <typename E>
+struct Expr_t
+{
+    ///--------------------------------------------------------
+    /// @brief Downcasts to the concrete expression node
+    ///
+    /// @return reference to concrete node
+    const E& self() const
+    {
+        return static_cast<const E&>(*this);
+    }
+};
+
+/// @brief Leaf of an expression, wraps the storage of a Matrix or Vector
+template <typename T>
+struct Expr_Leaf_t : public Expr_t<Expr_Leaf_t<T>>
+{
+    typedef T value_type;
+
+    /// @brief first element of the wrapped storage
+    const T* m_data;
+
+    /// @brief row count of the wrapped object (vectors use their length)
+    size_t m_rows;
+
+    /// @brief column count of the wrapped object (vectors use 1)
+    size_t m_cols;
+
+    Expr_Leaf_t(const T* data, const size_t& rows, const size_t& cols) :
+        m_data(data), m_rows(rows), m_cols(cols) {};
+
+    T operator[](const size_t& i) const { return m_data[i]; };
+    size_t rows() const { return m_rows; };
+    size_t cols() const { return m_cols; };
+};
+
+/// @brief Elementwise node combining two expressions
+template <typename L, typename R, typename Op>
+struct Expr_Binary_t : public Expr_t<Expr_Binary_t<L, R, Op>>
+{
+    typedef typename L::value_type value_type;
+
+    L m_lhs;
+    R m_rhs;
+
+    ///--------------------------------------------------------
+    /// @brief Constructor, checks both sides have the same dimensions
+    ///
+    /// @throws std::invalid_argument if the dimensions differ
+    Expr_Binary_t(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs)
+    {
+        if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols())
+        {
+            throw std::invalid_argument("Elementwise expressions require operands of same dimensions");
+        }
+    };
+
+    value_type operator[](const size_t& i) const { return Op::apply(m_lhs[i], m_rhs[i]); };
+    size_t rows() const { return m_lhs.rows(); };
+    size_t cols() const { return m_lhs.cols(); };
+};
+
+/// @brief Elementwise node combining an expression with a scalar
+template <typename E, typename S, typename Op>
+struct Expr_Scalar_t : public Expr_t<Expr_Scalar_t<E, S, Op>>
+{
+    typedef typename E::value_type value_type;
+
+    E m_expr;
+    S m_scalar;
+
+    Expr_Scalar_t(const E& expr, const S& scalar) : m_expr(expr), m_scalar(scalar) {};
+
+    value_type operator[](const size_t& i) const { return Op::apply(m_expr[i], m_scalar); };
+    size_t rows() const { return m_expr.rows(); };
+    size_t cols() const { return m_expr.cols(); };
+};
+
+/// @brief Elementwise operation functors used by the expression nodes
+struct Expr_Add_t { template <typename A, typename B> static A apply(const A& a, const B& b) { return a + b; } };
+struct Expr_Sub_t { template <typename A, typename B> static A apply(const A& a, const B& b) { return a - b; } };
+struct Expr_Mul_t { template <typename A, typename B> static A apply(const A& a, const B& b) { return a * b; } };
+struct Expr_Div_t { template <typename A, typename B> static A apply(const A& a, const B& b) { return a / b; } };
+
+///--------------------------------------------------------
+/// @brief Wraps a matrix as the leaf of a lazy expression
+///
+/// @param mat matrix to wrap, must outlive the expression
+///
+/// @return expression leaf
+template <typename T>
+Expr_Leaf_t<T> lazy(const Matrix<T>& mat)
+{
+    return Expr_Leaf_t<T>(mat.get_data(), mat.getRowCount(), mat.getColCount());
+}
+
+///--------------------------------------------------------
+/// @brief Wraps a vector as the leaf of a lazy expression
+///
+/// @param vec vector to wrap, must outlive the expression
+///
+/// @return expression leaf
+template <typename T>
+Expr_Leaf_t<T> lazy(const Vector<T>& vec)
+{
+    return Expr_Leaf_t<T>(vec.get_data(), vec.size(), 1);
+}
+
+///--------------------------------------------------------
+/// @brief Evaluates an expression into a flat output buffer in one pass
+///
+/// @param expr expression to evaluate
+/// @param out output buffer, must hold rows * cols elements
+template <typename E>
+void evaluate_expr(const Expr_t<E>& expr, typename E::value_type* out)
+{
+    const E& e = expr.self();
+    const size_t len = e.rows() * e.cols();
+    parallel_for(0, len, parallel_grain(1), [&](size_t from, size_t to)
+    {
+        for (size_t i = from; i < to; i++)
+        {
+            out[i] = e[i];
+        }
+    });
+}
+
+///--------------------------------------------------------
+/// @brief Lazy elementwise addition
+template <typename L, typename R>
+Expr_Binary_t<L, R, Expr_Add_t> operator+(const Expr_t<L>& lhs, const Expr_t<R>& rhs)
+{
+    return Expr_Binary_t<L, R, Expr_Add_t>(lhs.self(), rhs.self());
+}
+
+///--------------------------------------------------------
+/// @brief Lazy elementwise subtraction
+template <typename L, typename R>
+Expr_Binary_t<L, R, Expr_Sub_t> operator-(const Expr_t<L>& lhs, const Expr_t<R>& rhs)
+{
+    return Expr_Binary_t<L, R, Expr_Sub_t>(lhs.self(), rhs.self());
+}
+
+///--------------------------------------------------------
+/// @brief Lazy elementwise (Hadamard) multiplication
+template <typename L, typename R>
+Expr_Binary_t<L, R, Expr_Mul_t> operator*(const Expr_t<L>& lhs, const Expr_t<R>& rhs)
+{
+    return Expr_Binary_t<L, R, Expr_Mul_t>(lhs.self(), rhs.self());
+}
+
+///--------------------------------------------------------
+/// @brief Lazy multiplication by a scalar
+template <typename E>
+Expr_Scalar_t<E, typename E::value_type, Expr_Mul_t> operator*(const Expr_t<E>& expr, const typename E::value_type& num)
+{
+    return Expr_Scalar_t<E, typename E::value_type, Expr_Mul_t>(expr.self(), num);
+}
+
+///--------------------------------------------------------
+/// @brief Lazy multiplication by a scalar, scalar on the left
+template <typename E>
+Expr_Scalar_t<E, typename E::value_type, Expr_Mul_t> operator*(const typename E::value_type& num, const Expr_t<E>& expr)
+{
+    return Expr_Scalar_t<E, typename E::value_type, Expr_Mul_t>(expr.self(), num);
+}
+
+///--------------------------------------------------------
+/// @brief Lazy division by a scalar
+template <typename E>
+Expr_Scalar_t<E, typename E::value_type, Expr_Div_t> operator/(const Expr_t<E>& expr, const typename E::value_type& num)
+{
+    return Expr_Scalar_t<E, typename E::value_type, Expr_Div_t>(expr.self(), num);
+}
@@ -0,0 +1,410 @@
+/// ------------------------------------------
+/// @file Gemm.h
+///
+/// @brief Header/Source file for the blocked general matrix multiply kernel
+/// used underneath Matrix<T>::operator%
+///
+/// Follows the usual packed layout: B is packed per (KC x NC) block to sit in L3,
+/// A is packed per (MC x KC) block to sit in L2, and a register tiled
+/// micro-kernel walks MR x NR tiles of C out of L1
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "Thread_Pool.h"
+#include "Complex_C.h"
+#include "Complex_Kernels.h"
+#include "Storage.h"
+
+// Cache blocking sizes, all tunable at compile time with -D
+///--------------------------------------------------------
+/// Rows of A packed per block, sized so an MC x KC panel of A sits in L2
+#ifndef GEMM_BLOCK_MC
+#define GEMM_BLOCK_MC 96
+#endif
+
+/// Shared depth of each packed panel, sized so a KC x NR sliver of B sits in L1
+#ifndef GEMM_BLOCK_KC
+#define GEMM_BLOCK_KC 256
+#endif
+
+/// Columns of B packed per block, sized so a KC x NC panel of B sits in L3
+#ifndef GEMM_BLOCK_NC
+#define GEMM_BLOCK_NC 2048
+#endif
+
+/// Products with m*n*k below this skip packing and use the simple loop
+#ifndef GEMM_SMALL_LIMIT
+#define GEMM_SMALL_LIMIT 32768
+#endif
+///--------------------------------------------------------
+
+/// @brief Register tile shape of the micro-kernel for a given type
+/// MR rows of A by NR columns of B are accumulated per kernel call
+///
+/// @tparam T type being multiplied, specialised below for double and float
+template <typename T>
+struct Gemm_Tile_t
+{
+    static constexpr size_t MR = 2;
+    static constexpr size_t NR = 2;
+};
+
+// NR must stay a power of two so the vector extension types below are valid
+#if defined(__AVX512F__)
+template <> struct Gemm_Tile_t<double> { static constexpr size_t MR = 8; static constexpr size_t NR = 16; };
+template <> struct Gemm_Tile_t<float>  { static constexpr size_t MR = 8; static constexpr size_t NR = 32; };
+#elif defined(__AVX__)
+template <> struct Gemm_Tile_t<double> { static constexpr size_t MR = 6; static constexpr size_t NR = 8; };
+template <> struct Gemm_Tile_t<float>  { static constexpr size_t MR = 6; static constexpr size_t NR = 16; };
+#else
+template <> struct Gemm_Tile_t<double> { static constexpr size_t MR = 4; static constexpr size_t NR = 4; };
+template <> struct Gemm_Tile_t<float>  { static constexpr size_t MR = 4; static constexpr size_t NR = 8; };
+#endif
+
+///--------------------------------------------------------
+/// @brief Packs an mc x kc block of A into MR row slivers, each stored column by column
+/// Rows past mc are zero padded so the micro-kernel never needs edge handling
+///
+/// @param mc rows to pack
+/// @param kc depth to pack
+/// @param A pointer to the first element of the block
+/// @param rsa distance between rows of A
+/// @param csa distance between columns of A
+/// @param Ap packed output buffer, at least ceil(mc/MR)*MR*kc long
+template <typename T>
+void _gemm_pack_A(const size_t& mc, const size_t& kc, const T* A, const size_t& rsa, const size_t& csa, T* Ap)
+{
+    constexpr size_t MR = Gemm_Tile_t<T>::MR;
+
+    for (size_t ir = 0; ir < mc; ir += MR)
+    {
+        const size_t mr = std::min(MR, mc - ir);
+        for (size_t p = 0; p < kc; p++)
+        {
+            for (size_t i = 0; i < mr; i++)
+            {
+                Ap[i] = A[(ir + i) * rsa + p * csa];
+            }
+            for (size_t i = mr; i < MR; i++)
+            {
+                Ap[i] = T(0);
+            }
+            Ap += MR;
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Packs a kc x nc block of B into NR column slivers, each stored row by row
+/// Columns past nc are zero padded so the micro-kernel never needs edge handling
+///
+/// @param kc depth to pack
+/// @param nc columns to pack
+/// @param B pointer to the first element of the block
+/// @param rsb distance between rows of B
+/// @param csb distance between columns of B
+/// @param Bp packed output buffer, at least ceil(nc/NR)*NR*kc long
+template <typename T>
+void _gemm_pack_B(const size_t& kc, const size_t& nc, const T* B, const size_t& rsb, const size_t& csb, T* Bp)
+{
+    constexpr size_t NR = Gemm_Tile_t<T>::NR;
+
+    for (size_t jr = 0; jr < nc; jr += NR)
+    {
+        const size_t nr = std::min(NR, nc - jr);
+        for (size_t p = 0; p < kc; p++)
+        {
+            for (size_t j = 0; j < nr; j++)
+            {
+                Bp[j] = B[p * rsb + (jr + j) * csb];
+            }
+            for (size_t j = nr; j < NR; j++)
+            {
+                Bp[j] = T(0);
+            }
+            Bp += NR;
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Register tiled micro-kernel, computes one MR x NR tile of C from packed slivers
+/// Generic version, relies on the operators of T
+///
+/// @param kc shared depth of the slivers
+/// @param Ap packed sliver of A (kc columns of MR)
+/// @param Bp packed sliver of B (kc rows of NR)
+/// @param C top left of the destination tile
+/// @param ldc row stride of C
+/// @param mr valid rows in this tile
+/// @param nr valid columns in this tile
+/// @param accumulate add to C if true, overwrite if false
+template <typename T>
+void _gemm_micro_kernel(const size_t& kc, const T* Ap, const T* Bp, T* C, const size_t& ldc,
+                        const size_t& mr, const size_t& nr, const bool& accumulate)
+{
+    constexpr size_t MR = Gemm_Tile_t<T>::MR;
+    constexpr size_t NR = Gemm_Tile_t<T>::NR;
+
+    T acc[MR][NR];
+    for (size_t i = 0; i < MR; i++)
+    {
+        for (size_t j = 0; j < NR; j++)
+        {
+            acc[i][j] = T(0);
+        }
+    }
+
+    for (size_t p = 0; p < kc; p++)
+    {
+        for (size_t i = 0; i < MR; i++)
+        {
+            for (size_t j = 0; j < NR; j++)
+            {
+                acc[i][j] += Ap[i] * Bp[j];
+            }
+        }
+        Ap += MR;
+        Bp += NR;
+    }
+
+    for (size_t i = 0; i < mr; i++)
+    {
+        for (size_t j = 0; j < nr; j++)
+        {
+            if (accumulate)
+            {
+                C[i * ldc + j] += acc[i][j];
+            }
+            else
+            {
+                C[i * ldc + j] = acc[i][j];
+            }
+        }
+    }
+}
+
+#if defined(__GNUC__)
+///--------------------------------------------------------
+/// @brief Register tiled micro-kernel for floating point types
+/// Each row of the tile is held in one GCC vector extension register group, so the
+/// inner loop compiles to broadcast + FMA for whatever SIMD width the target has
+///
+/// @param kc shared depth of the slivers
+/// @param Ap packed sliver of A (kc columns of MR)
+/// @param Bp packed sliver of B (kc rows of NR)
+/// @param C top left of the destination tile
+/// @param ldc row stride of C
+/// @param mr valid rows in this tile
+/// @param nr valid columns in this tile
+/// @param accumulate add to C if true, overwrite if false
+template <typename T>
+void _gemm_micro_kernel_simd(const size_t& kc, const T* Ap, const T* Bp, T* C, const size_t& ldc,
+                             const size_t& mr, const size_t& nr, const bool& accumulate)
+{
+    constexpr size_t MR = Gemm_Tile_t<T>::MR;
+    constexpr size_t NR = Gemm_Tile_t<T>::NR;
+    typedef T Row_Vec_t __attribute__((vector_size(NR * sizeof(T))));
+
+    Row_Vec_t acc[MR];
+    for (size_t i = 0; i < MR; i++)
+    {
+        acc[i] = Row_Vec_t{};
+    }
+
+    for (size_t p = 0; p < kc; p++)
+    {
+        Row_Vec_t b;
+        memcpy(&b, Bp, sizeof(Row_Vec_t));
+        for (size_t i = 0; i < MR; i++)
+        {
+            acc[i] += Ap[i] * b;
+        }
+        Ap += MR;
+        Bp += NR;
+    }
+
+    for (size_t i = 0; i < mr; i++)
+    {
+        T* cRow = C + i * ldc;
+        if (nr == NR)
+        {
+            Row_Vec_t c = acc[i];
+            if (accumulate)
+            {
+                Row_Vec_t old;
+                memcpy(&old, cRow, sizeof(Row_Vec_t));
+                c += old;
+            }
+            memcpy(cRow, &c, sizeof(Row_Vec_t));
+            continue;
+        }
+
+        for (size_t j = 0; j < nr; j++)
+        {
+            cRow[j] = accumulate ? cRow[j] + acc[i][j] : acc[i][j];
+        }
+    }
+}
+
+///--------------------------------------------------------
+template <>
+inline void _gemm_micro_kernel<double>(const size_t& kc, const double* Ap, const double* Bp, double* C, const size_t& ldc,
+                                       const size_t& mr, const size_t& nr, const bool& accumulate)
+{
+    _gemm_micro_kernel_simd<double>(kc, Ap, Bp, C, ldc, mr, nr, accumulate);
+}
+
+///--------------------------------------------------------
+template <>
+inline void _gemm_micro_kernel<float>(const size_t& kc, const float* Ap, const float* Bp, float* C, const size_t& ldc,
+                                      const size_t& mr, const size_t& nr, const bool& accumulate)
+{
+    _gemm_micro_kernel_simd<float>(kc, Ap, Bp, C, ldc, mr, nr, accumulate);
+}
+#endif
+
+///--------------------------------------------------------
+/// @brief Small product fallback, i-p-j ordering so the inner loop walks rows of B and C contiguously
+///
+/// @param m rows of A and C
+/// @param n columns of B and C
+/// @param k columns of A and rows of B
+/// @param A pointer to A
+/// @param rsa distance between rows of A
+/// @param csa distance between columns of A
+/// @param B pointer to B
+/// @param rsb distance between rows of B
+/// @param csb distance between columns of B
+/// @param C pointer to C, overwritten
+/// @param ldc row stride of C
+template <typename T>
+void _gemm_simple(const size_t& m, const size_t& n, const size_t& k,
+                  const T* A, const size_t& rsa, const size_t& csa,
+                  const T* B, const size_t& rsb, const size_t& csb,
+                  T* C, const size_t& ldc)
+{
+    for (size_t i = 0; i < m; i++)
+    {
+        T* cRow = C + i * ldc;
+        for (size_t j = 0; j < n; j++)
+        {
+            cRow[j] = T(0);
+        }
+
+        for (size_t p = 0; p < k; p++)
+        {
+            const T a = A[i * rsa + p * csa];
+            const T* bRow = B + p * rsb;
+            for (size_t j = 0; j < n; j++)
+            {
+                cRow[j] += a * bRow[j * csb];
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief General matrix multiply, C = A * B
+/// A and B are described by row/column strides so transposed operands can be read in place,
+/// C is always row major with row stride ldc
+///
+/// @param m rows of A and C
+/// @param n columns of B and C
+/// @param k columns of A and rows of B
+/// @param A pointer to A
+/// @param rsa distance between rows of A
+/// @param csa distance between columns of A
+/// @param B pointer to B
+/// @param rsb distance between rows of B
+/// @param csb distance between columns of B
+/// @param C pointer to C, overwritten
+/// @param ldc row stride of C
+template <typename T>
+void gemm(const size_t& m, const size_t& n, const size_t& k,
+          const T* A, const size_t& rsa, const size_t& csa,
+          const T* B, const size_t& rsb, const size_t& csb,
+          T* C, const size_t& ldc)
+{
+    if (m * n * k < GEMM_SMALL_LIMIT)
+    {
+        _gemm_simple(m, n, k, A, rsa, csa, B, rsb, csb, C, ldc);
+        return;
+    }
+
+    constexpr size_t MR = Gemm_Tile_t<T>::MR;
+    constexpr size_t NR = Gemm_Tile_t<T>::NR;
+
+    // row blocks are shared out across the pool, so shrink them when there would be
+    // fewer blocks than threads (kept a whole number of MR slivers)
+    const size_t threads = Thread_Pool::instance().getThreadCount();
+    const size_t mcSplit = ((m + threads - 1) / threads + MR - 1) / MR * MR;
+    const size_t mcBlock = std::max<size_t>(MR, std::min<size_t>(GEMM_BLOCK_MC, mcSplit));
+    const size_t mBlocks = (m + mcBlock - 1) / mcBlock;
+
+    const size_t mcMax = std::min<size_t>(mcBlock, m);
+    const size_t kcMax = std::min<size_t>(GEMM_BLOCK_KC, k);
+    const size_t ncMax = std::min<size_t>(GEMM_BLOCK_NC, n);
+
+    // packed B panel is shared by all threads, each task packs its own A block
+    Storage_Vector_t<T> Bp(((ncMax + NR - 1) / NR) * NR * kcMax);
+    const size_t apSize = ((mcMax + MR - 1) / MR) * MR * kcMax;
+
+    for (size_t jc = 0; jc < n; jc += GEMM_BLOCK_NC)
+    {
+        const size_t nc = std::min<size_t>(GEMM_BLOCK_NC, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += GEMM_BLOCK_KC)
+        {
+            const size_t kc = std::min<size_t>(GEMM_BLOCK_KC, k - pc);
+            // first depth block overwrites C, the rest accumulate into it
+            const bool accumulate = pc != 0;
+
+            _gemm_pack_B(kc, nc, B + pc * rsb + jc * csb, rsb, csb, Bp.data());
+
+            parallel_for(0, mBlocks, parallel_grain(mcBlock * nc * kc), [&](size_t from, size_t to)
+            {
+                Storage_Vector_t<T> Ap(apSize);
+
+                for (size_t block = from; block < to; block++)
+                {
+                    const size_t ic = block * mcBlock;
+                    const size_t mc = std::min<size_t>(mcBlock, m - ic);
+
+                    _gemm_pack_A(mc, kc, A + ic * rsa + pc * csa, rsa, csa, Ap.data());
+
+                    for (size_t jr = 0; jr < nc; jr += NR)
+                    {
+                        const size_t nr = std::min(NR, nc - jr);
+                        for (size_t ir = 0; ir < mc; ir += MR)
+                        {
+                            const size_t mr = std::min(MR, mc - ir);
+                            _gemm_micro_kernel<T>(kc, Ap.data() + ir * kc, Bp.data() + jr * kc,
+                                                  C + (ic + ir) * ldc + jc + jr, ldc, mr, nr, accumulate);
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Complex specialisation, runs on the split real/imaginary SIMD kernels
+/// instead of the out of line Complex_C_t operators, see complex_gemm
+template <>
+inline void gemm<Complex_C_t>(const size_t& m, const size_t& n, const size_t& k,
+                              const Complex_C_t* A, const size_t& rsa, const size_t& csa,
+                              const Complex_C_t* B, const size_t& rsb, const size_t& csb,
+                              Complex_C_t* C, const size_t& ldc)
+{
+    complex_gemm(m, n, k, A, rsa, csa, B, rsb, csb, C, ldc);
+}
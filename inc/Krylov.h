@@ -0,0 +1,821 @@
+/// ------------------------------------------
+/// @file Krylov.h
+///
+/// @brief Header/Source file for the preconditioned Krylov iterative solvers
+///
+/// Solves Ax = b using only products with A, for large dense or sparse systems
+/// where a factorization is too expensive. Conjugate Gradient is for Hermitian
+/// (symmetric) positive definite A, GMRES(m) and BiCGSTAB for general A. The
+/// preconditioner is built once when the solver is made and reused by every solve,
+/// CG applies it symmetrically, GMRES and BiCGSTAB apply it on the right so the
+/// residual tested is the true residual b - Ax
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+#include <functional>
+#include <algorithm>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Sparse.h"
+#include "Scalar.h"
+#include "Reduce.h"
+#include "Thread_Pool.h"
+
+/// Relative residual ||b - Ax|| / ||b|| at which a Krylov solve stops by default
+#ifndef KRYLOV_DEFAULT_TOL
+#define KRYLOV_DEFAULT_TOL 1e-10
+#endif
+
+/// Iteration budget of a Krylov solve by default
+#ifndef KRYLOV_DEFAULT_MAX_ITER
+#define KRYLOV_DEFAULT_MAX_ITER 1000
+#endif
+
+/// Basis size m of GMRES(m) before it restarts by default
+#ifndef KRYLOV_DEFAULT_RESTART
+#define KRYLOV_DEFAULT_RESTART 30
+#endif
+
+/// @brief Krylov methods, selected at runtime through Krylov_Solver<T>::solve
+enum class Krylov_Method_t
+{
+    CG,         // conjugate gradient, Hermitian positive definite only
+    GMRES,      // restarted GMRES(m), general, monotone residual
+    BICGSTAB    // stabilised biconjugate gradient, general, short recurrences
+};
+
+/// @brief Preconditioners, M approximates A and M^-1 is applied each iteration
+enum class Krylov_Precond_t
+{
+    NONE,       // identity
+    JACOBI,     // inverse of the diagonal of A
+    ILU0        // incomplete LU on the non-zero pattern of A, no fill in
+};
+
+/// @brief Stopping rules and monitoring for a Krylov solve
+struct Krylov_Options_t
+{
+    /// @brief stop once ||b - Ax|| <= m_tol * ||b||
+    double m_tol = KRYLOV_DEFAULT_TOL;
+
+    /// @brief stop after this many iterations (for GMRES one iteration is one basis vector)
+    size_t m_max_iter = KRYLOV_DEFAULT_MAX_ITER;
+
+    /// @brief GMRES basis size before restarting, ignored by the other methods
+    size_t m_restart = KRYLOV_DEFAULT_RESTART;
+
+    /// @brief called after each iteration with its number (from 1) and relative residual,
+    /// return false to stop the solve early
+    std::function<bool(const size_t& iteration, const double& residual)> m_callback;
+};
+
+/// @brief Results of a Krylov solve
+struct Krylov_Result_t
+{
+    /// @brief iterations performed
+    size_t m_iterations = 0;
+
+    /// @brief relative residual ||b - Ax|| / ||b|| of the returned solution
+    double m_residual = 0;
+
+    /// @brief true if m_residual reached the tolerance
+    bool m_converged = false;
+
+    /// @brief true if the solve ended on a breakdown (zero inner product) rather than the budget
+    bool m_breakdown = false;
+};
+
+/// @brief Templated class for solving Ax = b iteratively with a dense or sparse A
+template <typename T>
+class Krylov_Solver
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor for a dense system matrix, copies the matrix
+        ///
+        /// @param mat square system matrix
+        /// @param precond preconditioner to build, ILU0 uses the non-zero pattern of mat
+        ///
+        /// @throws std::invalid_argument if matrix is not square, or the preconditioner
+        /// cannot be built (zero on the diagonal or a zero pivot)
+        Krylov_Solver(const Matrix<T>& mat, const Krylov_Precond_t& precond = Krylov_Precond_t::NONE)
+            : m_size(mat.getRowCount()), m_precond(precond)
+        {
+            _check_square(mat.getRowCount(), mat.getColCount());
+
+            m_apply = [mat](const T* x, T* y)
+            {
+                const size_t n = mat.getRowCount();
+                parallel_for(0, n, parallel_grain(n), [&](size_t from, size_t to)
+                {
+                    for (size_t i = from; i < to; i++)
+                    {
+                        const T* row = &mat(i, 0);
+                        T sum = (T) 0;
+                        for (size_t j = 0; j < n; j++)
+                        {
+                            sum += row[j] * x[j];
+                        }
+                        y[i] = sum;
+                    }
+                });
+            };
+
+            if (precond == Krylov_Precond_t::JACOBI)
+            {
+                Vector<T> diag(m_size);
+                for (size_t i = 0; i < m_size; i++)
+                {
+                    diag.get_data()[i] = mat(i, i);
+                }
+                _build_jacobi(diag);
+            }
+            else if (precond == Krylov_Precond_t::ILU0)
+            {
+                _build_ilu0(SparseMatrix<T>(mat));
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor for a sparse system matrix, copies the matrix
+        ///
+        /// @param mat square system matrix, CSC is converted to CSR
+        /// @param precond preconditioner to build
+        ///
+        /// @throws std::invalid_argument if matrix is not square, or the preconditioner
+        /// cannot be built (zero on the diagonal or a zero pivot)
+        Krylov_Solver(const SparseMatrix<T>& mat, const Krylov_Precond_t& precond = Krylov_Precond_t::NONE)
+            : m_size(mat.getRowCount()), m_precond(precond)
+        {
+            _check_square(mat.getRowCount(), mat.getColCount());
+
+            SparseMatrix<T> csr = mat.toFormat(Sparse_Format_t::CSR);
+            m_apply = [csr](const T* x, T* y)
+            {
+                csr.multiply(x, y);
+            };
+
+            if (precond == Krylov_Precond_t::JACOBI)
+            {
+                _build_jacobi(csr.diagonal());
+            }
+            else if (precond == Krylov_Precond_t::ILU0)
+            {
+                _build_ilu0(csr);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b with the given method
+        ///
+        /// @param b right hand side
+        /// @param x initial guess, overwritten with the solution
+        /// @param method Krylov method to use
+        /// @param opts stopping rules and callback
+        ///
+        /// @return iteration count, residual and convergence status
+        ///
+        /// @throws std::invalid_argument if b or x are not the size of the system
+        Krylov_Result_t solve(const Vector<T>& b, Vector<T>& x, const Krylov_Method_t& method,
+                              const Krylov_Options_t& opts = Krylov_Options_t()) const
+        {
+            switch (method)
+            {
+                case Krylov_Method_t::CG:
+                    return cg(b, x, opts);
+
+                case Krylov_Method_t::GMRES:
+                    return gmres(b, x, opts);
+
+                case Krylov_Method_t::BICGSTAB:
+                    return bicgstab(b, x, opts);
+
+                default:
+                    throw std::invalid_argument("Unknown Krylov method");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b from a zero initial guess
+        ///
+        /// @param b right hand side
+        /// @param method Krylov method to use
+        /// @param opts stopping rules and callback
+        ///
+        /// @return the solution, check convergence with the overload taking x if it matters
+        ///
+        /// @throws std::invalid_argument if b is not the size of the system
+        Vector<T> solve(const Vector<T>& b, const Krylov_Method_t& method = Krylov_Method_t::GMRES,
+                        const Krylov_Options_t& opts = Krylov_Options_t()) const
+        {
+            Vector<T> x(m_size);
+            std::fill(x.get_data(), x.get_data() + m_size, (T) 0);
+            solve(b, x, method, opts);
+            return x;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Preconditioned conjugate gradient, A must be Hermitian positive definite
+        /// and for ILU0 the preconditioner should be too (it is for an SPD M-matrix)
+        ///
+        /// @param b right hand side
+        /// @param x initial guess, overwritten with the solution
+        /// @param opts stopping rules and callback
+        ///
+        /// @return iteration count, residual and convergence status
+        ///
+        /// @throws std::invalid_argument if b or x are not the size of the system
+        Krylov_Result_t cg(const Vector<T>& b, Vector<T>& x, const Krylov_Options_t& opts = Krylov_Options_t()) const
+        {
+            const size_t n = m_size;
+            _check_rhs(b, x);
+
+            Krylov_Result_t result;
+            const double bNorm = _rhs_norm(b);
+            std::vector<T> r(n), z(n), p(n), q(n);
+
+            _residual(b.get_data(), x.get_data(), r.data());
+            result.m_residual = _norm(r.data()) / bNorm;
+            if (result.m_residual <= opts.m_tol)
+            {
+                result.m_converged = true;
+                return result;
+            }
+
+            _precondition(r.data(), z.data());
+            std::copy(z.begin(), z.end(), p.begin());
+            T rz = _dot(r.data(), z.data());
+
+            T* xd = x.get_data();
+            while (result.m_iterations < opts.m_max_iter)
+            {
+                m_apply(p.data(), q.data());
+                const T pq = _dot(p.data(), q.data());
+                if (scalar_abs(pq) == 0)
+                {
+                    result.m_breakdown = true;
+                    break;
+                }
+
+                const T alpha = rz / pq;
+                for (size_t i = 0; i < n; i++)
+                {
+                    xd[i] += alpha * p[i];
+                    r[i] -= alpha * q[i];
+                }
+
+                result.m_iterations++;
+                result.m_residual = _norm(r.data()) / bNorm;
+                if (_finished(result, opts))
+                {
+                    break;
+                }
+
+                _precondition(r.data(), z.data());
+                const T rzNext = _dot(r.data(), z.data());
+                const T beta = rzNext / rz;
+                rz = rzNext;
+                for (size_t i = 0; i < n; i++)
+                {
+                    p[i] = z[i] + beta * p[i];
+                }
+            }
+
+            return result;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Restarted GMRES(m) with right preconditioning
+        /// Builds an orthonormal basis by modified Gram-Schmidt and keeps the Hessenberg
+        /// least squares problem triangular with Givens rotations, so the residual is
+        /// known every iteration without forming x
+        ///
+        /// @param b right hand side
+        /// @param x initial guess, overwritten with the solution
+        /// @param opts stopping rules, restart length and callback
+        ///
+        /// @return iteration count, residual and convergence status
+        ///
+        /// @throws std::invalid_argument if b or x are not the size of the system, or the restart length is 0
+        Krylov_Result_t gmres(const Vector<T>& b, Vector<T>& x, const Krylov_Options_t& opts = Krylov_Options_t()) const
+        {
+            const size_t n = m_size;
+            _check_rhs(b, x);
+            if (opts.m_restart < 1)
+            {
+                throw std::invalid_argument("GMRES restart length must be above 0");
+            }
+
+            const size_t m = std::min(opts.m_restart, n);
+            Krylov_Result_t result;
+            const double bNorm = _rhs_norm(b);
+
+            // basis vectors V (m+1 of them), Hessenberg H column by column, rotations and rhs g
+            std::vector<T> V((m + 1) * n), H((m + 1) * m), g(m + 1), sn(m);
+            std::vector<double> cs(m);
+            std::vector<T> r(n), w(n), z(n);
+
+            T* xd = x.get_data();
+            _residual(b.get_data(), xd, r.data());
+            double beta = _norm(r.data());
+            result.m_residual = beta / bNorm;
+            if (result.m_residual <= opts.m_tol)
+            {
+                result.m_converged = true;
+                return result;
+            }
+
+            bool stop = false;
+            while (!stop && result.m_iterations < opts.m_max_iter)
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    V[i] = r[i] / (T) beta;
+                }
+                std::fill(g.begin(), g.end(), (T) 0);
+                g[0] = (T) beta;
+
+                size_t k = 0;
+                while (k < m && result.m_iterations < opts.m_max_iter)
+                {
+                    T* h = &H[k * (m + 1)];
+                    _precondition(&V[k * n], z.data());
+                    m_apply(z.data(), w.data());
+
+                    for (size_t j = 0; j <= k; j++)
+                    {
+                        h[j] = _dot(&V[j * n], w.data());
+                        _axpy(-h[j], &V[j * n], w.data());
+                    }
+                    const double wNorm = _norm(w.data());
+                    h[k + 1] = (T) wNorm;
+
+                    for (size_t j = 0; j < k; j++)
+                    {
+                        _rotate(cs[j], sn[j], h[j], h[j + 1]);
+                    }
+                    _make_rotation(h[k], h[k + 1], cs[k], sn[k]);
+                    _rotate(cs[k], sn[k], h[k], h[k + 1]);
+                    _rotate(cs[k], sn[k], g[k], g[k + 1]);
+
+                    k++;
+                    result.m_iterations++;
+                    result.m_residual = scalar_abs(g[k]) / bNorm;
+
+                    // lucky breakdown, the solution lies in the current basis
+                    if (wNorm == 0)
+                    {
+                        result.m_converged = result.m_residual <= opts.m_tol;
+                        stop = true;
+                        break;
+                    }
+
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        V[k * n + i] = w[i] / (T) wNorm;
+                    }
+
+                    if (_finished(result, opts))
+                    {
+                        stop = true;
+                        break;
+                    }
+                }
+
+                // y = R^-1 g, then x += M^-1 V y
+                std::vector<T> y(k);
+                for (size_t i = k; i-- > 0;)
+                {
+                    T sum = g[i];
+                    for (size_t j = i + 1; j < k; j++)
+                    {
+                        sum -= H[j * (m + 1) + i] * y[j];
+                    }
+                    y[i] = sum / H[i * (m + 1) + i];
+                }
+
+                std::fill(w.begin(), w.end(), (T) 0);
+                for (size_t j = 0; j < k; j++)
+                {
+                    _axpy(y[j], &V[j * n], w.data());
+                }
+                _precondition(w.data(), z.data());
+                for (size_t i = 0; i < n; i++)
+                {
+                    xd[i] += z[i];
+                }
+
+                // the rotated residual drifts from the true one, restart from the true one
+                _residual(b.get_data(), xd, r.data());
+                beta = _norm(r.data());
+                result.m_residual = beta / bNorm;
+                result.m_converged = result.m_residual <= opts.m_tol;
+                if (result.m_converged || beta == 0)
+                {
+                    break;
+                }
+            }
+
+            return result;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief BiCGSTAB with right preconditioning
+        ///
+        /// @param b right hand side
+        /// @param x initial guess, overwritten with the solution
+        /// @param opts stopping rules and callback
+        ///
+        /// @return iteration count, residual and convergence status
+        ///
+        /// @throws std::invalid_argument if b or x are not the size of the system
+        Krylov_Result_t bicgstab(const Vector<T>& b, Vector<T>& x, const Krylov_Options_t& opts = Krylov_Options_t()) const
+        {
+            const size_t n = m_size;
+            _check_rhs(b, x);
+
+            Krylov_Result_t result;
+            const double bNorm = _rhs_norm(b);
+            std::vector<T> r(n), rHat(n), p(n), v(n), s(n), t(n), pHat(n), sHat(n);
+
+            T* xd = x.get_data();
+            _residual(b.get_data(), xd, r.data());
+            result.m_residual = _norm(r.data()) / bNorm;
+            if (result.m_residual <= opts.m_tol)
+            {
+                result.m_converged = true;
+                return result;
+            }
+
+            std::copy(r.begin(), r.end(), rHat.begin());
+            T rho = (T) 1;
+            T alpha = (T) 1;
+            T omega = (T) 1;
+            std::fill(p.begin(), p.end(), (T) 0);
+            std::fill(v.begin(), v.end(), (T) 0);
+
+            while (result.m_iterations < opts.m_max_iter)
+            {
+                const T rhoNext = _dot(rHat.data(), r.data());
+                if (scalar_abs(rhoNext) == 0 || scalar_abs(omega) == 0)
+                {
+                    result.m_breakdown = true;
+                    break;
+                }
+
+                const T beta = (rhoNext / rho) * (alpha / omega);
+                rho = rhoNext;
+                for (size_t i = 0; i < n; i++)
+                {
+                    p[i] = r[i] + beta * (p[i] - omega * v[i]);
+                }
+
+                _precondition(p.data(), pHat.data());
+                m_apply(pHat.data(), v.data());
+                const T rv = _dot(rHat.data(), v.data());
+                if (scalar_abs(rv) == 0)
+                {
+                    result.m_breakdown = true;
+                    break;
+                }
+                alpha = rho / rv;
+
+                for (size_t i = 0; i < n; i++)
+                {
+                    s[i] = r[i] - alpha * v[i];
+                }
+
+                // half step already good enough
+                result.m_iterations++;
+                const double sNorm = _norm(s.data());
+                if (sNorm / bNorm <= opts.m_tol)
+                {
+                    _axpy(alpha, pHat.data(), xd);
+                    result.m_residual = sNorm / bNorm;
+                    _finished(result, opts);
+                    break;
+                }
+
+                _precondition(s.data(), sHat.data());
+                m_apply(sHat.data(), t.data());
+                const double tt = _norm(t.data());
+                omega = (tt == 0) ? (T) 0 : _dot(t.data(), s.data()) / (T) (tt * tt);
+
+                for (size_t i = 0; i < n; i++)
+                {
+                    xd[i] += alpha * pHat[i] + omega * sHat[i];
+                    r[i] = s[i] - omega * t[i];
+                }
+
+                result.m_residual = _norm(r.data()) / bNorm;
+                if (_finished(result, opts))
+                {
+                    break;
+                }
+            }
+
+            return result;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies the preconditioner, z = M^-1 r
+        ///
+        /// @param r vector to precondition
+        ///
+        /// @return preconditioned vector
+        ///
+        /// @throws std::invalid_argument if r is not the size of the system
+        Vector<T> precondition(const Vector<T>& r) const
+        {
+            if (r.size() != m_size)
+            {
+                throw std::invalid_argument("Vector must be the size of the system");
+            }
+
+            Vector<T> z(m_size);
+            _precondition(r.get_data(), z.get_data());
+            return z;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the preconditioner in use
+        ///
+        /// @return preconditioner kind
+        Krylov_Precond_t getPrecond() const
+        {
+            return m_precond;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of unknowns
+        ///
+        /// @return size of the system
+        size_t size() const
+        {
+            return m_size;
+        };
+
+    private:
+        /// @brief number of unknowns
+        size_t m_size;
+
+        /// @brief preconditioner kind
+        Krylov_Precond_t m_precond;
+
+        /// @brief y = A x, over a private copy of the system matrix
+        std::function<void(const T*, T*)> m_apply;
+
+        /// @brief Jacobi, reciprocal of the diagonal
+        std::vector<T> m_inv_diag;
+
+        /// @brief ILU0, L (unit diagonal implied, strict lower part) and U in one CSR
+        /// matrix on the pattern of A
+        std::vector<size_t> m_ilu_outer;
+        std::vector<size_t> m_ilu_inner;
+        std::vector<T> m_ilu_values;
+
+        /// @brief ILU0, position of each row's diagonal in m_ilu_values
+        std::vector<size_t> m_ilu_diag;
+
+        ///--------------------------------------------------------
+        /// @brief Throws if a system matrix is not square
+        static void _check_square(const size_t& rows, const size_t& cols)
+        {
+            if (rows != cols)
+            {
+                throw std::invalid_argument("Matrix must be square to solve a linear system with it");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Throws if b or x is not the size of the system
+        void _check_rhs(const Vector<T>& b, const Vector<T>& x) const
+        {
+            if (b.size() != m_size || x.size() != m_size)
+            {
+                throw std::invalid_argument("Right hand side and solution must be the size of the system");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Norm of b used to make residuals relative, 1 for a zero b so x = 0 is accepted
+        double _rhs_norm(const Vector<T>& b) const
+        {
+            const double norm = _norm(b.get_data());
+            return (norm == 0) ? 1 : norm;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Inner product conj(x) . y
+        T _dot(const T* x, const T* y) const
+        {
+            return reduce_dotc(m_size, x, y);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief 2-norm of x
+        double _norm(const T* x) const
+        {
+            return reduce_norm2(m_size, x);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief y += a x
+        void _axpy(const T& a, const T* x, T* y) const
+        {
+            for (size_t i = 0; i < m_size; i++)
+            {
+                y[i] += a * x[i];
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief r = b - A x
+        void _residual(const T* b, const T* x, T* r) const
+        {
+            m_apply(x, r);
+            for (size_t i = 0; i < m_size; i++)
+            {
+                r[i] = b[i] - r[i];
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Records convergence and runs the callback after an iteration
+        ///
+        /// @return true if the solve should stop
+        bool _finished(Krylov_Result_t& result, const Krylov_Options_t& opts) const
+        {
+            result.m_converged = result.m_residual <= opts.m_tol;
+            const bool keepGoing = !opts.m_callback || opts.m_callback(result.m_iterations, result.m_residual);
+            return result.m_converged || !keepGoing;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Finds the rotation [c s; -conj(s) c] that zeroes b against a
+        /// c is real so the same form covers real and complex types
+        static void _make_rotation(const T& a, const T& b, double& c, T& s)
+        {
+            const double absA = scalar_abs(a);
+            const double absB = scalar_abs(b);
+            if (absB == 0)
+            {
+                c = 1;
+                s = (T) 0;
+                return;
+            }
+            if (absA == 0)
+            {
+                c = 0;
+                s = scalar_conj(b) / (T) absB;
+                return;
+            }
+
+            const double r = std::hypot(absA, absB);
+            c = absA / r;
+            s = (a / (T) absA) * scalar_conj(b) / (T) r;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies a rotation from _make_rotation to the pair (a, b) in place
+        static void _rotate(const double& c, const T& s, T& a, T& b)
+        {
+            const T top = (T) c * a + s * b;
+            b = (T) c * b - scalar_conj(s) * a;
+            a = top;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief z = M^-1 r, z must not alias r
+        void _precondition(const T* r, T* z) const
+        {
+            const size_t n = m_size;
+            switch (m_precond)
+            {
+                case Krylov_Precond_t::JACOBI:
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        z[i] = m_inv_diag[i] * r[i];
+                    }
+                    return;
+
+                case Krylov_Precond_t::ILU0:
+                    // L y = r forward, then U z = y backward, in place in z
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        T sum = r[i];
+                        for (size_t p = m_ilu_outer[i]; p < m_ilu_diag[i]; p++)
+                        {
+                            sum -= m_ilu_values[p] * z[m_ilu_inner[p]];
+                        }
+                        z[i] = sum;
+                    }
+                    for (size_t i = n; i-- > 0;)
+                    {
+                        T sum = z[i];
+                        for (size_t p = m_ilu_diag[i] + 1; p < m_ilu_outer[i + 1]; p++)
+                        {
+                            sum -= m_ilu_values[p] * z[m_ilu_inner[p]];
+                        }
+                        z[i] = sum / m_ilu_values[m_ilu_diag[i]];
+                    }
+                    return;
+
+                default:
+                    std::copy(r, r + n, z);
+                    return;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Builds the Jacobi preconditioner from the diagonal of A
+        ///
+        /// @throws std::invalid_argument if the diagonal has a zero
+        void _build_jacobi(const Vector<T>& diag)
+        {
+            m_inv_diag.resize(m_size);
+            for (size_t i = 0; i < m_size; i++)
+            {
+                if (scalar_abs(diag.get_data()[i]) == 0)
+                {
+                    throw std::invalid_argument("Jacobi preconditioner requires a diagonal without zeros");
+                }
+                m_inv_diag[i] = (T) 1 / diag.get_data()[i];
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Builds the ILU0 factors on the pattern of a CSR matrix, IKJ ordering
+        /// Row i is eliminated against every earlier row k in its pattern, updates that
+        /// fall outside the pattern are dropped
+        ///
+        /// @throws std::invalid_argument if a diagonal entry is missing or a pivot is zero
+        void _build_ilu0(const SparseMatrix<T>& csr)
+        {
+            const size_t n = m_size;
+            m_ilu_outer = csr.outer();
+            m_ilu_inner = csr.inner();
+            m_ilu_values = csr.values();
+            m_ilu_diag.resize(n);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                const auto first = m_ilu_inner.begin() + m_ilu_outer[i];
+                const auto last = m_ilu_inner.begin() + m_ilu_outer[i + 1];
+                const auto it = std::lower_bound(first, last, i);
+                if (it == last || *it != i)
+                {
+                    throw std::invalid_argument("ILU0 preconditioner requires every diagonal entry to be stored");
+                }
+                m_ilu_diag[i] = it - m_ilu_inner.begin();
+            }
+
+            // scatter of row i's positions, an index past the values marks a column outside the pattern
+            const size_t absent = m_ilu_values.size();
+            std::vector<size_t> pos(n, absent);
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t p = m_ilu_outer[i]; p < m_ilu_outer[i + 1]; p++)
+                {
+                    pos[m_ilu_inner[p]] = p;
+                }
+
+                for (size_t p = m_ilu_outer[i]; p < m_ilu_diag[i]; p++)
+                {
+                    const size_t k = m_ilu_inner[p];
+                    const T pivot = m_ilu_values[m_ilu_diag[k]];
+                    if (scalar_abs(pivot) == 0)
+                    {
+                        throw std::invalid_argument("ILU0 preconditioner hit a zero pivot");
+                    }
+
+                    const T lik = m_ilu_values[p] / pivot;
+                    m_ilu_values[p] = lik;
+                    for (size_t q = m_ilu_diag[k] + 1; q < m_ilu_outer[k + 1]; q++)
+                    {
+                        const size_t target = pos[m_ilu_inner[q]];
+                        if (target != absent)
+                        {
+                            m_ilu_values[target] -= lik * m_ilu_values[q];
+                        }
+                    }
+                }
+
+                if (scalar_abs(m_ilu_values[m_ilu_diag[i]]) == 0)
+                {
+                    throw std::invalid_argument("ILU0 preconditioner hit a zero pivot");
+                }
+
+                for (size_t p = m_ilu_outer[i]; p < m_ilu_outer[i + 1]; p++)
+                {
+                    pos[m_ilu_inner[p]] = absent;
+                }
+            }
+        };
+};
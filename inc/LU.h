@@ -0,0 +1,581 @@
+/// ------------------------------------------
+/// @file LU.h
+///
+/// @brief Header/Source file for the partial pivoting LU factorization object
+///
+/// Factorizes PA = LU, with L (unit diagonal) and U stored compactly in one
+/// matrix and the row interchanges stored as a permutation vector
+///
+/// Rank 1 changes A + u v^T are taken in O(n^2) through update() without refactorizing.
+/// Each is kept as a Sherman-Morrison correction applied after the triangular solves,
+/// until LU_UPDATE_LIMIT of them have built up or one would be ill conditioned, then the
+/// current matrix is rebuilt from the factors and factorized afresh
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Scalar.h"
+#include "Thread_Pool.h"
+#include "Profile.h"
+#include "Gemm.h"
+#include "Triangular.h"
+
+/// Number of columns factorized per panel in the blocked factorization
+#ifndef LU_BLOCK_SIZE
+#define LU_BLOCK_SIZE 64
+#endif
+
+/// Minimum order before the blocked factorization is used
+#ifndef LU_BLOCKED_LIMIT
+#define LU_BLOCKED_LIMIT 128
+#endif
+
+/// Most Sherman-Morrison corrections kept before the updated matrix is refactorized,
+/// each one adds O(n) to every solve
+#ifndef LU_UPDATE_LIMIT
+#define LU_UPDATE_LIMIT 32
+#endif
+
+/// A correction is refactorized instead when |1 + v^T A^-1 u| is at most this times
+/// |v| |A^-1 u|, below it the formula cancels away the digits of the update
+#ifndef LU_UPDATE_TOL
+#define LU_UPDATE_TOL 1e-8
+#endif
+
+/// @brief Templated class for factorizing a square matrix into PA = LU and solving with it
+template <typename T>
+class LU
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes the given matrix
+        ///
+        /// @note singular matrices are still factorized, isSingular() will report them
+        /// and any solve/inverse call will throw
+        ///
+        /// @param mat square matrix to factorize
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        LU(const Matrix<T>& mat) : m_lu(mat), m_perm(mat.getRowCount())
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to have an LU factorization");
+            }
+
+            const size_t n = mat.getRowCount();
+            Profile_Scope_t profile(Profile_Op_t::LU, 2.0 * n * n * n / 3, n * n * sizeof(T) + n * sizeof(size_t));
+            _factorize();
+            profile.setFailed(m_singular);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is the factorized matrix singular (exactly zero pivot found)?
+        ///
+        /// @return true if matrix has no inverse
+        bool isSingular() const
+        {
+            return m_singular;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the compact LU storage
+        /// Strict lower triangle holds L (unit diagonal implied), upper triangle holds U
+        ///
+        /// @return compact LU matrix
+        const Matrix<T>& getLU() const
+        {
+            return m_lu;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the row permutation, row i of PA is row getPermutation()[i] of A
+        ///
+        /// @return permutation vector
+        const std::vector<size_t>& getPermutation() const
+        {
+            return m_perm;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant, product of the U diagonal and permutation sign
+        /// times 1 + v^T A^-1 u for every pending update
+        ///
+        /// @return determinant of the factorized matrix
+        T determinant() const
+        {
+            const size_t n = m_lu.getRowCount();
+            const T* lu = m_lu.get_data();
+
+            T det = (T) m_sign;
+            for (size_t i = 0; i < n; i++)
+            {
+                det *= lu[i * n + i];
+            }
+
+            for (const T& denom : m_upd_denom)
+            {
+                det *= denom;
+            }
+
+            return det;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Rank 1 update, the factorization becomes that of A + u v^T in O(n^2)
+        /// (v is not conjugated). Refactorizes in O(n^3) instead when the matrix is singular,
+        /// LU_UPDATE_LIMIT corrections are pending or the correction is ill conditioned
+        ///
+        /// @note getLU() and getPermutation() describe the matrix before the pending corrections,
+        /// see getUpdateCount()
+        ///
+        /// @param u column vector
+        /// @param v row vector
+        ///
+        /// @throws std::invalid_argument if sizes mismatch
+        void update(const Vector<T>& u, const Vector<T>& v)
+        {
+            const size_t n = m_lu.getRowCount();
+            if (u.size() != n || v.size() != n)
+            {
+                throw std::invalid_argument("Update vectors must match the factorized order");
+            }
+
+            if (!m_singular && m_upd_denom.size() < LU_UPDATE_LIMIT)
+            {
+                // w = A^-1 u through the corrections so far, then 1 + v^T w
+                Vector<T> w = solve(u);
+                T denom = 1;
+                for (size_t i = 0; i < n; i++)
+                {
+                    denom += v.get_data()[i] * w.get_data()[i];
+                }
+
+                if (scalar_abs(denom) > LU_UPDATE_TOL * _norm(v.get_data()) * _norm(w.get_data()))
+                {
+                    m_upd_u.insert(m_upd_u.end(), u.get_data(), u.get_data() + n);
+                    m_upd_v.insert(m_upd_v.end(), v.get_data(), v.get_data() + n);
+                    m_upd_w.insert(m_upd_w.end(), w.get_data(), w.get_data() + n);
+                    m_upd_denom.push_back(denom);
+                    return;
+                }
+            }
+
+            _refactorize(u.get_data(), v.get_data());
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adds delta to one row, update(e_row, delta)
+        ///
+        /// @param row row index
+        /// @param delta change to the row
+        ///
+        /// @throws std::invalid_argument if the row is out of range or sizes mismatch
+        void updateRow(const size_t& row, const Vector<T>& delta)
+        {
+            update(_unit(row), delta);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adds delta to one column, update(delta, e_col)
+        ///
+        /// @param col column index
+        /// @param delta change to the column
+        ///
+        /// @throws std::invalid_argument if the column is out of range or sizes mismatch
+        void updateCol(const size_t& col, const Vector<T>& delta)
+        {
+            update(delta, _unit(col));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the number of rank 1 corrections applied on top of the factors
+        ///
+        /// @return pending corrections, 0 right after a (re)factorization
+        size_t getUpdateCount() const
+        {
+            return m_upd_denom.size();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            const size_t n = m_lu.getRowCount();
+            if (solutions.size() != n)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Vector<T> outVec(n);
+            _solve_in_place(_permuted(solutions.get_data(), 1, outVec.get_data()), 1);
+            _apply_updates(outVec.get_data(), 1);
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B for X, each column of B is a separate right hand side
+        ///
+        /// @param solutions right hand side matrix B, must have as many rows as A
+        ///
+        /// @return matrix X
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Matrix<T> solve(const Matrix<T>& solutions) const
+        {
+            const size_t n = m_lu.getRowCount();
+            if (solutions.getRowCount() != n)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            const size_t nrhs = solutions.getColCount();
+            Matrix<T> outMat(n, nrhs);
+            _solve_in_place(_permuted(solutions.get_data(), nrhs, outMat.get_data()), nrhs);
+            _apply_updates(outMat.get_data(), nrhs);
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the inverse of the factorized matrix
+        ///
+        /// @return the inverse matrix
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        Matrix<T> inverse() const
+        {
+            return solve(Matrix<T>::identity(m_lu.getRowCount()));
+        };
+
+    private:
+        /// @brief Compact L and U factors
+        Matrix<T> m_lu;
+
+        /// @brief Row permutation applied during pivoting
+        std::vector<size_t> m_perm;
+
+        /// @brief Sign of the permutation, +1 or -1
+        int m_sign = 1;
+
+        /// @brief Set if an exactly zero pivot was found
+        bool m_singular = false;
+
+        /// @brief u, v and w = A^-1 u of each pending correction, n apiece in update order
+        std::vector<T> m_upd_u;
+        std::vector<T> m_upd_v;
+        std::vector<T> m_upd_w;
+
+        /// @brief 1 + v^T w of each pending correction
+        std::vector<T> m_upd_denom;
+
+        ///--------------------------------------------------------
+        /// @brief Performs the right looking factorization in place on m_lu
+        /// Rows are swapped physically, which is cheap in row major storage. From
+        /// LU_BLOCKED_LIMIT up, panels of LU_BLOCK_SIZE columns are factorized and the
+        /// trailing matrix is updated once per panel through gemm
+        void _factorize()
+        {
+            const size_t n = m_lu.getRowCount();
+            T* lu = m_lu.get_data();
+
+            for (size_t i = 0; i < n; i++)
+            {
+                m_perm[i] = i;
+            }
+
+            if (n < LU_BLOCKED_LIMIT)
+            {
+                _factorize_panel(0, n);
+                return;
+            }
+
+            for (size_t k0 = 0; k0 < n; k0 += LU_BLOCK_SIZE)
+            {
+                const size_t k1 = std::min<size_t>(n, k0 + LU_BLOCK_SIZE);
+                _factorize_panel(k0, k1);
+                if (k1 == n)
+                {
+                    break;
+                }
+
+                // U12 = L11^-1 A12, L11 unit lower, column ranges are independent
+                const size_t width = n - k1;
+                parallel_for(0, width, parallel_grain((k1 - k0) * (k1 - k0) / 2), [&](size_t from, size_t to)
+                {
+                    for (size_t i = k0 + 1; i < k1; i++)
+                    {
+                        T* row = lu + i * n + k1;
+                        for (size_t j = k0; j < i; j++)
+                        {
+                            const T l = lu[i * n + j];
+                            if (l == (T) 0)
+                            {
+                                continue;
+                            }
+
+                            const T* pivotRowData = lu + j * n + k1;
+                            for (size_t c = from; c < to; c++)
+                            {
+                                row[c] -= l * pivotRowData[c];
+                            }
+                        }
+                    }
+                });
+
+                // A22 -= L21 U12
+                Matrix<T> update(width, width);
+                T* u = update.get_data();
+                gemm(width, width, k1 - k0,
+                     lu + k1 * n + k0, n, 1,
+                     lu + k0 * n + k1, n, 1,
+                     u, width);
+
+                parallel_for(k1, n, parallel_grain(width), [&](size_t from, size_t to)
+                {
+                    for (size_t i = from; i < to; i++)
+                    {
+                        T* row = lu + i * n + k1;
+                        const T* updateRow = u + (i - k1) * width;
+                        for (size_t c = 0; c < width; c++)
+                        {
+                            row[c] -= updateRow[c];
+                        }
+                    }
+                });
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Factorizes columns k0 to k1, pivoting over all rows below and swapping whole rows
+        /// Only the columns of the panel are updated, the unblocked factorization is panel (0, n)
+        ///
+        /// @param k0 first column of the panel
+        /// @param k1 one past the last column of the panel
+        void _factorize_panel(const size_t& k0, const size_t& k1)
+        {
+            const size_t n = m_lu.getRowCount();
+            T* lu = m_lu.get_data();
+
+            for (size_t k = k0; k < k1; k++)
+            {
+                // find largest magnitude pivot in column k
+                size_t pivotRow = k;
+                double pivotAbs = scalar_abs(lu[k * n + k]);
+                for (size_t i = k + 1; i < n; i++)
+                {
+                    double curAbs = scalar_abs(lu[i * n + k]);
+                    if (curAbs > pivotAbs)
+                    {
+                        pivotAbs = curAbs;
+                        pivotRow = i;
+                    }
+                }
+
+                if (pivotAbs == 0)
+                {
+                    // column already eliminated, nothing to do but record singularity
+                    m_singular = true;
+                    continue;
+                }
+
+                if (pivotRow != k)
+                {
+                    std::swap_ranges(lu + k * n, lu + (k + 1) * n, lu + pivotRow * n);
+                    std::swap(m_perm[k], m_perm[pivotRow]);
+                    m_sign = -m_sign;
+                }
+
+                const T pivot = lu[k * n + k];
+                const T* pivotRowData = lu + k * n;
+
+                // rank 1 update of the trailing rows, inner loop is contiguous
+                // rows are independent so they are shared out across the pool
+                parallel_for(k + 1, n, parallel_grain(k1 - k), [&](size_t from, size_t to)
+                {
+                    for (size_t i = from; i < to; i++)
+                    {
+                        T* row = lu + i * n;
+                        const T factor = row[k] / pivot;
+                        row[k] = factor;
+
+                        if (factor == (T) 0)
+                        {
+                            continue;
+                        }
+
+                        for (size_t j = k + 1; j < k1; j++)
+                        {
+                            row[j] -= factor * pivotRowData[j];
+                        }
+                    }
+                });
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies right hand side rows into the output in permuted order
+        ///
+        /// @param src right hand side, row major with nrhs columns
+        /// @param nrhs number of right hand sides
+        /// @param dst output buffer, row major with nrhs columns
+        ///
+        /// @return dst
+        T* _permuted(const T* src, const size_t& nrhs, T* dst) const
+        {
+            const size_t n = m_lu.getRowCount();
+            for (size_t i = 0; i < n; i++)
+            {
+                std::copy(src + m_perm[i] * nrhs, src + (m_perm[i] + 1) * nrhs, dst + i * nrhs);
+            }
+            return dst;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Forward then back substitution over all right hand sides at once
+        ///
+        /// @param x permuted right hand sides, overwritten with the solutions
+        /// @param nrhs number of right hand sides
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        void _solve_in_place(T* x, const size_t& nrhs) const
+        {
+            if (m_singular)
+            {
+                throw std::invalid_argument("Matrix is singular, no unique solution exists");
+            }
+
+            const size_t n = m_lu.getRowCount();
+            const T* lu = m_lu.get_data();
+
+            // Ly = Pb, L has an implied unit diagonal, then Ux = y
+            triangular_solve(Triangle_t::LOWER, false, true, n, lu, n, x, nrhs);
+            triangular_solve(Triangle_t::UPPER, false, false, n, lu, n, x, nrhs);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies the pending corrections in update order, each
+        /// x -= w (v^T x) / (1 + v^T w) turns A_k-1^-1 b into A_k^-1 b
+        ///
+        /// @param x solutions of the factorized matrix, overwritten
+        /// @param nrhs number of right hand sides
+        void _apply_updates(T* x, const size_t& nrhs) const
+        {
+            const size_t n = m_lu.getRowCount();
+            for (size_t k = 0; k < m_upd_denom.size(); k++)
+            {
+                const T* v = m_upd_v.data() + k * n;
+                const T* w = m_upd_w.data() + k * n;
+                for (size_t c = 0; c < nrhs; c++)
+                {
+                    T dot = 0;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        dot += v[i] * x[i * nrhs + c];
+                    }
+
+                    const T coeff = dot / m_upd_denom[k];
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        x[i * nrhs + c] -= w[i] * coeff;
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Rebuilds A = P^T L U plus every pending correction and u v^T, then factorizes it
+        ///
+        /// @param u column vector of the new update
+        /// @param v row vector of the new update
+        void _refactorize(const T* u, const T* v)
+        {
+            const size_t n = m_lu.getRowCount();
+            const T* lu = m_lu.get_data();
+
+            Matrix<T> lower(n, n);
+            Matrix<T> upper(n, n);
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    lower.get_data()[i * n + j] = (j < i) ? lu[i * n + j] : ((i == j) ? (T) 1 : (T) 0);
+                    upper.get_data()[i * n + j] = (j < i) ? (T) 0 : lu[i * n + j];
+                }
+            }
+
+            const Matrix<T> product = lower % upper;
+            T* a = m_lu.get_data();
+            for (size_t i = 0; i < n; i++)
+            {
+                std::copy(product.get_data() + i * n, product.get_data() + (i + 1) * n, a + m_perm[i] * n);
+            }
+
+            for (size_t k = 0; k <= m_upd_denom.size(); k++)
+            {
+                const bool last = k == m_upd_denom.size();
+                const T* uk = last ? u : m_upd_u.data() + k * n;
+                const T* vk = last ? v : m_upd_v.data() + k * n;
+                for (size_t i = 0; i < n; i++)
+                {
+                    for (size_t j = 0; j < n; j++)
+                    {
+                        a[i * n + j] += uk[i] * vk[j];
+                    }
+                }
+            }
+
+            m_upd_u.clear();
+            m_upd_v.clear();
+            m_upd_w.clear();
+            m_upd_denom.clear();
+            m_sign = 1;
+            m_singular = false;
+            _factorize();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Euclidean norm of n elements
+        double _norm(const T* x) const
+        {
+            double sum = 0;
+            for (size_t i = 0; i < m_lu.getRowCount(); i++)
+            {
+                const double mag = scalar_abs(x[i]);
+                sum += mag * mag;
+            }
+            return std::sqrt(sum);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unit vector e_index of the factorized order
+        ///
+        /// @throws std::invalid_argument if index is out of range
+        Vector<T> _unit(const size_t& index) const
+        {
+            const size_t n = m_lu.getRowCount();
+            if (index >= n)
+            {
+                throw std::invalid_argument("Update index out of range");
+            }
+
+            Vector<T> outVec(n);
+            std::fill(outVec.get_data(), outVec.get_data() + n, (T) 0);
+            outVec.get_data()[index] = 1;
+            return outVec;
+        };
+};
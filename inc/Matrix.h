@@ -13,27 +13,87 @@
 #include <cstring>
 #include <cmath>
 #include <vector>
+#include <utility>
 
 #include "Vector.h"
+#include "View.h"
+#include "Storage.h"
+#include "Gemm.h"
+#include "Strassen.h"
+#include "Transpose.h"
+#include "Thread_Pool.h"
+#include "Expr.h"
+#include "Matrix_Fwd.h"
 #include "Complex_C.h"
 #include "Complex_P.h"
+#include "Complex_D.h"
 #include "Poly.h"
+#include "Scalar.h"
+#include "Reduce.h"
+#include "Device.h"
+#include "Profile.h"
 
-// Matrix inversion method to use by default
-// uncomment only one
-///--------------------------------------------------------
-#define INVERSE_QR_METHOD // fastest
-//#define INVERSE_ADJ_METHOD // slowest
-///--------------------------------------------------------
+/// @brief Matrix inversion strategies, selected at runtime through Matrix<T>::inverse
+enum class Inverse_Method_t
+{
+    AUTO,   // detects triangular, symmetric positive definite and banded structure, else LU
+    LU,     // partial pivoting LU
+    QR,     // QR decomposition
+    ADJ     // adjoint over determinant, slowest
+};
+
+/// @brief Which triangle of a matrix holds its values
+enum class Triangle_t
+{
+    LOWER,  // zero above the diagonal
+    UPPER   // zero below the diagonal
+};
+
+/// Matrix inversion method to use by default
+#define INVERSE_DEFAULT_METHOD Inverse_Method_t::AUTO
 
-/// Max number of QR interations to be used when calculating eigenvalues
+#ifndef BANDED_DISPATCH_RATIO
+/// Structure detection uses the banded LU when (kl + ku + 1) * ratio <= n
+#define BANDED_DISPATCH_RATIO 4
+#endif
+
+/// Max number of QR interations per eigenvalue before the eigen solver gives up
 #define MAX_QR_EIGEN_ITER 1000
-/// Limit for convergence
+/// Relative tolerance used to detect symmetric matrices for the eigen solver
 #define QR_CONVERGENCE_LIMIT 1e-12
 
+/// @brief Results of an eigenvalue solve
+struct Eigen_Result_t
+{
+    /// @brief eigenvalues, in order of their position on the reduced diagonal
+    std::vector<Complex_C_t> m_values;
+
+    /// @brief QR/QL iterations spent before each eigenvalue deflated (pairs share a count)
+    std::vector<size_t> m_iterations;
+
+    /// @brief total QR/QL iterations performed
+    size_t m_total_iterations = 0;
+
+    /// @brief false if any eigenvalue hit MAX_QR_EIGEN_ITER, unconverged values are left as the diagonal
+    bool m_converged = true;
+
+    /// @brief true if the symmetric (tridiagonal + QL) path was taken
+    bool m_symmetric = false;
+};
+
+template <typename T> class LU;
+template <typename T> class QR;
+template <typename T> class Eigen_Solver;
+template <typename T> class Triangular_Matrix;
+template <typename T> class Cholesky;
+template <typename T> class Banded_Matrix;
+template <typename T> class Banded_LU;
+template <typename T> class Refined_Solver;
+
 /// @brief Templated class for storing, acsessing and performing operations on a matrix of values
+/// Dimensions are set at run time, see Matrix_Fixed.h for the compile time sized Matrix<T, R, C>
 template <typename T>
-class Matrix
+class Matrix<T, MATRIX_DYNAMIC, MATRIX_DYNAMIC>
 {
     public:
         ///--------------------------------------------------------
@@ -59,7 +119,7 @@ class Matrix
             m_cols = cols;
             m_rows = rows;
 
-            m_data = new T[m_cols * m_rows];
+            m_data = storage_new<T>(m_cols * m_rows);
         };
 
         ///--------------------------------------------------------
@@ -93,7 +153,7 @@ class Matrix
             m_cols = colLen;
             m_rows = matData.size();
 
-            m_data = new T[m_cols * m_rows];
+            m_data = storage_new<T>(m_cols * m_rows);
             size_t row = 0;
             for (auto rowData : matData)
             {
@@ -117,15 +177,42 @@ class Matrix
             m_cols = mat.getColCount();
             m_rows = mat.getRowCount();
 
-            m_data = new T[m_cols * m_rows];
+            m_data = storage_new<T>(m_cols * m_rows);
             memcpy(m_data, mat.get_data(), m_rows * m_cols * sizeof(T));
         };
 
+        ///--------------------------------------------------------
+        /// @brief Move constructor, takes ownership of the other matrix's storage
+        ///
+        /// @note moved from matrix is left empty (0x0) and must only be destroyed or assigned to
+        ///
+        /// @param mat matrix to move from
+        Matrix<T>(Matrix<T>&& mat) noexcept
+        {
+            m_cols = mat.m_cols;
+            m_rows = mat.m_rows;
+            m_data = mat.m_data;
+
+            mat.m_cols = 0;
+            mat.m_rows = 0;
+            mat.m_data = nullptr;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor evaluating a lazy elementwise expression, see Expr.h
+        ///
+        /// @param expr expression to evaluate, in a single pass
+        template <typename E>
+        Matrix(const Expr_t<E>& expr) : Matrix(expr.self().rows(), expr.self().cols())
+        {
+            evaluate_expr(expr, m_data);
+        };
+
         ///--------------------------------------------------------
         /// @brief Destructor
         ~Matrix()
         {
-            delete[] m_data;
+            storage_delete(m_data, m_cols * m_rows);
         };
 
         /// @brief Assignment operator
@@ -133,16 +220,65 @@ class Matrix
         /// @return reference to assigned matrix
         Matrix<T>& operator=(Matrix<T> const& mat)
         {
+            // skip if being assigned to self
+            if (this == &mat)
+            {
+                return *this;
+            }
+
+            // reuse the existing array if the element count is unchanged
+            if (m_cols * m_rows != mat.getColCount() * mat.getRowCount())
+            {
+                storage_delete(m_data, m_cols * m_rows);
+                m_data = storage_new<T>(mat.getColCount() * mat.getRowCount());
+            }
+
             m_cols = mat.getColCount();
             m_rows = mat.getRowCount();
 
-            // assigned so data will already be present, delete old array to resize
-            delete[] m_data;
-            m_data = new T[m_cols * m_rows];
             memcpy(m_data, mat.get_data(), m_rows * m_cols * sizeof(T));
             return *this;
         }
 
+        ///--------------------------------------------------------
+        /// @brief Move assignment operator, swaps storage with the other matrix
+        ///
+        /// @param mat matrix object being moved from
+        ///
+        /// @return reference to assigned matrix
+        Matrix<T>& operator=(Matrix<T>&& mat) noexcept
+        {
+            std::swap(m_cols, mat.m_cols);
+            std::swap(m_rows, mat.m_rows);
+            std::swap(m_data, mat.m_data);
+            return *this;
+        }
+
+        ///--------------------------------------------------------
+        /// @brief Assignment from a lazy elementwise expression, see Expr.h
+        /// Evaluates in place when the dimensions already match
+        ///
+        /// @param expr expression to evaluate
+        ///
+        /// @return reference to assigned matrix
+        template <typename E>
+        Matrix<T>& operator=(const Expr_t<E>& expr)
+        {
+            const size_t rows = expr.self().rows();
+            const size_t cols = expr.self().cols();
+
+            // elements only ever read their own index, so evaluating over an operand is safe
+            if (rows != m_rows || cols != m_cols)
+            {
+                Matrix<T> outMat(expr);
+                *this = std::move(outMat);
+                return *this;
+            }
+
+            evaluate_expr(expr, m_data);
+            return *this;
+        }
+
         ///--------------------------------------------------------
         /// @brief Operator overload of +, implements matrix addition
         ///
@@ -159,10 +295,15 @@ class Matrix
             Matrix<T> outMat(m_rows, m_cols);
 
             // Can sum the memory regions as both have same dimensions
-            for (size_t i = 0; i < m_cols * m_rows; i++)
+            const T* rhs = mat.get_data();
+            T* out = outMat.get_data();
+            parallel_for(0, m_cols * m_rows, parallel_grain(1), [&](size_t from, size_t to)
             {
-                outMat.get_data()[i] = m_data[i] + mat.get_data()[i];
-            }
+                for (size_t i = from; i < to; i++)
+                {
+                    out[i] = m_data[i] + rhs[i];
+                }
+            });
 
             return outMat;
         }
@@ -183,10 +324,15 @@ class Matrix
             Matrix<T> outMat(m_rows, m_cols);
 
             // Can sub the memory regions as both have same dimensions
-            for (size_t i = 0; i < m_cols * m_rows; i++)
+            const T* rhs = mat.get_data();
+            T* out = outMat.get_data();
+            parallel_for(0, m_cols * m_rows, parallel_grain(1), [&](size_t from, size_t to)
             {
-                outMat.get_data()[i] = m_data[i] - mat.get_data()[i];
-            }
+                for (size_t i = from; i < to; i++)
+                {
+                    out[i] = m_data[i] - rhs[i];
+                }
+            });
 
             return outMat;
         }
@@ -207,10 +353,15 @@ class Matrix
             Matrix<T> outMat(m_rows, m_cols);
 
             // Can product the memory regions as both have same dimensions
-            for (size_t i = 0; i < m_cols * m_rows; i++)
+            const T* rhs = mat.get_data();
+            T* out = outMat.get_data();
+            parallel_for(0, m_cols * m_rows, parallel_grain(1), [&](size_t from, size_t to)
             {
-                outMat.get_data()[i] = m_data[i] * mat.get_data()[i];
-            }
+                for (size_t i = from; i < to; i++)
+                {
+                    out[i] = m_data[i] * rhs[i];
+                }
+            });
 
             return outMat;
         }
@@ -224,16 +375,23 @@ class Matrix
         {
             Matrix<T> outMat(m_rows, m_cols);
 
-            for (size_t i = 0; i < m_rows * m_cols; i++)
+            T* out = outMat.get_data();
+            parallel_for(0, m_rows * m_cols, parallel_grain(1), [&](size_t from, size_t to)
             {
-                outMat.get_data()[i] = m_data[i] / num;
-            }
+                for (size_t i = from; i < to; i++)
+                {
+                    out[i] = m_data[i] / num;
+                }
+            });
 
             return outMat;
         };
 
         ///--------------------------------------------------------
         /// @brief Operator overload of %, implements matrix cross product
+        /// float/double products with every dimension DEVICE_OFFLOAD_MIN_DIM and up run on the GPU
+        /// when available, see Device.h. Otherwise real floating point products with every
+        /// dimension 2 * STRASSEN_CUTOFF and up use Strassen-Winograd, see Strassen.h
         ///
         /// @param mat reference to rval matrix
         ///
@@ -245,22 +403,69 @@ class Matrix
                 throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
             }
 
-            Matrix<T> outMat(m_rows, mat.getColCount());
+            Profile_Scope_t profile(Profile_Op_t::PRODUCT, 2.0 * m_rows * mat.getColCount() * m_cols,
+                                    m_rows * mat.getColCount() * sizeof(T));
 
-            for (size_t i = 0; i < outMat.getRowCount(); i++)
+            if constexpr (device_scalar_v<T>)
             {
-                for (size_t j = 0; j < outMat.getColCount(); j++)
+                // big enough to be worth the transfers, see Device.h
+                if (device_offload_product(m_rows, mat.getColCount(), m_cols))
                 {
-                    T sum = 0;
-                    for (size_t idx = 0; idx < m_cols; idx++)
-                    {
-                        T product = get(i, idx) * mat.get(idx, j);
-                        sum += product;
-                    }
-                    outMat.set(i,j, sum);
+                    return (Device_Matrix<T>(*this, true) % Device_Matrix<T>(mat, true)).toMatrix();
                 }
             }
 
+            Matrix<T> outMat(m_rows, mat.getColCount());
+
+            // both operands are row major, so unit column stride and row stride of the width
+            strassen_gemm(m_rows, mat.getColCount(), m_cols,
+                 m_data, m_cols, 1,
+                 mat.get_data(), mat.getColCount(), 1,
+                 outMat.get_data(), outMat.getColCount());
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, multiplies by a view such as B.transposed()
+        /// The view's strides are handed to gemm so it is never copied out first
+        ///
+        /// @param view rval view, (p,n) for a (m,p) matrix
+        ///
+        /// @return result of dot product matricies
+        Matrix<T> operator%(const Block_View<const T>& view) const
+        {
+            return multiply(this->view(), view);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Multiplies two views, e.g. multiply(A.transposed(), B) for A^T B
+        /// Neither operand is materialized, gemm packs straight from their strides. Large
+        /// real floating point products use Strassen-Winograd as in operator%
+        ///
+        /// @param lview left hand view (m,p)
+        /// @param rview right hand view (p,n)
+        ///
+        /// @return (m,n) product
+        ///
+        /// @throws std::invalid_argument if the inner dimensions differ
+        static Matrix<T> multiply(const Block_View<const T>& lview, const Block_View<const T>& rview)
+        {
+            if (lview.getColCount() != rview.getRowCount())
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            Profile_Scope_t profile(Profile_Op_t::PRODUCT, 2.0 * lview.getRowCount() * rview.getColCount() * lview.getColCount(),
+                                    lview.getRowCount() * rview.getColCount() * sizeof(T));
+
+            Matrix<T> outMat(lview.getRowCount(), rview.getColCount());
+
+            strassen_gemm(lview.getRowCount(), rview.getColCount(), lview.getColCount(),
+                 lview.data(), lview.rowStride(), lview.colStride(),
+                 rview.data(), rview.rowStride(), rview.colStride(),
+                 outMat.get_data(), outMat.getColCount());
+
             return outMat;
         };
 
@@ -313,53 +518,194 @@ class Matrix
         {
             Matrix<T> outMat(m_rows, m_cols);
 
-            for (size_t i = 0; i < m_rows * m_cols; i++)
+            T* out = outMat.get_data();
+            parallel_for(0, m_rows * m_cols, parallel_grain(1), [&](size_t from, size_t to)
             {
-                outMat.get_data()[i] = m_data[i] * num;
-            }
+                for (size_t i = from; i < to; i++)
+                {
+                    out[i] = m_data[i] * num;
+                }
+            });
 
             return outMat;
         };
 
         ///--------------------------------------------------------
-        /// @brief Gets the value at the row col position
+        /// @brief Gets the value at the row col position, always bounds checked
         ///
         /// @param row to get value from
         /// @param col to get value from
         ///
         /// @returns value at given location
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
         T get(const size_t& row, const size_t& col) const
         {
             return m_data[_trans_coord(row, col)];
         };
 
         ///--------------------------------------------------------
-        /// @brief Sets the value at the row col position
+        /// @brief Sets the value at the row col position, always bounds checked
         ///
         /// @param row to set value at
         /// @param col to set value at
         /// @param val to set coordinate to
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
         void set(const size_t& row, const size_t& col, const T& val)
         {
             m_data[_trans_coord(row, col)] = val;
         };
 
+        ///--------------------------------------------------------
+        /// @brief Unchecked element access for inner loops, only bounds checked when
+        /// MATRIX_BOUNDS_CHECK is set (debug builds, see View.h)
+        ///
+        /// @param row of element
+        /// @param col of element
+        ///
+        /// @returns reference to element
+        T& operator()(const size_t& row, const size_t& col)
+        {
+#if MATRIX_BOUNDS_CHECK
+            return m_data[_trans_coord(row, col)];
+#else
+            return m_data[row * m_cols + col];
+#endif
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unchecked read only element access, only bounds checked when
+        /// MATRIX_BOUNDS_CHECK is set (debug builds, see View.h)
+        ///
+        /// @param row of element
+        /// @param col of element
+        ///
+        /// @returns const reference to element
+        const T& operator()(const size_t& row, const size_t& col) const
+        {
+#if MATRIX_BOUNDS_CHECK
+            return m_data[_trans_coord(row, col)];
+#else
+            return m_data[row * m_cols + col];
+#endif
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of a row, reads and writes the matrix in place
+        ///
+        /// @param row row to view
+        ///
+        /// @return view of row [row], left to right
+        ///
+        /// @throws std::invalid_argument if row is out of bounds
+        Strided_View<T> row(const size_t& row)
+        {
+            return Strided_View<T>(m_data + _trans_coord(row, 0), m_cols, 1);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Read only view of a row
+        ///
+        /// @param row row to view
+        ///
+        /// @return view of row [row], left to right
+        ///
+        /// @throws std::invalid_argument if row is out of bounds
+        Strided_View<const T> row(const size_t& row) const
+        {
+            return Strided_View<const T>(m_data + _trans_coord(row, 0), m_cols, 1);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of a column, reads and writes the matrix in place
+        ///
+        /// @param col column to view
+        ///
+        /// @return view of column [col], top to bottom
+        ///
+        /// @throws std::invalid_argument if col is out of bounds
+        Strided_View<T> col(const size_t& col)
+        {
+            return Strided_View<T>(m_data + _trans_coord(0, col), m_rows, m_cols);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Read only view of a column
+        ///
+        /// @param col column to view
+        ///
+        /// @return view of column [col], top to bottom
+        ///
+        /// @throws std::invalid_argument if col is out of bounds
+        Strided_View<const T> col(const size_t& col) const
+        {
+            return Strided_View<const T>(m_data + _trans_coord(0, col), m_rows, m_cols);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of the leading diagonal, reads and writes the matrix in place
+        ///
+        /// @return view of the min(m,n) diagonal elements
+        Strided_View<T> diag()
+        {
+            return Strided_View<T>(m_data, std::min(m_rows, m_cols), m_cols + 1);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Read only view of the leading diagonal
+        ///
+        /// @return view of the min(m,n) diagonal elements
+        Strided_View<const T> diag() const
+        {
+            return Strided_View<const T>(m_data, std::min(m_rows, m_cols), m_cols + 1);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of a sub-block, reads and writes the matrix in place
+        ///
+        /// @param row top row of the block
+        /// @param col left column of the block
+        /// @param rows number of rows in the block
+        /// @param cols number of columns in the block
+        ///
+        /// @return view of the block
+        ///
+        /// @throws std::invalid_argument if the block does not fit within the matrix
+        Block_View<T> block(const size_t& row, const size_t& col, const size_t& rows, const size_t& cols)
+        {
+            return view().block(row, col, rows, cols);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Read only view of a sub-block
+        ///
+        /// @param row top row of the block
+        /// @param col left column of the block
+        /// @param rows number of rows in the block
+        /// @param cols number of columns in the block
+        ///
+        /// @return view of the block
+        ///
+        /// @throws std::invalid_argument if the block does not fit within the matrix
+        Block_View<const T> block(const size_t& row, const size_t& col, const size_t& rows, const size_t& cols) const
+        {
+            return view().block(row, col, rows, cols);
+        };
+
         ///--------------------------------------------------------
         /// @brief Sets values for an entire row, rowData must have same length as matrix width
         ///
         /// @param row row to overwrite
         /// @param rowData data for row write
-        void setRow(const size_t& row, const std::vector<T> rowData)
+        void setRow(const size_t& row, const std::vector<T>& rowData)
         {
             if (rowData.size() != m_cols)
             {
                 throw std::invalid_argument("Row set vector length must be same as matrix width");
             }
 
-            for(size_t i = 0; i < m_cols; i++)
-            {
-                set(row, i, rowData.at(i));
-            }
+            this->row(row).assign(rowData);
         };
 
         ///--------------------------------------------------------
@@ -368,17 +714,14 @@ class Matrix
         ///
         /// @param row row to overwrite
         /// @param rowData data for row write
-        void setRow(const size_t& row, const Vector<T> rowData)
+        void setRow(const size_t& row, const Vector<T>& rowData)
         {
             if (rowData.size() != m_cols)
             {
                 throw std::invalid_argument("Row set vector length must be same as matrix width");
             }
 
-            for(size_t i = 0; i < m_cols; i++)
-            {
-                set(row, i, rowData.get(i));
-            }
+            this->row(row).assign(rowData);
         };
 
         ///--------------------------------------------------------
@@ -386,17 +729,14 @@ class Matrix
         ///
         /// @param col column to overwrite
         /// @param colData data for column write
-        void setCol(const size_t& col, const std::vector<T> colData)
+        void setCol(const size_t& col, const std::vector<T>& colData)
         {
             if (colData.size() != m_rows)
             {
                 throw std::invalid_argument("Column set vector length must be same as matrix hieght");
             }
 
-            for(size_t i = 0; i < m_rows; i++)
-            {
-                set(i, col, colData.at(i));
-            }
+            this->col(col).assign(colData);
         };
 
         ///--------------------------------------------------------
@@ -404,17 +744,14 @@ class Matrix
         ///
         /// @param col column to overwrite
         /// @param colData data for column write
-        void setCol(const size_t& col, const Vector<T> colData)
+        void setCol(const size_t& col, const Vector<T>& colData)
         {
             if (colData.size() != m_rows)
             {
                 throw std::invalid_argument("Column set vector length must be same as matrix hieght");
             }
 
-            for(size_t i = 0; i < m_rows; i++)
-            {
-                set(i, col, colData.get(i));
-            }
+            this->col(col).assign(colData);
         };
 
         ///--------------------------------------------------------
@@ -449,89 +786,110 @@ class Matrix
         ///--------------------------------------------------------
         /// @brief Reads the requested row from the matrix and return left to right
         ///
+        /// @note copies, use row() to work on the matrix in place
+        ///
         /// @param row row to read and return
         ///
         /// @return contents of row [row]
         std::vector<T> getRow(const size_t& row) const
         {
-            std::vector<T> outRow(m_cols);
-
-            for (size_t i = 0; i < m_cols; i++)
-            {
-                outRow.at(i) = get(row, i);
-            }
-
-            return outRow;
+            return this->row(row).toStdVector();
         };
 
         ///--------------------------------------------------------
         /// @brief Reads the requested column from the matrix and return top to bottom
         ///
+        /// @note copies, use col() to work on the matrix in place
+        ///
         /// @param col column to read and return
         ///
         /// @return contents of column [col]
         std::vector<T> getCol(const size_t& col) const
         {
-            std::vector<T> outCol(m_rows);
-
-            for (size_t i = 0; i < m_rows; i++)
-            {
-                outCol.at(i) = get(i, col);
-            }
-
-            return outCol;
+            return this->col(col).toStdVector();
         };
 
         ///--------------------------------------------------------
         /// @brief Reads the requested row from the matrix and return left to right, returns in vector obj form
         ///
+        /// @note copies, use row() to work on the matrix in place
+        ///
         /// @param row row to read and return
         ///
         /// @return contents of row [row], returned as matrix
-        Vector<T> getRowVec(const size_t& row)
+        Vector<T> getRowVec(const size_t& row) const
         {
-            Vector<T> outVec(m_cols);
-            for (size_t i = 0; i < m_cols; i++)
-            {
-                outVec.set(i, get(row, i));
-            }
-            return outVec;
+            return this->row(row).toVector();
         };
 
         ///--------------------------------------------------------
         /// @brief Reads the requested column from the matrix and return top to bottom, returns in vector obj form
         ///
+        /// @note copies, use col() to work on the matrix in place
+        ///
         /// @param row column to read and return
         ///
         /// @return contents of column [col], returned as matrix
         Vector<T> getColVec(const size_t& col) const
         {
-            Vector<T> outVec(m_rows);
-            for (size_t i = 0; i < m_rows; i++)
-            {
-                outVec.set(i, get(i, col));
-            }
-            return outVec;
+            return this->col(col).toVector();
         };
 
         ///--------------------------------------------------------
         /// @brief Create the transpose of the matrix
+        /// Blocked copy, see Transpose.h. Use transposed() to skip the copy when
+        /// the result is only multiplied, or transpose_inplace() to skip the allocation
         ///
         /// @return the transposed form of the matrix
         Matrix<T> transpose() const
         {
             // Create matrix with transposed dimensions
             Matrix<T> transposeMat(m_cols, m_rows);
+            transpose_copy(m_rows, m_cols, m_data, m_cols, transposeMat.get_data(), m_rows);
+            return transposeMat;
+        };
 
-            for (size_t i = 0; i < m_rows; i++)
+        ///--------------------------------------------------------
+        /// @brief Transposes the matrix in place
+        /// Square matrices are swapped tile by tile without allocating, other shapes
+        /// fall back to a transposed copy
+        void transpose_inplace()
+        {
+            if (m_rows == m_cols)
             {
-                for (size_t j = 0; j < m_cols; j++)
-                {
-                    transposeMat.set(j, i, get(i,j));
-                }
+                transpose_square_inplace(m_rows, m_data, m_cols);
+                return;
             }
 
-            return transposeMat;
+            *this = transpose();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of the whole matrix, reads and writes the matrix in place
+        ///
+        /// @return (m,n) view
+        Block_View<T> view()
+        {
+            return Block_View<T>(m_data, m_rows, m_cols, m_cols);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Read only view of the whole matrix
+        ///
+        /// @return (m,n) view
+        Block_View<const T> view() const
+        {
+            return Block_View<const T>(m_data, m_rows, m_cols, m_cols);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Read only transposed view, only the strides are swapped so nothing is copied
+        /// Pass to operator%/multiply to have gemm read the transpose directly
+        ///
+        /// @return (n,m) view of the transpose
+        Block_View<const T> transposed() const
+        {
+            return view().transposed();
         };
 
         ///--------------------------------------------------------
@@ -565,7 +923,7 @@ class Matrix
                         continue;
                     }
 
-                    outMat.set(i - rowSkip, j - colSkip, get(i, j));
+                    outMat(i - rowSkip, j - colSkip) = (*this)(i, j);
                 }
             }
 
@@ -622,38 +980,188 @@ class Matrix
                 return get(0,0);
             }
 
-            size_t workingRow = _find_zeros_row();
+            // the diagonal product is exact for every type, so check this before the integer path
+            if (isUpperTriangular() || isLowerTriangular())
+            {
+                T det = (T) 1;
+                for (size_t i = 0; i < m_rows; i++)
+                {
+                    det *= m_data[i * m_cols + i];
+                }
+                return det;
+            }
 
-            T det = 0;
-            for (size_t j = 0; j < m_cols; j++)
+            // integer types would truncate during elimination, factorize a double copy and round
+            if constexpr (std::is_integral_v<T>)
             {
-                if (get(workingRow, j) != 0)
+                typedef std::conditional_t<std::is_integral_v<T>, double, T> Factor_t;
+
+                Matrix<Factor_t> dblMat(m_rows, m_cols);
+                for (size_t i = 0; i < m_rows * m_cols; i++)
                 {
-                    T res = get(workingRow, j) * cofactor(workingRow, j);
-                    det += res;
+                    dblMat.get_data()[i] = (Factor_t) m_data[i];
                 }
+                return (T) std::llround(LU<Factor_t>(dblMat).determinant());
             }
+            else
+            {
+                size_t lower, upper;
+                if (_is_narrow_band(lower, upper))
+                {
+                    return Banded_LU<T>(Banded_Matrix<T>(*this, lower, upper)).determinant();
+                }
+
+                if constexpr (device_scalar_v<T>)
+                {
+                    if (device_offload_order(m_rows))
+                    {
+                        return Device_Matrix<T>(*this, true).determinant();
+                    }
+                }
+
+                if (_has_positive_diagonal() && isSymmetric())
+                {
+                    Cholesky<T> chol(*this);
+                    if (chol.isPositiveDefinite())
+                    {
+                        return chol.determinant();
+                    }
+                }
 
-            return det;
+                return LU<T>(*this).determinant();
+            }
         };
 
         ///--------------------------------------------------------
-        /// @brief Calculates the adjoint matrix
+        /// @brief Is every element below the diagonal exactly zero?
         ///
-        /// @returns the adjoint matrix of the matrix
-        Matrix<T> adjoint()
+        /// @return true if square and upper triangular
+        bool isUpperTriangular() const
         {
-            Matrix<T> outMat(m_rows, m_cols);
+            if (m_rows != m_cols)
+            {
+                return false;
+            }
 
-            for (size_t i = 0; i < m_rows; i++)
+            for (size_t i = 1; i < m_rows; i++)
             {
-                for (size_t j = 0; j < m_cols; j++)
+                const T* row = m_data + i * m_cols;
+                for (size_t j = 0; j < i; j++)
                 {
-                    outMat.set(i,j, cofactor(i,j));
+                    if (row[j] != (T) 0)
+                    {
+                        return false;
+                    }
                 }
             }
-
-            return outMat.transpose();
+            return true;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is every element above the diagonal exactly zero?
+        ///
+        /// @return true if square and lower triangular
+        bool isLowerTriangular() const
+        {
+            if (m_rows != m_cols)
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i + 1 < m_rows; i++)
+            {
+                const T* row = m_data + i * m_cols;
+                for (size_t j = i + 1; j < m_cols; j++)
+                {
+                    if (row[j] != (T) 0)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is the matrix exactly symmetric (Hermitian for complex types)?
+        ///
+        /// @return true if square and A = A^H
+        bool isSymmetric() const
+        {
+            if (m_rows != m_cols)
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j <= i; j++)
+                {
+                    if (m_data[i * m_cols + j] != scalar_conj(m_data[j * m_cols + i]))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Finds the number of non-zero sub and super diagonals
+        ///
+        /// @return pair of <kl, ku>
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        std::pair<size_t, size_t> bandwidth() const
+        {
+            if (m_rows != m_cols)
+            {
+                throw std::invalid_argument("Matrix must be square to have a bandwidth");
+            }
+
+            size_t lower = 0, upper = 0;
+            _band_scan(lower, upper, m_cols);
+            return std::make_pair(lower, upper);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the adjoint matrix
+        /// Non-singular matrices above 3x3 use adj(A) = det(A) * A^-1 from one LU factorization,
+        /// otherwise falls back to cofactor expansion
+        ///
+        /// @returns the adjoint matrix of the matrix
+        Matrix<T> adjoint()
+        {
+            if constexpr (!std::is_integral_v<T>)
+            {
+                if (m_rows == m_cols && m_cols > 3)
+                {
+                    LU<T> lu(*this);
+                    if (!lu.isSingular())
+                    {
+                        const T det = lu.determinant();
+                        Matrix<T> outMat = lu.inverse();
+                        for (size_t i = 0; i < m_rows * m_cols; i++)
+                        {
+                            outMat.get_data()[i] *= det;
+                        }
+                        return outMat;
+                    }
+                }
+            }
+
+            Matrix<T> outMat(m_rows, m_cols);
+
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < m_cols; j++)
+                {
+                    outMat.set(i,j, cofactor(i,j));
+                }
+            }
+
+            outMat.transpose_inplace();
+            return outMat;
         };
 
         ///--------------------------------------------------------
@@ -673,73 +1181,135 @@ class Matrix
 
         ///--------------------------------------------------------
         /// @brief Calculate the inverse matrix, uses QR method
+        /// Solves R X = Q^H with Q applied implicitly, Q is never formed
         ///
         /// @return the inverse matrix
-        Matrix<T> inverse_qr()
+        Matrix<T> inverse_qr() const
         {
-            auto [Q_mat, R_mat] = qr_decompose();
-            return R_mat.inverse_adj() % Q_mat.transpose();
+            return QR<T>(*this).inverse();
         };
 
         ///--------------------------------------------------------
-        /// @brief Calculate the inverse matrix, uses QR method by default
+        /// @brief Calculate the inverse matrix, uses partial pivoting LU factorization
+        /// Runs on the GPU for float/double of order DEVICE_OFFLOAD_MIN_ORDER and up, see Device.h
         ///
         /// @return the inverse matrix
-        Matrix<T> inverse()
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        Matrix<T> inverse_lu() const
         {
-            #ifdef INVERSE_QR_METHOD
-            return inverse_qr();
-            #endif
+            if constexpr (device_scalar_v<T>)
+            {
+                if (m_rows == m_cols && device_offload_order(m_rows))
+                {
+                    return Device_Matrix<T>(*this, true).inverse().toMatrix();
+                }
+            }
+
+            LU<T> lu(*this);
+            if (lu.isSingular())
+            {
+                throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+            }
 
-            #ifdef INVERSE_ADJ_METHOD
-            return inverse_adj();
-            #endif
+            return lu.inverse();
         };
 
         ///--------------------------------------------------------
-        /// @brief Performs QR decomposition on the matrix
+        /// @brief Calculate the inverse matrix, picks the factorization from the structure present
+        /// Triangular matrices back substitute, narrow banded ones use the banded LU and
+        /// symmetric positive definite ones Cholesky, anything else uses inverse_lu()
         ///
-        /// @return Pair of <Q, R> matricies
-        /// Q will be under .first, R under .second
-        std::pair<Matrix<T>, Matrix<T>> qr_decompose() const
+        /// @return the inverse matrix
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        Matrix<T> inverse_auto() const
         {
-            Matrix<T> Q_mat(m_rows, m_cols);
-            Matrix<T> R_mat(m_rows, m_cols);
-
-            // Start with Q matrix
-            // Create list of previous orthogonal components
-            std::vector<Vector<T>> prevOrthoComps;
-            for (size_t i = 0; i < m_cols; i++)
+            if constexpr (!std::is_integral_v<T>)
             {
-                Vector<T> q_vec = getColVec(i);
-                // subtract inner products of previous orthogonal components
-                for (size_t j = i; j > 0; j--)
+                if (m_rows == m_cols)
                 {
-                    q_vec = q_vec - (prevOrthoComps[j - 1] * (q_vec * prevOrthoComps[j - 1]));
+                    if (isUpperTriangular())
+                    {
+                        return Triangular_Matrix<T>(*this, Triangle_t::UPPER).inverse().toMatrix();
+                    }
+                    if (isLowerTriangular())
+                    {
+                        return Triangular_Matrix<T>(*this, Triangle_t::LOWER).inverse().toMatrix();
+                    }
+
+                    size_t lower, upper;
+                    if (_is_narrow_band(lower, upper))
+                    {
+                        Banded_LU<T> lu{Banded_Matrix<T>(*this, lower, upper)};
+                        if (lu.isSingular())
+                        {
+                            throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+                        }
+                        return lu.inverse();
+                    }
+
+                    // an indefinite matrix is only found partway through, fall through to the general paths
+                    if (_has_positive_diagonal() && isSymmetric())
+                    {
+                        Cholesky<T> chol(*this);
+                        if (chol.isPositiveDefinite())
+                        {
+                            return chol.inverse();
+                        }
+                    }
                 }
-                prevOrthoComps.push_back(q_vec.normalize());
             }
 
-            // create matrix out of calculated ortogonal components
-            for(size_t i = 0; i < prevOrthoComps.size(); i++)
+            return inverse_lu();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculate the inverse matrix
+        ///
+        /// @param method inversion strategy, INVERSE_DEFAULT_METHOD if not given
+        ///
+        /// @return the inverse matrix
+        Matrix<T> inverse(const Inverse_Method_t& method = INVERSE_DEFAULT_METHOD)
+        {
+            switch (method)
             {
-                Q_mat.setCol(i, prevOrthoComps[i]);
-            }
+                case Inverse_Method_t::AUTO:
+                    return inverse_auto();
 
-            // Use Q to create R: (Q^T)A = (Q^T)(QR) = (I)R = R
-            R_mat = Q_mat.transpose() % *this;
+                case Inverse_Method_t::QR:
+                    return inverse_qr();
 
-            // clean out double innaccuracy in lower R triangle by zeroing elements
-            for (size_t row = 1; row < m_rows; row++)
-            {
-                for(size_t col = 0; col < m_cols; col++)
-                {
-                    R_mat.set(row, col, (T)0);
-                    if (col == row - 1) break;
-                }
+                case Inverse_Method_t::ADJ:
+                    return inverse_adj();
+
+                case Inverse_Method_t::LU:
+                default:
+                    return inverse_lu();
             }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Performs QR decomposition on the matrix, uses Householder reflections
+        /// For (m,n) matrices Q is (m,k) and R is (k,n), with k = min(m,n)
+        ///
+        /// @note use the QR object directly (QR.h) to keep Q implicit
+        ///
+        /// @return Pair of <Q, R> matricies
+        /// Q will be under .first, R under .second
+        std::pair<Matrix<T>, Matrix<T>> qr_decompose() const
+        {
+            QR<T> qr(*this);
+            return {qr.Q(), qr.R()};
+        };
 
-            return {Q_mat, R_mat};
+        ///--------------------------------------------------------
+        /// @brief Performs QR decomposition on the matrix and only returns R
+        ///
+        /// @return upper triangular R matrix
+        Matrix<T> qr_r() const
+        {
+            return QR<T>(*this).R();
         };
 
         ///--------------------------------------------------------
@@ -764,138 +1334,150 @@ class Matrix
         };
 
         ///--------------------------------------------------------
-        /// @brief Creates a normalized version of all values in the matrix
+        /// @brief Creates a normalized version of all values in the matrix, divided by the
+        /// Frobenius norm in one reducing and one scaling pass. A zero matrix is returned unchanged
         ///
         /// @return normalized matrix
-        Matrix<T> normalize()
+        Matrix<T> normalize() const
         {
-            T sum = 0;
-            for (size_t i = 0; i < m_rows * m_cols; i++)
-            {
-                // do not replace with pow, need to account for custom types
-                sum += get_data()[i] * get_data()[i];
-            }
-
-            // chooses which routine to compile depending on complex type
-            if constexpr (std::is_same_v<T, Complex_C_t>)
-            {
-                sum = powReal(sum, 0.5);
-            }
-            else if constexpr (std::is_same_v<T, Complex_P_t>)
-            {
-                sum = powReal(sum, 0.5);
-            }
-            else
-            {
-                sum = std::sqrt(sum);
-            }
+            Matrix<T> outMat(m_rows, m_cols);
+            reduce_normalize(m_rows * m_cols, m_data, outMat.get_data());
+            return outMat;
+        }
 
-            return *this / sum;
+        ///--------------------------------------------------------
+        /// @brief Normalizes all values in the matrix in place, see normalize
+        ///
+        /// @return Frobenius norm the matrix had before scaling
+        double normalizeInPlace()
+        {
+            return reduce_normalize(m_rows * m_cols, m_data, m_data);
         }
 
         ///--------------------------------------------------------
-        /// @brief Calculates eigenvalues for the matrix, matrix must be square
-        /// Uses QR convergence
-        /// max iteration number defined by MAX_QR_EIGEN_ITER
-        /// convergence limit defined by
+        /// @brief Sums every value in the matrix
         ///
-        /// TODO: fix this function, does not work currently
+        /// @return sum of all values
+        T sum() const
+        {
+            return reduce_sum(m_rows * m_cols, m_data);
+        }
+
+        ///--------------------------------------------------------
+        /// @brief Finds the Frobenius norm, sqrt of the sum of every |value|^2
         ///
-        /// @return vector list of eigen values (convergence not guarenteed)
-        std::vector<T> eigenvalues() const
+        /// @return Frobenius norm
+        double frobeniusNorm() const
         {
-            if (m_cols != m_rows)
-            {
-                throw std::invalid_argument("Matrix must be square to have eigenvalues");
-            }
+            return reduce_norm2(m_rows * m_cols, m_data);
+        }
 
-            auto QR_mat = this->qr_decompose();
-            auto mat = QR_mat.second % QR_mat.first;
+        ///--------------------------------------------------------
+        /// @brief Finds the 1-norm, the largest column sum of magnitudes
+        ///
+        /// @return 1-norm
+        double norm1() const
+        {
+            return reduce_norm_1(m_rows, m_cols, m_data, m_cols);
+        }
 
-            // get diagonals for convergence checking
-            std::vector<T> last_vals(m_cols);
-            for (size_t i = 0; i < m_cols; i++)
-            {
-                last_vals.at(i) = get(i,i);
-            }
+        ///--------------------------------------------------------
+        /// @brief Finds the infinity-norm, the largest row sum of magnitudes
+        ///
+        /// @return infinity-norm
+        double normInf() const
+        {
+            return reduce_norm_inf(m_rows, m_cols, m_data, m_cols);
+        }
 
-            bool converged = false;
-            size_t iter_count = 1;
+        ///--------------------------------------------------------
+        /// @brief Finds the largest magnitude of any value
+        ///
+        /// @return largest magnitude
+        double maxAbs() const
+        {
+            return reduce_max_abs(m_rows * m_cols, m_data);
+        }
 
-            while(!converged && (iter_count < MAX_QR_EIGEN_ITER))
-            {
-                QR_mat = mat.qr_decompose();
-                mat = QR_mat.second % QR_mat.first;
+        ///--------------------------------------------------------
+        /// @brief Counts the values that are exactly zero
+        ///
+        /// @return number of zeros
+        size_t countZeros() const
+        {
+            return reduce_count_zeros(m_rows * m_cols, m_data);
+        }
 
-                std::vector<T> cur_vals(m_cols);
-                for (size_t i = 0; i < m_cols; i++)
-                {
-                    cur_vals.at(i) = mat.get(i,i);
-                }
+        ///--------------------------------------------------------
+        /// @brief Runs the eigenvalue solver, matrix must be square
+        /// Reduces to Hessenberg (or tridiagonal if real symmetric) form then runs
+        /// shifted implicit QR, max iterations per eigenvalue defined by MAX_QR_EIGEN_ITER
+        ///
+        /// @return eigenvalues with iteration counts and convergence status
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Eigen_Result_t eigen_solve() const
+        {
+            return Eigen_Solver<T>(*this).result();
+        }
 
-                converged = true;
-                for(size_t i = 0; i < cur_vals.size(); i++)
+        ///--------------------------------------------------------
+        /// @brief Calculates eigenvalues for the matrix as complex numbers, matrix must be square
+        /// Complex conjugate pairs of real matrices are both listed. Large float/double symmetric
+        /// matrices are solved on the GPU when available, see Device.h
+        ///
+        /// @return vector list of eigen values (convergence not guarenteed)
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        std::vector<Complex_C_t> eigenvalues_complex() const
+        {
+            if constexpr (device_scalar_v<T>)
+            {
+                // the device solver only covers the symmetric case, its values come in ascending order
+                if (m_rows == m_cols && device_offload_order(m_rows) && isSymmetric())
                 {
-                    if constexpr (std::is_same_v<T, Complex_C_t>)
-                    {
-                        if ((last_vals.at(i) - cur_vals.at(i)).absolute() > QR_CONVERGENCE_LIMIT)
-                        {
-                            converged = false;
-                            break;
-                        }
-                    }
-                    else if constexpr (std::is_same_v<T, Complex_P_t>)
-                    {
-                        if (std::abs((last_vals.at(i) - cur_vals.at(i)).real()) > QR_CONVERGENCE_LIMIT)
-                        {
-                            converged = false;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        // by default attempts to use the std abs, for user-defined types add another 'if constexpr'
-                        if (std::abs(last_vals.at(i) - cur_vals.at(i)) > QR_CONVERGENCE_LIMIT)
-                        {
-                            converged = false;
-                            break;
-                        }
-                    }
+                    const std::vector<T> vals = Device_Matrix<T>(*this, true).eigenvalues_symmetric();
+                    return std::vector<Complex_C_t>(vals.begin(), vals.end());
                 }
-
-                last_vals = cur_vals;
-                iter_count++;
             }
 
-            return last_vals;
+            return eigen_solve().m_values;
         }
 
         ///--------------------------------------------------------
-        /// @brief Calculates eigenvectors for the matrix, matrix must be square
+        /// @brief Calculates eigenvalues for the matrix, matrix must be square
+        /// Real types keep only the real component of complex eigenvalues, use
+        /// eigenvalues_complex() to see them in full
+        ///
+        /// @return vector list of eigen values (convergence not guarenteed)
         ///
-        /// @return list of eigenvectors
-        std::vector<Vector<T>> eigenvectors() const
+        /// @throws std::invalid_argument if matrix is not square
+        std::vector<T> eigenvalues() const
         {
-            Vector<T> e_vals = eigenvalues();
-            std::vector<Vector<T>> e_vecs;
+            const std::vector<Complex_C_t> vals = eigenvalues_complex();
 
-            // Create list of zeros for solutions
-            Vector<T> zeros(e_vals.size());
-            for (size_t i = 0; i < e_vals.size(); i++)
+            std::vector<T> outVals(vals.size());
+            for (size_t i = 0; i < vals.size(); i++)
             {
-                zeros.set(i, 0);
+                outVals[i] = scalar_from_complex<T>(vals[i]);
             }
 
-            for (size_t i = 0; i < e_vals.size(); i++)
-            {
-                // Create the eigenvalue subtracted matrix
-                Matrix<T> eval_sub_mat = *this - (Matrix<T>::identity(m_cols) * e_vals.get(i));
-
-                // get derivation from all zeros solution
-                e_vecs.push_back(eval_sub_mat.derive_var(zeros));
-            }
+            return outVals;
+        }
 
-            return e_vecs;
+        ///--------------------------------------------------------
+        /// @brief Calculates eigenvectors for the matrix, matrix must be square
+        /// Uses inverse iteration on the reduced form found by the eigen solver,
+        /// column j is the unit eigenvector of eigenvalues()[j]. For real types a
+        /// complex conjugate pair at j, j+1 stores the real part in column j and
+        /// the imaginary part in column j+1
+        ///
+        /// @return matrix of eigenvectors as columns
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Matrix<T> eigenvectors() const
+        {
+            return Eigen_Solver<T>(*this).eigenvectors();
         }
 
         ///--------------------------------------------------------
@@ -917,47 +1499,40 @@ class Matrix
                 throw std::invalid_argument("Incorrect number of solutions");
             }
 
+            Profile_Scope_t profile(Profile_Op_t::RREF, 2.0 * m_rows * m_rows * (m_cols + 1),
+                                    m_rows * (m_cols + 1) * sizeof(T));
+
             // create augmented matrix with zeros row
             Matrix<T> augmented_mat(m_rows, m_cols + 1);
-            for (size_t row = 0; row < m_rows; row++)
-            {
-                for (size_t col = 0; col < m_cols; col++)
-                {
-                    augmented_mat.set(row, col, get(row, col));
-                }
-                augmented_mat.set(row, m_cols, solutions.get(row));
-            }
+            augmented_mat.block(0, 0, m_rows, m_cols).assign(*this);
+            augmented_mat.col(m_cols).assign(solutions);
 
             // multiply first row to make first pivot 1
-            Vector<T> last_row = augmented_mat.getRowVec(0);
-            last_row = last_row * (1 / last_row.get(0));
-            augmented_mat.setRow(0, last_row);
+            augmented_mat.row(0).scale(1 / augmented_mat(0, 0));
 
             // guassian eliminate matrix into reduced row echelon form
-            // col is the current pivot
+            // col is the current pivot, rows are updated in place through views
             for (size_t col = 0; col < m_cols; col++)
             {
-                last_row = augmented_mat.getRowVec(col);
+                const Strided_View<const T> last_row = augmented_mat.row(col);
 
                 // use the last row to reduce [row] variables to zero
                 for (size_t row = 1 + col; row < m_rows; row++)
                 {
-                    Vector<T> cur_row = augmented_mat.getRowVec(row);
-                    cur_row = cur_row - (last_row * cur_row.get(col));
-                    cur_row = cur_row * (1 / cur_row.get(col+1));
-                    augmented_mat.setRow(row, cur_row);
+                    Strided_View<T> cur_row = augmented_mat.row(row);
+                    cur_row.axpy(-cur_row[col], last_row);
+                    cur_row.scale(1 / cur_row[col+1]);
                 }
             }
 
             // work backwards to reduce all non-pivot points to zero
             for (int row = m_rows - 2; row >= 0; row--)
             {
-                last_row = augmented_mat.getRowVec(row + 1);
+                const Strided_View<const T> last_row = augmented_mat.row(row + 1);
                 for (int sub_row = row; sub_row >= 0; sub_row--)
                 {
-                    Vector<T> cur_row = augmented_mat.getRowVec(sub_row);
-                    cur_row = cur_row - last_row * cur_row.get(row+1);
-                    augmented_mat.setRow(sub_row, cur_row);
+                    Strided_View<T> cur_row = augmented_mat.row(sub_row);
+                    cur_row.axpy(-cur_row[row+1], last_row);
                 }
             }
 
@@ -979,6 +1554,20 @@ class Matrix
             return derivations;
         }
 
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b by a float factorization refined to double accuracy, see Refine.h
+        /// Falls back to a double factorization if refinement stalls
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if matrix is not square, sizes mismatch or matrix is singular
+        Vector<T> solve_refined(const Vector<T>& solutions) const
+        {
+            return Refined_Solver<T>(*this).solve(solutions);
+        }
+
         ///--------------------------------------------------------
         /// @brief Creates an identity matrix of size len
         ///
@@ -988,26 +1577,15 @@ class Matrix
         static Matrix<T> identity(const size_t& len)
         {
             Matrix<T> id(len, len);
-            for (size_t i = 0; i < len; i++)
-            {
-                for (size_t j = 0; j < len; j++)
-                {
-                    if (i==j)
-                    {
-                        id.set(i,j, (T) 1);
-                    }
-                    else
-                    {
-                        id.set(i,j, (T) 0);
-                    }
-                }
-            }
+            id.block(0, 0, len, len).fill((T) 0);
+            id.diag().fill((T) 1);
 
             return id;
         }
 
     private:
         /// @brief Stores all matrix values, one dimensional to exploit memory adjacency benifits
+        /// Aligned and pooled, see Storage.h
         T* m_data;
 
         /// @brief the number of columns in the matrix
@@ -1037,78 +1615,99 @@ class Matrix
         };
 
         ///--------------------------------------------------------
-        /// @brief Finds the row containing the most zeros (or cells below abosolute limit)
+        /// @brief Determines if a coordinate is out of bounds for this matrix
         ///
-        /// @note if no zeros are found in matrix, row 1 (index 0) will be returned
+        /// @param row of coordinate (i in common notation)
+        /// @param col of coordinate (j in common notation)
         ///
-        /// @returns index of row with most zeros
-        size_t _find_zeros_row() const
+        /// @returns is coordinate in bounds of this array?
+        bool _check_bounds(const size_t& row, const size_t& col) const
         {
-            size_t highestZerosCount = 0;
-            size_t zerosRow = 0;
+            // True if both coords are in bounds (size_t is unsigned, cannot be below 0)
+            return (row < m_rows) && (col < m_cols);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Generates the string needed for the error reporting for a bad coord
+        ///
+        /// @param row offending coord row
+        /// @param col offending coord col
+        /// @return string of error message
+        std::string _gen_coord_err_string(const size_t& row, const size_t& col) const
+        {
+            std::stringstream err;
+            err << "Bad coordinate, (" << row << "," << col << ") is not within the bounds of (" << m_rows - 1 << "," << m_cols - 1 << ")";
+            return err.str();
+        };
 
+        ///--------------------------------------------------------
+        /// @brief Widens lower/upper to cover every non-zero of a square matrix
+        /// Each row only tests the elements outside the band found so far
+        ///
+        /// @param lower sub diagonal count, updated
+        /// @param upper super diagonal count, updated
+        /// @param limit stop once kl + ku + 1 exceeds this
+        ///
+        /// @returns true if the band stayed within limit
+        bool _band_scan(size_t& lower, size_t& upper, const size_t& limit) const
+        {
             for (size_t i = 0; i < m_rows; i++)
             {
-                size_t zeroCount = 0;
-                for (size_t j = 0; j < m_cols; j++)
+                const T* row = m_data + i * m_cols;
+                for (size_t j = 0; j + lower < i; j++)
                 {
-                    if constexpr (std::is_same_v<T, Complex_C_t>)
+                    if (row[j] != (T) 0)
                     {
-                        if (get(i,j).absolute() == 0)
-                        {
-                            zeroCount++;
-                        }
+                        lower = i - j;
+                        break;
                     }
-                    else if constexpr (std::is_same_v<T, Complex_P_t>)
-                    {
-                        if (get(i,j).m_mag == 0)
-                        {
-                            zeroCount++;
-                        }
-                    }
-                    else
+                }
+                for (size_t j = m_cols - 1; j > i + upper; j--)
+                {
+                    if (row[j] != (T) 0)
                     {
-                        if (get(i,j) == (T) 0)
-                        {
-                            zeroCount++;
-                        }
+                        upper = j - i;
+                        break;
                     }
                 }
 
-                if (zeroCount > highestZerosCount)
+                if (lower + upper + 1 > limit)
                 {
-                    highestZerosCount = zeroCount;
-                    zerosRow = i;
+                    return false;
                 }
             }
-
-            return zerosRow;
+            return true;
         };
 
         ///--------------------------------------------------------
-        /// @brief Determines if a coordinate is out of bounds for this matrix
+        /// @brief Is the band narrow enough for the banded LU to pay off (see BANDED_DISPATCH_RATIO)?
         ///
-        /// @param row of coordinate (i in common notation)
-        /// @param col of coordinate (j in common notation)
+        /// @param lower set to the sub diagonal count
+        /// @param upper set to the super diagonal count
         ///
-        /// @returns is coordinate in bounds of this array?
-        bool _check_bounds(const size_t& row, const size_t& col) const
+        /// @returns true if square and (kl + ku + 1) * BANDED_DISPATCH_RATIO <= n
+        bool _is_narrow_band(size_t& lower, size_t& upper) const
         {
-            // True if both coords are in bounds (size_t is unsigned, cannot be below 0)
-            return (row < m_rows) && (col < m_cols);
+            lower = 0;
+            upper = 0;
+            return m_rows == m_cols && m_cols >= BANDED_DISPATCH_RATIO &&
+                   _band_scan(lower, upper, m_cols / BANDED_DISPATCH_RATIO);
         };
 
         ///--------------------------------------------------------
-        /// @brief Generates the string needed for the error reporting for a bad coord
+        /// @brief Cheap precheck for positive definite, every diagonal element must have positive real part
         ///
-        /// @param row offending coord row
-        /// @param col offending coord col
-        /// @return string of error message
-        std::string _gen_coord_err_string(const size_t& row, const size_t& col) const
+        /// @returns true if all diagonal elements are positive
+        bool _has_positive_diagonal() const
         {
-            std::stringstream err;
-            err << "Bad coordinate, (" << row << "," << col << ") is not within the bounds of (" << m_rows - 1 << "," << m_cols - 1 << ")";
-            return err.str();
+            for (size_t i = 0; i < std::min(m_rows, m_cols); i++)
+            {
+                if (!(scalar_real(m_data[i * m_cols + i]) > 0))
+                {
+                    return false;
+                }
+            }
+            return true;
         };
 };
 
@@ -1141,3 +1740,13 @@ std::ostream& operator<<(std::ostream& os, const Matrix<T>& mat)
 
     return os;
 }
+
+#include "Triangular.h"
+#include "Symmetric.h"
+#include "Banded.h"
+#include "LU.h"
+#include "QR.h"
+#include "Refine.h"
+#include "Update.h"
+#include "Eigen.h"
+#include "Matrix_Fixed.h"
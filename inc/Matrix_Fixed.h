@@ -0,0 +1,621 @@
+/// ------------------------------------------
+/// @file Matrix_Fixed.h
+///
+/// @brief Header/Source file for the compile time sized matrix Matrix<T, R, C>
+///
+/// Stored inline (no heap), every loop has a compile time trip count and is
+/// unrolled, and mismatched dimensions fail to compile instead of throwing.
+/// Converts to and from the run time sized Matrix<T> for everything else
+///
+/// @note Must implement all functions upon definition due to template format
+/// @note Included at the end of Matrix.h, include Matrix.h rather than this file
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <ostream>
+
+#include "Matrix_Fwd.h"
+#include "View.h"
+
+/// @brief Compile time sized matrix, R rows by C columns stored row major inline
+template <typename T, size_t R, size_t C>
+class Matrix
+{
+    static_assert(R > 0 && C > 0, "Cols/Rows of a matrix must be above 0");
+
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, all values zero
+        constexpr Matrix() : m_data{} {};
+
+        ///--------------------------------------------------------
+        /// @brief Constructor from nested braces, i.e: Matrix<double, 2, 2> m({{1, 2}, {3, 4}})
+        /// Too many rows/values is a compile error, missing values are zero
+        ///
+        /// @param matData rows of values
+        constexpr Matrix(const T (&matData)[R][C]) : m_data{}
+        {
+            _unroll<R * C>([&](size_t i)
+            {
+                m_data[i] = matData[i / C][i % C];
+            });
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor from a run time sized matrix
+        ///
+        /// @param mat matrix to copy, must be R x C
+        ///
+        /// @throws std::invalid_argument if the dimensions differ
+        explicit Matrix(const Matrix<T>& mat) : m_data{}
+        {
+            if (mat.getRowCount() != R || mat.getColCount() != C)
+            {
+                throw std::invalid_argument("Matrix dimensions do not match the fixed size");
+            }
+
+            _unroll<R * C>([&](size_t i)
+            {
+                m_data[i] = mat.get_data()[i];
+            });
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies into a run time sized matrix
+        ///
+        /// @return R x C matrix
+        Matrix<T> toDynamic() const
+        {
+            Matrix<T> outMat(R, C);
+            _unroll<R * C>([&](size_t i)
+            {
+                outMat.get_data()[i] = m_data[i];
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Implicit conversion to a run time sized matrix, see toDynamic()
+        operator Matrix<T>() const
+        {
+            return toDynamic();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Read only view of the whole matrix, see View.h
+        ///
+        /// @return R x C view
+        Block_View<const T> view() const
+        {
+            return Block_View<const T>(m_data, R, C, C);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of the whole matrix, reads and writes in place
+        ///
+        /// @return R x C view
+        Block_View<T> view()
+        {
+            return Block_View<T>(m_data, R, C, C);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows in the matrix
+        static constexpr size_t getRowCount()
+        {
+            return R;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns in the matrix
+        static constexpr size_t getColCount()
+        {
+            return C;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the internal array for the matrix
+        ///
+        /// @returns first element of the R*C row major values
+        constexpr T* get_data()
+        {
+            return m_data;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the internal array for the matrix
+        ///
+        /// @returns first element of the R*C row major values
+        constexpr const T* get_data() const
+        {
+            return m_data;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Compile time checked element access
+        ///
+        /// @tparam I row of element
+        /// @tparam J column of element
+        ///
+        /// @returns reference to element
+        template <size_t I, size_t J>
+        constexpr T& at()
+        {
+            static_assert(I < R && J < C, "Coordinate is not within the bounds of the matrix");
+            return m_data[I * C + J];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Compile time checked element access
+        ///
+        /// @tparam I row of element
+        /// @tparam J column of element
+        ///
+        /// @returns const reference to element
+        template <size_t I, size_t J>
+        constexpr const T& at() const
+        {
+            static_assert(I < R && J < C, "Coordinate is not within the bounds of the matrix");
+            return m_data[I * C + J];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unchecked element access, only bounds checked when MATRIX_BOUNDS_CHECK is set
+        ///
+        /// @param row of element
+        /// @param col of element
+        ///
+        /// @returns reference to element
+        constexpr T& operator()(const size_t& row, const size_t& col)
+        {
+#if MATRIX_BOUNDS_CHECK
+            _check_bounds(row, col);
+#endif
+            return m_data[row * C + col];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unchecked element access, only bounds checked when MATRIX_BOUNDS_CHECK is set
+        ///
+        /// @param row of element
+        /// @param col of element
+        ///
+        /// @returns const reference to element
+        constexpr const T& operator()(const size_t& row, const size_t& col) const
+        {
+#if MATRIX_BOUNDS_CHECK
+            _check_bounds(row, col);
+#endif
+            return m_data[row * C + col];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets the value at the row col position, always bounds checked
+        ///
+        /// @param row to get value from
+        /// @param col to get value from
+        ///
+        /// @returns value at given location
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
+        constexpr T get(const size_t& row, const size_t& col) const
+        {
+            _check_bounds(row, col);
+            return m_data[row * C + col];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Sets the value at the row col position, always bounds checked
+        ///
+        /// @param row to set value at
+        /// @param col to set value at
+        /// @param val to set coordinate to
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
+        constexpr void set(const size_t& row, const size_t& col, const T& val)
+        {
+            _check_bounds(row, col);
+            m_data[row * C + col] = val;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of +, implements matrix addition
+        ///
+        /// @param mat reference to rval matrix
+        ///
+        /// @return result of summed matricies
+        constexpr Matrix<T, R, C> operator+(const Matrix<T, R, C>& mat) const
+        {
+            Matrix<T, R, C> outMat;
+            _unroll<R * C>([&](size_t i)
+            {
+                outMat.m_data[i] = m_data[i] + mat.m_data[i];
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of -, implements matrix subtraction
+        ///
+        /// @param mat reference to rval matrix
+        ///
+        /// @return result of subtracted matricies
+        constexpr Matrix<T, R, C> operator-(const Matrix<T, R, C>& mat) const
+        {
+            Matrix<T, R, C> outMat;
+            _unroll<R * C>([&](size_t i)
+            {
+                outMat.m_data[i] = m_data[i] - mat.m_data[i];
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of *, implements matrix element multiplication
+        ///
+        /// @param mat reference to rval matrix
+        ///
+        /// @return elementwise product
+        constexpr Matrix<T, R, C> operator*(const Matrix<T, R, C>& mat) const
+        {
+            Matrix<T, R, C> outMat;
+            _unroll<R * C>([&](size_t i)
+            {
+                outMat.m_data[i] = m_data[i] * mat.m_data[i];
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of *, implements scalar multiplication
+        ///
+        /// @param num scalar to multiply by
+        ///
+        /// @return multiplied matrix
+        constexpr Matrix<T, R, C> operator*(const T& num) const
+        {
+            Matrix<T, R, C> outMat;
+            _unroll<R * C>([&](size_t i)
+            {
+                outMat.m_data[i] = m_data[i] * num;
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of /, implements scalar division
+        ///
+        /// @param num scalar to divide by
+        ///
+        /// @return divided matrix
+        constexpr Matrix<T, R, C> operator/(const T& num) const
+        {
+            Matrix<T, R, C> outMat;
+            _unroll<R * C>([&](size_t i)
+            {
+                outMat.m_data[i] = m_data[i] / num;
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, implements matrix cross product
+        /// (R,C) % (C,K) gives (R,K), any other shape fails to compile
+        ///
+        /// @param mat reference to rval matrix
+        ///
+        /// @return result of dot product matricies
+        template <size_t RR, size_t K>
+        constexpr Matrix<T, R, K> operator%(const Matrix<T, RR, K>& mat) const
+        {
+            static_assert(RR == C, "Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+
+            Matrix<T, R, K> outMat;
+            _unroll<R * K>([&](size_t ij)
+            {
+                const size_t i = ij / K;
+                const size_t j = ij % K;
+                T sum = m_data[i * C] * mat.get_data()[j];
+                _unroll<C - 1>([&](size_t p)
+                {
+                    sum += m_data[i * C + p + 1] * mat.get_data()[(p + 1) * K + j];
+                });
+                outMat.get_data()[ij] = sum;
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, multiplies by a run time sized matrix
+        ///
+        /// @param mat reference to rval matrix, must have C rows
+        ///
+        /// @return (R, mat columns) product
+        ///
+        /// @throws std::invalid_argument if the inner dimensions differ
+        Matrix<T> operator%(const Matrix<T>& mat) const
+        {
+            return Matrix<T>::multiply(view(), mat.view());
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of ==, compares two matricies
+        ///
+        /// @param mat rval mat to compare
+        ///
+        /// @return true if every value is equal
+        constexpr bool operator==(const Matrix<T, R, C>& mat) const
+        {
+            bool equal = true;
+            _unroll<R * C>([&](size_t i)
+            {
+                equal = equal && (m_data[i] == mat.m_data[i]);
+            });
+            return equal;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of !=, compares two matricies
+        ///
+        /// @param mat rval mat to compare
+        ///
+        /// @return true if any value differs
+        constexpr bool operator!=(const Matrix<T, R, C>& mat) const
+        {
+            return !(*this == mat);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Create the transpose of the matrix
+        ///
+        /// @return the (C, R) transposed form of the matrix
+        constexpr Matrix<T, C, R> transpose() const
+        {
+            Matrix<T, C, R> outMat;
+            _unroll<R * C>([&](size_t i)
+            {
+                outMat.get_data()[(i % C) * R + i / C] = m_data[i];
+            });
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant, closed form up to 4x4, LU beyond that
+        ///
+        /// @returns value of the determinant for the matrix
+        constexpr T determinant() const
+        {
+            static_assert(R == C, "Matrix must be square to have a determinant");
+
+            const T* a = m_data;
+            if constexpr (R == 1)
+            {
+                return a[0];
+            }
+            else if constexpr (R == 2)
+            {
+                return a[0] * a[3] - a[1] * a[2];
+            }
+            else if constexpr (R == 3)
+            {
+                return a[0] * (a[4] * a[8] - a[5] * a[7])
+                     - a[1] * (a[3] * a[8] - a[5] * a[6])
+                     + a[2] * (a[3] * a[7] - a[4] * a[6]);
+            }
+            else if constexpr (R == 4)
+            {
+                // 2x2 minors of the top two and bottom two rows, Laplace expansion pairs them up
+                const T b00 = a[0] * a[5] - a[1] * a[4];
+                const T b01 = a[0] * a[6] - a[2] * a[4];
+                const T b02 = a[0] * a[7] - a[3] * a[4];
+                const T b03 = a[1] * a[6] - a[2] * a[5];
+                const T b04 = a[1] * a[7] - a[3] * a[5];
+                const T b05 = a[2] * a[7] - a[3] * a[6];
+                const T b06 = a[8] * a[13] - a[9] * a[12];
+                const T b07 = a[8] * a[14] - a[10] * a[12];
+                const T b08 = a[8] * a[15] - a[11] * a[12];
+                const T b09 = a[9] * a[14] - a[10] * a[13];
+                const T b10 = a[9] * a[15] - a[11] * a[13];
+                const T b11 = a[10] * a[15] - a[11] * a[14];
+                return b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
+            }
+            else
+            {
+                return toDynamic().determinant();
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculate the inverse matrix, closed form (adjugate / determinant) up to 4x4,
+        /// LU beyond that
+        ///
+        /// @return the inverse matrix
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        constexpr Matrix<T, R, C> inverse() const
+        {
+            static_assert(R == C, "Matrix must be square to have an inverse");
+
+            if constexpr (R > 4)
+            {
+                return Matrix<T, R, C>(toDynamic().inverse());
+            }
+            else
+            {
+                const T* a = m_data;
+                Matrix<T, R, C> outMat;
+                T* o = outMat.m_data;
+                T det = determinant();
+
+                if (det == (T) 0)
+                {
+                    throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+                }
+
+                if constexpr (R == 1)
+                {
+                    o[0] = (T) 1;
+                }
+                else if constexpr (R == 2)
+                {
+                    o[0] = a[3];
+                    o[1] = -a[1];
+                    o[2] = -a[2];
+                    o[3] = a[0];
+                }
+                else if constexpr (R == 3)
+                {
+                    o[0] = a[4] * a[8] - a[5] * a[7];
+                    o[1] = a[2] * a[7] - a[1] * a[8];
+                    o[2] = a[1] * a[5] - a[2] * a[4];
+                    o[3] = a[5] * a[6] - a[3] * a[8];
+                    o[4] = a[0] * a[8] - a[2] * a[6];
+                    o[5] = a[2] * a[3] - a[0] * a[5];
+                    o[6] = a[3] * a[7] - a[4] * a[6];
+                    o[7] = a[1] * a[6] - a[0] * a[7];
+                    o[8] = a[0] * a[4] - a[1] * a[3];
+                }
+                else
+                {
+                    const T b00 = a[0] * a[5] - a[1] * a[4];
+                    const T b01 = a[0] * a[6] - a[2] * a[4];
+                    const T b02 = a[0] * a[7] - a[3] * a[4];
+                    const T b03 = a[1] * a[6] - a[2] * a[5];
+                    const T b04 = a[1] * a[7] - a[3] * a[5];
+                    const T b05 = a[2] * a[7] - a[3] * a[6];
+                    const T b06 = a[8] * a[13] - a[9] * a[12];
+                    const T b07 = a[8] * a[14] - a[10] * a[12];
+                    const T b08 = a[8] * a[15] - a[11] * a[12];
+                    const T b09 = a[9] * a[14] - a[10] * a[13];
+                    const T b10 = a[9] * a[15] - a[11] * a[13];
+                    const T b11 = a[10] * a[15] - a[11] * a[14];
+
+                    o[0] = a[5] * b11 - a[6] * b10 + a[7] * b09;
+                    o[1] = a[2] * b10 - a[1] * b11 - a[3] * b09;
+                    o[2] = a[13] * b05 - a[14] * b04 + a[15] * b03;
+                    o[3] = a[10] * b04 - a[9] * b05 - a[11] * b03;
+                    o[4] = a[6] * b08 - a[4] * b11 - a[7] * b07;
+                    o[5] = a[0] * b11 - a[2] * b08 + a[3] * b07;
+                    o[6] = a[14] * b02 - a[12] * b05 - a[15] * b01;
+                    o[7] = a[8] * b05 - a[10] * b02 + a[11] * b01;
+                    o[8] = a[4] * b10 - a[5] * b08 + a[7] * b06;
+                    o[9] = a[1] * b08 - a[0] * b10 - a[3] * b06;
+                    o[10] = a[12] * b04 - a[13] * b02 + a[15] * b00;
+                    o[11] = a[9] * b02 - a[8] * b04 - a[11] * b00;
+                    o[12] = a[5] * b07 - a[4] * b09 - a[6] * b06;
+                    o[13] = a[0] * b09 - a[1] * b07 + a[2] * b06;
+                    o[14] = a[13] * b01 - a[12] * b03 - a[14] * b00;
+                    o[15] = a[8] * b03 - a[9] * b01 + a[10] * b00;
+                }
+
+                const T invDet = (T) 1 / det;
+                _unroll<R * C>([&](size_t i)
+                {
+                    o[i] *= invDet;
+                });
+                return outMat;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Creates an identity matrix
+        ///
+        /// @return identity matrix of size R
+        static constexpr Matrix<T, R, C> identity()
+        {
+            static_assert(R == C, "Identity matrix must be square");
+
+            Matrix<T, R, C> id;
+            _unroll<R>([&](size_t i)
+            {
+                id.m_data[i * C + i] = (T) 1;
+            });
+            return id;
+        };
+
+    private:
+        /// @brief Stores all matrix values row major, inline so the matrix never allocates
+        T m_data[R * C];
+
+        ///--------------------------------------------------------
+        /// @brief Calls f(0) ... f(N-1) with the loop fully unrolled at compile time
+        ///
+        /// @param f callable taking the index
+        template <size_t N, typename F>
+        static constexpr void _unroll(F&& f)
+        {
+            _unroll_seq(std::make_index_sequence<N>{}, f);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Expands the index sequence of _unroll
+        template <size_t... I, typename F>
+        static constexpr void _unroll_seq(std::index_sequence<I...>, F& f)
+        {
+            (f(I), ...);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Throws if a coordinate is out of bounds
+        ///
+        /// @param row of coordinate
+        /// @param col of coordinate
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
+        constexpr void _check_bounds(const size_t& row, const size_t& col) const
+        {
+            if (!(row < R && col < C)) [[unlikely]]
+            {
+                _bounds_error(row, col);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Throws the out of bounds error, kept out of line of the constexpr accessors
+        ///
+        /// @param row offending coord row
+        /// @param col offending coord col
+        ///
+        /// @throws std::invalid_argument always
+        [[noreturn]] static void _bounds_error(const size_t& row, const size_t& col)
+        {
+            std::stringstream err;
+            err << "Bad coordinate, (" << row << "," << col << ") is not within the bounds of ("
+                << R - 1 << "," << C - 1 << ")";
+            throw std::invalid_argument(err.str());
+        };
+};
+
+///--------------------------------------------------------
+/// @brief Overload of *, scalar multiplication with the scalar on the left
+///
+/// @param num scalar to multiply by
+/// @param mat matrix to multiply
+///
+/// @return multiplied matrix
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> operator*(const T& num, const Matrix<T, R, C>& mat)
+{
+    return mat * num;
+}
+
+///--------------------------------------------------------
+/// @brief Overload of <<, used to convert a fixed size matrix into an output stream
+///
+/// @param os output stream
+/// @param mat matrix to push to output stream
+///
+/// @return output stream
+template <typename T, size_t R, size_t C>
+std::ostream& operator<<(std::ostream& os, const Matrix<T, R, C>& mat)
+{
+    return os << mat.toDynamic();
+}
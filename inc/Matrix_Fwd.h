@@ -0,0 +1,16 @@
+/// ------------------------------------------
+/// @file Matrix_Fwd.h
+///
+/// @brief Forward declaration of Matrix, the one place its default arguments are given
+///
+/// Matrix<T> (both dimensions MATRIX_DYNAMIC) is sized at run time and lives in
+/// Matrix.h, Matrix<T, R, C> is sized at compile time and lives in Matrix_Fixed.h
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+
+/// @brief Dimension value marking a matrix sized at run time
+constexpr size_t MATRIX_DYNAMIC = 0;
+
+template <typename T, size_t R = MATRIX_DYNAMIC, size_t C = MATRIX_DYNAMIC> class Matrix;
@@ -0,0 +1,429 @@
+/// ------------------------------------------
+/// @file Matrix_IO.h
+///
+/// @brief Header/Source file for the binary matrix file format and its memory mapped reader
+///
+/// File layout, all integers little endian:
+///
+///     offset  size  field
+///          0     8  magic "MATRIXB\0"
+///          8     4  format version, MATRIX_FILE_VERSION
+///         12     4  element type, Matrix_Dtype_t
+///         16     4  storage order, Matrix_Order_t
+///         20     4  element size in bytes
+///         24     4  byte order mark 0x01020304 as written, rejects big endian files
+///         28     4  reserved, zero
+///         32     8  rows
+///         40     8  columns
+///         48     8  payload offset from the start of the file, MATRIX_FILE_ALIGNMENT aligned
+///         56     8  tile side for TILED files, zero otherwise
+///     offset   ...  rows * cols elements, packed, in the storage order
+///
+/// Complex_C_t elements are stored as (real, imaginary) pairs of doubles.
+///
+/// TILED payloads hold ceil(rows / tile) x ceil(cols / tile) square tiles in row major
+/// tile order, each tile * tile elements row major, with edge tiles zero padded to full
+/// size. They are read and written a tile at a time through Tile_File_t, see Tiled.h
+///
+/// Matrix_File_t maps a file and hands out a read only Block_View straight over the
+/// mapped pages, so nothing is read until it is touched. Column major files come out as
+/// a view with swapped strides, load() copies into a packed row major Matrix
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Matrix.h"
+#include "View.h"
+#include "Complex_C.h"
+
+/// Version written into new files, readers reject any other
+#define MATRIX_FILE_VERSION 1
+
+/// Alignment of the payload within the file, so mapped elements are aligned in memory
+#ifndef MATRIX_FILE_ALIGNMENT
+#define MATRIX_FILE_ALIGNMENT 64
+#endif
+
+/// @brief Element types the file format can hold
+enum class Matrix_Dtype_t : uint32_t
+{
+    FLOAT = 1,
+    DOUBLE = 2,
+    COMPLEX_C = 3   // Complex_C_t, (real, imaginary) doubles
+};
+
+/// @brief Element order of the payload
+enum class Matrix_Order_t : uint32_t
+{
+    ROW_MAJOR = 0,
+    COL_MAJOR = 1,
+    TILED = 2
+};
+
+/// @brief On disk header, see the file description for the layout
+struct Matrix_File_Header_t
+{
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_dtype;
+    uint32_t m_order;
+    uint32_t m_elem_size;
+    uint32_t m_bom;
+    uint32_t m_reserved0;
+    uint64_t m_rows;
+    uint64_t m_cols;
+    uint64_t m_offset;
+    uint64_t m_tile;
+};
+
+static_assert(sizeof(Matrix_File_Header_t) == 64, "Matrix file header must be 64 bytes");
+static_assert(sizeof(Complex_C_t) == 2 * sizeof(double) && std::is_standard_layout_v<Complex_C_t>,
+              "Complex_C_t must be two packed doubles to be stored in matrix files");
+
+///--------------------------------------------------------
+/// @brief Finds the file element type of T
+///
+/// @return element type tag
+template <typename T>
+constexpr Matrix_Dtype_t matrix_dtype()
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return Matrix_Dtype_t::FLOAT;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return Matrix_Dtype_t::DOUBLE;
+    }
+    else if constexpr (std::is_same_v<T, Complex_C_t>)
+    {
+        return Matrix_Dtype_t::COMPLEX_C;
+    }
+    else
+    {
+        static_assert(std::is_same_v<T, double>, "Matrix files hold float, double or Complex_C_t elements");
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Builds the header of a new matrix file
+///
+/// @param rows rows of the matrix
+/// @param cols columns of the matrix
+/// @param order storage order of the payload
+/// @param tile tile side for TILED files, ignored otherwise
+///
+/// @return header with the payload at the first aligned offset
+template <typename T>
+Matrix_File_Header_t matrix_file_header(const size_t& rows, const size_t& cols, const Matrix_Order_t& order,
+                                        const size_t& tile = 0)
+{
+    Matrix_File_Header_t header{};
+    std::memcpy(header.m_magic, "MATRIXB", 8);
+    header.m_version = MATRIX_FILE_VERSION;
+    header.m_dtype = static_cast<uint32_t>(matrix_dtype<T>());
+    header.m_order = static_cast<uint32_t>(order);
+    header.m_elem_size = sizeof(T);
+    header.m_bom = 0x01020304;
+    header.m_rows = rows;
+    header.m_cols = cols;
+    header.m_offset = (sizeof(Matrix_File_Header_t) + MATRIX_FILE_ALIGNMENT - 1) / MATRIX_FILE_ALIGNMENT * MATRIX_FILE_ALIGNMENT;
+    header.m_tile = (order == Matrix_Order_t::TILED) ? tile : 0;
+    return header;
+}
+
+///--------------------------------------------------------
+/// @brief Writes a matrix, or any view of one, to a binary matrix file
+///
+/// @param path file to create or overwrite
+/// @param view matrix to write
+/// @param order storage order to write the payload in, ROW_MAJOR or COL_MAJOR
+///
+/// @throws std::invalid_argument if order is TILED
+/// @throws std::runtime_error if the file cannot be written
+template <typename T>
+void matrix_save(const std::string& path, const Block_View<T>& view,
+                 const Matrix_Order_t& order = Matrix_Order_t::ROW_MAJOR)
+{
+    using Value_t = std::remove_const_t<T>;
+
+    if (order == Matrix_Order_t::TILED)
+    {
+        throw std::invalid_argument("matrix_save writes ROW_MAJOR or COL_MAJOR files, use Tiled_Matrix::fromMatrix for TILED");
+    }
+
+    const Matrix_File_Header_t header = matrix_file_header<Value_t>(view.getRowCount(), view.getColCount(), order);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Could not open matrix file for writing: " + path);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const std::vector<char> pad(header.m_offset - sizeof(header), 0);
+    file.write(pad.data(), pad.size());
+
+    // one line (row or column) at a time, straight from memory when it is contiguous
+    const bool rowMajor = order == Matrix_Order_t::ROW_MAJOR;
+    const Block_View<const Value_t> lines = rowMajor ? view : view.transposed();
+    std::vector<Value_t> line(lines.getColCount());
+    for (size_t i = 0; i < lines.getRowCount(); i++)
+    {
+        const Value_t* data = line.data();
+        if (lines.isRowContiguous())
+        {
+            data = lines.row(i).data();
+        }
+        else
+        {
+            for (size_t j = 0; j < line.size(); j++)
+            {
+                line[j] = lines(i, j);
+            }
+        }
+        file.write(reinterpret_cast<const char*>(data), line.size() * sizeof(Value_t));
+    }
+
+    if (!file)
+    {
+        throw std::runtime_error("Failed writing matrix file: " + path);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Writes a matrix to a binary matrix file
+///
+/// @param path file to create or overwrite
+/// @param mat matrix to write
+/// @param order storage order to write the payload in, ROW_MAJOR or COL_MAJOR
+///
+/// @throws std::invalid_argument if order is TILED
+/// @throws std::runtime_error if the file cannot be written
+template <typename T>
+void matrix_save(const std::string& path, const Matrix<T>& mat, const Matrix_Order_t& order = Matrix_Order_t::ROW_MAJOR)
+{
+    matrix_save(path, mat.view(), order);
+}
+
+/// @brief Read only memory mapping of a binary matrix file
+/// Movable, not copyable, the mapping (and every view of it) lives as long as the object
+class Matrix_File_t
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, maps the file and validates its header
+        ///
+        /// @param path file to map
+        ///
+        /// @throws std::runtime_error if the file cannot be opened, mapped, or is not a valid matrix file
+        Matrix_File_t(const std::string& path);
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, unmaps the file
+        ~Matrix_File_t();
+
+        Matrix_File_t(const Matrix_File_t&) = delete;
+        Matrix_File_t& operator=(const Matrix_File_t&) = delete;
+
+        Matrix_File_t(Matrix_File_t&& other) noexcept;
+        Matrix_File_t& operator=(Matrix_File_t&& other) noexcept;
+
+        ///--------------------------------------------------------
+        /// @brief Get the element type of the file
+        ///
+        /// @return element type tag
+        Matrix_Dtype_t dtype() const
+        {
+            return static_cast<Matrix_Dtype_t>(m_header.m_dtype);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the storage order of the payload
+        ///
+        /// @return storage order
+        Matrix_Order_t order() const
+        {
+            return static_cast<Matrix_Order_t>(m_header.m_order);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows in the matrix
+        size_t getRowCount() const
+        {
+            return m_header.m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns in the matrix
+        size_t getColCount() const
+        {
+            return m_header.m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the raw payload, in the file's element type and order
+        ///
+        /// @return first byte of the mapped payload
+        const void* payload() const
+        {
+            return m_map + m_header.m_offset;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Hints that the whole payload will be read soon, so the kernel reads ahead
+        void prefetch() const;
+
+        ///--------------------------------------------------------
+        /// @brief Zero copy read only view over the mapped payload
+        ///
+        /// @return view of the matrix, strided for column major files
+        ///
+        /// @throws std::invalid_argument if T is not the element type of the file or the file is tiled
+        template <typename T>
+        Block_View<const T> view() const
+        {
+            if (matrix_dtype<T>() != dtype())
+            {
+                throw std::invalid_argument("Element type does not match the matrix file");
+            }
+            if (order() == Matrix_Order_t::TILED)
+            {
+                throw std::invalid_argument("Tiled matrix files cannot be viewed as one block, open them as a Tiled_Matrix");
+            }
+
+            const T* data = static_cast<const T*>(payload());
+            const size_t rows = getRowCount();
+            const size_t cols = getColCount();
+            return (order() == Matrix_Order_t::ROW_MAJOR) ? Block_View<const T>(data, rows, cols, cols, 1)
+                                                          : Block_View<const T>(data, rows, cols, 1, rows);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the mapped matrix into memory
+        ///
+        /// @return row major copy of the matrix
+        ///
+        /// @throws std::invalid_argument if T is not the element type of the file or the file is tiled
+        template <typename T>
+        Matrix<T> load() const
+        {
+            return view<T>().toMatrix();
+        };
+
+    private:
+        /// @brief validated copy of the header
+        Matrix_File_Header_t m_header{};
+
+        /// @brief start of the mapping, nullptr once moved from
+        const char* m_map = nullptr;
+
+        /// @brief bytes mapped
+        size_t m_size = 0;
+
+        ///--------------------------------------------------------
+        /// @brief Unmaps the file if mapped
+        void _unmap() noexcept;
+};
+
+/// @brief Read/write positional access to a matrix file, the backing store of Tiled_Matrix
+/// Reads and writes at distinct offsets may run concurrently from different threads
+class Tile_File_t
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, creates (or truncates) a file sized for the header's payload
+        /// The payload reads back as zero until written
+        ///
+        /// @param path file to create
+        /// @param header header to write, see matrix_file_header
+        ///
+        /// @throws std::runtime_error if the file cannot be created or the header is invalid
+        Tile_File_t(const std::string& path, const Matrix_File_Header_t& header);
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, opens an existing file for reading and writing and validates its header
+        ///
+        /// @param path file to open
+        ///
+        /// @throws std::runtime_error if the file cannot be opened or is not a valid matrix file
+        Tile_File_t(const std::string& path);
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, closes the file
+        ~Tile_File_t();
+
+        Tile_File_t(const Tile_File_t&) = delete;
+        Tile_File_t& operator=(const Tile_File_t&) = delete;
+
+        Tile_File_t(Tile_File_t&& other) noexcept;
+        Tile_File_t& operator=(Tile_File_t&& other) noexcept;
+
+        ///--------------------------------------------------------
+        /// @brief Get the validated header of the file
+        ///
+        /// @return file header
+        const Matrix_File_Header_t& header() const
+        {
+            return m_header;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Reads bytes from the payload
+        ///
+        /// @param offset byte offset from the start of the payload
+        /// @param dst buffer to fill
+        /// @param bytes number of bytes to read
+        ///
+        /// @throws std::runtime_error if the read fails or runs past the end of the file
+        void read(const uint64_t& offset, void* dst, const size_t& bytes) const;
+
+        ///--------------------------------------------------------
+        /// @brief Writes bytes to the payload
+        ///
+        /// @param offset byte offset from the start of the payload
+        /// @param src bytes to write
+        /// @param bytes number of bytes to write
+        ///
+        /// @throws std::runtime_error if the write fails
+        void write(const uint64_t& offset, const void* src, const size_t& bytes) const;
+
+    private:
+        /// @brief validated copy of the header
+        Matrix_File_Header_t m_header{};
+
+        /// @brief native file handle (HANDLE on Windows), -1 once moved from
+        intptr_t m_handle = -1;
+
+        /// @brief file name, for error messages
+        std::string m_path;
+
+        ///--------------------------------------------------------
+        /// @brief Reads bytes at an absolute file position, retrying short reads
+        ///
+        /// @throws std::runtime_error if the read fails or runs past the end of the file
+        void _read_at(uint64_t pos, void* dst, const size_t& bytes) const;
+
+        ///--------------------------------------------------------
+        /// @brief Writes bytes at an absolute file position, retrying short writes
+        ///
+        /// @throws std::runtime_error if the write fails
+        void _write_at(uint64_t pos, const void* src, const size_t& bytes) const;
+
+        ///--------------------------------------------------------
+        /// @brief Closes the file if open
+        void _close() noexcept;
+};
@@ -27,12 +27,59 @@
 /// @brief minimum differnce that must be exceeded by at least 1 root between durand-kerner iterations to continue
 #define MIN_DIFF_CONV_TEST 1.0E-9
 
+/// @brief maximum number of aberth-ehrlich sweeps that may be performed
+#ifndef MAX_ABERTH_ITERATIONS
+#define MAX_ABERTH_ITERATIONS 1024
+#endif
+
+/// @brief an aberth-ehrlich estimate is frozen once |p(z)| is under this times sum |a_k| |z|^k
+#ifndef POLY_ROOT_EVAL_EPS
+#define POLY_ROOT_EVAL_EPS (4 * std::numeric_limits<double>::epsilon())
+#endif
+
+/// @brief polynomials of at least this degree update their roots across the thread pool
+#ifndef POLY_PARALLEL_ROOTS
+#define POLY_PARALLEL_ROOTS 128
+#endif
+
+/// @brief polynomials root found together per task by FindPolyRootsBatch, one lane each
+#ifndef POLY_BATCH_CHUNK
+#define POLY_BATCH_CHUNK 256
+#endif
+
 /// @brief Polynomial represented as the list of coefficents
 typedef std::vector<Complex_C_t> Poly_Coeff_t;
 
 /// @brief Polynomial factor, i.e: (2x-(4+3i)) -> <2, {4,3}>
 typedef std::pair<double, Complex_C_t> Poly_factor_t;
 
+/// @brief Root finding strategies, selected at runtime through FindPolyRoots / FactorizePoly
+enum class Poly_Root_Method_t
+{
+    ABERTH,         // aberth-ehrlich, cubic convergence, converged roots are frozen
+    DURAND_KERNER,  // durand-kerner (weierstrass), the original method
+    COMPANION       // eigenvalues of the companion matrix through the hessenberg QR solver
+};
+
+/// Root finding method to use by default
+#define POLY_ROOT_DEFAULT_METHOD Poly_Root_Method_t::ABERTH
+
+/// @brief Results of a root find
+struct Poly_Roots_Result_t
+{
+    /// @brief roots, one per degree, repeated roots are listed repeatedly
+    std::vector<Complex_C_t> m_roots;
+
+    /// @brief |p(root)| for each root
+    std::vector<double> m_residuals;
+
+    /// @brief iterations (sweeps over all roots) performed, QR iterations for COMPANION
+    size_t m_iterations = 0;
+
+    /// @brief false if the iteration limit was hit before every root converged
+    bool m_converged = false;
+};
+
 /// ------------------------------------------
 /// @brief Operator implementation for adding two polynomial coefficent sets
 ///
@@ -53,13 +100,27 @@ Poly_Coeff_t operator-(const Poly_Coeff_t& coeffL, const Poly_Coeff_t& coeffR);
 
 /// ------------------------------------------
 /// @brief Operator implementation for multiplying two polynomial coefficent sets
+/// Schoolbook O(n*m), every coefficient accurate relative to its own size, see
+/// MultiplyPolyFFT for the faster opt-in
 ///
 /// @param coeffL left polynomial coeff
 /// @param coeffR right polynomial coeff
 ///
-/// @return resulting polynomial as coeff list
+/// @return resulting polynomial as coeff list, empty if either is empty
 Poly_Coeff_t operator*(const Poly_Coeff_t& coeffL, const Poly_Coeff_t& coeffR);
 
+/// ------------------------------------------
+/// @brief Multiplies two polynomials with a radix 2 FFT convolution, O((n+m) log(n+m))
+/// Opt-in only, operator* never calls it: the error of every coefficient is only bounded
+/// relative to the largest coefficient of the product, so coefficients many orders of
+/// magnitude smaller than that can lose all accuracy. Use it for well scaled operands
+///
+/// @param coeffL left polynomial coeff
+/// @param coeffR right polynomial coeff
+///
+/// @return resulting polynomial as coeff list, empty if either is empty
+Poly_Coeff_t MultiplyPolyFFT(const Poly_Coeff_t& coeffL, const Poly_Coeff_t& coeffR);
+
 /// ------------------------------------------
 /// @brief Cast to ostream for printing polynomial
 ///
@@ -86,6 +147,8 @@ std::ostream& operator<<(std::ostream& os, const std::vector<Poly_factor_t>& fac
 ///
 /// Supports complex factors: (x+2+3i) -> {1, {2,3}}
 ///
+/// Multiplies the factors out one at a time in one buffer, O(n^2)
+///
 /// @param factorList list of factors stored as pairs, (2x-3) -> {2, -3}
 ///
 /// @return list of coefficents for the compressed polynomial
@@ -93,6 +156,7 @@ Poly_Coeff_t CompressFactors(const std::vector<Poly_factor_t>& factorList);
 
 /// ------------------------------------------
 /// @brief Using a compressed polynomial coefficent list, return the output for a value of x
+/// Horner's scheme, one complex multiply add per coefficient
 ///
 /// @param x input value
 /// @param compressedPoly compressed polynomial to use as function
@@ -101,15 +165,74 @@ Poly_Coeff_t CompressFactors(const std::vector<Poly_factor_t>& factorList);
 Complex_C_t getValCompressedPoly(const Complex_C_t x, const Poly_Coeff_t& compressedPoly);
 
 /// ------------------------------------------
-/// @brief Factorize the given complex polynomial into all roots
+/// @brief Evaluates a compressed polynomial at many points at once
+/// Horner's scheme run over all points together, each coefficient is one split complex
+/// multiply across the points so the SIMD kernels of Complex_Kernels.h do the work
+///
+/// @param xs input values
+/// @param compressedPoly compressed polynomial to use as function
+///
+/// @return output of polynomial function for each x, in order
+Poly_Coeff_t getValsCompressedPoly(const Poly_Coeff_t& xs, const Poly_Coeff_t& compressedPoly);
+
+/// ------------------------------------------
+/// @brief Finds every root of the given complex polynomial
 /// Will not filter non-unique roots
 ///
-/// WARN: Works for 95% of all polynomials, but is not garenteed to converge
-/// Seems to not like high (<3-5 depends on the polynomial) coefficents on the highest rank
+/// ABERTH updates each estimate in place (Gauss-Seidel style) by the Newton step
+/// corrected for the other estimates, and stops updating an estimate once its step
+/// falls under MIN_DIFF_CONV_TEST relative to its size, or p(estimate) is within the
+/// rounding error of evaluating it (POLY_ROOT_EVAL_EPS). From POLY_PARALLEL_ROOTS roots
+/// up the estimates are split across the thread pool, each thread sees its own
+/// block's new values and the previous sweep's values of the rest
+///
+/// DURAND_KERNER is the original method: https://youtu.be/5JcpOj2KtWc
+/// capped at MAX_DK_ITERATIONS, ABERTH is capped at MAX_ABERTH_ITERATIONS
 ///
-/// Uses Durand-Kerner method: https://youtu.be/5JcpOj2KtWc
+/// @param compressedPoly complex polynomial, highest coefficient must be non-zero
+/// @param method root finding method
+///
+/// @return roots, residuals, iteration count and convergence status
+///
+/// @throws std::invalid_argument if the polynomial is below rank 2
+Poly_Roots_Result_t FindPolyRoots(const Poly_Coeff_t& compressedPoly, const Poly_Root_Method_t& method = POLY_ROOT_DEFAULT_METHOD);
+
+/// ------------------------------------------
+/// @brief Factorize the given complex polynomial into all roots
+/// Will not filter non-unique roots, see FindPolyRoots for the methods
+///
+/// WARN: not garenteed to converge, use FindPolyRoots to check
 ///
 /// @param compressedPoly complex polynomial
+/// @param method root finding method
 ///
 /// @return factor list
-std::vector< std::pair<double, Complex_C_t> > FactorizePoly(const Poly_Coeff_t& compressedPoly);
\ No newline at end of file
+///
+/// @throws std::invalid_argument if the polynomial is below rank 2
+std::vector< std::pair<double, Complex_C_t> > FactorizePoly(const Poly_Coeff_t& compressedPoly,
+                                                            const Poly_Root_Method_t& method = POLY_ROOT_DEFAULT_METHOD);
+
+/// ------------------------------------------
+/// @brief Finds the roots of many polynomials of the same rank together with ABERTH
+/// The polynomials are interleaved POLY_BATCH_CHUNK at a time so one SIMD lane iterates
+/// one polynomial, chunks run across the thread pool. Meant for many low rank polynomials,
+/// large ranks are better served one at a time by FindPolyRoots
+///
+/// @param polys complex polynomials of one rank, highest coefficients must be non-zero
+///
+/// @return one result per polynomial, as FindPolyRoots
+///
+/// @throws std::invalid_argument if the ranks differ or are below 2
+std::vector<Poly_Roots_Result_t> FindPolyRootsBatch(const std::vector<Poly_Coeff_t>& polys);
+
+/// ------------------------------------------
+/// @brief Factorize many complex polynomials of the same rank into all roots, see FindPolyRootsBatch
+///
+/// WARN: not garenteed to converge, use FindPolyRootsBatch to check
+///
+/// @param polys complex polynomials of one rank
+///
+/// @return factor list per polynomial
+///
+/// @throws std::invalid_argument if the ranks differ or are below 2
+std::vector<std::vector<Poly_factor_t>> FactorizePolyBatch(const std::vector<Poly_Coeff_t>& polys);
@@ -0,0 +1,213 @@
+/// ------------------------------------------
+/// @file Profile.h
+///
+/// @brief Header file for the opt-in per operation profiling counters
+///
+/// Built with MATRIX_PROFILE defined (CMake option MATRIX_PROFILE=ON) the products,
+/// factorizations, RREF, eigen solvers and polynomial root finders each time themselves
+/// through a Profile_Scope_t. Every thread records into its own counters, one uncontended
+/// relaxed add per field, and profile_snapshot() sums them across threads so a monitor
+/// thread can scrape them at any time. Without MATRIX_PROFILE the scopes are empty and
+/// compile away, the snapshot is then all zeros
+///
+/// @note MATRIX_PROFILE must be the same for the library and all code including Matrix.h,
+/// the CMake option sets it on the Matrix::headers target for that reason
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <iosfwd>
+#include <string>
+
+/// Environment variable naming a file the counters are written to as JSON at exit, unset writes nothing
+#define PROFILE_JSON_ENV "MATRIX_PROFILE_JSON"
+
+/// @brief Instrumented operations
+enum class Profile_Op_t : size_t
+{
+    PRODUCT,        // Matrix<T>::operator% and multiply
+    LU,             // LU factorization
+    QR,             // QR factorization
+    CHOLESKY,       // Cholesky factorization
+    RREF,           // Matrix<T>::RREF
+    EIGEN,          // Eigen_Solver reduction and QR/QL iteration
+    POLY_ROOTS,     // FindPolyRoots / FactorizePoly
+    POLY_BATCH,     // FindPolyRootsBatch / FactorizePolyBatch
+    COUNT
+};
+
+/// @brief Totals of one operation
+struct Profile_Counter_t
+{
+    /// @brief completed calls, including ones that threw
+    uint64_t m_calls = 0;
+
+    /// @brief wall time summed over calls, nanoseconds
+    uint64_t m_total_ns = 0;
+
+    /// @brief longest single call, nanoseconds
+    uint64_t m_peak_ns = 0;
+
+    /// @brief floating point operations estimated from the dimensions, iterative phases
+    /// are counted in m_iterations instead
+    uint64_t m_flops = 0;
+
+    /// @brief bytes allocated for results and workspace
+    uint64_t m_bytes = 0;
+
+    /// @brief solver iterations (QR/QL sweeps, root finding sweeps)
+    uint64_t m_iterations = 0;
+
+    /// @brief calls that did not converge, found a singular / indefinite matrix or threw
+    uint64_t m_failures = 0;
+};
+
+/// @brief Counters of every operation, indexed by Profile_Op_t
+typedef std::array<Profile_Counter_t, (size_t) Profile_Op_t::COUNT> Profile_Snapshot_t;
+
+///--------------------------------------------------------
+/// @brief Was the library built with MATRIX_PROFILE?
+///
+/// @return true if the counters are recorded
+bool profile_enabled();
+
+///--------------------------------------------------------
+/// @brief Returns the JSON / display name of an operation, e.g. "lu"
+///
+/// @param op operation
+///
+/// @return lower case name
+const char* profile_op_name(const Profile_Op_t& op);
+
+///--------------------------------------------------------
+/// @brief Adds one call to the calling thread's counters, used by Profile_Scope_t
+///
+/// @param op operation
+/// @param ns duration of the call
+/// @param flops estimated floating point operations
+/// @param bytes bytes allocated
+/// @param iterations solver iterations
+/// @param failed did the call fail
+void profile_record(const Profile_Op_t& op, const uint64_t& ns, const uint64_t& flops, const uint64_t& bytes,
+                    const uint64_t& iterations, const bool& failed);
+
+///--------------------------------------------------------
+/// @brief Sums the counters of every thread, threads that have exited included
+/// Safe to call while other threads are recording, each field is read atomically
+///
+/// @return totals per operation
+Profile_Snapshot_t profile_snapshot();
+
+///--------------------------------------------------------
+/// @brief Returns the calling thread's counters only
+///
+/// @return totals per operation
+Profile_Snapshot_t profile_thread_snapshot();
+
+///--------------------------------------------------------
+/// @brief Zeroes the counters of every thread
+void profile_reset();
+
+///--------------------------------------------------------
+/// @brief Writes a snapshot as a JSON object keyed by operation name, operations
+/// with no calls are left out
+///
+/// @param os output stream
+/// @param snapshot counters to write
+void profile_write_json(std::ostream& os, const Profile_Snapshot_t& snapshot);
+
+///--------------------------------------------------------
+/// @brief Returns profile_snapshot() as JSON, see profile_write_json
+///
+/// @return JSON text
+std::string profile_json();
+
+/// @brief Times one call of an operation from construction to destruction and records it
+class Profile_Scope_t
+{
+    public:
+#ifdef MATRIX_PROFILE
+        ///--------------------------------------------------------
+        /// @brief Constructor, starts the timer
+        ///
+        /// @param op operation being timed
+        /// @param flops estimated floating point operations of the call
+        /// @param bytes bytes the call allocates
+        Profile_Scope_t(const Profile_Op_t& op, const double& flops = 0, const size_t& bytes = 0)
+            : m_op(op), m_flops((uint64_t) flops), m_bytes(bytes),
+              m_exceptions(std::uncaught_exceptions()), m_start(std::chrono::steady_clock::now())
+        {
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, records the call, leaving through an exception counts as a failure
+        ~Profile_Scope_t()
+        {
+            const uint64_t ns = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start).count();
+            profile_record(m_op, ns, m_flops, m_bytes, m_iterations,
+                           m_failed || std::uncaught_exceptions() > m_exceptions);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adds solver iterations to the call
+        ///
+        /// @param count iterations
+        void addIterations(const size_t& count)
+        {
+            m_iterations += count;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adds floating point operations known only once the call has started
+        ///
+        /// @param flops estimated floating point operations
+        void addFlops(const double& flops)
+        {
+            m_flops += (uint64_t) flops;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Marks the call as failed (unconverged, singular)
+        ///
+        /// @param failed true if it failed
+        void setFailed(const bool& failed)
+        {
+            m_failed = failed;
+        };
+#else
+        Profile_Scope_t(const Profile_Op_t&, const double& = 0, const size_t& = 0)
+        {
+        };
+
+        void addIterations(const size_t&)
+        {
+        };
+
+        void addFlops(const double&)
+        {
+        };
+
+        void setFailed(const bool&)
+        {
+        };
+#endif
+
+        Profile_Scope_t(const Profile_Scope_t&) = delete;
+        Profile_Scope_t& operator=(const Profile_Scope_t&) = delete;
+
+#ifdef MATRIX_PROFILE
+    private:
+        Profile_Op_t m_op;
+        uint64_t m_flops;
+        uint64_t m_bytes;
+        uint64_t m_iterations = 0;
+        bool m_failed = false;
+        int m_exceptions;
+        std::chrono::steady_clock::time_point m_start;
+#endif
+};
@@ -0,0 +1,580 @@
+/// ------------------------------------------
+/// @file QR.h
+///
+/// @brief Header/Source file for the Householder QR factorization object
+///
+/// Factorizes A = QR in place on a working copy. R is kept in the upper triangle,
+/// the Householder vectors below the diagonal (unit leading element implied) and
+/// their scale factors in a tau vector, so Q is never formed unless asked for.
+/// Wide matrices are factorized in panels applied as compact WY block reflectors
+/// (I - V T V^H) so the trailing update runs through gemm
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Gemm.h"
+#include "Storage.h"
+#include "Thread_Pool.h"
+#include "Profile.h"
+#include "Scalar.h"
+#include "Triangular.h"
+
+/// Number of columns factorized per panel in the blocked factorization
+#ifndef QR_BLOCK_SIZE
+#define QR_BLOCK_SIZE 32
+#endif
+
+/// Minimum column count before the blocked (compact WY) factorization is used
+#ifndef QR_BLOCKED_LIMIT
+#define QR_BLOCKED_LIMIT 128
+#endif
+
+/// @brief Templated class for factorizing a matrix into A = QR with Householder reflections
+template <typename T>
+class QR
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes the given (m,n) matrix
+        ///
+        /// @param mat matrix to factorize
+        QR(const Matrix<T>& mat) : m_qr(mat), m_tau(std::min(mat.getRowCount(), mat.getColCount()))
+        {
+            const size_t n = m_qr.getColCount();
+
+            // 2mnk - (m + n)k^2 + 2k^3/3 for k = min(m, n) reflectors
+            const double dm = (double) m_qr.getRowCount();
+            const double dk = (double) m_tau.size();
+            Profile_Scope_t profile(Profile_Op_t::QR, 2 * dm * n * dk - (dm + n) * dk * dk + 2 * dk * dk * dk / 3,
+                                    (m_qr.getRowCount() * n + m_tau.size()) * sizeof(T));
+
+            if (n < QR_BLOCKED_LIMIT)
+            {
+                _factorize_panel(0, m_tau.size(), n);
+                return;
+            }
+
+            const size_t k = m_tau.size();
+            for (size_t k0 = 0; k0 < k; k0 += QR_BLOCK_SIZE)
+            {
+                const size_t nb = std::min<size_t>(QR_BLOCK_SIZE, k - k0);
+
+                // factor the panel only, then apply it to the trailing columns as one block
+                _factorize_panel(k0, k0 + nb, k0 + nb);
+                if (k0 + nb < n)
+                {
+                    T* trailing = m_qr.get_data() + k0 * n + k0 + nb;
+                    _apply_block_left(k0, nb, trailing, n, n - k0 - nb, true);
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Builds the upper triangular R factor, (min(m,n),n)
+        ///
+        /// @return R matrix
+        Matrix<T> R() const
+        {
+            const size_t k = m_tau.size();
+            const size_t n = m_qr.getColCount();
+            Matrix<T> R_mat(k, n);
+
+            for (size_t i = 0; i < k; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    R_mat.get_data()[i * n + j] = (j < i) ? (T) 0 : m_qr.get_data()[i * n + j];
+                }
+            }
+
+            return R_mat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Builds the thin orthogonal (unitary) Q factor, (m,min(m,n))
+        ///
+        /// @return Q matrix
+        Matrix<T> Q() const
+        {
+            const size_t m = m_qr.getRowCount();
+            const size_t k = m_tau.size();
+
+            Matrix<T> Q_mat(m, k);
+            for (size_t i = 0; i < m; i++)
+            {
+                for (size_t j = 0; j < k; j++)
+                {
+                    Q_mat.get_data()[i * k + j] = (i == j) ? (T) 1 : (T) 0;
+                }
+            }
+
+            apply_Q(Q_mat);
+            return Q_mat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the compact QR storage
+        /// Upper triangle holds R, below it the Householder vectors (unit leading element implied)
+        ///
+        /// @return compact QR matrix
+        const Matrix<T>& getQR() const
+        {
+            return m_qr;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the Householder scale factors, H_k = I - tau_k v_k v_k^H
+        ///
+        /// @return tau vector, min(m,n) long
+        const std::vector<T>& getTau() const
+        {
+            return m_tau;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies Q^H from the left without forming Q, mat := Q^H mat
+        ///
+        /// @param mat matrix with as many rows as the factorized matrix
+        ///
+        /// @throws std::invalid_argument if row count mismatches
+        void apply_Qt(Matrix<T>& mat) const
+        {
+            _check_rows(mat);
+
+            const size_t k = m_tau.size();
+            const size_t ncols = mat.getColCount();
+
+            // Q^H = H_k^H ... H_1^H, so the first reflector is applied first
+            for (size_t k0 = 0; k0 < k; k0 += QR_BLOCK_SIZE)
+            {
+                const size_t nb = std::min<size_t>(QR_BLOCK_SIZE, k - k0);
+                _apply_block_left(k0, nb, mat.get_data() + k0 * ncols, ncols, ncols, true);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies Q from the left without forming Q, mat := Q mat
+        ///
+        /// @param mat matrix with as many rows as the factorized matrix
+        ///
+        /// @throws std::invalid_argument if row count mismatches
+        void apply_Q(Matrix<T>& mat) const
+        {
+            _check_rows(mat);
+
+            const size_t k = m_tau.size();
+            const size_t ncols = mat.getColCount();
+
+            // Q = H_1 ... H_k, so the last reflector is applied first
+            for (size_t k0 = ((k - 1) / QR_BLOCK_SIZE) * QR_BLOCK_SIZE; ; k0 -= QR_BLOCK_SIZE)
+            {
+                const size_t nb = std::min<size_t>(QR_BLOCK_SIZE, k - k0);
+                _apply_block_left(k0, nb, mat.get_data() + k0 * ncols, ncols, ncols, false);
+                if (k0 == 0) break;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies Q from the right without forming Q, mat := mat Q
+        /// e.g: forming RQ for QR iteration only needs R and this call
+        ///
+        /// @param mat matrix with as many columns as the factorized matrix has rows
+        ///
+        /// @throws std::invalid_argument if column count mismatches
+        void apply_Q_right(Matrix<T>& mat) const
+        {
+            const size_t m = m_qr.getRowCount();
+            if (mat.getColCount() != m)
+            {
+                throw std::invalid_argument("Matrix width must equal the factorized row count to apply Q");
+            }
+
+            const size_t nrows = mat.getRowCount();
+            Storage_Vector_t<T> v(m);
+            Storage_Vector_t<T> w(nrows);
+
+            // mat Q = mat H_1 ... H_k, so the first reflector is applied first
+            for (size_t k = 0; k < m_tau.size(); k++)
+            {
+                if (m_tau[k] == (T) 0)
+                {
+                    continue;
+                }
+
+                const size_t len = _load_reflector(k, v.data());
+                T* C = mat.get_data() + k;
+
+                // w = C v, then C -= tau w v^H
+                for (size_t i = 0; i < nrows; i++)
+                {
+                    const T* cRow = C + i * m;
+                    T sum = 0;
+                    for (size_t j = 0; j < len; j++)
+                    {
+                        sum += cRow[j] * v[j];
+                    }
+                    w[i] = sum * m_tau[k];
+                }
+
+                for (size_t i = 0; i < nrows; i++)
+                {
+                    T* cRow = C + i * m;
+                    for (size_t j = 0; j < len; j++)
+                    {
+                        cRow[j] -= w[i] * scalar_conj(v[j]);
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x, least squares solution if A is tall
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, A is wide or R is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            Matrix<T> rhs(solutions.size(), 1);
+            memcpy(rhs.get_data(), solutions.get_data(), solutions.size() * sizeof(T));
+
+            Matrix<T> res = solve(rhs);
+
+            Vector<T> outVec(res.getRowCount());
+            memcpy(outVec.get_data(), res.get_data(), res.getRowCount() * sizeof(T));
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B for X, each column of B is a separate right hand side
+        /// Least squares solution if A is tall
+        ///
+        /// @param solutions right hand side matrix B
+        ///
+        /// @return matrix X, (n, columns of B)
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, A is wide or R is singular
+        Matrix<T> solve(const Matrix<T>& solutions) const
+        {
+            const size_t m = m_qr.getRowCount();
+            const size_t n = m_qr.getColCount();
+            if (m < n)
+            {
+                throw std::invalid_argument("QR solve requires at least as many rows as columns");
+            }
+
+            Matrix<T> y = solutions;
+            apply_Qt(y);
+
+            // back substitute R x = (Q^H b), only the first n rows take part
+            const size_t nrhs = y.getColCount();
+            Matrix<T> x(n, nrhs);
+            memcpy(x.get_data(), y.get_data(), n * nrhs * sizeof(T));
+
+            if (!triangular_solve(Triangle_t::UPPER, false, false, n, m_qr.get_data(), n, x.get_data(), nrhs))
+            {
+                throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+            }
+
+            return x;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the inverse of the factorized matrix, R^-1 Q^H
+        ///
+        /// @return the inverse matrix
+        ///
+        /// @throws std::invalid_argument if matrix is not square or is singular
+        Matrix<T> inverse() const
+        {
+            if (m_qr.getRowCount() != m_qr.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to have an inverse");
+            }
+
+            return solve(Matrix<T>::identity(m_qr.getRowCount()));
+        };
+
+    private:
+        /// @brief R in the upper triangle, Householder vectors below it
+        Matrix<T> m_qr;
+
+        /// @brief Householder scale factors, H_k = I - tau_k v_k v_k^H
+        std::vector<T> m_tau;
+
+        ///--------------------------------------------------------
+        /// @brief Checks a matrix has the row count of the factorized matrix
+        ///
+        /// @throws std::invalid_argument if not
+        void _check_rows(const Matrix<T>& mat) const
+        {
+            if (mat.getRowCount() != m_qr.getRowCount())
+            {
+                throw std::invalid_argument("Matrix height must equal the factorized row count to apply Q");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies Householder vector k out of the working copy into a contiguous buffer
+        ///
+        /// @param k reflector index
+        /// @param v output buffer, at least m-k long
+        ///
+        /// @return length of the reflector (m-k)
+        size_t _load_reflector(const size_t& k, T* v) const
+        {
+            const size_t m = m_qr.getRowCount();
+            const size_t n = m_qr.getColCount();
+            const T* qr = m_qr.get_data();
+
+            v[0] = (T) 1;
+            for (size_t i = k + 1; i < m; i++)
+            {
+                v[i - k] = qr[i * n + k];
+            }
+
+            return m - k;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unblocked factorization of columns [kBegin, kEnd)
+        /// Each reflector is applied to the columns up to colEnd
+        ///
+        /// @param kBegin first column to factorize
+        /// @param kEnd one past the last column to factorize
+        /// @param colEnd one past the last column to update
+        void _factorize_panel(const size_t& kBegin, const size_t& kEnd, const size_t& colEnd)
+        {
+            const size_t m = m_qr.getRowCount();
+            const size_t n = m_qr.getColCount();
+            T* qr = m_qr.get_data();
+
+            Storage_Vector_t<T> v(m);
+            Storage_Vector_t<T> w(n);
+
+            for (size_t k = kBegin; k < kEnd; k++)
+            {
+                // generate reflector so that H^H x = beta e1 (follows LAPACK xLARFG)
+                const T alpha = qr[k * n + k];
+                double xnorm = 0;
+                for (size_t i = k + 1; i < m; i++)
+                {
+                    const double a = scalar_abs(qr[i * n + k]);
+                    xnorm += a * a;
+                }
+
+                const double alphaAbs = scalar_abs(alpha);
+                if (xnorm == 0 && scalar_abs(alpha - scalar_conj(alpha)) == 0)
+                {
+                    // column already reduced and alpha is real, H = I
+                    m_tau[k] = (T) 0;
+                    continue;
+                }
+
+                double beta = std::sqrt(alphaAbs * alphaAbs + xnorm);
+                if (scalar_real(alpha) >= 0)
+                {
+                    beta = -beta;
+                }
+
+                m_tau[k] = ((T) beta - alpha) / (T) beta;
+                const T scale = (T) 1 / (alpha - (T) beta);
+                for (size_t i = k + 1; i < m; i++)
+                {
+                    qr[i * n + k] = qr[i * n + k] * scale;
+                }
+                qr[k * n + k] = (T) beta;
+
+                if (k + 1 >= colEnd)
+                {
+                    continue;
+                }
+
+                // apply H^H = I - conj(tau) v v^H to the remaining columns of the panel
+                const size_t len = _load_reflector(k, v.data());
+                _reflect_left(v.data(), len, scalar_conj(m_tau[k]), qr + k * n + k + 1, n, colEnd - k - 1, w.data());
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies a single reflector from the left, C := (I - tau v v^H) C
+        ///
+        /// @param v reflector, len long
+        /// @param len rows of C
+        /// @param tau scale factor to use
+        /// @param C top left of the block to update
+        /// @param ldc row stride of C
+        /// @param ncols columns of C
+        /// @param w workspace, at least ncols long
+        static void _reflect_left(const T* v, const size_t& len, const T& tau, T* C, const size_t& ldc, const size_t& ncols, T* w)
+        {
+            // columns are independent, so each task owns a band of columns of C and w
+            parallel_for(0, ncols, parallel_grain(2 * len), [&](size_t from, size_t to)
+            {
+                // w = v^H C, accumulated row by row so every access is contiguous
+                for (size_t j = from; j < to; j++)
+                {
+                    w[j] = (T) 0;
+                }
+                for (size_t i = 0; i < len; i++)
+                {
+                    const T vi = scalar_conj(v[i]);
+                    const T* cRow = C + i * ldc;
+                    for (size_t j = from; j < to; j++)
+                    {
+                        w[j] += vi * cRow[j];
+                    }
+                }
+
+                for (size_t i = 0; i < len; i++)
+                {
+                    const T factor = tau * v[i];
+                    T* cRow = C + i * ldc;
+                    for (size_t j = from; j < to; j++)
+                    {
+                        cRow[j] -= factor * w[j];
+                    }
+                }
+            });
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies the block of nb reflectors starting at k0 from the left
+        /// Small blocks are applied one reflector at a time, larger ones as I - V T V^H via gemm
+        ///
+        /// @param k0 first reflector of the block
+        /// @param nb number of reflectors in the block
+        /// @param C rows k0.. of the matrix being updated
+        /// @param ldc row stride of C
+        /// @param ncols columns of C
+        /// @param conjTrans apply the block's conjugate transpose (for Q^H) if true
+        void _apply_block_left(const size_t& k0, const size_t& nb, T* C, const size_t& ldc, const size_t& ncols, const bool& conjTrans) const
+        {
+            const size_t m = m_qr.getRowCount();
+            const size_t len = m - k0;
+
+            // narrow updates do not amortise forming the block reflector
+            if (nb == 1 || ncols < QR_BLOCK_SIZE)
+            {
+                Storage_Vector_t<T> v(len);
+                Storage_Vector_t<T> w(ncols);
+
+                // block reflector is H_k0 ... H_k0+nb-1
+                for (size_t step = 0; step < nb; step++)
+                {
+                    const size_t k = conjTrans ? k0 + step : k0 + nb - 1 - step;
+                    if (m_tau[k] == (T) 0)
+                    {
+                        continue;
+                    }
+
+                    const size_t vlen = _load_reflector(k, v.data());
+                    const T tau = conjTrans ? scalar_conj(m_tau[k]) : m_tau[k];
+                    _reflect_left(v.data(), vlen, tau, C + (k - k0) * ldc, ldc, ncols, w.data());
+                }
+                return;
+            }
+
+            // explicit V (len x nb, unit diagonal) and its conjugate transpose
+            Storage_Vector_t<T> V(len * nb, (T) 0);
+            Storage_Vector_t<T> Vh(nb * len, (T) 0);
+            Storage_Vector_t<T> v(len);
+            for (size_t j = 0; j < nb; j++)
+            {
+                const size_t vlen = _load_reflector(k0 + j, v.data());
+                for (size_t i = 0; i < vlen; i++)
+                {
+                    V[(i + j) * nb + j] = v[i];
+                    Vh[j * len + i + j] = scalar_conj(v[i]);
+                }
+            }
+
+            // upper triangular T such that H_k0 ... H_k0+nb-1 = I - V T V^H (follows LAPACK xLARFT)
+            Storage_Vector_t<T> Tm(nb * nb, (T) 0);
+            for (size_t i = 0; i < nb; i++)
+            {
+                const T tau = m_tau[k0 + i];
+                Tm[i * nb + i] = tau;
+                if (i == 0 || tau == (T) 0)
+                {
+                    continue;
+                }
+
+                // z = -tau V[:,0:i]^H v_i
+                Storage_Vector_t<T> z(i, (T) 0);
+                for (size_t r = 0; r < len; r++)
+                {
+                    const T vri = V[r * nb + i];
+                    if (vri == (T) 0)
+                    {
+                        continue;
+                    }
+                    for (size_t c = 0; c < i; c++)
+                    {
+                        z[c] += Vh[c * len + r] * vri;
+                    }
+                }
+
+                // T[0:i, i] = T[0:i, 0:i] z
+                for (size_t r = 0; r < i; r++)
+                {
+                    T sum = 0;
+                    for (size_t c = r; c < i; c++)
+                    {
+                        sum += Tm[r * nb + c] * z[c];
+                    }
+                    Tm[r * nb + i] = -tau * sum;
+                }
+            }
+
+            // W = V^H C
+            Storage_Vector_t<T> W(nb * ncols);
+            gemm(nb, ncols, len, Vh.data(), len, (size_t) 1, (const T*) C, ldc, (size_t) 1, W.data(), ncols);
+
+            // W = T W (or T^H W), T is upper triangular so T^H is lower
+            Storage_Vector_t<T> TW(nb * ncols);
+            for (size_t r = 0; r < nb; r++)
+            {
+                T* out = TW.data() + r * ncols;
+                for (size_t j = 0; j < ncols; j++)
+                {
+                    out[j] = (T) 0;
+                }
+
+                const size_t cBegin = conjTrans ? 0 : r;
+                const size_t cEnd = conjTrans ? r + 1 : nb;
+                for (size_t c = cBegin; c < cEnd; c++)
+                {
+                    const T t = conjTrans ? scalar_conj(Tm[c * nb + r]) : Tm[r * nb + c];
+                    const T* wRow = W.data() + c * ncols;
+                    for (size_t j = 0; j < ncols; j++)
+                    {
+                        out[j] += t * wRow[j];
+                    }
+                }
+            }
+
+            // C -= V W
+            Storage_Vector_t<T> VW(len * ncols);
+            gemm(len, ncols, nb, (const T*) V.data(), nb, (size_t) 1, (const T*) TW.data(), ncols, (size_t) 1, VW.data(), ncols);
+            for (size_t i = 0; i < len; i++)
+            {
+                T* cRow = C + i * ldc;
+                const T* vwRow = VW.data() + i * ncols;
+                for (size_t j = 0; j < ncols; j++)
+                {
+                    cRow[j] -= vwRow[j];
+                }
+            }
+        };
+};
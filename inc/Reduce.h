@@ -0,0 +1,602 @@
+/// ------------------------------------------
+/// @file Reduce.h
+///
+/// @brief Header/Source file for the reductions (sums, dot products, norms, counts) shared by
+/// Matrix, Vector and the solvers
+///
+/// Every reduction is an operation struct run by one engine. The engine sums pairwise: runs
+/// of REDUCE_LEAF elements are reduced straight into REDUCE_LANES independent accumulators,
+/// which the compiler keeps in SIMD registers for float and double, and the leaf results are
+/// combined as a balanced tree, so the rounding error grows with log(n) rather than n.
+/// Arrays longer than REDUCE_BLOCK are cut into fixed blocks reduced in parallel and combined
+/// by the same tree, the result does not depend on the thread count
+///
+/// Per-type work (magnitudes, conjugates, zero tests) goes through Scalar_Traits, so a
+/// user-defined type only needs its Scalar_Traits specialisation to use these
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+
+#include "Scalar.h"
+#include "Thread_Pool.h"
+#include "Complex_C.h"
+#include "Complex_Kernels.h"
+
+/// Independent accumulators per leaf, a power of two and multiple of the SIMD width keeps every lane busy
+#ifndef REDUCE_LANES
+#define REDUCE_LANES 16
+#endif
+
+/// Bytes per SIMD register the accumulators are held in
+#ifndef REDUCE_VECTOR_BYTES
+#if defined(__AVX512F__)
+#define REDUCE_VECTOR_BYTES 64
+#elif defined(__AVX__)
+#define REDUCE_VECTOR_BYTES 32
+#else
+#define REDUCE_VECTOR_BYTES 16
+#endif
+#endif
+
+/// Elements reduced straight into the accumulators before pairwise combining, multiple of REDUCE_LANES
+#ifndef REDUCE_LEAF
+#define REDUCE_LEAF 1024
+#endif
+
+/// Elements per parallel block, multiple of REDUCE_LEAF, arrays no longer than this run serially
+#ifndef REDUCE_BLOCK
+#define REDUCE_BLOCK 32768
+#endif
+
+/// @brief sum of x
+template <typename T>
+struct Reduce_Sum_t
+{
+    typedef T Acc_t;
+    static constexpr bool binary = false;
+    static constexpr bool lanes = std::is_floating_point_v<T>;
+
+    static Acc_t identity() { return (T) 0; }
+    static Acc_t step(const Acc_t& acc, const T& x, const T&) { return acc + x; }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return lacc + racc; }
+
+    template <typename V>
+    static void lane(V& acc, const V& x, const V&) { acc += x; }
+
+    template <typename V>
+    static void lane_combine(V& acc, const V& other) { acc += other; }
+};
+
+/// @brief sum of |x|^2, accumulated in T for floating point and double otherwise
+template <typename T>
+struct Reduce_Squares_t
+{
+    typedef std::conditional_t<std::is_floating_point_v<T>, T, double> Acc_t;
+    static constexpr bool binary = false;
+    static constexpr bool lanes = std::is_floating_point_v<T>;
+
+    static Acc_t identity() { return 0; }
+    static Acc_t step(const Acc_t& acc, const T& x, const T&) { return acc + (Acc_t) scalar_abs2(x); }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return lacc + racc; }
+
+    template <typename V>
+    static void lane(V& acc, const V& x, const V&) { acc += x * x; }
+
+    template <typename V>
+    static void lane_combine(V& acc, const V& other) { acc += other; }
+};
+
+/// @brief sum of |x|
+template <typename T>
+struct Reduce_Abs_t
+{
+    typedef std::conditional_t<std::is_floating_point_v<T>, T, double> Acc_t;
+    static constexpr bool binary = false;
+    static constexpr bool lanes = std::is_floating_point_v<T>;
+
+    static Acc_t identity() { return 0; }
+    static Acc_t step(const Acc_t& acc, const T& x, const T&) { return acc + (Acc_t) scalar_abs(x); }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return lacc + racc; }
+
+    template <typename V>
+    static void lane(V& acc, const V& x, const V&) { acc += (x < 0 ? -x : x); }
+
+    template <typename V>
+    static void lane_combine(V& acc, const V& other) { acc += other; }
+};
+
+/// @brief largest |x|, NaN values are skipped
+template <typename T>
+struct Reduce_Max_Abs_t
+{
+    typedef std::conditional_t<std::is_floating_point_v<T>, T, double> Acc_t;
+    static constexpr bool binary = false;
+    static constexpr bool lanes = std::is_floating_point_v<T>;
+
+    static Acc_t identity() { return 0; }
+    static Acc_t step(const Acc_t& acc, const T& x, const T&) { return combine(acc, (Acc_t) scalar_abs(x)); }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return (lacc < racc) ? racc : lacc; }
+
+    template <typename V>
+    static void lane(V& acc, const V& x, const V&)
+    {
+        const V mag = x < 0 ? -x : x;
+        acc = (acc < mag) ? mag : acc;
+    }
+
+    template <typename V>
+    static void lane_combine(V& acc, const V& other) { acc = (acc < other) ? other : acc; }
+};
+
+/// @brief smallest |x|, infinity for no elements, NaN values are skipped
+template <typename T>
+struct Reduce_Min_Abs_t
+{
+    typedef std::conditional_t<std::is_floating_point_v<T>, T, double> Acc_t;
+    static constexpr bool binary = false;
+    static constexpr bool lanes = std::is_floating_point_v<T>;
+
+    static Acc_t identity() { return std::numeric_limits<Acc_t>::infinity(); }
+    static Acc_t step(const Acc_t& acc, const T& x, const T&) { return combine(acc, (Acc_t) scalar_abs(x)); }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return (racc < lacc) ? racc : lacc; }
+
+    template <typename V>
+    static void lane(V& acc, const V& x, const V&)
+    {
+        const V mag = x < 0 ? -x : x;
+        acc = (mag < acc) ? mag : acc;
+    }
+
+    template <typename V>
+    static void lane_combine(V& acc, const V& other) { acc = (other < acc) ? other : acc; }
+};
+
+/// @brief sum of x * y
+template <typename T>
+struct Reduce_Dot_t
+{
+    typedef T Acc_t;
+    static constexpr bool binary = true;
+    static constexpr bool lanes = std::is_floating_point_v<T>;
+
+    static Acc_t identity() { return (T) 0; }
+    static Acc_t step(const Acc_t& acc, const T& x, const T& y) { return acc + x * y; }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return lacc + racc; }
+
+    template <typename V>
+    static void lane(V& acc, const V& x, const V& y) { acc += x * y; }
+
+    template <typename V>
+    static void lane_combine(V& acc, const V& other) { acc += other; }
+};
+
+/// @brief sum of conj(x) * y
+template <typename T>
+struct Reduce_Dotc_t
+{
+    typedef T Acc_t;
+    static constexpr bool binary = true;
+    static constexpr bool lanes = std::is_floating_point_v<T>;
+
+    static Acc_t identity() { return (T) 0; }
+    static Acc_t step(const Acc_t& acc, const T& x, const T& y) { return acc + scalar_conj(x) * y; }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return lacc + racc; }
+
+    template <typename V>
+    static void lane(V& acc, const V& x, const V& y) { acc += x * y; }
+
+    template <typename V>
+    static void lane_combine(V& acc, const V& other) { acc += other; }
+};
+
+/// @brief number of exact zeros
+template <typename T>
+struct Reduce_Zeros_t
+{
+    typedef size_t Acc_t;
+    static constexpr bool binary = false;
+    static constexpr bool lanes = false;
+
+    static Acc_t identity() { return 0; }
+    static Acc_t step(const Acc_t& acc, const T& x, const T&) { return acc + (Scalar_Traits<T>::is_zero(x) ? 1 : 0); }
+    static Acc_t combine(const Acc_t& lacc, const Acc_t& racc) { return lacc + racc; }
+};
+
+///--------------------------------------------------------
+/// @brief Reduces one leaf straight through the accumulators
+///
+/// @param x first operand
+/// @param y second operand, x again for unary operations
+/// @param len elements, at most REDUCE_LEAF
+///
+/// @return leaf result
+template <typename Op_t, typename T>
+typename Op_t::Acc_t _reduce_leaf(const T* x, const T* y, const size_t& len)
+{
+    typedef typename Op_t::Acc_t Acc_t;
+
+    Acc_t acc = Op_t::identity();
+    size_t i = 0;
+
+#if defined(__GNUC__)
+    if constexpr (Op_t::lanes)
+    {
+        // REDUCE_LANES accumulators as separate dependency chains of native width registers
+        typedef T Lane_Vec_t __attribute__((vector_size(REDUCE_VECTOR_BYTES)));
+        constexpr size_t width = REDUCE_VECTOR_BYTES / sizeof(T);
+        constexpr size_t chains = (REDUCE_LANES + width - 1) / width;
+        static_assert((chains & (chains - 1)) == 0, "REDUCE_LANES must be a power of two");
+
+        Lane_Vec_t accs[chains];
+#pragma GCC unroll 16
+        for (size_t k = 0; k < chains; k++)
+        {
+            accs[k] = Lane_Vec_t{} + Op_t::identity();
+        }
+
+        for (; i + chains * width <= len; i += chains * width)
+        {
+#pragma GCC unroll 16
+            for (size_t k = 0; k < chains; k++)
+            {
+                Lane_Vec_t xv, yv;
+                memcpy(&xv, x + i + k * width, sizeof(Lane_Vec_t));
+                if constexpr (Op_t::binary)
+                {
+                    memcpy(&yv, y + i + k * width, sizeof(Lane_Vec_t));
+                }
+                else
+                {
+                    yv = xv;
+                }
+                Op_t::lane(accs[k], xv, yv);
+            }
+        }
+
+        // fold the chains then the lanes as a tree too
+#pragma GCC unroll 16
+        for (size_t half = chains / 2; half > 0; half /= 2)
+        {
+#pragma GCC unroll 16
+            for (size_t k = 0; k < half; k++)
+            {
+                Op_t::lane_combine(accs[k], accs[k + half]);
+            }
+        }
+        for (size_t l = 0; l < width; l++)
+        {
+            acc = Op_t::combine(acc, accs[0][l]);
+        }
+    }
+#endif
+
+    for (; i < len; i++)
+    {
+        acc = Op_t::step(acc, x[i], y[i]);
+    }
+
+    return acc;
+}
+
+///--------------------------------------------------------
+/// @brief Reduces [from, to) by splitting at leaf boundaries until each half is one leaf
+///
+/// @param x first operand
+/// @param y second operand, x again for unary operations
+/// @param from first index
+/// @param to one past the last index
+///
+/// @return result over the range
+template <typename Op_t, typename T>
+typename Op_t::Acc_t _reduce_pairwise(const T* x, const T* y, const size_t& from, const size_t& to)
+{
+    if (to - from <= REDUCE_LEAF)
+    {
+        return _reduce_leaf<Op_t>(x + from, y + from, to - from);
+    }
+
+    const size_t leaves = (to - from) / REDUCE_LEAF;
+    const size_t mid = from + ((leaves + 1) / 2) * REDUCE_LEAF;
+    return Op_t::combine(_reduce_pairwise<Op_t>(x, y, from, mid), _reduce_pairwise<Op_t>(x, y, mid, to));
+}
+
+///--------------------------------------------------------
+/// @brief Runs a reduction, in parallel blocks of REDUCE_BLOCK elements past one block
+///
+/// @param len elements
+/// @param x first operand
+/// @param y second operand, x again for unary operations
+///
+/// @return result over all elements, Op_t::identity() if len is 0
+template <typename Op_t, typename T>
+typename Op_t::Acc_t _reduce(const size_t& len, const T* x, const T* y)
+{
+    typedef typename Op_t::Acc_t Acc_t;
+
+    if (len == 0)
+    {
+        return Op_t::identity();
+    }
+    if (len <= REDUCE_BLOCK)
+    {
+        return _reduce_pairwise<Op_t>(x, y, 0, len);
+    }
+
+    // fixed blocks so the combining order, and with it the rounding, is the same on any pool size
+    std::vector<Acc_t> partial((len + REDUCE_BLOCK - 1) / REDUCE_BLOCK, Op_t::identity());
+    parallel_for(0, partial.size(), parallel_grain(REDUCE_BLOCK), [&](size_t from, size_t to)
+    {
+        for (size_t b = from; b < to; b++)
+        {
+            partial[b] = _reduce_pairwise<Op_t>(x, y, b * REDUCE_BLOCK, std::min(len, (b + 1) * REDUCE_BLOCK));
+        }
+    });
+
+    for (size_t width = 1; width < partial.size(); width *= 2)
+    {
+        for (size_t b = 0; b + width < partial.size(); b += 2 * width)
+        {
+            partial[b] = Op_t::combine(partial[b], partial[b + width]);
+        }
+    }
+
+    return partial[0];
+}
+
+///--------------------------------------------------------
+/// @brief Sum of an array
+///
+/// @param len elements
+/// @param x array
+///
+/// @return sum of x[i]
+template <typename T>
+T reduce_sum(const size_t& len, const T* x)
+{
+    return _reduce<Reduce_Sum_t<T>>(len, x, x);
+}
+
+///--------------------------------------------------------
+/// @brief Unconjugated dot product
+///
+/// @param len elements
+/// @param x first array
+/// @param y second array
+///
+/// @return sum of x[i] * y[i]
+template <typename T>
+T reduce_dot(const size_t& len, const T* x, const T* y)
+{
+    if constexpr (std::is_same_v<T, Complex_C_t>)
+    {
+        // split into real/imaginary blocks for the SIMD kernels
+        return complex_dot(len, x, y);
+    }
+    else
+    {
+        return _reduce<Reduce_Dot_t<T>>(len, x, y);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Conjugated (inner) product, same as reduce_dot for real types
+///
+/// @param len elements
+/// @param x first array, conjugated
+/// @param y second array
+///
+/// @return sum of conj(x[i]) * y[i]
+template <typename T>
+T reduce_dotc(const size_t& len, const T* x, const T* y)
+{
+    return _reduce<Reduce_Dotc_t<T>>(len, x, y);
+}
+
+///--------------------------------------------------------
+/// @brief Sum of squared magnitudes
+///
+/// @param len elements
+/// @param x array
+///
+/// @return sum of |x[i]|^2
+template <typename T>
+double reduce_sum_squares(const size_t& len, const T* x)
+{
+    if constexpr (std::is_same_v<T, Complex_C_t>)
+    {
+        // |a + bi|^2 = a^2 + b^2, so the interleaved components reduce as one real array
+        static_assert(sizeof(Complex_C_t) == 2 * sizeof(double), "Complex_C_t must be two packed doubles");
+        return reduce_sum_squares(2 * len, reinterpret_cast<const double*>(x));
+    }
+    else
+    {
+        return (double) _reduce<Reduce_Squares_t<T>>(len, x, x);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Euclidean (2-) norm of an array, the Frobenius norm of a contiguous matrix
+///
+/// @param len elements
+/// @param x array
+///
+/// @return sqrt of the sum of |x[i]|^2
+template <typename T>
+double reduce_norm2(const size_t& len, const T* x)
+{
+    return std::sqrt(reduce_sum_squares(len, x));
+}
+
+///--------------------------------------------------------
+/// @brief Sum of magnitudes
+///
+/// @param len elements
+/// @param x array
+///
+/// @return sum of |x[i]|
+template <typename T>
+double reduce_asum(const size_t& len, const T* x)
+{
+    return (double) _reduce<Reduce_Abs_t<T>>(len, x, x);
+}
+
+///--------------------------------------------------------
+/// @brief Largest magnitude
+///
+/// @param len elements
+/// @param x array
+///
+/// @return max of |x[i]|, 0 if len is 0
+template <typename T>
+double reduce_max_abs(const size_t& len, const T* x)
+{
+    return (double) _reduce<Reduce_Max_Abs_t<T>>(len, x, x);
+}
+
+///--------------------------------------------------------
+/// @brief Smallest magnitude
+///
+/// @param len elements
+/// @param x array
+///
+/// @return min of |x[i]|, infinity if len is 0
+template <typename T>
+double reduce_min_abs(const size_t& len, const T* x)
+{
+    return (double) _reduce<Reduce_Min_Abs_t<T>>(len, x, x);
+}
+
+///--------------------------------------------------------
+/// @brief Counts the elements that are exactly zero
+///
+/// @param len elements
+/// @param x array
+///
+/// @return number of zero elements
+template <typename T>
+size_t reduce_count_zeros(const size_t& len, const T* x)
+{
+    return _reduce<Reduce_Zeros_t<T>>(len, x, x);
+}
+
+///--------------------------------------------------------
+/// @brief 1-norm (largest column magnitude sum) of a row major matrix
+/// Accumulates every column a row at a time so the rows are read contiguously
+///
+/// @param rows row count
+/// @param cols column count
+/// @param a top left element
+/// @param lda row stride of a
+///
+/// @return max over columns of the sum of |a(i, j)|
+template <typename T>
+double reduce_norm_1(const size_t& rows, const size_t& cols, const T* a, const size_t& lda)
+{
+    std::vector<double> colSums(cols, 0.0);
+    parallel_for(0, cols, parallel_grain(rows), [&](size_t from, size_t to)
+    {
+        for (size_t i = 0; i < rows; i++)
+        {
+            const T* row = a + i * lda;
+            for (size_t j = from; j < to; j++)
+            {
+                colSums[j] += scalar_abs(row[j]);
+            }
+        }
+    });
+
+    return reduce_max_abs(cols, colSums.data());
+}
+
+///--------------------------------------------------------
+/// @brief Infinity-norm (largest row magnitude sum) of a row major matrix
+///
+/// @param rows row count
+/// @param cols column count
+/// @param a top left element
+/// @param lda row stride of a
+///
+/// @return max over rows of the sum of |a(i, j)|
+template <typename T>
+double reduce_norm_inf(const size_t& rows, const size_t& cols, const T* a, const size_t& lda)
+{
+    std::vector<double> rowSums(rows, 0.0);
+    parallel_for(0, rows, parallel_grain(cols), [&](size_t from, size_t to)
+    {
+        for (size_t i = from; i < to; i++)
+        {
+            rowSums[i] = reduce_asum(cols, a + i * lda);
+        }
+    });
+
+    return reduce_max_abs(rows, rowSums.data());
+}
+
+///--------------------------------------------------------
+/// @brief Writes x / divisor to out, floating point and complex types multiply by the reciprocal
+///
+/// @param len elements
+/// @param x array to divide
+/// @param out destination, may be x itself
+/// @param divisor value to divide by
+template <typename T>
+void reduce_divide(const size_t& len, const T* x, T* out, const double& divisor)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        const T div = (T) divisor;
+        parallel_for(0, len, parallel_grain(1), [&](size_t from, size_t to)
+        {
+            for (size_t i = from; i < to; i++)
+            {
+                out[i] = x[i] / div;
+            }
+        });
+    }
+    else
+    {
+        const T scale = (T) (1.0 / divisor);
+        parallel_for(0, len, parallel_grain(1), [&](size_t from, size_t to)
+        {
+            for (size_t i = from; i < to; i++)
+            {
+                out[i] = x[i] * scale;
+            }
+        });
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Fused normalisation, one reducing pass for the 2-norm then one scaling pass
+/// straight into out, no temporary is allocated
+///
+/// @param len elements
+/// @param x array to normalise
+/// @param out destination, may be x itself to normalise in place
+///
+/// @return the 2-norm of x, out is x copied unchanged if it is 0
+template <typename T>
+double reduce_normalize(const size_t& len, const T* x, T* out)
+{
+    const double norm = reduce_norm2(len, x);
+    if (norm == 0)
+    {
+        if (out != x)
+        {
+            std::copy(x, x + len, out);
+        }
+        return norm;
+    }
+
+    reduce_divide(len, x, out, norm);
+    return norm;
+}
@@ -0,0 +1,426 @@
+/// ------------------------------------------
+/// @file Refine.h
+///
+/// @brief Header/Source file for the mixed precision iterative refinement solver
+///
+/// Ax = b is factorized once in a lower precision (float for double systems), where
+/// the factorization runs at twice the SIMD width and half the memory traffic, then
+/// each refinement step computes the residual r = b - Ax in full precision and
+/// corrects x by the low precision solve of Ad = r. Well conditioned systems reach
+/// full precision backward error in a few steps. If the low precision factorization
+/// fails, or refinement stops making progress, the system is factorized again in full
+/// precision and solved directly
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <type_traits>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Gemm.h"
+#include "LU.h"
+#include "QR.h"
+
+/// Refinement steps before giving up on the low precision factorization by default
+#ifndef REFINE_DEFAULT_MAX_ITER
+#define REFINE_DEFAULT_MAX_ITER 30
+#endif
+
+/// A step must shrink the backward error by at least this factor, or refinement has stalled
+#ifndef REFINE_STALL_RATIO
+#define REFINE_STALL_RATIO 0.5
+#endif
+
+/// @brief Factorization used at low precision
+enum class Refine_Factor_t
+{
+    LU,     // partial pivoting LU, fastest
+    QR      // Householder QR, backward stable without pivoting growth
+};
+
+/// @brief Precision the factorization is carried out in for a system of type T
+/// Types without a lower precision keep their own, Refined_Solver rejects them
+template <typename T> struct Refine_Precision_t { typedef T Low_t; };
+template <> struct Refine_Precision_t<double> { typedef float Low_t; };
+template <> struct Refine_Precision_t<long double> { typedef double Low_t; };
+
+/// @brief True if T has a lower precision to factorize in
+template <typename T>
+constexpr bool refine_scalar_v = !std::is_same_v<typename Refine_Precision_t<T>::Low_t, T>;
+
+/// @brief Stopping rules for a refined solve
+struct Refine_Options_t
+{
+    /// @brief stop once the backward error is at or below this, 0 uses epsilon(T) * sqrt(n)
+    double m_tol = 0;
+
+    /// @brief refinement steps allowed before falling back to the full precision factorization
+    size_t m_max_iter = REFINE_DEFAULT_MAX_ITER;
+
+    /// @brief fall back as soon as a step fails to shrink the backward error by REFINE_STALL_RATIO,
+    /// otherwise the best solution found is returned unconverged
+    bool m_fallback = true;
+};
+
+/// @brief Results of a refined solve
+struct Refine_Result_t
+{
+    /// @brief refinement steps (corrections) applied to the low precision solution
+    size_t m_iterations = 0;
+
+    /// @brief normwise backward error max_j ||b_j - A x_j|| / (||A|| ||x_j|| + ||b_j||), infinity norms
+    double m_backward_error = 0;
+
+    /// @brief true if m_backward_error reached the tolerance
+    bool m_converged = false;
+
+    /// @brief true if the solution came from the full precision factorization
+    bool m_fallback = false;
+};
+
+/// @brief Templated class for solving square Ax = b by low precision factorization and refinement
+template <typename T>
+class Refined_Solver
+{
+    static_assert(refine_scalar_v<T>, "Refined_Solver only solves double or long double systems");
+
+    typedef typename Refine_Precision_t<T>::Low_t Low_t;
+
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, copies the matrix and factorizes it in low precision
+        ///
+        /// @note a matrix the low precision cannot represent, or whose low precision
+        /// factorization is singular, goes straight to the full precision one at the first solve
+        ///
+        /// @param mat square system matrix
+        /// @param factor factorization to use at low precision
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Refined_Solver(const Matrix<T>& mat, const Refine_Factor_t& factor = Refine_Factor_t::LU)
+            : m_mat(mat)
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to be solved");
+            }
+
+            const size_t n = mat.getRowCount();
+            const T* a = mat.get_data();
+            Matrix<Low_t> low(n, n);
+            Low_t* l = low.get_data();
+
+            bool representable = true;
+            m_norm = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                double rowSum = 0;
+                for (size_t j = 0; j < n; j++)
+                {
+                    const T val = a[i * n + j];
+                    rowSum += (double) std::abs(val);
+                    representable = representable && std::abs(val) <= (T) std::numeric_limits<Low_t>::max();
+                    l[i * n + j] = (Low_t) val;
+                }
+                m_norm = std::max(m_norm, rowSum);
+            }
+
+            if (!representable)
+            {
+                return;
+            }
+
+            if (factor == Refine_Factor_t::QR)
+            {
+                m_low_qr = std::make_unique<QR<Low_t>>(low);
+                m_low_ok = true;
+                for (size_t i = 0; i < n && m_low_ok; i++)
+                {
+                    m_low_ok = m_low_qr->getQR()(i, i) != (Low_t) 0;
+                }
+            }
+            else
+            {
+                m_low_lu = std::make_unique<LU<Low_t>>(low);
+                m_low_ok = !m_low_lu->isSingular();
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B, each column of B is a separate right hand side
+        ///
+        /// @param solutions right hand side matrix B
+        /// @param x output, set to the solution matrix X
+        /// @param opts stopping rules
+        ///
+        /// @return refinement steps, backward error, convergence and fallback status
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, or the matrix is singular
+        /// in full precision too
+        Refine_Result_t solve(const Matrix<T>& solutions, Matrix<T>& x, const Refine_Options_t& opts = Refine_Options_t()) const
+        {
+            const size_t n = m_mat.getRowCount();
+            if (solutions.getRowCount() != n)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            const double tol = (opts.m_tol > 0) ? opts.m_tol : std::numeric_limits<T>::epsilon() * std::sqrt((double) n);
+
+            Refine_Result_t result;
+            if (!m_low_ok)
+            {
+                return _full_solve(solutions, x, tol);
+            }
+
+            const size_t nrhs = solutions.getColCount();
+            x = _low_solve(solutions);
+            Matrix<T> r(n, nrhs);
+            result.m_backward_error = _residual(solutions, x, r);
+
+            // best iterate kept, a diverging step is never returned
+            Matrix<T> best = x;
+            double bestError = result.m_backward_error;
+            while (result.m_backward_error > tol)
+            {
+                if (result.m_iterations == opts.m_max_iter)
+                {
+                    break;
+                }
+
+                const Matrix<T> d = _low_solve(r);
+                for (size_t i = 0; i < n * nrhs; i++)
+                {
+                    x.get_data()[i] += d.get_data()[i];
+                }
+                result.m_iterations++;
+
+                const double prevError = result.m_backward_error;
+                result.m_backward_error = _residual(solutions, x, r);
+                if (result.m_backward_error < bestError)
+                {
+                    best = x;
+                    bestError = result.m_backward_error;
+                }
+
+                if (!(result.m_backward_error <= REFINE_STALL_RATIO * prevError) && result.m_backward_error > tol)
+                {
+                    break;
+                }
+            }
+
+            if (bestError <= tol)
+            {
+                x = best;
+                result.m_backward_error = bestError;
+                result.m_converged = true;
+                return result;
+            }
+
+            if (opts.m_fallback)
+            {
+                Refine_Result_t fallback = _full_solve(solutions, x, tol);
+                fallback.m_iterations = result.m_iterations;
+                return fallback;
+            }
+
+            x = best;
+            result.m_backward_error = bestError;
+            return result;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b
+        ///
+        /// @param solutions right hand side vector b
+        /// @param x output, set to the solution vector
+        /// @param opts stopping rules
+        ///
+        /// @return refinement steps, backward error, convergence and fallback status
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, or the matrix is singular
+        /// in full precision too
+        Refine_Result_t solve(const Vector<T>& solutions, Vector<T>& x, const Refine_Options_t& opts = Refine_Options_t()) const
+        {
+            const size_t n = m_mat.getRowCount();
+            if (solutions.size() != n)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Matrix<T> rhs(n, 1);
+            std::copy(solutions.get_data(), solutions.get_data() + n, rhs.get_data());
+
+            Matrix<T> res(n, 1);
+            const Refine_Result_t result = solve(rhs, res, opts);
+
+            x = Vector<T>(n);
+            std::copy(res.get_data(), res.get_data() + n, x.get_data());
+            return result;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b with the default stopping rules
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return solution vector, check the overload taking x for the backward error
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            Vector<T> x(m_mat.getRowCount());
+            solve(solutions, x);
+            return x;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Did the low precision factorization succeed? If not every solve falls back
+        ///
+        /// @return true if refinement will be attempted
+        bool isLowPrecisionUsable() const
+        {
+            return m_low_ok;
+        };
+
+    private:
+        /// @brief system matrix in full precision, for the residuals
+        Matrix<T> m_mat;
+
+        /// @brief infinity norm of the system matrix
+        double m_norm = 0;
+
+        /// @brief low precision factors, one of them is set
+        std::unique_ptr<LU<Low_t>> m_low_lu;
+        std::unique_ptr<QR<Low_t>> m_low_qr;
+
+        /// @brief false if the low precision factorization could not be made or is singular
+        bool m_low_ok = false;
+
+        /// @brief full precision factorization, made by the first solve that needs it and kept
+        mutable std::unique_ptr<LU<T>> m_full;
+        mutable std::mutex m_full_mutex;
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B with the low precision factors, B is scaled to keep it in range
+        ///
+        /// @param rhs right hand sides in full precision
+        ///
+        /// @return solutions in full precision
+        Matrix<T> _low_solve(const Matrix<T>& rhs) const
+        {
+            const size_t count = rhs.getRowCount() * rhs.getColCount();
+            const T* src = rhs.get_data();
+
+            T scale = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                scale = std::max(scale, std::abs(src[i]));
+            }
+
+            Matrix<T> outMat(rhs.getRowCount(), rhs.getColCount());
+            if (scale == (T) 0)
+            {
+                std::fill(outMat.get_data(), outMat.get_data() + count, (T) 0);
+                return outMat;
+            }
+
+            Matrix<Low_t> low(rhs.getRowCount(), rhs.getColCount());
+            for (size_t i = 0; i < count; i++)
+            {
+                low.get_data()[i] = (Low_t) (src[i] / scale);
+            }
+
+            const Matrix<Low_t> sol = m_low_lu ? m_low_lu->solve(low) : m_low_qr->solve(low);
+            for (size_t i = 0; i < count; i++)
+            {
+                outMat.get_data()[i] = (T) sol.get_data()[i] * scale;
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief r = B - AX in full precision
+        ///
+        /// @param rhs right hand sides B
+        /// @param x current solutions X
+        /// @param r output residuals
+        ///
+        /// @return backward error of X, the largest over the columns
+        double _residual(const Matrix<T>& rhs, const Matrix<T>& x, Matrix<T>& r) const
+        {
+            const size_t n = m_mat.getRowCount();
+            const size_t nrhs = rhs.getColCount();
+
+            gemm(n, nrhs, n,
+                 m_mat.get_data(), n, 1,
+                 x.get_data(), nrhs, 1,
+                 r.get_data(), nrhs);
+
+            std::vector<double> rNorm(nrhs, 0), xNorm(nrhs, 0), bNorm(nrhs, 0);
+            for (size_t i = 0; i < n; i++)
+            {
+                T* ri = r.get_data() + i * nrhs;
+                const T* bi = rhs.get_data() + i * nrhs;
+                const T* xi = x.get_data() + i * nrhs;
+                for (size_t c = 0; c < nrhs; c++)
+                {
+                    ri[c] = bi[c] - ri[c];
+                    rNorm[c] = std::max(rNorm[c], (double) std::abs(ri[c]));
+                    xNorm[c] = std::max(xNorm[c], (double) std::abs(xi[c]));
+                    bNorm[c] = std::max(bNorm[c], (double) std::abs(bi[c]));
+                }
+            }
+
+            double error = 0;
+            for (size_t c = 0; c < nrhs; c++)
+            {
+                const double denom = m_norm * xNorm[c] + bNorm[c];
+                const double colError = (denom > 0) ? rNorm[c] / denom : 0;
+
+                // NaN from an overflowed correction must not read as converged
+                error = (std::isnan(colError) || std::isnan(error)) ? std::numeric_limits<double>::quiet_NaN()
+                                                                    : std::max(error, colError);
+            }
+            return std::isnan(error) ? std::numeric_limits<double>::infinity() : error;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves with the full precision LU, made on first use
+        ///
+        /// @param rhs right hand sides B
+        /// @param x output solutions X
+        /// @param tol backward error counted as converged
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        Refine_Result_t _full_solve(const Matrix<T>& rhs, Matrix<T>& x, const double& tol) const
+        {
+            const LU<T>* full;
+            {
+                std::lock_guard<std::mutex> lock(m_full_mutex);
+                if (!m_full)
+                {
+                    m_full = std::make_unique<LU<T>>(m_mat);
+                }
+                full = m_full.get();
+            }
+
+            x = full->solve(rhs);
+
+            Refine_Result_t result;
+            Matrix<T> r(rhs.getRowCount(), rhs.getColCount());
+            result.m_backward_error = _residual(rhs, x, r);
+            result.m_fallback = true;
+            result.m_converged = result.m_backward_error <= tol;
+            return result;
+        };
+};
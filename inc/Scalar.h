@@ -0,0 +1,283 @@
+/// ------------------------------------------
+/// @file Scalar.h
+///
+/// @brief Header/Source file for per-type scalar helpers used by the factorizations
+///
+/// Every per-type decision (magnitude, conjugate, components) goes through Scalar_Traits.
+/// The primary template covers the built in arithmetic types through the std functions,
+/// the complex types specialise it below. A user-defined numeric type plugs into the
+/// factorizations and the reductions of Reduce.h by specialising Scalar_Traits the same way
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+#include "Complex_C.h"
+#include "Complex_P.h"
+#include "Complex_D.h"
+
+/// @brief Per-type scalar operations, the primary template handles real types
+template <typename T>
+struct Scalar_Traits
+{
+    /// @brief does T carry an imaginary component?
+    static constexpr bool is_complex = false;
+
+    ///--------------------------------------------------------
+    /// @brief Magnitude as a double
+    static double abs(const T& val)
+    {
+        return (double) std::abs(val);
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Squared magnitude as a double, avoids the square root of abs()
+    static double abs2(const T& val)
+    {
+        const double mag = abs(val);
+        return mag * mag;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Is val exactly zero?
+    static bool is_zero(const T& val)
+    {
+        return val == (T) 0;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Complex conjugate, unchanged for real types
+    static T conj(const T& val)
+    {
+        return val;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Real component as a double
+    static double real(const T& val)
+    {
+        return (double) val;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Imaginary component as a double
+    static double imag(const T&)
+    {
+        return 0;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Converts a cartesian complex, keeping only the real component
+    static T from_complex(const Complex_C_t& com)
+    {
+        return (T) com.m_real;
+    };
+};
+
+/// @brief Cartesian complex operations
+template <>
+struct Scalar_Traits<Complex_C_t>
+{
+    static constexpr bool is_complex = true;
+
+    static double abs(const Complex_C_t& val)
+    {
+        return val.absolute();
+    };
+
+    static double abs2(const Complex_C_t& val)
+    {
+        return val.m_real * val.m_real + val.m_imagine * val.m_imagine;
+    };
+
+    static bool is_zero(const Complex_C_t& val)
+    {
+        return val.m_real == 0 && val.m_imagine == 0;
+    };
+
+    static Complex_C_t conj(const Complex_C_t& val)
+    {
+        return val.conjugate();
+    };
+
+    static double real(const Complex_C_t& val)
+    {
+        return val.m_real;
+    };
+
+    static double imag(const Complex_C_t& val)
+    {
+        return val.m_imagine;
+    };
+
+    static Complex_C_t from_complex(const Complex_C_t& com)
+    {
+        return com;
+    };
+};
+
+/// @brief Polar complex operations
+template <>
+struct Scalar_Traits<Complex_P_t>
+{
+    static constexpr bool is_complex = true;
+
+    static double abs(const Complex_P_t& val)
+    {
+        return std::fabs(val.m_mag);
+    };
+
+    static double abs2(const Complex_P_t& val)
+    {
+        return val.m_mag * val.m_mag;
+    };
+
+    static bool is_zero(const Complex_P_t& val)
+    {
+        return val.m_mag == 0;
+    };
+
+    static Complex_P_t conj(const Complex_P_t& val)
+    {
+        return Complex_P_t{val.m_mag, -val.m_arg};
+    };
+
+    static double real(const Complex_P_t& val)
+    {
+        return val.real();
+    };
+
+    static double imag(const Complex_P_t& val)
+    {
+        return val.imaginary();
+    };
+
+    static Complex_P_t from_complex(const Complex_C_t& com)
+    {
+        return Complex_P_t{com.absolute(), (com.m_imagine == 0 && com.m_real >= 0) ? 0 : com.argument()};
+    };
+};
+
+/// @brief Dual form complex operations, each uses whichever form is already held
+template <>
+struct Scalar_Traits<Complex_D_t>
+{
+    static constexpr bool is_complex = true;
+
+    static double abs(const Complex_D_t& val)
+    {
+        return val.absolute();
+    };
+
+    static double abs2(const Complex_D_t& val)
+    {
+        return val.hasCartesian() ? val.m_real * val.m_real + val.m_imagine * val.m_imagine
+                                  : val.m_mag * val.m_mag;
+    };
+
+    static bool is_zero(const Complex_D_t& val)
+    {
+        return val.hasCartesian() ? (val.m_real == 0 && val.m_imagine == 0) : val.m_mag == 0;
+    };
+
+    static Complex_D_t conj(const Complex_D_t& val)
+    {
+        return val.conjugate();
+    };
+
+    static double real(const Complex_D_t& val)
+    {
+        return val.real();
+    };
+
+    static double imag(const Complex_D_t& val)
+    {
+        return val.imaginary();
+    };
+
+    static Complex_D_t from_complex(const Complex_C_t& com)
+    {
+        return Complex_D_t{com};
+    };
+};
+
+/// @brief Is T one of the complex number types?
+template <typename T>
+constexpr bool scalar_is_complex_v = Scalar_Traits<T>::is_complex;
+
+///--------------------------------------------------------
+/// @brief Finds the absolute value (magnitude) of a scalar as a double
+/// Used for pivot selection and convergence tests
+///
+/// @param val value to find magnitude of
+///
+/// @return magnitude of val
+template <typename T>
+double scalar_abs(const T& val)
+{
+    return Scalar_Traits<T>::abs(val);
+}
+
+///--------------------------------------------------------
+/// @brief Finds the squared magnitude of a scalar as a double
+///
+/// @param val value to find squared magnitude of
+///
+/// @return |val|^2
+template <typename T>
+double scalar_abs2(const T& val)
+{
+    return Scalar_Traits<T>::abs2(val);
+}
+
+///--------------------------------------------------------
+/// @brief Finds the complex conjugate of a scalar, real types are returned unchanged
+///
+/// @param val value to conjugate
+///
+/// @return conjugate of val
+template <typename T>
+T scalar_conj(const T& val)
+{
+    return Scalar_Traits<T>::conj(val);
+}
+
+///--------------------------------------------------------
+/// @brief Finds the real component of a scalar as a double
+///
+/// @param val value to take real component of
+///
+/// @return real component of val
+template <typename T>
+double scalar_real(const T& val)
+{
+    return Scalar_Traits<T>::real(val);
+}
+
+///--------------------------------------------------------
+/// @brief Finds the imaginary component of a scalar as a double, zero for real types
+///
+/// @param val value to take imaginary component of
+///
+/// @return imaginary component of val
+template <typename T>
+double scalar_imag(const T& val)
+{
+    return Scalar_Traits<T>::imag(val);
+}
+
+///--------------------------------------------------------
+/// @brief Converts a cartesian complex into type T
+/// Real types only keep the real component
+///
+/// @param com complex number to convert
+///
+/// @return com as type T
+template <typename T>
+T scalar_from_complex(const Complex_C_t& com)
+{
+    return Scalar_Traits<T>::from_complex(com);
+}
@@ -0,0 +1,801 @@
+/// ------------------------------------------
+/// @file Sparse.h
+///
+/// @brief Header/Source file for the compressed sparse matrix object
+///
+/// Only the non-zero values are kept, compressed by row (CSR) or by column (CSC).
+/// Each outer index (row for CSR, column for CSC) owns the run
+/// m_outer[i] .. m_outer[i+1] of m_inner/m_values, with inner indices sorted and
+/// unique. Products are computed in CSR form, CSC operands are converted first
+/// (SpMV excepted, which scatters)
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Scalar.h"
+#include "Thread_Pool.h"
+
+/// @brief Compression order of a SparseMatrix
+enum class Sparse_Format_t
+{
+    CSR,    // compressed sparse rows, fast row access and SpMV
+    CSC     // compressed sparse columns, fast column access
+};
+
+/// @brief One entry of a sparse matrix, used to build one
+template <typename T>
+struct Sparse_Triplet_t
+{
+    /// @brief row of the entry
+    size_t m_row;
+
+    /// @brief column of the entry
+    size_t m_col;
+
+    /// @brief value of the entry
+    T m_val;
+};
+
+/// @brief Templated class for storing and operating on mostly zero matricies
+template <typename T>
+class SparseMatrix
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor for an all zero sparse matrix
+        ///
+        /// @param rows number of rows
+        /// @param cols number of columns
+        /// @param format compression order
+        ///
+        /// @throws std::invalid_argument if rows/cols < 1
+        SparseMatrix(const size_t& rows, const size_t& cols, const Sparse_Format_t& format = Sparse_Format_t::CSR)
+            : m_rows(rows), m_cols(cols), m_format(format)
+        {
+            if (rows < 1 || cols < 1)
+            {
+                throw std::invalid_argument("Cols/Rows of a matrix must be above 0");
+            }
+
+            m_outer.assign(_outer_count() + 1, 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor from a list of entries, duplicates are summed
+        ///
+        /// @param rows number of rows
+        /// @param cols number of columns
+        /// @param entries entries in any order
+        /// @param format compression order
+        ///
+        /// @throws std::invalid_argument if rows/cols < 1 or an entry is out of bounds
+        SparseMatrix(const size_t& rows, const size_t& cols, const std::vector<Sparse_Triplet_t<T>>& entries,
+                     const Sparse_Format_t& format = Sparse_Format_t::CSR)
+            : SparseMatrix(rows, cols, format)
+        {
+            const bool csr = m_format == Sparse_Format_t::CSR;
+
+            // counting sort by outer index
+            for (const Sparse_Triplet_t<T>& entry : entries)
+            {
+                if (entry.m_row >= m_rows || entry.m_col >= m_cols)
+                {
+                    throw std::invalid_argument(_gen_coord_err_string(entry.m_row, entry.m_col));
+                }
+                m_outer[(csr ? entry.m_row : entry.m_col) + 1]++;
+            }
+            std::partial_sum(m_outer.begin(), m_outer.end(), m_outer.begin());
+
+            std::vector<size_t> fill(m_outer.begin(), m_outer.end() - 1);
+            m_inner.resize(entries.size());
+            m_values.resize(entries.size());
+            for (const Sparse_Triplet_t<T>& entry : entries)
+            {
+                const size_t pos = fill[csr ? entry.m_row : entry.m_col]++;
+                m_inner[pos] = csr ? entry.m_col : entry.m_row;
+                m_values[pos] = entry.m_val;
+            }
+
+            _sort_and_merge();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor from compressed arrays, taken over without copying
+        ///
+        /// @param rows number of rows
+        /// @param cols number of columns
+        /// @param outer run starts, one per outer index plus the end
+        /// @param inner inner index of each value, sorted and unique within each run
+        /// @param values the non-zero values
+        /// @param format compression order the arrays are in
+        ///
+        /// @throws std::invalid_argument if the arrays are not a valid compressed matrix
+        SparseMatrix(const size_t& rows, const size_t& cols, std::vector<size_t> outer, std::vector<size_t> inner,
+                     std::vector<T> values, const Sparse_Format_t& format = Sparse_Format_t::CSR)
+            : m_rows(rows), m_cols(cols), m_format(format),
+              m_outer(std::move(outer)), m_inner(std::move(inner)), m_values(std::move(values))
+        {
+            if (rows < 1 || cols < 1)
+            {
+                throw std::invalid_argument("Cols/Rows of a matrix must be above 0");
+            }
+
+            if (m_outer.size() != _outer_count() + 1 || m_outer.front() != 0 ||
+                m_outer.back() != m_inner.size() || m_inner.size() != m_values.size())
+            {
+                throw std::invalid_argument("Compressed arrays do not describe a matrix of this size");
+            }
+
+            for (size_t i = 0; i < _outer_count(); i++)
+            {
+                if (m_outer[i] > m_outer[i + 1])
+                {
+                    throw std::invalid_argument("Compressed run starts must not decrease");
+                }
+
+                for (size_t p = m_outer[i]; p < m_outer[i + 1]; p++)
+                {
+                    if (m_inner[p] >= _inner_count() || (p > m_outer[i] && m_inner[p] <= m_inner[p - 1]))
+                    {
+                        throw std::invalid_argument("Compressed inner indices must be in bounds, sorted and unique");
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor from a dense matrix, keeps values with magnitude above dropTol
+        ///
+        /// @param mat dense matrix to compress
+        /// @param format compression order
+        /// @param dropTol values with scalar_abs <= dropTol are left out
+        SparseMatrix(const Matrix<T>& mat, const Sparse_Format_t& format = Sparse_Format_t::CSR, const double& dropTol = 0)
+            : SparseMatrix(mat.getRowCount(), mat.getColCount(), format)
+        {
+            const bool csr = m_format == Sparse_Format_t::CSR;
+            for (size_t i = 0; i < _outer_count(); i++)
+            {
+                for (size_t j = 0; j < _inner_count(); j++)
+                {
+                    const T& val = csr ? mat(i, j) : mat(j, i);
+                    if (scalar_abs(val) > dropTol)
+                    {
+                        m_inner.push_back(j);
+                        m_values.push_back(val);
+                    }
+                }
+                m_outer[i + 1] = m_inner.size();
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Expands into a dense matrix
+        ///
+        /// @return dense copy, zeros filled in
+        Matrix<T> toDense() const
+        {
+            Matrix<T> outMat(m_rows, m_cols);
+            outMat.view().fill((T) 0);
+
+            const bool csr = m_format == Sparse_Format_t::CSR;
+            for (size_t i = 0; i < _outer_count(); i++)
+            {
+                for (size_t p = m_outer[i]; p < m_outer[i + 1]; p++)
+                {
+                    (csr ? outMat(i, m_inner[p]) : outMat(m_inner[p], i)) = m_values[p];
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Converts to another compression order, O(nnz)
+        ///
+        /// @param format order to convert to
+        ///
+        /// @return the same matrix in the requested order (a copy if already in it)
+        SparseMatrix<T> toFormat(const Sparse_Format_t& format) const
+        {
+            if (format == m_format)
+            {
+                return *this;
+            }
+
+            // the other order is the transpose's storage read back with rows and columns swapped
+            SparseMatrix<T> swapped = _transpose_storage();
+            swapped.m_format = format;
+            std::swap(swapped.m_rows, swapped.m_cols);
+            return swapped;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Create the transpose of the matrix
+        /// Reinterprets the storage in the other compression order, no values are moved
+        ///
+        /// @return the transposed matrix (CSR input gives CSC output and vice versa)
+        SparseMatrix<T> transpose() const
+        {
+            SparseMatrix<T> outMat = *this;
+            std::swap(outMat.m_rows, outMat.m_cols);
+            outMat.m_format = (m_format == Sparse_Format_t::CSR) ? Sparse_Format_t::CSC : Sparse_Format_t::CSR;
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets the value at the row col position, binary searches the run
+        ///
+        /// @param row to get value from
+        /// @param col to get value from
+        ///
+        /// @returns value at given location, zero if not stored
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
+        T get(const size_t& row, const size_t& col) const
+        {
+            if (row >= m_rows || col >= m_cols)
+            {
+                throw std::invalid_argument(_gen_coord_err_string(row, col));
+            }
+
+            const size_t outer = (m_format == Sparse_Format_t::CSR) ? row : col;
+            const size_t inner = (m_format == Sparse_Format_t::CSR) ? col : row;
+            const auto first = m_inner.begin() + m_outer[outer];
+            const auto last = m_inner.begin() + m_outer[outer + 1];
+            const auto it = std::lower_bound(first, last, inner);
+
+            return (it != last && *it == inner) ? m_values[it - m_inner.begin()] : (T) 0;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies out the leading diagonal, used by Jacobi style preconditioners
+        ///
+        /// @return vector of the min(m,n) diagonal values
+        Vector<T> diagonal() const
+        {
+            const size_t len = std::min(m_rows, m_cols);
+            Vector<T> outVec(len);
+            for (size_t i = 0; i < len; i++)
+            {
+                outVec.get_data()[i] = get(i, i);
+            }
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Sparse matrix vector product, y = A x
+        /// CSR rows are gathered in parallel, CSC columns are scattered serially
+        ///
+        /// @param x input of length cols
+        /// @param y output of length rows, overwritten (must not alias x)
+        void multiply(const T* x, T* y) const
+        {
+            if (m_format == Sparse_Format_t::CSR)
+            {
+                parallel_for(0, m_rows, parallel_grain(_avg_run() + 1), [&](size_t from, size_t to)
+                {
+                    for (size_t i = from; i < to; i++)
+                    {
+                        T sum = (T) 0;
+                        for (size_t p = m_outer[i]; p < m_outer[i + 1]; p++)
+                        {
+                            sum += m_values[p] * x[m_inner[p]];
+                        }
+                        y[i] = sum;
+                    }
+                });
+                return;
+            }
+
+            std::fill(y, y + m_rows, (T) 0);
+            for (size_t j = 0; j < m_cols; j++)
+            {
+                const T xj = x[j];
+                for (size_t p = m_outer[j]; p < m_outer[j + 1]; p++)
+                {
+                    y[m_inner[p]] += m_values[p] * xj;
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, sparse matrix vector product (SpMV)
+        ///
+        /// @param vec vector of length cols
+        ///
+        /// @return vector of length rows
+        ///
+        /// @throws std::invalid_argument if the vector length is not the column count
+        Vector<T> operator%(const Vector<T>& vec) const
+        {
+            if (vec.size() != m_cols)
+            {
+                throw std::invalid_argument("Sparse product requires a vector as long as the matrix is wide");
+            }
+
+            Vector<T> outVec(m_rows);
+            multiply(vec.get_data(), outVec.get_data());
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, sparse matrix by dense matrix product
+        /// Each output row is AXPYs of dense rows picked by the sparse row
+        ///
+        /// @param mat dense (cols, n) matrix
+        ///
+        /// @return dense (rows, n) product
+        ///
+        /// @throws std::invalid_argument if the inner dimensions differ
+        Matrix<T> operator%(const Matrix<T>& mat) const
+        {
+            if (mat.getRowCount() != m_cols)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            if (m_format != Sparse_Format_t::CSR)
+            {
+                return toFormat(Sparse_Format_t::CSR) % mat;
+            }
+
+            const size_t n = mat.getColCount();
+            Matrix<T> outMat(m_rows, n);
+
+            parallel_for(0, m_rows, parallel_grain((_avg_run() + 1) * n), [&](size_t from, size_t to)
+            {
+                for (size_t i = from; i < to; i++)
+                {
+                    Strided_View<T> outRow = outMat.row(i);
+                    outRow.fill((T) 0);
+                    for (size_t p = m_outer[i]; p < m_outer[i + 1]; p++)
+                    {
+                        outRow.axpy(m_values[p], mat.row(m_inner[p]));
+                    }
+                }
+            });
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, sparse by sparse product (SpGEMM)
+        /// Row by row Gustavson: a symbolic pass sizes each output row, then a
+        /// numeric pass fills it through a dense accumulator, both parallel over rows
+        ///
+        /// @param mat sparse (cols, n) matrix
+        ///
+        /// @return sparse (rows, n) product in CSR form, exact zeros from cancellation are kept
+        ///
+        /// @throws std::invalid_argument if the inner dimensions differ
+        SparseMatrix<T> operator%(const SparseMatrix<T>& mat) const
+        {
+            if (mat.getRowCount() != m_cols)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            if (m_format != Sparse_Format_t::CSR || mat.m_format != Sparse_Format_t::CSR)
+            {
+                return toFormat(Sparse_Format_t::CSR) % mat.toFormat(Sparse_Format_t::CSR);
+            }
+
+            const size_t n = mat.getColCount();
+            const size_t grain = parallel_grain((_avg_run() + 1) * (mat._avg_run() + 1));
+            std::vector<size_t> outer(m_rows + 1, 0);
+
+            // symbolic, marker[j] == i + 1 once column j has been seen in row i
+            parallel_for(0, m_rows, grain, [&](size_t from, size_t to)
+            {
+                std::vector<size_t> marker(n, 0);
+                for (size_t i = from; i < to; i++)
+                {
+                    size_t count = 0;
+                    for (size_t p = m_outer[i]; p < m_outer[i + 1]; p++)
+                    {
+                        const size_t k = m_inner[p];
+                        for (size_t q = mat.m_outer[k]; q < mat.m_outer[k + 1]; q++)
+                        {
+                            if (marker[mat.m_inner[q]] != i + 1)
+                            {
+                                marker[mat.m_inner[q]] = i + 1;
+                                count++;
+                            }
+                        }
+                    }
+                    outer[i + 1] = count;
+                }
+            });
+            std::partial_sum(outer.begin(), outer.end(), outer.begin());
+
+            std::vector<size_t> inner(outer.back());
+            std::vector<T> values(outer.back());
+
+            // numeric
+            parallel_for(0, m_rows, grain, [&](size_t from, size_t to)
+            {
+                std::vector<T> acc(n, (T) 0);
+                std::vector<size_t> marker(n, 0);
+                for (size_t i = from; i < to; i++)
+                {
+                    size_t fill = outer[i];
+                    for (size_t p = m_outer[i]; p < m_outer[i + 1]; p++)
+                    {
+                        const size_t k = m_inner[p];
+                        const T aik = m_values[p];
+                        for (size_t q = mat.m_outer[k]; q < mat.m_outer[k + 1]; q++)
+                        {
+                            const size_t j = mat.m_inner[q];
+                            if (marker[j] != i + 1)
+                            {
+                                marker[j] = i + 1;
+                                inner[fill++] = j;
+                                acc[j] = aik * mat.m_values[q];
+                            }
+                            else
+                            {
+                                acc[j] += aik * mat.m_values[q];
+                            }
+                        }
+                    }
+
+                    std::sort(inner.begin() + outer[i], inner.begin() + outer[i + 1]);
+                    for (size_t p = outer[i]; p < outer[i + 1]; p++)
+                    {
+                        values[p] = acc[inner[p]];
+                    }
+                }
+            });
+
+            SparseMatrix<T> outMat(m_rows, n);
+            outMat.m_outer = std::move(outer);
+            outMat.m_inner = std::move(inner);
+            outMat.m_values = std::move(values);
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of +, implements sparse matrix addition
+        ///
+        /// @param mat reference to rval matrix
+        ///
+        /// @return sum, in this matrix's compression order
+        ///
+        /// @throws std::invalid_argument if the dimensions differ
+        SparseMatrix<T> operator+(const SparseMatrix<T>& mat) const
+        {
+            return _merge(mat, (T) 1, "Matrix addition requires matricies of same dimensions");
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of -, implements sparse matrix subtraction
+        ///
+        /// @param mat reference to rval matrix
+        ///
+        /// @return difference, in this matrix's compression order
+        ///
+        /// @throws std::invalid_argument if the dimensions differ
+        SparseMatrix<T> operator-(const SparseMatrix<T>& mat) const
+        {
+            return _merge(mat, (T) -1, "Matrix subtraction requires matricies of same dimensions");
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of *, implements scalar multiplication of the stored values
+        ///
+        /// @param num scalar to multiply by
+        ///
+        /// @return multiplied matrix
+        SparseMatrix<T> operator*(const T& num) const
+        {
+            SparseMatrix<T> outMat = *this;
+            for (T& val : outMat.m_values)
+            {
+                val *= num;
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows in the matrix
+        size_t getRowCount() const
+        {
+            return m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns in the matrix
+        size_t getColCount() const
+        {
+            return m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of stored values
+        ///
+        /// @return number of non-zeros
+        size_t nnz() const
+        {
+            return m_values.size();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the compression order
+        ///
+        /// @return CSR or CSC
+        Sparse_Format_t format() const
+        {
+            return m_format;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Run starts, one per outer index (row for CSR, column for CSC) plus the end
+        ///
+        /// @return reference to the run starts
+        const std::vector<size_t>& outer() const
+        {
+            return m_outer;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Inner index (column for CSR, row for CSC) of each stored value
+        ///
+        /// @return reference to the inner indices
+        const std::vector<size_t>& inner() const
+        {
+            return m_inner;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief The stored values, may be written in place (the pattern is fixed)
+        ///
+        /// @return reference to the values
+        std::vector<T>& values()
+        {
+            return m_values;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief The stored values
+        ///
+        /// @return reference to the values
+        const std::vector<T>& values() const
+        {
+            return m_values;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Creates a sparse identity matrix of size len
+        ///
+        /// @param len side length of the identity matrix
+        ///
+        /// @return identity matrix of requested size
+        static SparseMatrix<T> identity(const size_t& len)
+        {
+            std::vector<size_t> outer(len + 1);
+            std::iota(outer.begin(), outer.end(), 0);
+            std::vector<size_t> inner(len);
+            std::iota(inner.begin(), inner.end(), 0);
+            return SparseMatrix<T>(len, len, std::move(outer), std::move(inner), std::vector<T>(len, (T) 1));
+        };
+
+    private:
+        /// @brief the number of rows in the matrix
+        size_t m_rows;
+
+        /// @brief the number of columns in the matrix
+        size_t m_cols;
+
+        /// @brief compression order
+        Sparse_Format_t m_format;
+
+        /// @brief run starts, _outer_count() + 1 entries
+        std::vector<size_t> m_outer;
+
+        /// @brief inner index of each stored value
+        std::vector<size_t> m_inner;
+
+        /// @brief stored values
+        std::vector<T> m_values;
+
+        ///--------------------------------------------------------
+        /// @brief Number of runs, rows for CSR and columns for CSC
+        size_t _outer_count() const
+        {
+            return (m_format == Sparse_Format_t::CSR) ? m_rows : m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Range of inner indices, columns for CSR and rows for CSC
+        size_t _inner_count() const
+        {
+            return (m_format == Sparse_Format_t::CSR) ? m_cols : m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Mean stored values per run, used to size parallel chunks
+        size_t _avg_run() const
+        {
+            return nnz() / _outer_count();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Sorts each run by inner index and sums duplicates, compacting the arrays
+        void _sort_and_merge()
+        {
+            std::vector<std::pair<size_t, T>> run;
+            size_t write = 0;
+            size_t start = 0;
+            for (size_t i = 0; i < _outer_count(); i++)
+            {
+                run.clear();
+                for (size_t p = start; p < m_outer[i + 1]; p++)
+                {
+                    run.emplace_back(m_inner[p], m_values[p]);
+                }
+                std::stable_sort(run.begin(), run.end(),
+                                 [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+
+                start = m_outer[i + 1];
+                m_outer[i] = write;
+                for (size_t r = 0; r < run.size(); r++)
+                {
+                    if (write > m_outer[i] && m_inner[write - 1] == run[r].first)
+                    {
+                        m_values[write - 1] += run[r].second;
+                        continue;
+                    }
+                    m_inner[write] = run[r].first;
+                    m_values[write] = run[r].second;
+                    write++;
+                }
+            }
+            m_outer[_outer_count()] = write;
+            m_inner.resize(write);
+            m_values.resize(write);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Builds the storage of the transpose in the same compression order, O(nnz)
+        /// i.e. the runs are regrouped by inner index
+        ///
+        /// @return matrix whose runs are this matrix's inner indices (dimensions not swapped)
+        SparseMatrix<T> _transpose_storage() const
+        {
+            const size_t outerCount = _inner_count();
+            std::vector<size_t> outer(outerCount + 1, 0);
+            for (size_t idx : m_inner)
+            {
+                outer[idx + 1]++;
+            }
+            std::partial_sum(outer.begin(), outer.end(), outer.begin());
+
+            std::vector<size_t> fill(outer.begin(), outer.end() - 1);
+            std::vector<size_t> inner(nnz());
+            std::vector<T> values(nnz());
+
+            // walking runs in order keeps the new inner indices sorted
+            for (size_t i = 0; i < _outer_count(); i++)
+            {
+                for (size_t p = m_outer[i]; p < m_outer[i + 1]; p++)
+                {
+                    const size_t pos = fill[m_inner[p]]++;
+                    inner[pos] = i;
+                    values[pos] = m_values[p];
+                }
+            }
+
+            SparseMatrix<T> outMat = *this;
+            outMat.m_outer = std::move(outer);
+            outMat.m_inner = std::move(inner);
+            outMat.m_values = std::move(values);
+            std::swap(outMat.m_rows, outMat.m_cols);
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Merges two matricies run by run, this + scale * mat
+        ///
+        /// @param mat rval matrix, converted to this matrix's order if needed
+        /// @param scale applied to mat's values
+        /// @param err message thrown on a dimension mismatch
+        ///
+        /// @return merged matrix
+        SparseMatrix<T> _merge(const SparseMatrix<T>& mat, const T& scale, const char* err) const
+        {
+            if (mat.m_rows != m_rows || mat.m_cols != m_cols)
+            {
+                throw std::invalid_argument(err);
+            }
+
+            if (mat.m_format != m_format)
+            {
+                return _merge(mat.toFormat(m_format), scale, err);
+            }
+
+            SparseMatrix<T> outMat(m_rows, m_cols, m_format);
+            outMat.m_inner.reserve(nnz() + mat.nnz());
+            outMat.m_values.reserve(nnz() + mat.nnz());
+
+            for (size_t i = 0; i < _outer_count(); i++)
+            {
+                size_t p = m_outer[i];
+                size_t q = mat.m_outer[i];
+                while (p < m_outer[i + 1] || q < mat.m_outer[i + 1])
+                {
+                    const size_t pj = (p < m_outer[i + 1]) ? m_inner[p] : _inner_count();
+                    const size_t qj = (q < mat.m_outer[i + 1]) ? mat.m_inner[q] : _inner_count();
+
+                    if (pj < qj)
+                    {
+                        outMat.m_inner.push_back(pj);
+                        outMat.m_values.push_back(m_values[p++]);
+                    }
+                    else if (qj < pj)
+                    {
+                        outMat.m_inner.push_back(qj);
+                        outMat.m_values.push_back(mat.m_values[q++] * scale);
+                    }
+                    else
+                    {
+                        outMat.m_inner.push_back(pj);
+                        outMat.m_values.push_back(m_values[p++] + mat.m_values[q++] * scale);
+                    }
+                }
+                outMat.m_outer[i + 1] = outMat.m_inner.size();
+            }
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Generates the string needed for the error reporting for a bad coord
+        ///
+        /// @param row offending coord row
+        /// @param col offending coord col
+        /// @return string of error message
+        std::string _gen_coord_err_string(const size_t& row, const size_t& col) const
+        {
+            std::stringstream err;
+            err << "Bad coordinate, (" << row << "," << col << ") is not within the bounds of (" << m_rows - 1 << "," << m_cols - 1 << ")";
+            return err.str();
+        };
+};
+
+///--------------------------------------------------------
+/// @brief Overload of <<, lists the stored values as (row,col) value, one per line
+///
+/// @param os output stream
+/// @param mat sparse matrix to push to output stream
+///
+/// @return output stream
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const SparseMatrix<T>& mat)
+{
+    const bool csr = mat.format() == Sparse_Format_t::CSR;
+    const size_t outerCount = mat.outer().size() - 1;
+    for (size_t i = 0; i < outerCount; i++)
+    {
+        for (size_t p = mat.outer()[i]; p < mat.outer()[i + 1]; p++)
+        {
+            const size_t row = csr ? i : mat.inner()[p];
+            const size_t col = csr ? mat.inner()[p] : i;
+            os << "(" << row << "," << col << ") " << mat.values()[p] << std::endl;
+        }
+    }
+    return os;
+}
@@ -0,0 +1,220 @@
+/// ------------------------------------------
+/// @file Storage.h
+///
+/// @brief Header file for the aligned, pooled buffer allocator behind Matrix and Vector
+///
+/// Every buffer is STORAGE_ALIGNMENT byte aligned. Freed buffers are kept in per
+/// thread free lists by size class and handed straight back out to the next request
+/// of the same class, so loops that keep making same sized temporaries stop going to
+/// the heap after the first pass
+///
+/// A Storage_Arena_t makes a scope: while it lives, buffers allocated on its thread
+/// come from its own chunks and free lists, and when it ends all of that is returned
+/// at once. Buffers that outlive the arena stay valid, their chunk is only freed
+/// once the last of them is released
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/// Alignment of every buffer in bytes, must be a power of two of at least alignof(max_align_t)
+#ifndef STORAGE_ALIGNMENT
+#define STORAGE_ALIGNMENT 64
+#endif
+
+/// Largest buffer in bytes kept in the free lists, bigger ones go straight back to the heap
+#ifndef STORAGE_POOL_MAX_BLOCK
+#define STORAGE_POOL_MAX_BLOCK (32 * 1024 * 1024)
+#endif
+
+/// Most buffers kept per size class in each free list
+#ifndef STORAGE_POOL_DEPTH
+#define STORAGE_POOL_DEPTH 16
+#endif
+
+/// Bytes reserved at a time by an arena
+#ifndef STORAGE_ARENA_CHUNK
+#define STORAGE_ARENA_CHUNK (1024 * 1024)
+#endif
+
+/// @brief Where released buffers go when no arena is active
+enum class Storage_Policy_t
+{
+    HEAP,   // straight back to the heap, every allocation is a fresh one
+    POOL    // kept in the per thread free lists for reuse
+};
+
+///--------------------------------------------------------
+/// @brief Allocates an aligned buffer, from the active arena, the free lists or the heap
+///
+/// @param bytes size of the buffer
+///
+/// @return STORAGE_ALIGNMENT aligned buffer
+///
+/// @throws std::bad_alloc if the heap is exhausted
+void* storage_allocate(const size_t& bytes);
+
+///--------------------------------------------------------
+/// @brief Releases a buffer from storage_allocate, may be called from any thread
+///
+/// @param ptr buffer to release, nullptr is ignored
+void storage_release(void* ptr) noexcept;
+
+///--------------------------------------------------------
+/// @brief Sets the policy used for buffers released outside of an arena
+///
+/// @param policy policy to use from now on
+void storage_set_policy(const Storage_Policy_t& policy);
+
+///--------------------------------------------------------
+/// @brief Returns the policy used for buffers released outside of an arena
+///
+/// @return current policy
+Storage_Policy_t storage_policy();
+
+///--------------------------------------------------------
+/// @brief Returns every buffer in the calling thread's free lists to the heap
+void storage_trim();
+
+///--------------------------------------------------------
+/// @brief Allocates and default constructs count elements, the aligned stand in for new T[]
+///
+/// @param count number of elements
+///
+/// @return first element
+template <typename T>
+T* storage_new(const size_t& count)
+{
+    static_assert(alignof(T) <= STORAGE_ALIGNMENT, "Type is over aligned for the storage pool");
+
+    T* ptr = static_cast<T*>(storage_allocate(count * sizeof(T)));
+    try
+    {
+        std::uninitialized_default_construct_n(ptr, count);
+    }
+    catch (...)
+    {
+        storage_release(ptr);
+        throw;
+    }
+    return ptr;
+}
+
+///--------------------------------------------------------
+/// @brief Destroys and releases elements from storage_new, the stand in for delete[]
+///
+/// @param ptr first element, nullptr is ignored
+/// @param count number of elements
+template <typename T>
+void storage_delete(T* ptr, const size_t& count) noexcept
+{
+    if (ptr != nullptr)
+    {
+        std::destroy_n(ptr, count);
+        storage_release(ptr);
+    }
+}
+
+/// @brief Standard allocator over the storage pool, for containers used as workspace
+template <typename T>
+struct Storage_Allocator_t
+{
+    typedef T value_type;
+
+    Storage_Allocator_t() noexcept {};
+
+    template <typename U>
+    Storage_Allocator_t(const Storage_Allocator_t<U>&) noexcept {};
+
+    T* allocate(const size_t count)
+    {
+        return static_cast<T*>(storage_allocate(count * sizeof(T)));
+    };
+
+    void deallocate(T* ptr, const size_t) noexcept
+    {
+        storage_release(ptr);
+    };
+};
+
+template <typename T, typename U>
+bool operator==(const Storage_Allocator_t<T>&, const Storage_Allocator_t<U>&) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const Storage_Allocator_t<T>&, const Storage_Allocator_t<U>&) noexcept
+{
+    return false;
+}
+
+/// @brief std::vector with aligned, pooled storage
+template <typename T>
+using Storage_Vector_t = std::vector<T, Storage_Allocator_t<T>>;
+
+struct Storage_Chunk_t;
+
+/// @brief Scoped arena, see the file description. Arenas nest, the innermost serves its thread
+/// Not copyable or movable, make one on the stack around a solve
+class Storage_Arena_t
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, makes this the active arena of the calling thread
+        Storage_Arena_t();
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, returns every chunk that no surviving buffer still uses
+        /// and restores the previously active arena
+        ~Storage_Arena_t();
+
+        Storage_Arena_t(const Storage_Arena_t&) = delete;
+        Storage_Arena_t& operator=(const Storage_Arena_t&) = delete;
+
+        ///--------------------------------------------------------
+        /// @brief Bytes reserved from the heap by this arena so far
+        ///
+        /// @return reserved bytes
+        size_t reserved() const
+        {
+            return m_reserved;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the active arena of the calling thread
+        ///
+        /// @return arena, nullptr if none is active
+        static Storage_Arena_t* current();
+
+    private:
+        friend void* storage_allocate(const size_t& bytes);
+        friend void storage_release(void* ptr) noexcept;
+
+        /// @brief arena that was active before this one
+        Storage_Arena_t* m_prev;
+
+        /// @brief chunk being carved up
+        Storage_Chunk_t* m_chunk = nullptr;
+
+        /// @brief bytes of m_chunk already handed out
+        size_t m_used = 0;
+
+        /// @brief bytes reserved from the heap
+        size_t m_reserved = 0;
+
+        /// @brief released buffers, by size class, reused before carving new ones
+        std::vector<std::vector<void*>> m_free;
+
+        ///--------------------------------------------------------
+        /// @brief Carves a buffer of a size class out of the current chunk
+        ///
+        /// @param cls size class index
+        /// @param bytes payload bytes of that class
+        ///
+        /// @return payload pointer
+        void* _carve(const size_t& cls, const size_t& bytes);
+};
@@ -0,0 +1,396 @@
+/// ------------------------------------------
+/// @file Strassen.h
+///
+/// @brief Header/Source file for the Strassen-Winograd fast multiply used by Matrix<T>::operator%
+/// on large real floating point products
+///
+/// Each recursion level splits the operands into quadrants and forms the product from
+/// seven half sized products and fifteen quadrant additions (Winograd's variant), recursing
+/// until a dimension drops below STRASSEN_CUTOFF where the blocked gemm takes over. Odd
+/// dimensions are peeled: the even part recurses and the last row, column and depth slice
+/// are fixed up with gemm and a rank 1 update
+///
+/// The top level runs its seven products as parallel tasks when the pool has more than one
+/// thread and the extra workspace stays under STRASSEN_PARALLEL_WORKSPACE, every level below
+/// runs the sequential schedule of Boyer et al. that needs only two quadrant temporaries.
+/// All workspace is one pooled buffer taken before the recursion starts
+///
+/// The error bound is normwise rather than elementwise and grows by a constant factor per
+/// level, callers that need the classical bound turn it off with strassen_set_enabled(false)
+/// or MATRIX_STRASSEN=0
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "Gemm.h"
+#include "Storage.h"
+#include "Thread_Pool.h"
+
+/// Smallest dimension a recursion level may leave behind, below it the blocked gemm is faster
+#ifndef STRASSEN_CUTOFF
+#define STRASSEN_CUTOFF 512
+#endif
+
+/// Most workspace bytes the parallel top level may use, above it the top level is sequential too
+#ifndef STRASSEN_PARALLEL_WORKSPACE
+#define STRASSEN_PARALLEL_WORKSPACE ((size_t) 1 << 30)
+#endif
+
+/// Environment variable read on first use, "0" turns the fast multiply off
+#define STRASSEN_ENABLE_ENV "MATRIX_STRASSEN"
+
+///--------------------------------------------------------
+/// @brief Turns the Strassen-Winograd path on or off for every thread
+///
+/// @param enabled false runs every product through the classical gemm
+void strassen_set_enabled(const bool& enabled);
+
+///--------------------------------------------------------
+/// @brief Is the Strassen-Winograd path switched on?
+///
+/// @return false if disabled through strassen_set_enabled or STRASSEN_ENABLE_ENV
+bool strassen_enabled();
+
+///--------------------------------------------------------
+/// @brief Would a (m,k) x (k,n) product of T take the Strassen-Winograd path?
+///
+/// @param m rows of A
+/// @param n columns of B
+/// @param k shared dimension
+///
+/// @return true for real floating point types with every dimension at least 2 * STRASSEN_CUTOFF
+template <typename T>
+bool strassen_applies(const size_t& m, const size_t& n, const size_t& k)
+{
+    return std::is_floating_point_v<T> && std::min({m, n, k}) >= 2 * STRASSEN_CUTOFF && strassen_enabled();
+}
+
+/// @brief Strided description of one operand, element (i,j) is m_ptr[i * m_rs + j * m_cs]
+template <typename T>
+struct Strassen_Operand_t
+{
+    const T* m_ptr;
+    size_t m_rs;
+    size_t m_cs;
+
+    ///--------------------------------------------------------
+    /// @brief Returns the operand starting at (i,j)
+    Strassen_Operand_t at(const size_t& i, const size_t& j) const
+    {
+        return {m_ptr + i * m_rs + j * m_cs, m_rs, m_cs};
+    };
+};
+
+///--------------------------------------------------------
+/// @brief Elementwise C = A + sign * B over an (m,n) block, rows are shared out over the pool
+///
+/// @param sign 1 or -1
+/// @param C row major destination with row stride ldc, may alias A or B if laid out the same
+template <typename T>
+void _strassen_add(const size_t& m, const size_t& n, const Strassen_Operand_t<T>& A, const T& sign,
+                   const Strassen_Operand_t<T>& B, T* C, const size_t& ldc)
+{
+    parallel_for(0, m, parallel_grain(n), [&](size_t from, size_t to)
+    {
+        for (size_t i = from; i < to; i++)
+        {
+            const T* a = A.m_ptr + i * A.m_rs;
+            const T* b = B.m_ptr + i * B.m_rs;
+            T* c = C + i * ldc;
+            if (A.m_cs == 1 && B.m_cs == 1)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    c[j] = a[j] + sign * b[j];
+                }
+            }
+            else
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    c[j] = a[j * A.m_cs] + sign * b[j * B.m_cs];
+                }
+            }
+        }
+    });
+}
+
+///--------------------------------------------------------
+/// @brief Row major (m,n) block at C with row stride ldc as an operand
+template <typename T>
+Strassen_Operand_t<T> _strassen_out(const T* C, const size_t& ldc)
+{
+    return {C, ldc, 1};
+}
+
+///--------------------------------------------------------
+/// @brief Does a level of (m,n,k) recurse?
+inline bool _strassen_recurses(const size_t& m, const size_t& n, const size_t& k)
+{
+    return std::min({m, n, k}) >= 2 * STRASSEN_CUTOFF;
+}
+
+///--------------------------------------------------------
+/// @brief Workspace elements of the sequential schedule at (m,n,k) and every level below it
+inline size_t _strassen_workspace(const size_t& m, const size_t& n, const size_t& k)
+{
+    if (!_strassen_recurses(m, n, k))
+    {
+        return 0;
+    }
+
+    const size_t mh = m / 2;
+    const size_t nh = n / 2;
+    const size_t kh = k / 2;
+    return mh * std::max(kh, nh) + kh * nh + _strassen_workspace(mh, nh, kh);
+}
+
+///--------------------------------------------------------
+/// @brief Workspace elements of the parallel top level, all eight operand sums, three spare
+/// products and a sequential workspace per task
+inline size_t _strassen_parallel_workspace(const size_t& m, const size_t& n, const size_t& k)
+{
+    const size_t mh = m / 2;
+    const size_t nh = n / 2;
+    const size_t kh = k / 2;
+    return 4 * mh * kh + 4 * kh * nh + 3 * mh * nh + 7 * _strassen_workspace(mh, nh, kh);
+}
+
+template <typename T>
+void _strassen_level(const size_t& m, const size_t& n, const size_t& k,
+                     const Strassen_Operand_t<T>& A, const Strassen_Operand_t<T>& B,
+                     T* C, const size_t& ldc, T* work, const bool& parallel);
+
+///--------------------------------------------------------
+/// @brief One product of the recursion, recursing or handing over to gemm
+template <typename T>
+void _strassen_product(const size_t& m, const size_t& n, const size_t& k,
+                       const Strassen_Operand_t<T>& A, const Strassen_Operand_t<T>& B,
+                       T* C, const size_t& ldc, T* work)
+{
+    if (_strassen_recurses(m, n, k))
+    {
+        _strassen_level(m, n, k, A, B, C, ldc, work, false);
+    }
+    else
+    {
+        gemm(m, n, k, A.m_ptr, A.m_rs, A.m_cs, B.m_ptr, B.m_rs, B.m_cs, C, ldc);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Sequential Winograd schedule on the even (2mh, 2nh, 2kh) part, C quadrants double
+/// as product storage so only X (mh x max(kh,nh)) and Y (kh x nh) are needed
+template <typename T>
+void _strassen_sequential(const size_t& mh, const size_t& nh, const size_t& kh,
+                          const Strassen_Operand_t<T>& A, const Strassen_Operand_t<T>& B,
+                          T* C, const size_t& ldc, T* work)
+{
+    const Strassen_Operand_t<T> A11 = A, A12 = A.at(0, kh), A21 = A.at(mh, 0), A22 = A.at(mh, kh);
+    const Strassen_Operand_t<T> B11 = B, B12 = B.at(0, nh), B21 = B.at(kh, 0), B22 = B.at(kh, nh);
+    T* C11 = C;
+    T* C12 = C + nh;
+    T* C21 = C + mh * ldc;
+    T* C22 = C + mh * ldc + nh;
+
+    // X holds one A sum (row stride kh) and later P1 (row stride nh)
+    T* X = work;
+    T* Y = X + mh * std::max(kh, nh);
+    T* next = Y + kh * nh;
+    const Strassen_Operand_t<T> Xs = {X, kh, 1};
+    const Strassen_Operand_t<T> Ys = {Y, nh, 1};
+
+    _strassen_add(mh, kh, A11, (T) -1, A21, X, kh);                                 // S3
+    _strassen_add(kh, nh, B22, (T) -1, B12, Y, nh);                                 // T3
+    _strassen_product(mh, nh, kh, Xs, Ys, C21, ldc, next);                          // P7
+    _strassen_add(mh, kh, A21, (T) 1, A22, X, kh);                                  // S1
+    _strassen_add(kh, nh, B12, (T) -1, B11, Y, nh);                                 // T1
+    _strassen_product(mh, nh, kh, Xs, Ys, C22, ldc, next);                          // P5
+    _strassen_add(mh, kh, Xs, (T) -1, A11, X, kh);                                  // S2
+    _strassen_add(kh, nh, B22, (T) -1, Ys, Y, nh);                                  // T2
+    _strassen_product(mh, nh, kh, Xs, Ys, C12, ldc, next);                          // P6
+    _strassen_add(mh, kh, A12, (T) -1, Xs, X, kh);                                  // S4
+    _strassen_product(mh, nh, kh, Xs, B22, C11, ldc, next);                         // P3
+    _strassen_product(mh, nh, kh, A11, B11, X, nh, next);                           // P1
+
+    const Strassen_Operand_t<T> P1 = {X, nh, 1};
+    _strassen_add(mh, nh, P1, (T) 1, _strassen_out(C12, ldc), C12, ldc);            // U2 = P1 + P6
+    _strassen_add(mh, nh, _strassen_out(C12, ldc), (T) 1, _strassen_out(C21, ldc), C21, ldc);  // U3 = U2 + P7
+    _strassen_add(mh, nh, _strassen_out(C12, ldc), (T) 1, _strassen_out(C22, ldc), C12, ldc);  // U4 = U2 + P5
+    _strassen_add(mh, nh, _strassen_out(C21, ldc), (T) 1, _strassen_out(C22, ldc), C22, ldc);  // U7 = U3 + P5
+    _strassen_add(mh, nh, _strassen_out(C12, ldc), (T) 1, _strassen_out(C11, ldc), C12, ldc);  // U5 = U4 + P3
+    _strassen_add(kh, nh, Ys, (T) -1, B21, Y, nh);                                  // T4
+    _strassen_product(mh, nh, kh, A22, Ys, C11, ldc, next);                         // P4
+    _strassen_add(mh, nh, _strassen_out(C21, ldc), (T) -1, _strassen_out(C11, ldc), C21, ldc); // U6 = U3 - P4
+    _strassen_product(mh, nh, kh, A12, B21, C11, ldc, next);                        // P2
+    _strassen_add(mh, nh, P1, (T) 1, _strassen_out(C11, ldc), C11, ldc);            // U1 = P1 + P2
+}
+
+///--------------------------------------------------------
+/// @brief Parallel Winograd schedule on the even part, every operand sum is formed first
+/// so the seven products are independent tasks, each with its own slice of the workspace
+template <typename T>
+void _strassen_parallel(const size_t& mh, const size_t& nh, const size_t& kh,
+                        const Strassen_Operand_t<T>& A, const Strassen_Operand_t<T>& B,
+                        T* C, const size_t& ldc, T* work)
+{
+    const Strassen_Operand_t<T> A11 = A, A12 = A.at(0, kh), A21 = A.at(mh, 0), A22 = A.at(mh, kh);
+    const Strassen_Operand_t<T> B11 = B, B12 = B.at(0, nh), B21 = B.at(kh, 0), B22 = B.at(kh, nh);
+    T* C11 = C;
+    T* C12 = C + nh;
+    T* C21 = C + mh * ldc;
+    T* C22 = C + mh * ldc + nh;
+
+    T* S[4];
+    T* Tb[4];
+    T* P[3];
+    for (size_t i = 0; i < 4; i++)
+    {
+        S[i] = work + i * mh * kh;
+        Tb[i] = work + 4 * mh * kh + i * kh * nh;
+    }
+    for (size_t i = 0; i < 3; i++)
+    {
+        P[i] = work + 4 * mh * kh + 4 * kh * nh + i * mh * nh;
+    }
+    T* next = P[2] + mh * nh;
+    const size_t childWork = _strassen_workspace(mh, nh, kh);
+
+    const Strassen_Operand_t<T> S1 = {S[0], kh, 1}, S2 = {S[1], kh, 1}, S3 = {S[2], kh, 1}, S4 = {S[3], kh, 1};
+    const Strassen_Operand_t<T> T1 = {Tb[0], nh, 1}, T2 = {Tb[1], nh, 1}, T3 = {Tb[2], nh, 1}, T4 = {Tb[3], nh, 1};
+
+    _strassen_add(mh, kh, A21, (T) 1, A22, S[0], kh);
+    _strassen_add(mh, kh, S1, (T) -1, A11, S[1], kh);
+    _strassen_add(mh, kh, A11, (T) -1, A21, S[2], kh);
+    _strassen_add(mh, kh, A12, (T) -1, S2, S[3], kh);
+    _strassen_add(kh, nh, B12, (T) -1, B11, Tb[0], nh);
+    _strassen_add(kh, nh, B22, (T) -1, T1, Tb[1], nh);
+    _strassen_add(kh, nh, B22, (T) -1, B12, Tb[2], nh);
+    _strassen_add(kh, nh, T2, (T) -1, B21, Tb[3], nh);
+
+    // P1 -> P[0], P2 -> C11, P3 -> C12, P4 -> C21, P5 -> C22, P6 -> P[1], P7 -> P[2]
+    parallel_for(0, 7, 1, [&](size_t from, size_t to)
+    {
+        for (size_t task = from; task < to; task++)
+        {
+            T* w = next + task * childWork;
+            switch (task)
+            {
+                case 0: _strassen_product(mh, nh, kh, A11, B11, P[0], nh, w); break;
+                case 1: _strassen_product(mh, nh, kh, A12, B21, C11, ldc, w); break;
+                case 2: _strassen_product(mh, nh, kh, S4, B22, C12, ldc, w); break;
+                case 3: _strassen_product(mh, nh, kh, A22, T4, C21, ldc, w); break;
+                case 4: _strassen_product(mh, nh, kh, S1, T1, C22, ldc, w); break;
+                case 5: _strassen_product(mh, nh, kh, S2, T2, P[1], nh, w); break;
+                default: _strassen_product(mh, nh, kh, S3, T3, P[2], nh, w); break;
+            }
+        }
+    });
+
+    const Strassen_Operand_t<T> P1 = {P[0], nh, 1}, U2 = {P[1], nh, 1}, U3 = {P[2], nh, 1};
+    _strassen_add(mh, nh, _strassen_out(C11, ldc), (T) 1, P1, C11, ldc);            // U1 = P2 + P1
+    _strassen_add(mh, nh, U2, (T) 1, P1, P[1], nh);                                 // U2 = P6 + P1
+    _strassen_add(mh, nh, U3, (T) 1, U2, P[2], nh);                                 // U3 = P7 + U2
+    _strassen_add(mh, nh, U2, (T) 1, _strassen_out(C22, ldc), P[1], nh);            // U4 = U2 + P5
+    _strassen_add(mh, nh, _strassen_out(C12, ldc), (T) 1, U2, C12, ldc);            // U5 = P3 + U4
+    _strassen_add(mh, nh, U3, (T) -1, _strassen_out(C21, ldc), C21, ldc);           // U6 = U3 - P4
+    _strassen_add(mh, nh, _strassen_out(C22, ldc), (T) 1, U3, C22, ldc);            // U7 = P5 + U3
+}
+
+///--------------------------------------------------------
+/// @brief One recursion level, the even part goes through the Winograd schedule and the
+/// odd row, column and depth slice are peeled off
+template <typename T>
+void _strassen_level(const size_t& m, const size_t& n, const size_t& k,
+                     const Strassen_Operand_t<T>& A, const Strassen_Operand_t<T>& B,
+                     T* C, const size_t& ldc, T* work, const bool& parallel)
+{
+    const size_t mh = m / 2;
+    const size_t nh = n / 2;
+    const size_t kh = k / 2;
+
+    if (parallel)
+    {
+        _strassen_parallel(mh, nh, kh, A, B, C, ldc, work);
+    }
+    else
+    {
+        _strassen_sequential(mh, nh, kh, A, B, C, ldc, work);
+    }
+
+    const size_t m2 = 2 * mh;
+    const size_t n2 = 2 * nh;
+    const size_t k2 = 2 * kh;
+
+    // last depth slice, C(m2,n2) += A(:,k-1) B(k-1,:)
+    if (k2 < k)
+    {
+        const Strassen_Operand_t<T> a = A.at(0, k2);
+        const Strassen_Operand_t<T> b = B.at(k2, 0);
+        parallel_for(0, m2, parallel_grain(n2), [&](size_t from, size_t to)
+        {
+            for (size_t i = from; i < to; i++)
+            {
+                const T ai = a.m_ptr[i * a.m_rs];
+                T* c = C + i * ldc;
+                for (size_t j = 0; j < n2; j++)
+                {
+                    c[j] += ai * b.m_ptr[j * b.m_cs];
+                }
+            }
+        });
+    }
+
+    // last column over every row, then the last row over the even columns
+    if (n2 < n)
+    {
+        const Strassen_Operand_t<T> b = B.at(0, n2);
+        gemm(m, (size_t) 1, k, A.m_ptr, A.m_rs, A.m_cs, b.m_ptr, b.m_rs, b.m_cs, C + n2, ldc);
+    }
+    if (m2 < m)
+    {
+        const Strassen_Operand_t<T> a = A.at(m2, 0);
+        gemm((size_t) 1, n2, k, a.m_ptr, a.m_rs, a.m_cs, B.m_ptr, B.m_rs, B.m_cs, C + m2 * ldc, ldc);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief General matrix multiply C = A * B, through Strassen-Winograd when strassen_applies
+/// and the blocked gemm otherwise. Arguments as for gemm
+///
+/// @param m rows of A and C
+/// @param n columns of B and C
+/// @param k columns of A and rows of B
+/// @param A pointer to A
+/// @param rsa distance between rows of A
+/// @param csa distance between columns of A
+/// @param B pointer to B
+/// @param rsb distance between rows of B
+/// @param csb distance between columns of B
+/// @param C pointer to C, overwritten, must not overlap A or B
+/// @param ldc row stride of C
+template <typename T>
+void strassen_gemm(const size_t& m, const size_t& n, const size_t& k,
+                   const T* A, const size_t& rsa, const size_t& csa,
+                   const T* B, const size_t& rsb, const size_t& csb,
+                   T* C, const size_t& ldc)
+{
+    if (!strassen_applies<T>(m, n, k))
+    {
+        gemm(m, n, k, A, rsa, csa, B, rsb, csb, C, ldc);
+        return;
+    }
+
+    const size_t parallelWork = _strassen_parallel_workspace(m, n, k);
+    const bool parallel = Thread_Pool::instance().getThreadCount() > 1 &&
+                          parallelWork * sizeof(T) <= STRASSEN_PARALLEL_WORKSPACE;
+
+    Storage_Vector_t<T> work(parallel ? parallelWork : _strassen_workspace(m, n, k));
+    _strassen_level(m, n, k, Strassen_Operand_t<T>{A, rsa, csa}, Strassen_Operand_t<T>{B, rsb, csb},
+                    C, ldc, work.data(), parallel);
+}
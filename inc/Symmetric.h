@@ -0,0 +1,644 @@
+/// ------------------------------------------
+/// @file Symmetric.h
+///
+/// @brief Header/Source file for packed symmetric matrices and the Cholesky factorization
+///
+/// A Symmetric_Matrix stores only its lower triangle, packed row by row (n(n+1)/2 values),
+/// element (i,j) with j <= i at i(i+1)/2 + j. For complex types the matrix is Hermitian,
+/// the upper triangle reads back as the conjugate of the lower. Cholesky factorizes
+/// A = L L^H for positive definite A, L is lower triangular with a real positive diagonal
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Scalar.h"
+#include "Storage.h"
+#include "Thread_Pool.h"
+#include "Profile.h"
+#include "Triangular.h"
+
+template <typename T> class Cholesky;
+
+/// @brief Templated class for symmetric (Hermitian for complex types) matrices in packed storage
+template <typename T>
+class Symmetric_Matrix
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, zero filled
+        ///
+        /// @param len order of the matrix
+        ///
+        /// @throws std::invalid_argument if len < 1
+        Symmetric_Matrix(const size_t& len) : m_len(len)
+        {
+            if (len < 1)
+            {
+                throw std::invalid_argument("Cols/Rows of a matrix must be above 0");
+            }
+
+            m_data.assign(len * (len + 1) / 2, (T) 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, packs the lower triangle of a square matrix, the upper is not read
+        ///
+        /// @note symmetry is not checked, see Matrix::isSymmetric
+        ///
+        /// @param mat square matrix
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Symmetric_Matrix(const Matrix<T>& mat) : Symmetric_Matrix(mat.getRowCount())
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to be symmetric");
+            }
+
+            for (size_t i = 0; i < m_len; i++)
+            {
+                std::copy(mat.get_data() + i * m_len, mat.get_data() + i * m_len + i + 1, _row(i));
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows
+        size_t getRowCount() const
+        {
+            return m_len;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns
+        size_t getColCount() const
+        {
+            return m_len;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the value at (row, col), above the diagonal read from (col, row)
+        ///
+        /// @param row row location of the value
+        /// @param col column location of the value
+        ///
+        /// @return value at (row, col)
+        T get(const size_t& row, const size_t& col) const
+        {
+            _check_bounds(row, col);
+            return (col <= row) ? _row(row)[col] : scalar_conj(_row(col)[row]);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Set the value at (row, col) and its mirror (col, row)
+        ///
+        /// @note the diagonal of a Hermitian matrix is real, give diagonal values no imaginary part
+        ///
+        /// @param row row location of the value
+        /// @param col column location of the value
+        /// @param val value to set
+        void set(const size_t& row, const size_t& col, const T& val)
+        {
+            _check_bounds(row, col);
+            if (col <= row)
+            {
+                _row(row)[col] = val;
+            }
+            else
+            {
+                _row(col)[row] = scalar_conj(val);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the packed lower triangle, row i starts at i(i+1)/2
+        ///
+        /// @return first packed element
+        const T* get_data() const
+        {
+            return m_data.data();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Expands to a dense matrix
+        ///
+        /// @return dense matrix
+        Matrix<T> toMatrix() const
+        {
+            Matrix<T> outMat(m_len, m_len);
+            for (size_t i = 0; i < m_len; i++)
+            {
+                const T* row = _row(i);
+                for (size_t j = 0; j <= i; j++)
+                {
+                    outMat(i, j) = row[j];
+                    outMat(j, i) = scalar_conj(row[j]);
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product with a dense matrix, each stored element is read once
+        /// and applied for both of its mirrored positions
+        ///
+        /// @param mat (n,p) matrix
+        ///
+        /// @return (n,p) product
+        ///
+        /// @throws std::invalid_argument if mat does not have n rows
+        Matrix<T> operator%(const Matrix<T>& mat) const
+        {
+            if (mat.getRowCount() != m_len)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            const size_t n = m_len;
+            const size_t p = mat.getColCount();
+            const T* b = mat.get_data();
+            Matrix<T> outMat(n, p);
+            outMat.block(0, 0, n, p).fill((T) 0);
+            T* c = outMat.get_data();
+
+            // each task owns a range of output columns, so the mirrored updates never collide
+            parallel_for(0, p, parallel_grain(n * n), [&](size_t from, size_t to)
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const T* row = _row(i);
+                    T* ci = c + i * p;
+                    const T* bi = b + i * p;
+                    for (size_t j = 0; j < i; j++)
+                    {
+                        const T aij = row[j];
+                        const T aji = scalar_conj(aij);
+                        T* cj = c + j * p;
+                        const T* bj = b + j * p;
+                        for (size_t k = from; k < to; k++)
+                        {
+                            ci[k] += aij * bj[k];
+                            cj[k] += aji * bi[k];
+                        }
+                    }
+
+                    const T aii = row[i];
+                    for (size_t k = from; k < to; k++)
+                    {
+                        ci[k] += aii * bi[k];
+                    }
+                }
+            });
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product with a vector, each stored element is read once
+        ///
+        /// @param vec n long vector
+        ///
+        /// @return product vector
+        ///
+        /// @throws std::invalid_argument if vec is not n long
+        Vector<T> operator%(const Vector<T>& vec) const
+        {
+            if (vec.size() != m_len)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            const T* x = vec.get_data();
+            Vector<T> outVec(m_len);
+            T* y = outVec.get_data();
+            std::fill(y, y + m_len, (T) 0);
+
+            for (size_t i = 0; i < m_len; i++)
+            {
+                const T* row = _row(i);
+                T sum = row[i] * x[i];
+                for (size_t j = 0; j < i; j++)
+                {
+                    sum += row[j] * x[j];
+                    y[j] += scalar_conj(row[j]) * x[i];
+                }
+                y[i] += sum;
+            }
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Factorizes A = L L^H
+        ///
+        /// @return Cholesky factorization, check isPositiveDefinite()
+        Cholesky<T> cholesky() const
+        {
+            return Cholesky<T>(*this);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant, by Cholesky when positive definite, LU otherwise
+        ///
+        /// @return determinant of the matrix
+        T determinant() const
+        {
+            const Cholesky<T> chol(*this);
+            if (chol.isPositiveDefinite())
+            {
+                return chol.determinant();
+            }
+            return toMatrix().determinant();
+        };
+
+    private:
+        /// @brief order of the matrix
+        size_t m_len;
+
+        /// @brief packed lower triangle
+        Storage_Vector_t<T> m_data;
+
+        ///--------------------------------------------------------
+        /// @brief Start of packed row i
+        T* _row(const size_t& i)
+        {
+            return m_data.data() + i * (i + 1) / 2;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Start of packed row i
+        const T* _row(const size_t& i) const
+        {
+            return m_data.data() + i * (i + 1) / 2;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Checks the element lies inside the matrix
+        ///
+        /// @throws std::invalid_argument if not
+        void _check_bounds(const size_t& row, const size_t& col) const
+        {
+            if (row >= m_len || col >= m_len)
+            {
+                throw std::invalid_argument("Index out of range");
+            }
+        };
+};
+
+/// @brief Templated class for factorizing a Hermitian positive definite matrix into A = L L^H and solving with it
+template <typename T>
+class Cholesky
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes the lower triangle of the given matrix
+        ///
+        /// @note matrices that are not positive definite stop at the first non-positive
+        /// pivot, isPositiveDefinite() will report them and any solve/inverse call will throw
+        ///
+        /// @param mat square matrix, the upper triangle is not read
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Cholesky(const Matrix<T>& mat) : m_l(_square(mat), Triangle_t::LOWER)
+        {
+            _factorize();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes a packed symmetric matrix
+        ///
+        /// @param mat symmetric matrix
+        Cholesky(const Symmetric_Matrix<T>& mat) : m_l(mat.getRowCount(), Triangle_t::LOWER)
+        {
+            const size_t n = mat.getRowCount();
+            T* l = m_l.get_data();
+            for (size_t i = 0; i < n; i++)
+            {
+                std::copy(mat.get_data() + i * (i + 1) / 2, mat.get_data() + i * (i + 1) / 2 + i + 1, l + i * n);
+            }
+            _factorize();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Did every pivot come out real positive?
+        ///
+        /// @return true if the matrix is positive definite
+        bool isPositiveDefinite() const
+        {
+            return m_positive;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the factor L
+        ///
+        /// @return lower triangular L, A = L L^H
+        const Triangular_Matrix<T>& getL() const
+        {
+            return m_l;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant, the squared product of the L diagonal
+        ///
+        /// @return determinant of the factorized matrix
+        ///
+        /// @throws std::invalid_argument if the matrix is not positive definite
+        T determinant() const
+        {
+            _check_positive();
+            const T det = m_l.determinant();
+            return det * scalar_conj(det);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x, L y = b then L^H x = y
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or the matrix is not positive definite
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            const size_t n = m_l.getRowCount();
+            if (solutions.size() != n)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Vector<T> outVec(n);
+            std::copy(solutions.get_data(), solutions.get_data() + n, outVec.get_data());
+            _solve_in_place(outVec.get_data(), 1);
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B for X, each column of B is a separate right hand side
+        ///
+        /// @param solutions right hand side matrix B, must have as many rows as A
+        ///
+        /// @return matrix X
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or the matrix is not positive definite
+        Matrix<T> solve(const Matrix<T>& solutions) const
+        {
+            if (solutions.getRowCount() != m_l.getRowCount())
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Matrix<T> outMat = solutions;
+            _solve_in_place(outMat.get_data(), outMat.getColCount());
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the inverse of the factorized matrix, A^-1 = L^-H L^-1
+        /// The triangular inverse and the half product it feeds are each n^3/3 operations,
+        /// against 2n^3 for solving against I
+        ///
+        /// @return the inverse matrix
+        ///
+        /// @throws std::invalid_argument if the matrix is not positive definite
+        Matrix<T> inverse() const
+        {
+            _check_positive();
+
+            const size_t n = m_l.getRowCount();
+            const Triangular_Matrix<T> lInv = m_l.inverse();
+            const T* w = lInv.get_data();
+            Matrix<T> outMat(n, n);
+            T* c = outMat.get_data();
+
+            // lower triangle, C_ij = sum over k >= i of conj(W_ki) W_kj, rows of W read contiguously
+            parallel_for(0, n, parallel_grain(n * n / 4), [&](size_t from, size_t to)
+            {
+                for (size_t i = from; i < to; i++)
+                {
+                    T* ci = c + i * n;
+                    std::fill(ci, ci + i + 1, (T) 0);
+                    for (size_t k = i; k < n; k++)
+                    {
+                        const T wki = scalar_conj(w[k * n + i]);
+                        const T* wk = w + k * n;
+                        for (size_t j = 0; j <= i; j++)
+                        {
+                            ci[j] += wki * wk[j];
+                        }
+                    }
+                }
+            });
+
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t j = i + 1; j < n; j++)
+                {
+                    c[i * n + j] = scalar_conj(c[j * n + i]);
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Rank 1 update in O(n^2), the factor becomes that of A + x x^H
+        ///
+        /// @param vec update vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or the matrix is not positive definite
+        void update(const Vector<T>& vec)
+        {
+            _check_positive();
+            Storage_Vector_t<T> x = _update_vector(vec);
+            _rotate(x.data(), 1.0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Rank 1 downdate in O(n^2), the factor becomes that of A - x x^H
+        /// A - x x^H is positive definite exactly when |L^-1 x| < 1, which is checked first
+        ///
+        /// @note rounding can still leave a zero pivot right at the limit, isPositiveDefinite()
+        /// then reports the factor as unusable
+        ///
+        /// @param vec downdate vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, the matrix is not positive definite
+        /// or A - x x^H would not be, the factor is unchanged in that case
+        void downdate(const Vector<T>& vec)
+        {
+            _check_positive();
+            Storage_Vector_t<T> x = _update_vector(vec);
+
+            const size_t n = m_l.getRowCount();
+            Storage_Vector_t<T> p(x);
+            triangular_solve(Triangle_t::LOWER, false, false, n, m_l.get_data(), n, p.data(), 1);
+
+            double norm = 0;
+            for (const T& val : p)
+            {
+                norm += scalar_abs(val) * scalar_abs(val);
+            }
+            if (!(norm < 1))
+            {
+                throw std::invalid_argument("Downdate would leave the matrix not positive definite");
+            }
+
+            _rotate(x.data(), -1.0);
+        };
+
+    private:
+        /// @brief lower triangular factor
+        Triangular_Matrix<T> m_l;
+
+        /// @brief cleared if a pivot was not real positive
+        bool m_positive = true;
+
+        ///--------------------------------------------------------
+        /// @brief Passes a matrix through if it is square
+        ///
+        /// @throws std::invalid_argument if not
+        static const Matrix<T>& _square(const Matrix<T>& mat)
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to have a Cholesky factorization");
+            }
+            return mat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Right looking factorization in place on the lower triangle
+        void _factorize()
+        {
+            const size_t n = m_l.getRowCount();
+            T* l = m_l.get_data();
+            Profile_Scope_t profile(Profile_Op_t::CHOLESKY, (double) n * n * n / 3, n * n * sizeof(T));
+
+            for (size_t k = 0; k < n; k++)
+            {
+                // the diagonal of a Hermitian matrix is real, any imaginary part is dropped
+                const double pivot = scalar_real(l[k * n + k]);
+                if (!(pivot > 0))
+                {
+                    m_positive = false;
+                    profile.setFailed(true);
+                    return;
+                }
+
+                const double root = std::sqrt(pivot);
+                l[k * n + k] = (T) root;
+                for (size_t i = k + 1; i < n; i++)
+                {
+                    l[i * n + k] = l[i * n + k] / (T) root;
+                }
+
+                // trailing lower triangle update, A_ij -= l_ik conj(l_jk), rows are independent
+                parallel_for(k + 1, n, parallel_grain((n - k) / 2), [&](size_t from, size_t to)
+                {
+                    for (size_t i = from; i < to; i++)
+                    {
+                        T* row = l + i * n;
+                        const T lik = row[k];
+                        if (lik == (T) 0)
+                        {
+                            continue;
+                        }
+
+                        for (size_t j = k + 1; j <= i; j++)
+                        {
+                            row[j] -= lik * scalar_conj(l[j * n + k]);
+                        }
+                    }
+                });
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies an update vector into workspace
+        ///
+        /// @throws std::invalid_argument if its size is not the factorized order
+        Storage_Vector_t<T> _update_vector(const Vector<T>& vec) const
+        {
+            if (vec.size() != m_l.getRowCount())
+            {
+                throw std::invalid_argument("Update vector must match the factorized order");
+            }
+            return Storage_Vector_t<T>(vec.get_data(), vec.get_data() + vec.size());
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Column by column rotation of L against x, L L^H + sigma x x^H
+        /// Column k: r = sqrt(l_kk^2 + sigma |x_k|^2), c = r / l_kk, s = x_k / l_kk, then
+        /// l_ik = (l_ik + sigma conj(s) x_i) / c and x_i = c x_i - s l_ik below the diagonal
+        ///
+        /// @param x update vector, destroyed
+        /// @param sigma 1 to update, -1 to downdate
+        void _rotate(T* x, const double& sigma)
+        {
+            const size_t n = m_l.getRowCount();
+            T* l = m_l.get_data();
+
+            for (size_t k = 0; k < n; k++)
+            {
+                if (x[k] == (T) 0)
+                {
+                    continue;
+                }
+
+                const double lkk = scalar_real(l[k * n + k]);
+                const double xk = scalar_abs(x[k]);
+                const double r2 = lkk * lkk + sigma * xk * xk;
+                if (!(r2 > 0))
+                {
+                    m_positive = false;
+                    return;
+                }
+
+                const double r = std::sqrt(r2);
+                const T c = (T) (r / lkk);
+                const T s = x[k] / (T) lkk;
+                const T sConj = (T) sigma * scalar_conj(s);
+                l[k * n + k] = (T) r;
+
+                for (size_t i = k + 1; i < n; i++)
+                {
+                    T& lik = l[i * n + k];
+                    lik = (lik + sConj * x[i]) / c;
+                    x[i] = c * x[i] - s * lik;
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @throws std::invalid_argument if the matrix is not positive definite
+        void _check_positive() const
+        {
+            if (!m_positive)
+            {
+                throw std::invalid_argument("Matrix is not positive definite, no Cholesky factorization exists");
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Both substitutions over all right hand sides at once
+        ///
+        /// @throws std::invalid_argument if the matrix is not positive definite
+        void _solve_in_place(T* x, const size_t& nrhs) const
+        {
+            _check_positive();
+
+            const size_t n = m_l.getRowCount();
+            const T* l = m_l.get_data();
+            triangular_solve(Triangle_t::LOWER, false, false, n, l, n, x, nrhs);
+            triangular_solve(Triangle_t::LOWER, true, false, n, l, n, x, nrhs);
+        };
+};
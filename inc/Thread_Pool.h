@@ -0,0 +1,144 @@
+/// ------------------------------------------
+/// @file Thread_Pool.h
+///
+/// @brief Header file for the shared thread pool used to partition Matrix operations
+///
+/// One pool is shared by the whole library. Work is handed out as index ranges through
+/// parallel_for, the calling thread always takes part so nested calls (a parallel routine
+/// calling another) make progress without needing extra threads
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+/// Minimum number of scalar operations a task should perform before it is worth handing
+/// to the pool, loops smaller than this run serially on the calling thread
+#ifndef PARALLEL_MIN_WORK
+#define PARALLEL_MIN_WORK 32768
+#endif
+
+/// Number of chunks handed out per thread, more chunks balance uneven work better
+#ifndef PARALLEL_CHUNKS_PER_THREAD
+#define PARALLEL_CHUNKS_PER_THREAD 4
+#endif
+
+/// Environment variable read at start up for the thread count, unset uses all hardware threads
+#define PARALLEL_THREADS_ENV "MATRIX_NUM_THREADS"
+
+/// @brief Shared pool of worker threads
+class Thread_Pool
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Returns the library wide pool, created on first use
+        ///
+        /// @return pool instance
+        static Thread_Pool& instance();
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, stops and joins all workers
+        ~Thread_Pool();
+
+        Thread_Pool(const Thread_Pool&) = delete;
+        Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+        ///--------------------------------------------------------
+        /// @brief Sets the number of threads used, including the calling thread
+        ///
+        /// @note must not be called while a parallel_for is running
+        ///
+        /// @param count thread count, 0 uses all hardware threads and 1 runs everything serially
+        void setThreadCount(size_t count);
+
+        ///--------------------------------------------------------
+        /// @brief Returns the number of threads used, including the calling thread
+        ///
+        /// @return thread count
+        size_t getThreadCount() const;
+
+        ///--------------------------------------------------------
+        /// @brief Runs body over [begin, end) split into chunks of at least grain indices,
+        /// blocks until every chunk has finished
+        ///
+        /// @param begin first index
+        /// @param end one past the last index
+        /// @param grain minimum indices per chunk, ranges no larger than this run serially
+        /// @param body called as body(chunkBegin, chunkEnd), must be safe to run concurrently
+        ///
+        /// @throws the first exception thrown by body, after all chunks have stopped
+        void parallel_for(const size_t& begin, const size_t& end, const size_t& grain,
+                          const std::function<void(size_t, size_t)>& body);
+
+    private:
+        ///--------------------------------------------------------
+        /// @brief Constructor, starts the workers using PARALLEL_THREADS_ENV if set
+        Thread_Pool();
+
+        ///--------------------------------------------------------
+        /// @brief Worker loop, runs queued tasks until stopped
+        void _worker();
+
+        ///--------------------------------------------------------
+        /// @brief Starts count - 1 workers (the caller is the last thread)
+        void _start(const size_t& count);
+
+        ///--------------------------------------------------------
+        /// @brief Stops and joins all workers
+        void _stop();
+
+        /// @brief worker threads
+        std::vector<std::thread> m_workers;
+
+        /// @brief queued tasks
+        std::deque<std::function<void()>> m_tasks;
+
+        /// @brief guards m_tasks and m_stopping
+        std::mutex m_mutex;
+
+        /// @brief signals new tasks or stopping
+        std::condition_variable m_cv;
+
+        /// @brief set to make workers exit
+        bool m_stopping = false;
+};
+
+///--------------------------------------------------------
+/// @brief Finds a grain size so each chunk performs at least PARALLEL_MIN_WORK operations
+///
+/// @param costPerIndex approximate scalar operations per loop index
+///
+/// @return grain to pass to parallel_for
+inline size_t parallel_grain(const size_t& costPerIndex)
+{
+    return std::max<size_t>(1, PARALLEL_MIN_WORK / std::max<size_t>(1, costPerIndex));
+}
+
+///--------------------------------------------------------
+/// @brief Runs body over [begin, end) on the shared pool, see Thread_Pool::parallel_for
+///
+/// @param begin first index
+/// @param end one past the last index
+/// @param grain minimum indices per chunk
+/// @param body called as body(chunkBegin, chunkEnd)
+inline void parallel_for(const size_t& begin, const size_t& end, const size_t& grain,
+                         const std::function<void(size_t, size_t)>& body)
+{
+    if (end <= begin + grain)
+    {
+        // skip the pool entirely for small loops
+        if (end > begin)
+        {
+            body(begin, end);
+        }
+        return;
+    }
+
+    Thread_Pool::instance().parallel_for(begin, end, grain, body);
+}
@@ -0,0 +1,1476 @@
+/// ------------------------------------------
+/// @file Tiled.h
+///
+/// @brief Header/Source file for out of core matrices stored as tiles in a matrix file
+///
+/// A Tiled_Matrix keeps its elements in a TILED matrix file (see Matrix_IO.h) and pages
+/// square tiles in and out through a bounded LRU cache, so only the memory budget has to
+/// fit in RAM. Dirty tiles are written back on eviction, flush() and destruction. Each
+/// cache owns an I/O thread that reads prefetched tiles while the caller computes on the
+/// ones it holds, the streaming operations below always request the next tiles before
+/// working on the current ones.
+///
+/// Multiply and transpose stream tile by tile. Tiled_LU and Tiled_QR factorize in place
+/// a column panel (all rows below the diagonal tile, one tile wide) at a time, so on top
+/// of the cache budget they hold two panels, rows x tile elements each, in memory
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Matrix.h"
+#include "Matrix_IO.h"
+#include "Vector.h"
+#include "View.h"
+#include "Gemm.h"
+#include "QR.h"
+#include "Scalar.h"
+#include "Storage.h"
+#include "Thread_Pool.h"
+#include "Transpose.h"
+
+/// Default side of a square tile, in elements
+#ifndef TILED_DEFAULT_TILE
+#define TILED_DEFAULT_TILE 512
+#endif
+
+/// Default bytes of tiles a cache may hold resident
+#ifndef TILED_DEFAULT_BUDGET
+#define TILED_DEFAULT_BUDGET (size_t(1) << 30)
+#endif
+
+/// Smallest budget accepted, in tiles, enough for the operands of one step plus the prefetched next ones
+#define TILED_MIN_TILES 8
+
+/// @brief How a pinned tile will be used
+enum class Tile_Access_t
+{
+    READ,       // read from the file, written back only if another pin changes it
+    WRITE,      // read from the file, written back
+    OVERWRITE   // zero filled instead of read, written back
+};
+
+/// @brief Bounded LRU cache of the tiles of one tile file, with a background prefetch thread
+/// Pinned tiles are never evicted. A demand pin that finds every resident tile pinned goes
+/// over budget rather than fail, prefetches never do
+template <typename T>
+class Tile_Cache_t
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, takes over an open tile file
+        ///
+        /// @param file TILED matrix file of T
+        /// @param budget bytes of tiles the cache may hold resident
+        ///
+        /// @throws std::invalid_argument if the budget holds fewer than TILED_MIN_TILES tiles
+        Tile_Cache_t(Tile_File_t&& file, const size_t& budget) : m_file(std::move(file)), m_budget(budget)
+        {
+            const size_t tile = m_file.header().m_tile;
+            m_tileElems = tile * tile;
+            m_tileBytes = m_tileElems * sizeof(T);
+
+            if (m_budget / m_tileBytes < TILED_MIN_TILES)
+            {
+                throw std::invalid_argument("Tile cache budget must hold at least TILED_MIN_TILES tiles");
+            }
+
+            m_io = std::thread([this]() { _io_loop(); });
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, stops the I/O thread and writes back dirty tiles
+        /// Write errors are lost here, call flush() first to see them
+        ~Tile_Cache_t()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_work.notify_all();
+            m_io.join();
+
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+            }
+
+            for (std::pair<const size_t, Entry_t>& entry : m_entries)
+            {
+                storage_delete(entry.second.m_data, m_tileElems);
+            }
+        };
+
+        Tile_Cache_t(const Tile_Cache_t&) = delete;
+        Tile_Cache_t& operator=(const Tile_Cache_t&) = delete;
+
+        ///--------------------------------------------------------
+        /// @brief Makes a tile resident and holds it there until unpin()
+        ///
+        /// @param id tile index, row major over the tile grid
+        /// @param access how the tile will be used
+        ///
+        /// @return the tile's tile x tile row major elements
+        ///
+        /// @throws std::runtime_error if the tile cannot be read, or a dirty tile cannot be written back to make room
+        T* pin(const size_t& id, const Tile_Access_t& access)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            for (;;)
+            {
+                typename std::unordered_map<size_t, Entry_t>::iterator found = m_entries.find(id);
+                if (found == m_entries.end())
+                {
+                    break;
+                }
+
+                Entry_t& entry = found->second;
+                if (!entry.m_ready)
+                {
+                    // the I/O thread is reading it, it may also give up and erase it
+                    m_loaded.wait(lock);
+                    continue;
+                }
+
+                m_hits++;
+                entry.m_pins++;
+                entry.m_dirty = entry.m_dirty || access != Tile_Access_t::READ;
+                m_lru.splice(m_lru.end(), m_lru, entry.m_lru);
+                return entry.m_data;
+            }
+
+            m_misses++;
+            _make_room();
+            Entry_t& entry = _insert(id);
+            entry.m_pins = 1;
+
+            if (access == Tile_Access_t::OVERWRITE)
+            {
+                std::fill_n(entry.m_data, m_tileElems, (T) 0);
+                entry.m_ready = true;
+                entry.m_dirty = true;
+                return entry.m_data;
+            }
+
+            lock.unlock();
+            try
+            {
+                m_file.read(id * m_tileBytes, entry.m_data, m_tileBytes);
+            }
+            catch (...)
+            {
+                lock.lock();
+                _erase(id);
+                m_loaded.notify_all();
+                throw;
+            }
+            lock.lock();
+
+            entry.m_ready = true;
+            entry.m_dirty = access == Tile_Access_t::WRITE;
+            m_loaded.notify_all();
+            return entry.m_data;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Releases one pin of a tile, it stays resident until evicted
+        ///
+        /// @param id tile index given to pin()
+        void unpin(const size_t& id)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.at(id).m_pins--;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Asks the I/O thread to read a tile ahead of its use
+        /// Dropped if the tile is resident, the queue is full or no room can be made without going over budget
+        ///
+        /// @param id tile index, row major over the tile grid
+        void prefetch(const size_t& id)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_entries.count(id) != 0 || m_queue.size() >= m_budget / m_tileBytes / 2)
+                {
+                    return;
+                }
+                m_queue.push_back(id);
+            }
+            m_work.notify_one();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Writes every dirty resident tile back to the file
+        ///
+        /// @throws std::runtime_error if a write fails
+        void flush()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (std::pair<const size_t, Entry_t>& entry : m_entries)
+            {
+                if (entry.second.m_ready && entry.second.m_dirty)
+                {
+                    m_file.write(entry.first * m_tileBytes, entry.second.m_data, m_tileBytes);
+                    entry.second.m_dirty = false;
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the file the tiles come from
+        ///
+        /// @return tile file
+        const Tile_File_t& file() const
+        {
+            return m_file;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the byte budget of the cache
+        ///
+        /// @return bytes of tiles the cache may hold resident
+        size_t getBudget() const
+        {
+            return m_budget;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the bytes of tiles resident right now
+        ///
+        /// @return resident bytes
+        size_t getResidentBytes() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_resident;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of pins that found their tile resident, prefetched or not
+        ///
+        /// @return cache hits
+        size_t getHits() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_hits;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of pins that had to read (or zero fill) their tile themselves
+        ///
+        /// @return cache misses
+        size_t getMisses() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_misses;
+        };
+
+    private:
+        /// @brief A resident (or loading) tile
+        struct Entry_t
+        {
+            T* m_data = nullptr;
+            size_t m_pins = 0;
+            bool m_ready = false;
+            bool m_dirty = false;
+            std::list<size_t>::iterator m_lru;
+        };
+
+        Tile_File_t m_file;
+        size_t m_budget;
+        size_t m_tileElems = 0;
+        size_t m_tileBytes = 0;
+
+        /// @brief resident tiles by index, node based so entries stay put while the lock is dropped
+        std::unordered_map<size_t, Entry_t> m_entries;
+
+        /// @brief resident tile indices, least recently pinned first
+        std::list<size_t> m_lru;
+
+        size_t m_resident = 0;
+        size_t m_hits = 0;
+        size_t m_misses = 0;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_loaded;
+        std::condition_variable m_work;
+        std::deque<size_t> m_queue;
+        bool m_stop = false;
+        std::thread m_io;
+
+        ///--------------------------------------------------------
+        /// @brief Evicts least recently used unpinned tiles until one more tile fits in the budget
+        /// Called with the lock held
+        ///
+        /// @return false if everything left is pinned or loading and the budget is still full
+        ///
+        /// @throws std::runtime_error if a dirty tile cannot be written back, it then stays resident
+        bool _make_room()
+        {
+            std::list<size_t>::iterator it = m_lru.begin();
+            while (m_resident + m_tileBytes > m_budget)
+            {
+                while (it != m_lru.end() && (m_entries.at(*it).m_pins != 0 || !m_entries.at(*it).m_ready))
+                {
+                    it++;
+                }
+                if (it == m_lru.end())
+                {
+                    return false;
+                }
+
+                const size_t id = *it++;
+                Entry_t& victim = m_entries.at(id);
+                if (victim.m_dirty)
+                {
+                    m_file.write(id * m_tileBytes, victim.m_data, m_tileBytes);
+                }
+                _erase(id);
+            }
+            return true;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adds a not yet ready entry for a tile, called with the lock held
+        ///
+        /// @param id tile index
+        ///
+        /// @return the new entry
+        Entry_t& _insert(const size_t& id)
+        {
+            Entry_t& entry = m_entries[id];
+            entry.m_data = storage_new<T>(m_tileElems);
+            entry.m_lru = m_lru.insert(m_lru.end(), id);
+            m_resident += m_tileBytes;
+            return entry;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Frees and forgets a tile without writing it back, called with the lock held
+        ///
+        /// @param id tile index
+        void _erase(const size_t& id)
+        {
+            Entry_t& entry = m_entries.at(id);
+            storage_delete(entry.m_data, m_tileElems);
+            m_lru.erase(entry.m_lru);
+            m_entries.erase(id);
+            m_resident -= m_tileBytes;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief I/O thread body, reads queued tiles until stopped
+        void _io_loop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_work.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+                if (m_stop)
+                {
+                    return;
+                }
+
+                const size_t id = m_queue.front();
+                m_queue.pop_front();
+                if (m_entries.count(id) != 0)
+                {
+                    continue;
+                }
+
+                bool room = false;
+                try
+                {
+                    room = _make_room();
+                }
+                catch (...)
+                {
+                    // the demand pin that needs the room will see the write error
+                }
+                if (!room)
+                {
+                    continue;
+                }
+
+                Entry_t& entry = _insert(id);
+                lock.unlock();
+                bool read = true;
+                try
+                {
+                    m_file.read(id * m_tileBytes, entry.m_data, m_tileBytes);
+                }
+                catch (...)
+                {
+                    // the demand pin will retry and report the error
+                    read = false;
+                }
+                lock.lock();
+
+                if (read)
+                {
+                    entry.m_ready = true;
+                }
+                else
+                {
+                    _erase(id);
+                }
+                m_loaded.notify_all();
+            }
+        };
+};
+
+/// @brief Pin of one tile of a Tiled_Matrix, the tile stays resident while this lives
+template <typename T>
+class Tile_Pin_t
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, pins a tile
+        ///
+        /// @param cache cache holding the tile
+        /// @param id tile index
+        /// @param access how the tile will be used
+        /// @param rows rows of the tile inside the matrix
+        /// @param cols columns of the tile inside the matrix
+        /// @param ld row stride of the tile, the tile side
+        Tile_Pin_t(Tile_Cache_t<T>& cache, const size_t& id, const Tile_Access_t& access,
+                   const size_t& rows, const size_t& cols, const size_t& ld)
+            : m_cache(&cache), m_id(id), m_data(cache.pin(id, access)), m_rows(rows), m_cols(cols), m_ld(ld)
+        {
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, unpins the tile
+        ~Tile_Pin_t()
+        {
+            if (m_cache != nullptr)
+            {
+                m_cache->unpin(m_id);
+            }
+        };
+
+        Tile_Pin_t(const Tile_Pin_t&) = delete;
+        Tile_Pin_t& operator=(const Tile_Pin_t&) = delete;
+
+        Tile_Pin_t(Tile_Pin_t&& other) noexcept
+            : m_cache(std::exchange(other.m_cache, nullptr)), m_id(other.m_id), m_data(other.m_data),
+              m_rows(other.m_rows), m_cols(other.m_cols), m_ld(other.m_ld)
+        {
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets the first element of the tile, rows are m_ld apart
+        ///
+        /// @return tile data
+        T* data() const
+        {
+            return m_data;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of the part of the tile inside the matrix
+        ///
+        /// @return (rows, cols) view with the tile's row stride
+        Block_View<T> view() const
+        {
+            return Block_View<T>(m_data, m_rows, m_cols, m_ld);
+        };
+
+    private:
+        Tile_Cache_t<T>* m_cache;
+        size_t m_id;
+        T* m_data;
+        size_t m_rows;
+        size_t m_cols;
+        size_t m_ld;
+};
+
+/// @brief Templated out of core matrix, elements live in a TILED matrix file and are paged through a bounded tile cache
+template <typename T>
+class Tiled_Matrix
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Creates a zero matrix backed by a new file
+        ///
+        /// @param path file to create, overwritten if it exists
+        /// @param rows number of rows
+        /// @param cols number of columns
+        /// @param tile side of the square tiles
+        /// @param budget bytes of tiles held in memory
+        ///
+        /// @return the new matrix
+        ///
+        /// @throws std::invalid_argument if a dimension or the tile is 0, or the budget is below TILED_MIN_TILES tiles
+        /// @throws std::runtime_error if the file cannot be created
+        static Tiled_Matrix create(const std::string& path, const size_t& rows, const size_t& cols,
+                                   const size_t& tile = TILED_DEFAULT_TILE, const size_t& budget = TILED_DEFAULT_BUDGET)
+        {
+            if (rows == 0 || cols == 0 || tile == 0)
+            {
+                throw std::invalid_argument("Cols/Rows/Tile of a tiled matrix must be above 0");
+            }
+
+            return Tiled_Matrix(path, Tile_File_t(path, matrix_file_header<T>(rows, cols, Matrix_Order_t::TILED, tile)), budget);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Opens the matrix in an existing TILED matrix file
+        ///
+        /// @param path file to open
+        /// @param budget bytes of tiles held in memory
+        ///
+        /// @return the matrix
+        ///
+        /// @throws std::invalid_argument if the file is not a TILED file of T, or the budget is below TILED_MIN_TILES tiles
+        /// @throws std::runtime_error if the file cannot be opened or is not a valid matrix file
+        static Tiled_Matrix open(const std::string& path, const size_t& budget = TILED_DEFAULT_BUDGET)
+        {
+            Tile_File_t file(path);
+            if (file.header().m_order != static_cast<uint32_t>(Matrix_Order_t::TILED))
+            {
+                throw std::invalid_argument("Matrix file is not tiled: " + path);
+            }
+            if (file.header().m_dtype != static_cast<uint32_t>(matrix_dtype<T>()))
+            {
+                throw std::invalid_argument("Element type does not match the matrix file");
+            }
+
+            return Tiled_Matrix(path, std::move(file), budget);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies an in memory matrix into a new tiled file
+        ///
+        /// @param path file to create, overwritten if it exists
+        /// @param mat matrix to copy
+        /// @param tile side of the square tiles
+        /// @param budget bytes of tiles held in memory
+        ///
+        /// @return the new matrix
+        static Tiled_Matrix fromMatrix(const std::string& path, const Matrix<T>& mat,
+                                       const size_t& tile = TILED_DEFAULT_TILE, const size_t& budget = TILED_DEFAULT_BUDGET)
+        {
+            Tiled_Matrix outMat = create(path, mat.getRowCount(), mat.getColCount(), tile, budget);
+            for (size_t i = 0; i < outMat.m_tileRows; i++)
+            {
+                for (size_t j = 0; j < outMat.m_tileCols; j++)
+                {
+                    outMat.pin(i, j, Tile_Access_t::OVERWRITE).view().assign(mat.view().block(i * tile, j * tile, outMat.tileRowCount(i), outMat.tileColCount(j)));
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, writes back dirty tiles, temporaries also delete their file
+        ~Tiled_Matrix()
+        {
+            m_cache.reset();
+            if (m_temporary)
+            {
+                std::remove(m_path.c_str());
+            }
+        };
+
+        Tiled_Matrix(const Tiled_Matrix&) = delete;
+        Tiled_Matrix& operator=(const Tiled_Matrix&) = delete;
+
+        Tiled_Matrix(Tiled_Matrix&& other) noexcept
+            : m_rows(other.m_rows), m_cols(other.m_cols), m_tile(other.m_tile),
+              m_tileRows(other.m_tileRows), m_tileCols(other.m_tileCols), m_path(std::move(other.m_path)),
+              m_temporary(std::exchange(other.m_temporary, false)), m_cache(std::move(other.m_cache))
+        {
+        };
+
+        Tiled_Matrix& operator=(Tiled_Matrix&& other) noexcept
+        {
+            if (this != &other)
+            {
+                m_cache.reset();
+                if (m_temporary)
+                {
+                    std::remove(m_path.c_str());
+                }
+
+                m_rows = other.m_rows;
+                m_cols = other.m_cols;
+                m_tile = other.m_tile;
+                m_tileRows = other.m_tileRows;
+                m_tileCols = other.m_tileCols;
+                m_path = std::move(other.m_path);
+                m_temporary = std::exchange(other.m_temporary, false);
+                m_cache = std::move(other.m_cache);
+            }
+            return *this;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the whole matrix into memory
+        ///
+        /// @return in memory copy
+        Matrix<T> toMatrix() const
+        {
+            Matrix<T> outMat(m_rows, m_cols);
+            for (size_t i = 0; i < m_tileRows; i++)
+            {
+                for (size_t j = 0; j < m_tileCols; j++)
+                {
+                    prefetch(i + (j + 1) / m_tileCols, (j + 1) % m_tileCols);
+                    outMat.block(i * m_tile, j * m_tile, tileRowCount(i), tileColCount(j)).assign(pin(i, j).view());
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows in the matrix
+        size_t getRowCount() const
+        {
+            return m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns in the matrix
+        size_t getColCount() const
+        {
+            return m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the side of the square tiles
+        ///
+        /// @return tile side in elements
+        size_t getTileSize() const
+        {
+            return m_tile;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows of tiles
+        ///
+        /// @return tile grid height
+        size_t getTileRowCount() const
+        {
+            return m_tileRows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns of tiles
+        ///
+        /// @return tile grid width
+        size_t getTileColCount() const
+        {
+            return m_tileCols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of matrix rows in a row of tiles, smaller for the last one
+        ///
+        /// @param tileRow row of the tile grid
+        ///
+        /// @return rows inside the matrix
+        size_t tileRowCount(const size_t& tileRow) const
+        {
+            return std::min(m_tile, m_rows - tileRow * m_tile);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of matrix columns in a column of tiles, smaller for the last one
+        ///
+        /// @param tileCol column of the tile grid
+        ///
+        /// @return columns inside the matrix
+        size_t tileColCount(const size_t& tileCol) const
+        {
+            return std::min(m_tile, m_cols - tileCol * m_tile);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the file backing the matrix
+        ///
+        /// @return file path
+        const std::string& getPath() const
+        {
+            return m_path;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the tile cache, for its budget and statistics
+        ///
+        /// @return tile cache
+        const Tile_Cache_t<T>& getCache() const
+        {
+            return *m_cache;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Pins a tile in memory
+        ///
+        /// @param tileRow row of the tile grid
+        /// @param tileCol column of the tile grid
+        /// @param access how the tile will be used
+        ///
+        /// @return pin of the tile
+        ///
+        /// @throws std::invalid_argument if the tile is outside the grid
+        Tile_Pin_t<T> pin(const size_t& tileRow, const size_t& tileCol, const Tile_Access_t& access = Tile_Access_t::READ) const
+        {
+            if (tileRow >= m_tileRows || tileCol >= m_tileCols)
+            {
+                throw std::invalid_argument("Tile index out of range");
+            }
+
+            return Tile_Pin_t<T>(*m_cache, tileRow * m_tileCols + tileCol, access,
+                                 tileRowCount(tileRow), tileColCount(tileCol), m_tile);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Starts reading a tile in the background, indices outside the grid are ignored
+        ///
+        /// @param tileRow row of the tile grid
+        /// @param tileCol column of the tile grid
+        void prefetch(const size_t& tileRow, const size_t& tileCol) const
+        {
+            if (tileRow < m_tileRows && tileCol < m_tileCols)
+            {
+                m_cache->prefetch(tileRow * m_tileCols + tileCol);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Starts reading a column panel in the background, tiles (tileRow.., tileCol)
+        ///
+        /// @param tileRow first row of the tile grid
+        /// @param tileCol column of the tile grid
+        void prefetchPanel(const size_t& tileRow, const size_t& tileCol) const
+        {
+            for (size_t i = tileRow; i < m_tileRows; i++)
+            {
+                prefetch(i, tileCol);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Reads one element
+        ///
+        /// @param row element row
+        /// @param col element column
+        ///
+        /// @return element value
+        ///
+        /// @throws std::invalid_argument if the element is outside the matrix
+        T get(const size_t& row, const size_t& col) const
+        {
+            _check_index(row, col);
+            return pin(row / m_tile, col / m_tile).data()[(row % m_tile) * m_tile + col % m_tile];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Writes one element
+        ///
+        /// @param row element row
+        /// @param col element column
+        /// @param val new value
+        ///
+        /// @throws std::invalid_argument if the element is outside the matrix
+        void set(const size_t& row, const size_t& col, const T& val)
+        {
+            _check_index(row, col);
+            pin(row / m_tile, col / m_tile, Tile_Access_t::WRITE).data()[(row % m_tile) * m_tile + col % m_tile] = val;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Writes every dirty resident tile back to the file
+        ///
+        /// @throws std::runtime_error if a write fails
+        void flush()
+        {
+            m_cache->flush();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies a column panel into memory, rows from tile row tileRow down, one tile column wide
+        ///
+        /// @param tileRow first row of the tile grid
+        /// @param tileCol column of the tile grid
+        /// @param panel resized to (rows - tileRow * tile, width of the tile column) and filled
+        void gatherPanel(const size_t& tileRow, const size_t& tileCol, Matrix<T>& panel) const
+        {
+            const size_t height = m_rows - tileRow * m_tile;
+            const size_t width = tileColCount(tileCol);
+            if (panel.getRowCount() != height || panel.getColCount() != width)
+            {
+                panel = Matrix<T>(height, width);
+            }
+
+            for (size_t i = tileRow; i < m_tileRows; i++)
+            {
+                prefetch(i + 1, tileCol);
+                panel.block((i - tileRow) * m_tile, 0, tileRowCount(i), width).assign(pin(i, tileCol).view());
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Writes a column panel from gatherPanel back, the tiles are overwritten without being read
+        ///
+        /// @param tileRow first row of the tile grid
+        /// @param tileCol column of the tile grid
+        /// @param panel (rows - tileRow * tile, width of the tile column) panel
+        ///
+        /// @throws std::invalid_argument if the panel has the wrong dimensions
+        void scatterPanel(const size_t& tileRow, const size_t& tileCol, const Matrix<T>& panel)
+        {
+            if (panel.getRowCount() != m_rows - tileRow * m_tile || panel.getColCount() != tileColCount(tileCol))
+            {
+                throw std::invalid_argument("Panel dimensions do not match the tile column");
+            }
+
+            for (size_t i = tileRow; i < m_tileRows; i++)
+            {
+                pin(i, tileCol, Tile_Access_t::OVERWRITE).view().assign(panel.block((i - tileRow) * m_tile, 0, tileRowCount(i), panel.getColCount()));
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product of two tiled matrices into a new file, tile by tile
+        /// While one pair of tiles multiplies, the next pair is read in the background
+        ///
+        /// @param rhs (p,n) right hand matrix, same tile size
+        /// @param path file for the (m,n) result, overwritten if it exists
+        ///
+        /// @return the product
+        ///
+        /// @throws std::invalid_argument if the dimensions or tile sizes do not match
+        Tiled_Matrix multiply(const Tiled_Matrix& rhs, const std::string& path) const
+        {
+            if (m_cols != rhs.m_rows)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+            if (m_tile != rhs.m_tile)
+            {
+                throw std::invalid_argument("Tiled matrices must share a tile size");
+            }
+
+            Tiled_Matrix outMat = create(path, m_rows, rhs.m_cols, m_tile, m_cache->getBudget());
+            Storage_Vector_t<T> acc(m_tile * m_tile);
+
+            for (size_t i = 0; i < m_tileRows; i++)
+            {
+                for (size_t j = 0; j < rhs.m_tileCols; j++)
+                {
+                    Tile_Pin_t<T> out = outMat.pin(i, j, Tile_Access_t::OVERWRITE);
+                    const size_t rows = tileRowCount(i);
+                    const size_t cols = rhs.tileColCount(j);
+
+                    for (size_t k = 0; k < m_tileCols; k++)
+                    {
+                        // request the operands of the next step, the next output tile after the last k
+                        const bool last = k + 1 == m_tileCols;
+                        const size_t nextI = (last && j + 1 == rhs.m_tileCols) ? i + 1 : i;
+                        const size_t nextJ = last ? (j + 1) % rhs.m_tileCols : j;
+                        const size_t nextK = last ? 0 : k + 1;
+                        prefetch(nextI, nextK);
+                        rhs.prefetch(nextK, nextJ);
+
+                        const Tile_Pin_t<T> lhsTile = pin(i, k);
+                        const Tile_Pin_t<T> rhsTile = rhs.pin(k, j);
+                        if (k == 0)
+                        {
+                            gemm(rows, cols, tileColCount(k), lhsTile.data(), m_tile, (size_t) 1,
+                                 rhsTile.data(), m_tile, (size_t) 1, out.data(), m_tile);
+                            continue;
+                        }
+
+                        gemm(rows, cols, tileColCount(k), lhsTile.data(), m_tile, (size_t) 1,
+                             rhsTile.data(), m_tile, (size_t) 1, acc.data(), m_tile);
+                        for (size_t r = 0; r < rows; r++)
+                        {
+                            Strided_View<T>(out.data() + r * m_tile, cols).axpy((T) 1, Strided_View<const T>(acc.data() + r * m_tile, cols));
+                        }
+                    }
+                }
+            }
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product of two tiled matrices into a temporary file next to this one
+        /// The temporary file is deleted with the result
+        ///
+        /// @param rhs (p,n) right hand matrix, same tile size
+        ///
+        /// @return the product
+        ///
+        /// @throws std::invalid_argument if the dimensions or tile sizes do not match
+        Tiled_Matrix operator%(const Tiled_Matrix& rhs) const
+        {
+            Tiled_Matrix outMat = multiply(rhs, _temp_path());
+            outMat.m_temporary = true;
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Transposes into a new file, tile by tile
+        ///
+        /// @param path file for the (n,m) result, overwritten if it exists
+        ///
+        /// @return the transpose
+        Tiled_Matrix transpose(const std::string& path) const
+        {
+            Tiled_Matrix outMat = create(path, m_cols, m_rows, m_tile, m_cache->getBudget());
+            for (size_t i = 0; i < m_tileRows; i++)
+            {
+                for (size_t j = 0; j < m_tileCols; j++)
+                {
+                    prefetch(i + (j + 1) / m_tileCols, (j + 1) % m_tileCols);
+
+                    const Tile_Pin_t<T> src = pin(i, j);
+                    const Tile_Pin_t<T> dst = outMat.pin(j, i, Tile_Access_t::OVERWRITE);
+                    transpose_copy(tileRowCount(i), tileColCount(j), src.data(), m_tile, dst.data(), m_tile);
+                }
+            }
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Transposes into a temporary file next to this one, deleted with the result
+        ///
+        /// @return the transpose
+        Tiled_Matrix transpose() const
+        {
+            Tiled_Matrix outMat = transpose(_temp_path());
+            outMat.m_temporary = true;
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ux = b in place, U the upper triangle of the leading (n,n) block
+        /// Used by the tiled factorizations, the strict lower triangle is never read
+        ///
+        /// @param x right hand side b on entry, solution on exit, n = number of columns long
+        ///
+        /// @throws std::invalid_argument if a diagonal element is exactly zero
+        void upper_solve(T* x) const
+        {
+            for (size_t k = m_tileCols; k-- > 0;)
+            {
+                const size_t k0 = k * m_tile;
+                const size_t width = tileColCount(k);
+
+                // x_k -= U_kj x_j for the tiles right of the diagonal
+                for (size_t j = k + 1; j < m_tileCols; j++)
+                {
+                    prefetch(k, j + 1);
+                    const Tile_Pin_t<T> upper = pin(k, j);
+                    const size_t cols = tileColCount(j);
+                    for (size_t r = 0; r < width; r++)
+                    {
+                        const T* row = upper.data() + r * m_tile;
+                        T sum = (T) 0;
+                        for (size_t c = 0; c < cols; c++)
+                        {
+                            sum += row[c] * x[j * m_tile + c];
+                        }
+                        x[k0 + r] -= sum;
+                    }
+                }
+
+                prefetch(k - 1, k - 1);
+                const Tile_Pin_t<T> diag = pin(k, k);
+                for (size_t r = width; r-- > 0;)
+                {
+                    const T* row = diag.data() + r * m_tile;
+                    T sum = x[k0 + r];
+                    for (size_t c = r + 1; c < width; c++)
+                    {
+                        sum -= row[c] * x[k0 + c];
+                    }
+                    if (row[r] == (T) 0)
+                    {
+                        throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+                    }
+                    x[k0 + r] = sum / row[r];
+                }
+            }
+        };
+
+    private:
+        size_t m_rows = 0;
+        size_t m_cols = 0;
+        size_t m_tile = 0;
+        size_t m_tileRows = 0;
+        size_t m_tileCols = 0;
+
+        /// @brief backing file
+        std::string m_path;
+
+        /// @brief delete the backing file on destruction, set on the results of operators
+        bool m_temporary = false;
+
+        /// @brief tile cache over the backing file, held by pointer so the matrix can move
+        std::unique_ptr<Tile_Cache_t<T>> m_cache;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, wraps an open tile file
+        ///
+        /// @param path file name
+        /// @param file open TILED file of T
+        /// @param budget bytes of tiles held in memory
+        Tiled_Matrix(const std::string& path, Tile_File_t&& file, const size_t& budget)
+            : m_rows(file.header().m_rows), m_cols(file.header().m_cols), m_tile(file.header().m_tile), m_path(path)
+        {
+            m_tileRows = (m_rows + m_tile - 1) / m_tile;
+            m_tileCols = (m_cols + m_tile - 1) / m_tile;
+            m_cache = std::make_unique<Tile_Cache_t<T>>(std::move(file), budget);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unused file name next to this matrix's file, for operator results
+        ///
+        /// @return file path
+        std::string _temp_path() const
+        {
+            static std::atomic<size_t> counter{0};
+            return m_path + "." + std::to_string(counter++) + ".tmp";
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Checks an element index is inside the matrix
+        ///
+        /// @throws std::invalid_argument if not
+        void _check_index(const size_t& row, const size_t& col) const
+        {
+            if (row >= m_rows || col >= m_cols)
+            {
+                throw std::invalid_argument("Index out of range");
+            }
+        };
+};
+
+/// @brief Templated out of core LU factorization with partial pivoting, PA = LU
+/// Factorizes a Tiled_Matrix in place a column panel at a time: the panel is factorized in
+/// memory, then each trailing tile column is streamed in, has the interchanges, the triangular
+/// solve and the rank update applied, and is written back while the next one is read.
+/// As in LINPACK the interchanges of later panels are not applied to earlier columns of L,
+/// solve() replays them in order
+template <typename T>
+class Tiled_LU
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes the given matrix in place
+        /// The matrix must outlive this object and not be changed while it is used
+        ///
+        /// @note singular matrices are still factorized, isSingular() will report them
+        /// and any solve call will throw
+        ///
+        /// @param mat square tiled matrix, overwritten with L (unit diagonal implied) and U
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Tiled_LU(Tiled_Matrix<T>& mat) : m_mat(mat), m_pivots(mat.getRowCount())
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to have an LU factorization");
+            }
+
+            _factorize();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is the factorized matrix singular (exactly zero pivot found)?
+        ///
+        /// @return true if matrix has no inverse
+        bool isSingular() const
+        {
+            return m_singular;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the row interchanges, row i was swapped with row pivots[i] at step i
+        ///
+        /// @return pivot rows, 0 based
+        const std::vector<size_t>& getPivots() const
+        {
+            return m_pivots;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant, product of the U diagonal and permutation sign
+        ///
+        /// @return determinant of the factorized matrix
+        T determinant() const
+        {
+            int sign = 1;
+            for (size_t i = 0; i < m_pivots.size(); i++)
+            {
+                if (m_pivots[i] != i)
+                {
+                    sign = -sign;
+                }
+            }
+
+            T det = (T) sign;
+            const size_t tile = m_mat.getTileSize();
+            for (size_t k = 0; k < m_mat.getTileRowCount(); k++)
+            {
+                m_mat.prefetch(k + 1, k + 1);
+                const Tile_Pin_t<T> diag = m_mat.pin(k, k);
+                for (size_t r = 0; r < m_mat.tileRowCount(k); r++)
+                {
+                    det *= diag.data()[r * tile + r];
+                }
+            }
+
+            return det;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            const size_t n = m_pivots.size();
+            if (solutions.size() != n)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+            if (m_singular)
+            {
+                throw std::invalid_argument("Matrix is singular, no unique solution exists");
+            }
+
+            Vector<T> x(n);
+            T* y = x.get_data();
+            std::copy_n(solutions.get_data(), n, y);
+
+            // forward substitution with unit L, each panel's interchanges first
+            const size_t tile = m_mat.getTileSize();
+            for (size_t k = 0; k < m_mat.getTileColCount(); k++)
+            {
+                const size_t k0 = k * tile;
+                const size_t width = m_mat.tileColCount(k);
+                for (size_t c = 0; c < width; c++)
+                {
+                    std::swap(y[k0 + c], y[m_pivots[k0 + c]]);
+                }
+
+                for (size_t i = k; i < m_mat.getTileRowCount(); i++)
+                {
+                    m_mat.prefetch(i + 1, k);
+                    const Tile_Pin_t<T> lower = m_mat.pin(i, k);
+                    for (size_t r = 0; r < m_mat.tileRowCount(i); r++)
+                    {
+                        const T* row = lower.data() + r * tile;
+                        const size_t cols = (i == k) ? r : width;
+                        T sum = (T) 0;
+                        for (size_t c = 0; c < cols; c++)
+                        {
+                            sum += row[c] * y[k0 + c];
+                        }
+                        y[i * tile + r] -= sum;
+                    }
+                }
+            }
+
+            m_mat.upper_solve(y);
+            return x;
+        };
+
+    private:
+        /// @brief factorized matrix, L below the diagonal and U on and above it
+        Tiled_Matrix<T>& m_mat;
+
+        /// @brief row interchanges, LAPACK ipiv style
+        std::vector<size_t> m_pivots;
+
+        bool m_singular = false;
+
+        ///--------------------------------------------------------
+        /// @brief Right looking factorization by column panels
+        void _factorize()
+        {
+            const size_t n = m_mat.getRowCount();
+            const size_t tile = m_mat.getTileSize();
+            Matrix<T> panel(1, 1);
+            Matrix<T> trailing(1, 1);
+            Storage_Vector_t<T> update;
+
+            for (size_t k = 0; k < m_mat.getTileColCount(); k++)
+            {
+                const size_t k0 = k * tile;
+                const size_t width = m_mat.tileColCount(k);
+                const size_t below = n - k0 - width;
+
+                m_mat.gatherPanel(k, k, panel);
+                m_mat.prefetchPanel(k, k + 1);
+                _factor_panel(panel, k0);
+                m_mat.scatterPanel(k, k, panel);
+
+                for (size_t j = k + 1; j < m_mat.getTileColCount(); j++)
+                {
+                    m_mat.gatherPanel(k, j, trailing);
+                    m_mat.prefetchPanel(k, j + 1);
+                    const size_t cols = trailing.getColCount();
+
+                    for (size_t c = 0; c < width; c++)
+                    {
+                        const size_t p = m_pivots[k0 + c] - k0;
+                        if (p != c)
+                        {
+                            std::swap_ranges(trailing.get_data() + c * cols, trailing.get_data() + (c + 1) * cols,
+                                             trailing.get_data() + p * cols);
+                        }
+                    }
+
+                    // U12 = L11^-1 A12
+                    for (size_t c = 0; c < width; c++)
+                    {
+                        const Strided_View<const T> pivotRow(trailing.get_data() + c * cols, cols);
+                        for (size_t r = c + 1; r < width; r++)
+                        {
+                            Strided_View<T>(trailing.get_data() + r * cols, cols).axpy(-panel(r, c), pivotRow);
+                        }
+                    }
+
+                    // A22 -= L21 U12
+                    if (below > 0)
+                    {
+                        update.resize(below * cols);
+                        gemm(below, cols, width, panel.get_data() + width * width, width, (size_t) 1,
+                             trailing.get_data(), cols, (size_t) 1, update.data(), cols);
+
+                        T* dst = trailing.get_data() + width * cols;
+                        parallel_for(0, below, parallel_grain(cols), [&](size_t from, size_t to)
+                        {
+                            for (size_t r = from; r < to; r++)
+                            {
+                                Strided_View<T>(dst + r * cols, cols).axpy((T) -1, Strided_View<const T>(update.data() + r * cols, cols));
+                            }
+                        });
+                    }
+
+                    m_mat.scatterPanel(k, j, trailing);
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unblocked partial pivoting factorization of one in memory panel
+        ///
+        /// @param panel (rows below k0, tile width) panel, overwritten with its L and U parts
+        /// @param k0 first row and column of the panel in the matrix, pivots are stored from it
+        void _factor_panel(Matrix<T>& panel, const size_t& k0)
+        {
+            const size_t height = panel.getRowCount();
+            const size_t width = panel.getColCount();
+            T* data = panel.get_data();
+
+            for (size_t c = 0; c < std::min(height, width); c++)
+            {
+                size_t pivotRow = c;
+                double pivotAbs = scalar_abs(data[c * width + c]);
+                for (size_t r = c + 1; r < height; r++)
+                {
+                    const double curAbs = scalar_abs(data[r * width + c]);
+                    if (curAbs > pivotAbs)
+                    {
+                        pivotAbs = curAbs;
+                        pivotRow = r;
+                    }
+                }
+
+                m_pivots[k0 + c] = k0 + pivotRow;
+                if (pivotAbs == 0)
+                {
+                    m_singular = true;
+                    continue;
+                }
+
+                if (pivotRow != c)
+                {
+                    std::swap_ranges(data + c * width, data + (c + 1) * width, data + pivotRow * width);
+                }
+
+                const T pivot = data[c * width + c];
+                const Strided_View<const T> pivotRest(data + c * width + c + 1, width - c - 1);
+                parallel_for(c + 1, height, parallel_grain(width - c), [&](size_t from, size_t to)
+                {
+                    for (size_t r = from; r < to; r++)
+                    {
+                        const T factor = data[r * width + c] / pivot;
+                        data[r * width + c] = factor;
+                        if (factor == (T) 0)
+                        {
+                            continue;
+                        }
+                        Strided_View<T>(data + r * width + c + 1, width - c - 1).axpy(-factor, pivotRest);
+                    }
+                });
+            }
+        };
+};
+
+/// @brief Templated out of core Householder QR factorization, A = QR
+/// Factorizes a Tiled_Matrix in place a column panel at a time with the in memory QR, then
+/// streams each trailing tile column through the panel's block reflector. R ends up in the
+/// upper triangle, the Householder vectors below it
+template <typename T>
+class Tiled_QR
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes the given (m,n) matrix in place
+        /// The matrix must outlive this object and not be changed while it is used
+        ///
+        /// @param mat tiled matrix, overwritten with R and the Householder vectors
+        Tiled_QR(Tiled_Matrix<T>& mat) : m_mat(mat), m_tau(std::min(mat.getRowCount(), mat.getColCount()))
+        {
+            _factorize();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the Householder scale factors, H_k = I - tau_k v_k v_k^H
+        ///
+        /// @return tau vector, min(m,n) long
+        const std::vector<T>& getTau() const
+        {
+            return m_tau;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies Q^H from the left without forming Q, vec := Q^H vec
+        ///
+        /// @param vec vector as long as the factorized matrix is tall
+        ///
+        /// @throws std::invalid_argument if the length mismatches
+        void apply_Qt(Vector<T>& vec) const
+        {
+            const size_t m = m_mat.getRowCount();
+            if (vec.size() != m)
+            {
+                throw std::invalid_argument("Vector length must equal the factorized row count to apply Q");
+            }
+
+            const size_t tile = m_mat.getTileSize();
+            T* y = vec.get_data();
+            Matrix<T> panel(1, 1);
+
+            for (size_t k = 0; k * tile < m_tau.size(); k++)
+            {
+                const size_t k0 = k * tile;
+                m_mat.gatherPanel(k, k, panel);
+                m_mat.prefetchPanel(k + 1, k + 1);
+
+                const size_t width = panel.getColCount();
+                const size_t height = panel.getRowCount();
+                for (size_t c = 0; c < std::min(width, height); c++)
+                {
+                    // y := (I - conj(tau) v v^H) y, v = [1, panel(c + 1.., c)]
+                    T dot = y[k0 + c];
+                    for (size_t r = c + 1; r < height; r++)
+                    {
+                        dot += scalar_conj(panel(r, c)) * y[k0 + r];
+                    }
+
+                    const T scale = scalar_conj(m_tau[k0 + c]) * dot;
+                    y[k0 + c] -= scale;
+                    for (size_t r = c + 1; r < height; r++)
+                    {
+                        y[k0 + r] -= panel(r, c) * scale;
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x, least squares if A is tall
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x, n long
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, A is wide or R is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            const size_t n = m_mat.getColCount();
+            if (m_mat.getRowCount() < n)
+            {
+                throw std::invalid_argument("QR solve requires at least as many rows as columns");
+            }
+
+            Vector<T> y = solutions;
+            apply_Qt(y);
+
+            // back substitute R x = (Q^H b), only the first n rows take part
+            Vector<T> x(n);
+            std::copy_n(y.get_data(), n, x.get_data());
+            m_mat.upper_solve(x.get_data());
+            return x;
+        };
+
+    private:
+        /// @brief factorized matrix, R on and above the diagonal and the reflectors below it
+        Tiled_Matrix<T>& m_mat;
+
+        /// @brief Householder scale factors
+        std::vector<T> m_tau;
+
+        ///--------------------------------------------------------
+        /// @brief Factorization by column panels
+        void _factorize()
+        {
+            const size_t tile = m_mat.getTileSize();
+            Matrix<T> panel(1, 1);
+            Matrix<T> trailing(1, 1);
+
+            for (size_t k = 0; k * tile < m_tau.size(); k++)
+            {
+                m_mat.gatherPanel(k, k, panel);
+                m_mat.prefetchPanel(k, k + 1);
+
+                const QR<T> qr(panel);
+                m_mat.scatterPanel(k, k, qr.getQR());
+                std::copy(qr.getTau().begin(), qr.getTau().end(), m_tau.begin() + k * tile);
+
+                for (size_t j = k + 1; j < m_mat.getTileColCount(); j++)
+                {
+                    m_mat.gatherPanel(k, j, trailing);
+                    m_mat.prefetchPanel(k, j + 1);
+                    qr.apply_Qt(trailing);
+                    m_mat.scatterPanel(k, j, trailing);
+                }
+            }
+        };
+};
@@ -0,0 +1,166 @@
+/// ------------------------------------------
+/// @file Transpose.h
+///
+/// @brief Header/Source file for the blocked transpose kernels used by Matrix<T>::transpose
+///
+/// Both copies work tile by tile so the reads and writes of a tile stay in L1, tiles
+/// are shared out across the thread pool. double and float tiles are transposed in
+/// registers (4x4 / 8x8 with AVX, 2x2 / 4x4 with NEON), picked once at run time
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+#include "Thread_Pool.h"
+
+/// Side length of the square tiles moved at a time, multiple of 8 for the SIMD kernels
+#ifndef TRANSPOSE_TILE
+#define TRANSPOSE_TILE 32
+#endif
+
+///--------------------------------------------------------
+/// @brief Transposes a rows x cols block of doubles, dst(j,i) = src(i,j)
+/// Meant for blocks that fit in L1, use transpose_copy for whole matrices
+///
+/// @param rows rows of src
+/// @param cols columns of src
+/// @param src source block
+/// @param lds row stride of src
+/// @param dst destination block (cols x rows), must not overlap src
+/// @param ldd row stride of dst
+void transpose_block(const size_t& rows, const size_t& cols, const double* src, const size_t& lds,
+                     double* dst, const size_t& ldd);
+
+///--------------------------------------------------------
+/// @brief Transposes a rows x cols block of floats, dst(j,i) = src(i,j)
+/// Meant for blocks that fit in L1, use transpose_copy for whole matrices
+///
+/// @param rows rows of src
+/// @param cols columns of src
+/// @param src source block
+/// @param lds row stride of src
+/// @param dst destination block (cols x rows), must not overlap src
+/// @param ldd row stride of dst
+void transpose_block(const size_t& rows, const size_t& cols, const float* src, const size_t& lds,
+                     float* dst, const size_t& ldd);
+
+///--------------------------------------------------------
+/// @brief Transposes a rows x cols block of any type, dst(j,i) = src(i,j)
+///
+/// @param rows rows of src
+/// @param cols columns of src
+/// @param src source block
+/// @param lds row stride of src
+/// @param dst destination block (cols x rows), must not overlap src
+/// @param ldd row stride of dst
+template <typename T>
+void transpose_block(const size_t& rows, const size_t& cols, const T* src, const size_t& lds,
+                     T* dst, const size_t& ldd)
+{
+    for (size_t j = 0; j < cols; j++)
+    {
+        for (size_t i = 0; i < rows; i++)
+        {
+            dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Out of place transpose, dst(j,i) = src(i,j)
+/// Each task owns a band of destination rows so writes never overlap
+///
+/// @param rows rows of src
+/// @param cols columns of src
+/// @param src source matrix
+/// @param lds row stride of src
+/// @param dst destination matrix (cols x rows), must not overlap src
+/// @param ldd row stride of dst
+template <typename T>
+void transpose_copy(const size_t& rows, const size_t& cols, const T* src, const size_t& lds,
+                    T* dst, const size_t& ldd)
+{
+    constexpr size_t tile = TRANSPOSE_TILE;
+    const size_t bands = (cols + tile - 1) / tile;
+
+    parallel_for(0, bands, parallel_grain(tile * rows), [&](size_t from, size_t to)
+    {
+        for (size_t jb = from * tile; jb < std::min(cols, to * tile); jb += tile)
+        {
+            const size_t jLen = std::min(cols - jb, tile);
+            for (size_t ib = 0; ib < rows; ib += tile)
+            {
+                const size_t iLen = std::min(rows - ib, tile);
+                transpose_block(iLen, jLen, src + ib * lds + jb, lds, dst + jb * ldd + ib, ldd);
+            }
+        }
+    });
+}
+
+///--------------------------------------------------------
+/// @brief In place transpose of an n x n matrix, no allocation
+/// Diagonal tiles are swapped about their own diagonal, each off diagonal pair of
+/// tiles (I,J), (J,I) is swapped whole. double/float pairs go through a stack tile
+/// so both halves use the SIMD kernels
+///
+/// @param n side length
+/// @param data matrix to transpose
+/// @param ld row stride of data
+template <typename T>
+void transpose_square_inplace(const size_t& n, T* data, const size_t& ld)
+{
+    constexpr size_t tile = TRANSPOSE_TILE;
+    const size_t bands = (n + tile - 1) / tile;
+
+    // band I handles tile pairs (I, J >= I), bands near the top do the most work
+    parallel_for(0, bands, parallel_grain(tile * n), [&](size_t from, size_t to)
+    {
+        for (size_t bi = from; bi < to; bi++)
+        {
+            const size_t ib = bi * tile;
+            const size_t iLen = std::min(n - ib, tile);
+
+            // diagonal tile
+            for (size_t i = ib; i < ib + iLen; i++)
+            {
+                for (size_t j = i + 1; j < ib + iLen; j++)
+                {
+                    std::swap(data[i * ld + j], data[j * ld + i]);
+                }
+            }
+
+            for (size_t jb = ib + tile; jb < n; jb += tile)
+            {
+                const size_t jLen = std::min(n - jb, tile);
+                T* upper = data + ib * ld + jb;     // iLen x jLen
+                T* lower = data + jb * ld + ib;     // jLen x iLen
+
+                if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+                {
+                    T buf[tile * tile];
+                    transpose_block(iLen, jLen, upper, ld, buf, tile);
+                    transpose_block(jLen, iLen, lower, ld, upper, ld);
+                    for (size_t j = 0; j < jLen; j++)
+                    {
+                        std::copy(buf + j * tile, buf + j * tile + iLen, lower + j * ld);
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < iLen; i++)
+                    {
+                        for (size_t j = 0; j < jLen; j++)
+                        {
+                            std::swap(upper[i * ld + j], lower[j * ld + i]);
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,467 @@
+/// ------------------------------------------
+/// @file Triangular.h
+///
+/// @brief Header/Source file for triangular matrices and the substitution kernel shared by the factorizations
+///
+/// A Triangular_Matrix keeps dense row major storage with the unused triangle held at
+/// zero, so it can be handed to anything taking a Matrix view, while its own solve,
+/// inverse, determinant and products only ever touch the stored triangle
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <algorithm>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Scalar.h"
+#include "Thread_Pool.h"
+
+///--------------------------------------------------------
+/// @brief Solves op(A) X = B in place by substitution, A triangular, op(A) = A or A^H
+/// Row i of A is read contiguously in every variant, transposed solves run as axpy updates
+///
+/// @param uplo triangle of A holding its values, the other is never read
+/// @param conjTrans solve with the conjugate transpose of A
+/// @param unit A has an implied unit diagonal, the stored diagonal is not read
+/// @param n order of A
+/// @param a first element of A
+/// @param lda distance between rows of A
+/// @param x right hand sides B, row major (n, nrhs) contiguous, overwritten with X
+/// @param nrhs number of right hand sides
+///
+/// @return false if a zero diagonal was met, x is then partially updated
+template <typename T>
+bool triangular_solve(const Triangle_t& uplo, const bool& conjTrans, const bool& unit, const size_t& n,
+                      const T* a, const size_t& lda, T* x, const size_t& nrhs)
+{
+    const auto divide = [&](const size_t& i) -> bool
+    {
+        if (unit)
+        {
+            return true;
+        }
+
+        const T diag = conjTrans ? scalar_conj(a[i * lda + i]) : a[i * lda + i];
+        if (diag == (T) 0)
+        {
+            return false;
+        }
+
+        T* xi = x + i * nrhs;
+        for (size_t r = 0; r < nrhs; r++)
+        {
+            xi[r] = xi[r] / diag;
+        }
+        return true;
+    };
+
+    // op(A) lower: forward, op(A) upper: backward
+    const bool forward = (uplo == Triangle_t::LOWER) != conjTrans;
+    for (size_t step = 0; step < n; step++)
+    {
+        const size_t i = forward ? step : n - 1 - step;
+        T* xi = x + i * nrhs;
+        const T* ai = a + i * lda;
+
+        if (!conjTrans)
+        {
+            // x_i -= sum a_ij x_j over the solved j, then divide
+            const size_t from = (uplo == Triangle_t::LOWER) ? 0 : i + 1;
+            const size_t to = (uplo == Triangle_t::LOWER) ? i : n;
+            for (size_t j = from; j < to; j++)
+            {
+                const T aij = ai[j];
+                const T* xj = x + j * nrhs;
+                for (size_t r = 0; r < nrhs; r++)
+                {
+                    xi[r] -= aij * xj[r];
+                }
+            }
+
+            if (!divide(i))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        // x_i is final once divided, then pushed into the unsolved x_j with conj(a_ij)
+        if (!divide(i))
+        {
+            return false;
+        }
+
+        const size_t from = (uplo == Triangle_t::LOWER) ? 0 : i + 1;
+        const size_t to = (uplo == Triangle_t::LOWER) ? i : n;
+        for (size_t j = from; j < to; j++)
+        {
+            const T aij = scalar_conj(ai[j]);
+            T* xj = x + j * nrhs;
+            for (size_t r = 0; r < nrhs; r++)
+            {
+                xj[r] -= aij * xi[r];
+            }
+        }
+    }
+
+    return true;
+}
+
+/// @brief Templated class for square lower or upper triangular matrices
+template <typename T>
+class Triangular_Matrix
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, zero filled
+        ///
+        /// @param len order of the matrix
+        /// @param uplo triangle holding the values
+        ///
+        /// @throws std::invalid_argument if len < 1
+        Triangular_Matrix(const size_t& len, const Triangle_t& uplo) : m_mat(len, len), m_uplo(uplo)
+        {
+            m_mat.block(0, 0, len, len).fill((T) 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, copies one triangle of a square matrix, the other is dropped
+        ///
+        /// @param mat square matrix
+        /// @param uplo triangle to keep
+        ///
+        /// @throws std::invalid_argument if matrix is not square
+        Triangular_Matrix(const Matrix<T>& mat, const Triangle_t& uplo) : m_mat(mat), m_uplo(uplo)
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to be triangular");
+            }
+
+            const size_t n = mat.getRowCount();
+            T* data = m_mat.get_data();
+            for (size_t i = 0; i < n; i++)
+            {
+                const size_t from = (uplo == Triangle_t::LOWER) ? i + 1 : 0;
+                const size_t to = (uplo == Triangle_t::LOWER) ? n : i;
+                std::fill(data + i * n + from, data + i * n + to, (T) 0);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the triangle holding the values
+        ///
+        /// @return LOWER or UPPER
+        Triangle_t getUplo() const
+        {
+            return m_uplo;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows
+        size_t getRowCount() const
+        {
+            return m_mat.getRowCount();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns
+        size_t getColCount() const
+        {
+            return m_mat.getColCount();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is (row, col) inside the stored triangle?
+        ///
+        /// @return true if the element can be non-zero
+        bool inTriangle(const size_t& row, const size_t& col) const
+        {
+            return (m_uplo == Triangle_t::LOWER) ? col <= row : col >= row;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the value at (row, col), zero outside the triangle
+        ///
+        /// @param row row location of the value
+        /// @param col column location of the value
+        ///
+        /// @return value at (row, col)
+        T get(const size_t& row, const size_t& col) const
+        {
+            return m_mat.get(row, col);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Set the value at (row, col)
+        ///
+        /// @param row row location of the value
+        /// @param col column location of the value
+        /// @param val value to set
+        ///
+        /// @throws std::invalid_argument if (row, col) is outside the stored triangle
+        void set(const size_t& row, const size_t& col, const T& val)
+        {
+            if (!inTriangle(row, col))
+            {
+                throw std::invalid_argument("Element outside the stored triangle");
+            }
+
+            m_mat.set(row, col, val);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the dense row major storage
+        /// Elements outside the triangle must be left at zero
+        ///
+        /// @return first element
+        T* get_data() const
+        {
+            return m_mat.get_data();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the dense storage, zero outside the triangle
+        ///
+        /// @return dense matrix
+        const Matrix<T>& toMatrix() const
+        {
+            return m_mat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is any diagonal element exactly zero?
+        ///
+        /// @return true if matrix has no inverse
+        bool isSingular() const
+        {
+            const size_t n = getRowCount();
+            for (size_t i = 0; i < n; i++)
+            {
+                if (m_mat.get_data()[i * n + i] == (T) 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the determinant, the product of the diagonal
+        ///
+        /// @return determinant of the matrix
+        T determinant() const
+        {
+            const size_t n = getRowCount();
+            T det = (T) 1;
+            for (size_t i = 0; i < n; i++)
+            {
+                det *= m_mat.get_data()[i * n + i];
+            }
+            return det;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x by substitution
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            const size_t n = getRowCount();
+            if (solutions.size() != n)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Vector<T> outVec(n);
+            std::copy(solutions.get_data(), solutions.get_data() + n, outVec.get_data());
+            _solve_in_place(outVec.get_data(), 1);
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B for X by substitution, each column of B is a separate right hand side
+        ///
+        /// @param solutions right hand side matrix B, must have as many rows as A
+        ///
+        /// @return matrix X
+        ///
+        /// @throws std::invalid_argument if sizes mismatch or matrix is singular
+        Matrix<T> solve(const Matrix<T>& solutions) const
+        {
+            if (solutions.getRowCount() != getRowCount())
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            Matrix<T> outMat = solutions;
+            _solve_in_place(outMat.get_data(), outMat.getColCount());
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Calculates the inverse, triangular in the same triangle
+        /// Column j of the inverse only has the entries on the triangle's side of j, so
+        /// the substitution is cut to them, n^3/3 operations
+        ///
+        /// @return the inverse matrix
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        Triangular_Matrix inverse() const
+        {
+            if (isSingular())
+            {
+                throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+            }
+
+            const size_t n = getRowCount();
+            const T* a = m_mat.get_data();
+            Triangular_Matrix outMat(n, m_uplo);
+            T* x = outMat.m_mat.get_data();
+
+            // columns are independent
+            parallel_for(0, n, parallel_grain(n * n / 2), [&](size_t from, size_t to)
+            {
+                for (size_t j = from; j < to; j++)
+                {
+                    x[j * n + j] = (T) 1 / a[j * n + j];
+                    if (m_uplo == Triangle_t::UPPER)
+                    {
+                        for (size_t i = j; i-- > 0;)
+                        {
+                            T sum = (T) 0;
+                            for (size_t k = i + 1; k <= j; k++)
+                            {
+                                sum += a[i * n + k] * x[k * n + j];
+                            }
+                            x[i * n + j] = ((T) 0 - sum) / a[i * n + i];
+                        }
+                    }
+                    else
+                    {
+                        for (size_t i = j + 1; i < n; i++)
+                        {
+                            T sum = (T) 0;
+                            for (size_t k = j; k < i; k++)
+                            {
+                                sum += a[i * n + k] * x[k * n + j];
+                            }
+                            x[i * n + j] = ((T) 0 - sum) / a[i * n + i];
+                        }
+                    }
+                }
+            });
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product with a dense matrix, only the stored triangle is read
+        ///
+        /// @param mat (n,p) matrix
+        ///
+        /// @return (n,p) product
+        ///
+        /// @throws std::invalid_argument if mat does not have n rows
+        Matrix<T> operator%(const Matrix<T>& mat) const
+        {
+            const size_t n = getRowCount();
+            if (mat.getRowCount() != n)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            const size_t p = mat.getColCount();
+            const T* a = m_mat.get_data();
+            const T* b = mat.get_data();
+            Matrix<T> outMat(n, p);
+            T* c = outMat.get_data();
+
+            parallel_for(0, n, parallel_grain(n * p / 2), [&](size_t from, size_t to)
+            {
+                for (size_t i = from; i < to; i++)
+                {
+                    T* ci = c + i * p;
+                    std::fill(ci, ci + p, (T) 0);
+
+                    const size_t kFrom = (m_uplo == Triangle_t::LOWER) ? 0 : i;
+                    const size_t kTo = (m_uplo == Triangle_t::LOWER) ? i + 1 : n;
+                    for (size_t k = kFrom; k < kTo; k++)
+                    {
+                        const T aik = a[i * n + k];
+                        const T* bk = b + k * p;
+                        for (size_t j = 0; j < p; j++)
+                        {
+                            ci[j] += aik * bk[j];
+                        }
+                    }
+                }
+            });
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Cross product with a vector, only the stored triangle is read
+        ///
+        /// @param vec n long vector
+        ///
+        /// @return product vector
+        ///
+        /// @throws std::invalid_argument if vec is not n long
+        Vector<T> operator%(const Vector<T>& vec) const
+        {
+            const size_t n = getRowCount();
+            if (vec.size() != n)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            const T* a = m_mat.get_data();
+            const T* v = vec.get_data();
+            Vector<T> outVec(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                const size_t kFrom = (m_uplo == Triangle_t::LOWER) ? 0 : i;
+                const size_t kTo = (m_uplo == Triangle_t::LOWER) ? i + 1 : n;
+
+                T sum = (T) 0;
+                for (size_t k = kFrom; k < kTo; k++)
+                {
+                    sum += a[i * n + k] * v[k];
+                }
+                outVec.get_data()[i] = sum;
+            }
+            return outVec;
+        };
+
+    private:
+        /// @brief Dense storage, zero outside the triangle
+        Matrix<T> m_mat;
+
+        /// @brief Triangle holding the values
+        Triangle_t m_uplo;
+
+        ///--------------------------------------------------------
+        /// @brief Substitution over all right hand sides at once
+        ///
+        /// @throws std::invalid_argument if matrix is singular
+        void _solve_in_place(T* x, const size_t& nrhs) const
+        {
+            if (!triangular_solve(m_uplo, false, false, getRowCount(), m_mat.get_data(), getRowCount(), x, nrhs))
+            {
+                throw std::invalid_argument("Matrix is singular, no unique solution exists");
+            }
+        };
+};
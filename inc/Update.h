@@ -0,0 +1,484 @@
+/// ------------------------------------------
+/// @file Update.h
+///
+/// @brief Header/Source file for low rank updates that avoid refactorizing after small edits
+///
+/// - inverse_update: Sherman-Morrison (rank 1) and Woodbury (rank k) updates of an
+///   explicit inverse, O(n^2) and O(n^2 k)
+/// - Updatable_QR: a QR factorization kept as explicit Q and R, so rows can be inserted
+///   or deleted and rank 1 changes applied with Givens rotations in O(m^2 + mn)
+///
+/// LU::update and Cholesky::update / downdate cover the other factorizations
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Scalar.h"
+#include "Storage.h"
+#include "Thread_Pool.h"
+#include "Triangular.h"
+#include "LU.h"
+#include "QR.h"
+
+///--------------------------------------------------------
+/// @brief Sherman-Morrison update, turns inv = A^-1 into (A + u v^T)^-1 in place
+/// (A + u v^T)^-1 = A^-1 - (A^-1 u)(v^T A^-1) / (1 + v^T A^-1 u)
+///
+/// @param inv square inverse, overwritten
+/// @param u column vector
+/// @param v row vector (not conjugated)
+///
+/// @return false if A + u v^T is singular (1 + v^T A^-1 u is zero), inv is then unchanged
+///
+/// @throws std::invalid_argument if sizes mismatch
+template <typename T>
+bool inverse_update(Matrix<T>& inv, const Vector<T>& u, const Vector<T>& v)
+{
+    const size_t n = inv.getRowCount();
+    if (inv.getColCount() != n || u.size() != n || v.size() != n)
+    {
+        throw std::invalid_argument("Update vectors must match the order of the square inverse");
+    }
+
+    const T* a = inv.get_data();
+    const T* uu = u.get_data();
+    const T* vv = v.get_data();
+
+    // w = A^-1 u and z = v^T A^-1, both read A^-1 by rows
+    Storage_Vector_t<T> w(n, (T) 0);
+    Storage_Vector_t<T> z(n, (T) 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        const T* row = a + i * n;
+        T sum = 0;
+        for (size_t j = 0; j < n; j++)
+        {
+            sum += row[j] * uu[j];
+            z[j] += vv[i] * row[j];
+        }
+        w[i] = sum;
+    }
+
+    T denom = 1;
+    for (size_t i = 0; i < n; i++)
+    {
+        denom += vv[i] * w[i];
+    }
+    if (denom == (T) 0)
+    {
+        return false;
+    }
+
+    T* out = inv.get_data();
+    parallel_for(0, n, parallel_grain(n), [&](size_t from, size_t to)
+    {
+        for (size_t i = from; i < to; i++)
+        {
+            const T coeff = w[i] / denom;
+            T* row = out + i * n;
+            for (size_t j = 0; j < n; j++)
+            {
+                row[j] -= coeff * z[j];
+            }
+        }
+    });
+    return true;
+}
+
+///--------------------------------------------------------
+/// @brief Woodbury update, turns inv = A^-1 into (A + U V^T)^-1 in place
+/// (A + U V^T)^-1 = A^-1 - A^-1 U (I + V^T A^-1 U)^-1 V^T A^-1, only a k x k system is solved
+///
+/// @param inv square inverse (n,n), overwritten
+/// @param U (n,k) column factor
+/// @param V (n,k) row factor (not conjugated)
+///
+/// @return false if A + U V^T is singular (I + V^T A^-1 U is), inv is then unchanged
+///
+/// @throws std::invalid_argument if sizes mismatch
+template <typename T>
+bool inverse_update(Matrix<T>& inv, const Matrix<T>& U, const Matrix<T>& V)
+{
+    const size_t n = inv.getRowCount();
+    const size_t k = U.getColCount();
+    if (inv.getColCount() != n || U.getRowCount() != n || V.getRowCount() != n || V.getColCount() != k)
+    {
+        throw std::invalid_argument("Update factors must be (n,k) for an (n,n) inverse");
+    }
+
+    const Matrix<T> W = inv % U;
+    const Matrix<T> Z = Matrix<T>::multiply(V.transposed(), inv.view());
+
+    Matrix<T> capacitance = Matrix<T>::multiply(V.transposed(), W.view());
+    for (size_t i = 0; i < k; i++)
+    {
+        capacitance.get_data()[i * k + i] += (T) 1;
+    }
+
+    const LU<T> lu(capacitance);
+    if (lu.isSingular())
+    {
+        return false;
+    }
+
+    const Matrix<T> correction = W % lu.solve(Z);
+    T* out = inv.get_data();
+    const T* corr = correction.get_data();
+    for (size_t i = 0; i < n * n; i++)
+    {
+        out[i] -= corr[i];
+    }
+    return true;
+}
+
+/// @brief Templated class for a QR factorization A = QR kept as full (m,m) Q and (m,n) R,
+/// updated in place by Givens rotations when A changes by a row or a rank 1 term
+template <typename T>
+class Updatable_QR
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, factorizes the given (m,n) matrix through Householder QR
+        /// and forms the full Q
+        ///
+        /// @param mat matrix to factorize
+        Updatable_QR(const Matrix<T>& mat)
+            : m_q(Matrix<T>::identity(mat.getRowCount())), m_r(mat.getRowCount(), mat.getColCount())
+        {
+            const QR<T> qr(mat);
+            qr.apply_Q(m_q);
+
+            const Matrix<T> R = qr.R();
+            const size_t n = mat.getColCount();
+            std::fill(m_r.get_data(), m_r.get_data() + m_r.getRowCount() * n, (T) 0);
+            std::copy(R.get_data(), R.get_data() + R.getRowCount() * n, m_r.get_data());
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the number of rows of the factorized matrix
+        ///
+        /// @return m
+        size_t getRowCount() const
+        {
+            return m_r.getRowCount();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the number of columns of the factorized matrix
+        ///
+        /// @return n
+        size_t getColCount() const
+        {
+            return m_r.getColCount();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the full unitary factor
+        ///
+        /// @return (m,m) Q
+        const Matrix<T>& getQ() const
+        {
+            return m_q;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns the upper triangular (trapezoidal) factor
+        ///
+        /// @return (m,n) R
+        const Matrix<T>& getR() const
+        {
+            return m_r;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Inserts a row, the factorization becomes that of A with vals as row `row`
+        /// The new row is appended to R and rotated out against the diagonal, O(m^2 + n^2)
+        ///
+        /// @param row index the new row takes, getRowCount() appends it
+        /// @param vals row values, getColCount() long
+        ///
+        /// @throws std::invalid_argument if the index or size is out of range
+        void insertRow(const size_t& row, const Vector<T>& vals)
+        {
+            const size_t m = m_r.getRowCount();
+            const size_t n = m_r.getColCount();
+            if (row > m || vals.size() != n)
+            {
+                throw std::invalid_argument("Inserted row must be n long at an index of at most m");
+            }
+
+            // Q' = P diag(Q, 1) with the new row's unit entry in the last column, R' = [R; vals]
+            Matrix<T> q(m + 1, m + 1);
+            T* qd = q.get_data();
+            std::fill(qd, qd + (m + 1) * (m + 1), (T) 0);
+            for (size_t i = 0; i < m; i++)
+            {
+                std::copy(m_q.get_data() + i * m, m_q.get_data() + (i + 1) * m, qd + (i < row ? i : i + 1) * (m + 1));
+            }
+            qd[row * (m + 1) + m] = 1;
+
+            Matrix<T> r(m + 1, n);
+            std::copy(m_r.get_data(), m_r.get_data() + m * n, r.get_data());
+            std::copy(vals.get_data(), vals.get_data() + n, r.get_data() + m * n);
+
+            m_q = std::move(q);
+            m_r = std::move(r);
+
+            for (size_t j = 0; j < std::min(m, n); j++)
+            {
+                _eliminate(j, m, j);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Deletes a row, the factorization becomes that of A without row `row`
+        /// Rotations take row `row` of Q to a unit vector, after which the first column of Q
+        /// and first row of R drop out, O(m^2 + mn)
+        ///
+        /// @param row index of the row to remove
+        ///
+        /// @throws std::invalid_argument if the index is out of range or A has one row
+        void deleteRow(const size_t& row)
+        {
+            const size_t m = m_r.getRowCount();
+            const size_t n = m_r.getColCount();
+            if (row >= m || m < 2)
+            {
+                throw std::invalid_argument("Deleted row must exist and leave at least one row");
+            }
+
+            // z = Q^H e_row, rotated up into its first entry
+            Storage_Vector_t<T> z(m);
+            for (size_t j = 0; j < m; j++)
+            {
+                z[j] = scalar_conj(m_q.get_data()[row * m + j]);
+            }
+
+            for (size_t j = m - 1; j-- > 0;)
+            {
+                const Givens_t g = _givens(z[j], z[j + 1]);
+                z[j] = (T) g.m_c * z[j] + g.m_s * z[j + 1];
+                z[j + 1] = 0;
+                _rotate(g, j, j + 1, std::min(j, n));
+            }
+
+            Matrix<T> q(m - 1, m - 1);
+            for (size_t i = 0, dst = 0; i < m; i++)
+            {
+                if (i != row)
+                {
+                    std::copy(m_q.get_data() + i * m + 1, m_q.get_data() + (i + 1) * m, q.get_data() + dst++ * (m - 1));
+                }
+            }
+
+            Matrix<T> r(m - 1, n);
+            std::copy(m_r.get_data() + n, m_r.get_data() + m * n, r.get_data());
+            // entries left below the diagonal are rounding, R1 is triangular in exact arithmetic
+            for (size_t i = 1; i < m - 1; i++)
+            {
+                std::fill(r.get_data() + i * n, r.get_data() + i * n + std::min(i, n), (T) 0);
+            }
+
+            m_q = std::move(q);
+            m_r = std::move(r);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Rank 1 update, the factorization becomes that of A + u v^T (v is not conjugated)
+        /// Q^H u is rotated into its first entry, which leaves R upper Hessenberg, the update
+        /// is added to the first row and a second sweep restores R, O(m^2 + mn)
+        ///
+        /// @param u column vector, m long
+        /// @param v row vector, n long
+        ///
+        /// @throws std::invalid_argument if sizes mismatch
+        void update(const Vector<T>& u, const Vector<T>& v)
+        {
+            const size_t m = m_r.getRowCount();
+            const size_t n = m_r.getColCount();
+            if (u.size() != m || v.size() != n)
+            {
+                throw std::invalid_argument("Update vectors must be m and n long");
+            }
+
+            // w = Q^H u
+            Storage_Vector_t<T> w(m, (T) 0);
+            for (size_t i = 0; i < m; i++)
+            {
+                const T* qRow = m_q.get_data() + i * m;
+                const T ui = u.get_data()[i];
+                for (size_t j = 0; j < m; j++)
+                {
+                    w[j] += scalar_conj(qRow[j]) * ui;
+                }
+            }
+
+            for (size_t j = m - 1; j-- > 0;)
+            {
+                const Givens_t g = _givens(w[j], w[j + 1]);
+                w[j] = (T) g.m_c * w[j] + g.m_s * w[j + 1];
+                w[j + 1] = 0;
+                _rotate(g, j, j + 1, std::min(j, n));
+            }
+
+            T* r0 = m_r.get_data();
+            for (size_t j = 0; j < n; j++)
+            {
+                r0[j] += w[0] * v.get_data()[j];
+            }
+
+            for (size_t j = 0; j + 1 < m && j < n; j++)
+            {
+                _eliminate(j, j + 1, j);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves Ax = b for x, least squares solution if A is tall
+        ///
+        /// @param solutions right hand side vector b
+        ///
+        /// @return vector x
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, A is wide or R is singular
+        Vector<T> solve(const Vector<T>& solutions) const
+        {
+            Matrix<T> rhs(solutions.size(), 1);
+            std::copy(solutions.get_data(), solutions.get_data() + solutions.size(), rhs.get_data());
+
+            const Matrix<T> res = solve(rhs);
+            Vector<T> outVec(res.getRowCount());
+            std::copy(res.get_data(), res.get_data() + res.getRowCount(), outVec.get_data());
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves AX = B for X, each column of B is a separate right hand side
+        /// Least squares solution if A is tall
+        ///
+        /// @param solutions right hand side matrix B
+        ///
+        /// @return matrix X, (n, columns of B)
+        ///
+        /// @throws std::invalid_argument if sizes mismatch, A is wide or R is singular
+        Matrix<T> solve(const Matrix<T>& solutions) const
+        {
+            const size_t m = m_r.getRowCount();
+            const size_t n = m_r.getColCount();
+            if (m < n)
+            {
+                throw std::invalid_argument("QR solve requires at least as many rows as columns");
+            }
+            if (solutions.getRowCount() != m)
+            {
+                throw std::invalid_argument("Incorrect number of solutions");
+            }
+
+            // only the first n rows of Q^H b take part in R x = Q^H b
+            const size_t nrhs = solutions.getColCount();
+            Matrix<T> x(n, nrhs);
+            std::fill(x.get_data(), x.get_data() + n * nrhs, (T) 0);
+            for (size_t i = 0; i < m; i++)
+            {
+                const T* qRow = m_q.get_data() + i * m;
+                const T* bRow = solutions.get_data() + i * nrhs;
+                for (size_t j = 0; j < n; j++)
+                {
+                    const T qij = scalar_conj(qRow[j]);
+                    T* xRow = x.get_data() + j * nrhs;
+                    for (size_t c = 0; c < nrhs; c++)
+                    {
+                        xRow[c] += qij * bRow[c];
+                    }
+                }
+            }
+
+            if (!triangular_solve(Triangle_t::UPPER, false, false, n, m_r.get_data(), n, x.get_data(), nrhs))
+            {
+                throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+            }
+            return x;
+        };
+
+    private:
+        /// @brief full unitary factor
+        Matrix<T> m_q;
+
+        /// @brief upper trapezoidal factor
+        Matrix<T> m_r;
+
+        /// @brief Plane rotation [c s; -conj(s) c], c real
+        struct Givens_t
+        {
+            double m_c;
+            T m_s;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Rotation taking (a, b) to (r, 0)
+        static Givens_t _givens(const T& a, const T& b)
+        {
+            const double absA = scalar_abs(a);
+            const double absB = scalar_abs(b);
+            if (absB == 0)
+            {
+                return {1.0, (T) 0};
+            }
+            if (absA == 0)
+            {
+                return {0.0, (T) 1};
+            }
+
+            const double r = std::hypot(absA, absB);
+            return {absA / r, (a / (T) absA) * scalar_conj(b) / (T) r};
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies g to rows i1, i2 of R from column col on, and g^H to columns i1, i2
+        /// of Q from the right so QR is unchanged
+        void _rotate(const Givens_t& g, const size_t& i1, const size_t& i2, const size_t& col)
+        {
+            const size_t m = m_q.getRowCount();
+            const size_t n = m_r.getColCount();
+            const T c = (T) g.m_c;
+            const T s = g.m_s;
+            const T sConj = scalar_conj(s);
+
+            T* x = m_r.get_data() + i1 * n;
+            T* y = m_r.get_data() + i2 * n;
+            for (size_t j = col; j < n; j++)
+            {
+                const T xj = x[j];
+                x[j] = c * xj + s * y[j];
+                y[j] = c * y[j] - sConj * xj;
+            }
+
+            T* q = m_q.get_data();
+            for (size_t i = 0; i < m; i++)
+            {
+                T* row = q + i * m;
+                const T qa = row[i1];
+                row[i1] = c * qa + sConj * row[i2];
+                row[i2] = c * row[i2] - s * qa;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Zeroes R(i2, col) against the pivot R(i1, col)
+        void _eliminate(const size_t& i1, const size_t& i2, const size_t& col)
+        {
+            const size_t n = m_r.getColCount();
+            T* r = m_r.get_data();
+            const Givens_t g = _givens(r[i1 * n + col], r[i2 * n + col]);
+            _rotate(g, i1, i2, col);
+            r[i2 * n + col] = 0;
+        };
+};
@@ -13,9 +13,16 @@
 #include <cstring>
 #include <cmath>
 #include <vector>
+#include <utility>
+#include <type_traits>
 
 #include "Complex_C.h"
 #include "Complex_P.h"
+#include "Complex_D.h"
+#include "Expr.h"
+#include "Complex_Kernels.h"
+#include "Storage.h"
+#include "Reduce.h"
 
 /// @brief Templated class for storing, acsessing and performing operations on a vector of values
 /// Vectors are fixed length, defined upon creation
@@ -37,7 +44,7 @@ class Vector
             }
 
             m_length = len;
-            vec_data = new T[m_length];
+            vec_data = storage_new<T>(m_length);
         }
 
         ///--------------------------------------------------------
@@ -54,7 +61,7 @@ class Vector
             }
 
             m_length = vecData.size();
-            vec_data = new T[m_length];
+            vec_data = storage_new<T>(m_length);
 
             size_t i = 0;
             for (auto num : vecData)
@@ -75,7 +82,7 @@ class Vector
             }
 
             m_length = inpVec.size();
-            vec_data = new T[m_length];
+            vec_data = storage_new<T>(m_length);
 
             for (size_t i = 0; i < inpVec.size(); i++)
             {
@@ -92,16 +99,41 @@ class Vector
         Vector<T>(Vector<T> const& vec)
         {
             m_length = vec.size();
-            vec_data = new T[m_length];
+            vec_data = storage_new<T>(m_length);
 
             memcpy(vec_data, vec.get_data(), m_length * sizeof(T));
         }
 
+        ///--------------------------------------------------------
+        /// @brief Move constructor, takes ownership of the other vector's storage
+        ///
+        /// @note moved from vector is left empty (length 0) and must only be destroyed or assigned to
+        ///
+        /// @param vec vector to move from
+        Vector<T>(Vector<T>&& vec) noexcept
+        {
+            m_length = vec.m_length;
+            vec_data = vec.vec_data;
+
+            vec.m_length = 0;
+            vec.vec_data = nullptr;
+        }
+
+        ///--------------------------------------------------------
+        /// @brief Constructor evaluating a lazy elementwise expression, see Expr.h
+        ///
+        /// @param expr expression to evaluate, in a single pass
+        template <typename E>
+        Vector(const Expr_t<E>& expr) : Vector(expr.self().rows() * expr.self().cols())
+        {
+            evaluate_expr(expr, vec_data);
+        }
+
         ///--------------------------------------------------------
         /// @brief Destructor
         ~Vector()
         {
-            delete[] vec_data;
+            storage_delete(vec_data, m_length);
         }
 
         ///--------------------------------------------------------
@@ -109,21 +141,62 @@ class Vector
         ///
         /// @param vec vector to assign from
         ///
-        /// @return dereferenced pointer to self
-        Vector<T> operator=(Vector<T> const& vec)
+        /// @return reference to self
+        Vector<T>& operator=(Vector<T> const& vec)
         {
             // skip if being assigned to self
             if(this != &vec)
             {
-                delete[] vec_data;
-                m_length = vec.size();
-                vec_data = new T[m_length];
+                // reuse the existing array if the length is unchanged
+                if (m_length != vec.size())
+                {
+                    storage_delete(vec_data, m_length);
+                    m_length = vec.size();
+                    vec_data = storage_new<T>(m_length);
+                }
 
                 memcpy(vec_data, vec.get_data(), sizeof(T) * m_length);
             }
             return *this;
         }
 
+        ///--------------------------------------------------------
+        /// @brief Move assignment operator, swaps storage with the other vector
+        ///
+        /// @param vec vector to move from
+        ///
+        /// @return reference to self
+        Vector<T>& operator=(Vector<T>&& vec) noexcept
+        {
+            std::swap(m_length, vec.m_length);
+            std::swap(vec_data, vec.vec_data);
+            return *this;
+        }
+
+        ///--------------------------------------------------------
+        /// @brief Assignment from a lazy elementwise expression, see Expr.h
+        /// Evaluates in place when the length already matches
+        ///
+        /// @param expr expression to evaluate
+        ///
+        /// @return reference to self
+        template <typename E>
+        Vector<T>& operator=(const Expr_t<E>& expr)
+        {
+            const size_t len = expr.self().rows() * expr.self().cols();
+
+            // elements only ever read their own index, so evaluating over an operand is safe
+            if (len != m_length)
+            {
+                Vector<T> outVec(expr);
+                *this = std::move(outVec);
+                return *this;
+            }
+
+            evaluate_expr(expr, vec_data);
+            return *this;
+        }
+
         ///--------------------------------------------------------
         /// @brief Operator overload of +, implements vector-vector addition
         ///
@@ -141,7 +214,7 @@ class Vector
 
             for (size_t i = 0; i < m_length; i++)
             {
-                outVec.get_data[i] = vec_data[i] + vec.get_data[i];
+                outVec.get_data()[i] = vec_data[i] + vec.get_data()[i];
             }
 
             return outVec;
@@ -183,13 +256,7 @@ class Vector
                 throw std::invalid_argument("Dot product requires vectors of same size");
             }
 
-            T sum = 0;
-            for (size_t i = 0; i < m_length; i++)
-            {
-                sum += vec_data[i] * vec.get_data()[i];
-            }
-
-            return sum;
+            return reduce_dot(m_length, vec_data, vec.get_data());
         }
 
         ///--------------------------------------------------------
@@ -286,33 +353,12 @@ class Vector
 
         ///--------------------------------------------------------
         /// @brief finds magnitude for the vector
-        /// e.g: sqrt(a^2 + b^2 + c^2...)
+        /// e.g: sqrt(|a|^2 + |b|^2 + |c|^2...), see reduce_norm2
         ///
         /// @return magnitude of the vector
         T magnitude() const
         {
-            T sum = 0;
-            for (size_t i = 0; i < m_length; i++)
-            {
-                // do not replace with pow, need to account for custom types
-                sum += get_data()[i] * get_data()[i];
-            }
-
-            // Dynamically chooses which routine to implement depending on complex type
-            if constexpr (std::is_same_v<T, Complex_C_t>)
-            {
-                sum = powReal(sum, 0.5);
-            }
-            else if constexpr (std::is_same_v<T, Complex_P_t>)
-            {
-                sum = powReal(sum, 0.5);
-            }
-            else
-            {
-                sum = std::sqrt(sum);
-            }
-
-            return sum;
+            return (T) reduce_norm2(m_length, vec_data);
         }
 
         ///--------------------------------------------------------
@@ -338,13 +384,14 @@ class Vector
         }
 
         ///--------------------------------------------------------
-        /// @brief Calculates the normailzed vector
+        /// @brief Calculates the normailzed vector, a zero vector is returned unchanged
         ///
         /// @return normalized vector
         Vector<T> normalize() const
         {
-            Vector<T> cpy = *this;
-            return cpy / magnitude();
+            Vector<T> outVec(m_length);
+            reduce_normalize(m_length, vec_data, outVec.get_data());
+            return outVec;
         }
 
         ///--------------------------------------------------------
@@ -353,49 +400,9 @@ class Vector
         /// @return internally normalized value
         Vector<T> internal_norm()
         {
-            Vector<T> cpy = *this;
-            T smallest;
-            if constexpr (std::is_same_v<T, Complex_C_t>)
-            {
-                smallest = cpy.get(0).absolute();
-            }
-            else if constexpr (std::is_same_v<T, Complex_P_t>)
-            {
-                smallest = cpy.get(0).mag();
-            }
-            else
-            {
-                // by default attempts to use the std abs, for user-defined types add another 'if constexpr'
-                smallest = std::abs(cpy.get(0));
-            }
-
-            for (size_t i = 1; i < cpy.size(); i++)
-            {
-                if constexpr (std::is_same_v<T, Complex_C_t>)
-                {
-                    if (cpy.get(i).absolute() < smallest)
-                    {
-                        smallest = cpy.get(i).absolute();
-                    }
-                }
-                else if constexpr (std::is_same_v<T, Complex_P_t>)
-                {
-                    if (cpy.get(i).mag() < smallest)
-                    {
-                        smallest = cpy.get(i).mag();
-                    }
-                }
-                else
-                {
-                    // by default attempts to use the std abs, for user-defined types add another 'if constexpr'
-                    if (std::abs(cpy.get(i)) < smallest)
-                    {
-                        smallest = std::abs(cpy.get(i));
-                    }
-                }
-            }
-
-            return cpy / smallest;
+            Vector<T> outVec(m_length);
+            reduce_divide(m_length, vec_data, outVec.get_data(), reduce_min_abs(m_length, vec_data));
+            return outVec;
         }
 
         ///--------------------------------------------------------
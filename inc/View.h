@@ -0,0 +1,566 @@
+/// ------------------------------------------
+/// @file View.h
+///
+/// @brief Header/Source file for non-owning strided views into matrix storage
+///
+/// Views point straight at the storage of a Matrix (or any contiguous array) and
+/// read and write it in place, so rows, columns, diagonals and sub-blocks can be
+/// worked on without copying them out. A view does not keep its storage alive, it
+/// must not outlive the matrix it was taken from
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "Vector.h"
+#include "Matrix_Fwd.h"
+
+/// Bounds check the unchecked accessors (operator[] and operator()), on unless NDEBUG is defined
+#ifndef MATRIX_BOUNDS_CHECK
+#ifdef NDEBUG
+#define MATRIX_BOUNDS_CHECK 0
+#else
+#define MATRIX_BOUNDS_CHECK 1
+#endif
+#endif
+
+/// @brief One dimensional view of len elements spaced stride apart
+/// Use a const T to make a read only view
+template <typename T>
+class Strided_View
+{
+    public:
+        /// @brief element type without const, used for values and copies
+        typedef std::remove_const_t<T> Value_t;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor
+        ///
+        /// @param data first element of the view
+        /// @param len number of elements
+        /// @param stride distance between elements in data
+        Strided_View(T* data, const size_t& len, const size_t& stride = 1)
+            : m_data(data), m_len(len), m_stride(stride) {};
+
+        ///--------------------------------------------------------
+        /// @brief Conversion of a writable view to a read only view
+        ///
+        /// @param view view to convert
+        template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+        Strided_View(const Strided_View<U>& view)
+            : m_data(view.data()), m_len(view.size()), m_stride(view.stride()) {};
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of elements in the view
+        ///
+        /// @return element count
+        size_t size() const
+        {
+            return m_len;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the distance between elements in the underlying storage
+        ///
+        /// @return stride in elements
+        size_t stride() const
+        {
+            return m_stride;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns a pointer to the first element
+        ///
+        /// @return first element of the view
+        T* data() const
+        {
+            return m_data;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unchecked element access, checked only when MATRIX_BOUNDS_CHECK is set
+        ///
+        /// @param index element to access
+        ///
+        /// @return reference to the element
+        T& operator[](const size_t& index) const
+        {
+#if MATRIX_BOUNDS_CHECK
+            _check_index(index);
+#endif
+            return m_data[index * m_stride];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets the element at index
+        ///
+        /// @param index element to get
+        ///
+        /// @return value at index
+        ///
+        /// @throws std::invalid_argument if index is out of bounds
+        Value_t get(const size_t& index) const
+        {
+            _check_index(index);
+            return m_data[index * m_stride];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Sets the element at index
+        ///
+        /// @param index element to set
+        /// @param val value to write
+        ///
+        /// @throws std::invalid_argument if index is out of bounds
+        void set(const size_t& index, const Value_t& val) const
+        {
+            _check_index(index);
+            m_data[index * m_stride] = val;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Overwrites every element of the view with another view's contents
+        ///
+        /// @param view source, must be the same size
+        ///
+        /// @throws std::invalid_argument if the sizes differ
+        void assign(const Strided_View<const Value_t>& view) const
+        {
+            _check_size(view.size());
+            for (size_t i = 0; i < m_len; i++)
+            {
+                m_data[i * m_stride] = view[i];
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Overwrites every element of the view with a vector's contents
+        ///
+        /// @param vec source, must be the same size
+        ///
+        /// @throws std::invalid_argument if the sizes differ
+        void assign(const Vector<Value_t>& vec) const
+        {
+            assign(Strided_View<const Value_t>(vec.get_data(), vec.size()));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Overwrites every element of the view with a std vector's contents
+        ///
+        /// @param vec source, must be the same size
+        ///
+        /// @throws std::invalid_argument if the sizes differ
+        void assign(const std::vector<Value_t>& vec) const
+        {
+            assign(Strided_View<const Value_t>(vec.data(), vec.size()));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Sets every element of the view to val
+        ///
+        /// @param val value to write
+        void fill(const Value_t& val) const
+        {
+            for (size_t i = 0; i < m_len; i++)
+            {
+                m_data[i * m_stride] = val;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Multiplies every element of the view by num in place
+        ///
+        /// @param num scalar to multiply by
+        void scale(const Value_t& num) const
+        {
+            for (size_t i = 0; i < m_len; i++)
+            {
+                m_data[i * m_stride] *= num;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adds a scaled view onto this one in place, this += num * view
+        /// The elementary row operation used by elimination
+        ///
+        /// @param num scale applied to view
+        /// @param view view to add, must be the same size (may overlap this one only if identical)
+        ///
+        /// @throws std::invalid_argument if the sizes differ
+        void axpy(const Value_t& num, const Strided_View<const Value_t>& view) const
+        {
+            _check_size(view.size());
+            for (size_t i = 0; i < m_len; i++)
+            {
+                m_data[i * m_stride] += view[i] * num;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the view out into a math vector
+        ///
+        /// @return vector holding a copy of the elements
+        Vector<Value_t> toVector() const
+        {
+            Vector<Value_t> outVec(m_len);
+            for (size_t i = 0; i < m_len; i++)
+            {
+                outVec.get_data()[i] = m_data[i * m_stride];
+            }
+            return outVec;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the view out into a std vector
+        ///
+        /// @return std vector holding a copy of the elements
+        std::vector<Value_t> toStdVector() const
+        {
+            std::vector<Value_t> outVec(m_len);
+            for (size_t i = 0; i < m_len; i++)
+            {
+                outVec[i] = m_data[i * m_stride];
+            }
+            return outVec;
+        };
+
+    private:
+        /// @brief first element of the view
+        T* m_data;
+
+        /// @brief number of elements
+        size_t m_len;
+
+        /// @brief distance between elements
+        size_t m_stride;
+
+        ///--------------------------------------------------------
+        /// @brief Throws if index is not within the view
+        ///
+        /// @param index index to check
+        ///
+        /// @throws std::invalid_argument if index is out of bounds
+        void _check_index(const size_t& index) const
+        {
+            if (!(index < m_len)) [[unlikely]]
+            {
+                std::stringstream err;
+                err << "Bad index, " << index << " is not within view of length " << m_len;
+                throw std::invalid_argument(err.str());
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Throws if len is not the size of this view
+        ///
+        /// @param len length to check
+        ///
+        /// @throws std::invalid_argument if len differs
+        void _check_size(const size_t& len) const
+        {
+            if (len != m_len)
+            {
+                throw std::invalid_argument("View operations require views of the same length");
+            }
+        };
+};
+
+/// @brief Two dimensional view of a rows x cols block, element (i,j) is at i * rs + j * cs
+/// Swapping the strides gives a transposed view without moving any data
+/// Use a const T to make a read only view
+template <typename T>
+class Block_View
+{
+    public:
+        /// @brief element type without const, used for values and copies
+        typedef std::remove_const_t<T> Value_t;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor
+        ///
+        /// @param data top left element of the block
+        /// @param rows number of rows
+        /// @param cols number of columns
+        /// @param rs distance between rows in data
+        /// @param cs distance between columns in data
+        Block_View(T* data, const size_t& rows, const size_t& cols, const size_t& rs, const size_t& cs = 1)
+            : m_data(data), m_rows(rows), m_cols(cols), m_rs(rs), m_cs(cs) {};
+
+        ///--------------------------------------------------------
+        /// @brief Conversion of a writable view to a read only view
+        ///
+        /// @param view view to convert
+        template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+        Block_View(const Block_View<U>& view)
+            : m_data(view.data()), m_rows(view.getRowCount()), m_cols(view.getColCount()), m_rs(view.rowStride()), m_cs(view.colStride()) {};
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the block
+        ///
+        /// @return number of rows
+        size_t getRowCount() const
+        {
+            return m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the block
+        ///
+        /// @return number of columns
+        size_t getColCount() const
+        {
+            return m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the distance between rows in the underlying storage
+        ///
+        /// @return row stride in elements
+        size_t rowStride() const
+        {
+            return m_rs;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the distance between columns in the underlying storage
+        ///
+        /// @return column stride in elements
+        size_t colStride() const
+        {
+            return m_cs;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Is each row contiguous in memory?
+        ///
+        /// @return true if the column stride is 1
+        bool isRowContiguous() const
+        {
+            return m_cs == 1;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Returns a pointer to the top left element
+        ///
+        /// @return first element of the block
+        T* data() const
+        {
+            return m_data;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Unchecked element access, checked only when MATRIX_BOUNDS_CHECK is set
+        ///
+        /// @param row row of element
+        /// @param col column of element
+        ///
+        /// @return reference to the element
+        T& operator()(const size_t& row, const size_t& col) const
+        {
+#if MATRIX_BOUNDS_CHECK
+            _check_bounds(row, col);
+#endif
+            return m_data[row * m_rs + col * m_cs];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets the value at the row col position
+        ///
+        /// @param row to get value from
+        /// @param col to get value from
+        ///
+        /// @return value at given location
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
+        Value_t get(const size_t& row, const size_t& col) const
+        {
+            _check_bounds(row, col);
+            return m_data[row * m_rs + col * m_cs];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Sets the value at the row col position
+        ///
+        /// @param row to set value at
+        /// @param col to set value at
+        /// @param val to set coordinate to
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
+        void set(const size_t& row, const size_t& col, const Value_t& val) const
+        {
+            _check_bounds(row, col);
+            m_data[row * m_rs + col * m_cs] = val;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of one row of the block
+        ///
+        /// @param row row to view
+        ///
+        /// @return view of row [row], left to right
+        ///
+        /// @throws std::invalid_argument if row is out of bounds
+        Strided_View<T> row(const size_t& row) const
+        {
+            _check_bounds(row, 0);
+            return Strided_View<T>(m_data + row * m_rs, m_cols, m_cs);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of one column of the block
+        ///
+        /// @param col column to view
+        ///
+        /// @return view of column [col], top to bottom
+        ///
+        /// @throws std::invalid_argument if col is out of bounds
+        Strided_View<T> col(const size_t& col) const
+        {
+            _check_bounds(0, col);
+            return Strided_View<T>(m_data + col * m_cs, m_rows, m_rs);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of the leading diagonal of the block
+        ///
+        /// @return view of the min(rows, cols) diagonal elements
+        Strided_View<T> diag() const
+        {
+            return Strided_View<T>(m_data, std::min(m_rows, m_cols), m_rs + m_cs);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief View of a sub-block of this block
+        ///
+        /// @param row top row of the sub-block
+        /// @param col left column of the sub-block
+        /// @param rows number of rows in the sub-block
+        /// @param cols number of columns in the sub-block
+        ///
+        /// @return view of the sub-block
+        ///
+        /// @throws std::invalid_argument if the sub-block does not fit within this block
+        Block_View<T> block(const size_t& row, const size_t& col, const size_t& rows, const size_t& cols) const
+        {
+            if (row + rows > m_rows || col + cols > m_cols)
+            {
+                throw std::invalid_argument("Block does not fit within the matrix");
+            }
+            return Block_View<T>(m_data + row * m_rs + col * m_cs, rows, cols, m_rs, m_cs);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Transposed view of this block, no data is moved
+        ///
+        /// @return cols x rows view with the strides swapped
+        Block_View<T> transposed() const
+        {
+            return Block_View<T>(m_data, m_cols, m_rows, m_cs, m_rs);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Overwrites the block with another block's contents
+        ///
+        /// @param view source, must have the same dimensions
+        ///
+        /// @throws std::invalid_argument if the dimensions differ
+        void assign(const Block_View<const Value_t>& view) const
+        {
+            if (view.getRowCount() != m_rows || view.getColCount() != m_cols)
+            {
+                throw std::invalid_argument("Block assignment requires blocks of same dimensions");
+            }
+
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < m_cols; j++)
+                {
+                    m_data[i * m_rs + j * m_cs] = view(i, j);
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Overwrites the block with a matrix's contents
+        ///
+        /// @param mat source, must have the same dimensions
+        ///
+        /// @throws std::invalid_argument if the dimensions differ
+        void assign(const Matrix<Value_t>& mat) const
+        {
+            assign(mat.block(0, 0, mat.getRowCount(), mat.getColCount()));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Sets every element of the block to val
+        ///
+        /// @param val value to write
+        void fill(const Value_t& val) const
+        {
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < m_cols; j++)
+                {
+                    m_data[i * m_rs + j * m_cs] = val;
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Copies the block out into its own matrix
+        ///
+        /// @return matrix holding a copy of the block
+        Matrix<Value_t> toMatrix() const
+        {
+            Matrix<Value_t> outMat(m_rows, m_cols);
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < m_cols; j++)
+                {
+                    outMat.get_data()[i * m_cols + j] = m_data[i * m_rs + j * m_cs];
+                }
+            }
+            return outMat;
+        };
+
+    private:
+        /// @brief top left element of the block
+        T* m_data;
+
+        /// @brief number of rows
+        size_t m_rows;
+
+        /// @brief number of columns
+        size_t m_cols;
+
+        /// @brief distance between rows
+        size_t m_rs;
+
+        /// @brief distance between columns
+        size_t m_cs;
+
+        ///--------------------------------------------------------
+        /// @brief Throws if a coordinate is not within the block
+        ///
+        /// @param row of coordinate
+        /// @param col of coordinate
+        ///
+        /// @throws std::invalid_argument if row/col location is out of bounds
+        void _check_bounds(const size_t& row, const size_t& col) const
+        {
+            if (!(row < m_rows && col < m_cols)) [[unlikely]]
+            {
+                std::stringstream err;
+                err << "Bad coordinate, (" << row << "," << col << ") is not within the bounds of ("
+                    << m_rows - 1 << "," << m_cols - 1 << ")";
+                throw std::invalid_argument(err.str());
+            }
+        };
+};
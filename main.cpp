@@ -16,6 +16,20 @@
 using std::cout;
 using std::endl;
 
+// compile every member of the updatable factorizations, not only the ones main calls
+template class LU<double>;
+template class Cholesky<double>;
+template class Updatable_QR<double>;
+template class Updatable_QR<Complex_C_t>;
+
+// same for the structured matrix types behind inverse(AUTO)
+template class Triangular_Matrix<double>;
+template class Symmetric_Matrix<double>;
+template class Symmetric_Matrix<Complex_C_t>;
+template class Cholesky<Complex_C_t>;
+template class Banded_Matrix<double>;
+template class Banded_LU<double>;
+
 
 class Timer
 {
@@ -47,6 +61,13 @@ Vector<double> gen_random_vec(const size_t& len, const double& lower, const doub
 // Generate random number, between lower and upper
 long gen_random(const double& lower, const double& upper);
 
+// Runs the rank 1 updates of LU, Cholesky, QR and an explicit inverse, prints their errors
+void demo_updates(const size_t& len);
+
+// Runs inverse(AUTO) and the structured types on triangular, banded and SPD matrices, prints their errors
+// len of at least 4 * BANDED_DISPATCH_RATIO takes the banded path for the band of width 4
+void demo_structured(const size_t& len);
+
 int main()
 {
     srandom(time(NULL));
@@ -80,7 +101,7 @@ int main()
     // cout << "-----proof-----" << endl;
     // cout << test % inv << endl;
 
-    cout << "Eigenvalues via QR convergence:" << endl;
+    cout << "Eigenvalues via shifted QR:" << endl;
     t.reset();
     auto eigenvalues = test.eigenvalues();
     for(auto val : eigenvalues)
@@ -90,13 +111,13 @@ int main()
     cout << endl;
 
     cout << "Eigenvectors: " << endl;
-    std::vector<Vector<double>> e_vecs = test.eigenvectors();
-    for(Vector<double> vec : e_vecs)
-    {
-        cout << vec << endl;
-    }
+    Matrix<double> e_vecs = test.eigenvectors();
+    cout << e_vecs << endl;
     cout << t.elapsed() * 1e6 << " micros" << endl;
 
+    demo_updates(6);
+    demo_structured(16);
+
     return EXIT_SUCCESS;
 }
 
@@ -121,6 +142,105 @@ Matrix<double> gen_random_mat(const size_t& len, const double& lower, const doub
     return outMat;
 }
 
+void demo_updates(const size_t& len)
+{
+    // diagonally dominant so every factorization exists
+    Matrix<double> a = gen_random_mat(len, 1, 10) + Matrix<double>::identity(len) * (double) (10 * len);
+    Vector<double> u = gen_random_vec(len, 1, 10);
+    Vector<double> v = gen_random_vec(len, 1, 10);
+    Matrix<double> rhs = gen_random_mat(len, 1, 10);
+
+    Matrix<double> uCol(len, 1), vRow(1, len);
+    for (size_t i = 0; i < len; i++)
+    {
+        uCol.set(i, 0, u.get(i));
+        vRow.set(0, i, v.get(i));
+    }
+    const Matrix<double> updated = a + uCol % vRow;
+
+    cout << "Rank 1 updates, max error:" << endl;
+
+    LU<double> lu(a);
+    lu.update(u, v);
+    lu.updateRow(0, v);
+    lu.updateCol(0, u);
+    Matrix<double> luTarget = updated;
+    for (size_t i = 0; i < len; i++)
+    {
+        luTarget.set(0, i, luTarget.get(0, i) + v.get(i));
+        luTarget.set(i, 0, luTarget.get(i, 0) + u.get(i));
+    }
+    cout << "LU solve " << (luTarget % lu.solve(rhs) - rhs).maxAbs() << endl;
+
+    const Matrix<double> spd = a % a.transposed() + Matrix<double>::identity(len);
+    Cholesky<double> chol(spd);
+    chol.update(u);
+    chol.downdate(u);
+    cout << "Cholesky solve " << (spd % chol.solve(rhs) - rhs).maxAbs() << endl;
+
+    Updatable_QR<double> qr(a);
+    qr.insertRow(1, v);
+    qr.deleteRow(1);
+    qr.update(u, v);
+    cout << "QR product " << (qr.getQ() % qr.getR() - updated).maxAbs() << endl;
+
+    Matrix<double> inv = a.inverse();
+    inverse_update(inv, u, v);
+    inverse_update(inv, uCol, vRow.transpose());
+    Matrix<double> invTarget = updated + uCol % vRow;
+    cout << "Inverse " << (invTarget % inv - Matrix<double>::identity(len)).maxAbs() << endl;
+}
+
+void demo_structured(const size_t& len)
+{
+    const Matrix<double> ident = Matrix<double>::identity(len);
+    const Matrix<double> dense = gen_random_mat(len, 1, 10) + ident * (double) (10 * len);
+    const Matrix<double> rhs = gen_random_mat(len, 1, 10);
+    Vector<double> vec = gen_random_vec(len, 1, 10);
+
+    Matrix<double> upper = dense;
+    Matrix<double> band = dense;
+    for (size_t i = 0; i < len; i++)
+    {
+        for (size_t j = 0; j < len; j++)
+        {
+            if (j < i)
+            {
+                upper.set(i, j, 0);
+            }
+            if (j + 1 < i || j > i + 2)
+            {
+                band.set(i, j, 0);
+            }
+        }
+    }
+    // summed with its transpose so it is exactly symmetric, whatever the product rounding
+    const Matrix<double> gram = dense % dense.transposed();
+    Matrix<double> spd = gram + gram.transpose() + ident;
+
+    cout << "Structured inverse(AUTO), max error:" << endl;
+    cout << "Triangular " << (upper % upper.inverse(Inverse_Method_t::AUTO) - ident).maxAbs() << endl;
+    cout << "Banded " << (band % band.inverse(Inverse_Method_t::AUTO) - ident).maxAbs() << endl;
+    cout << "SPD " << (spd % spd.inverse(Inverse_Method_t::AUTO) - ident).maxAbs() << endl;
+
+    const Triangular_Matrix<double> tri(upper, Triangle_t::UPPER);
+    cout << "Triangular solve " << (upper % tri.solve(rhs) - rhs).maxAbs() << endl;
+
+    const Banded_Matrix<double> banded(band, 1, 2);
+    const Vector<double> bandB = banded % banded.solve(vec);
+    double bandErr = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        bandErr = std::max(bandErr, std::fabs(bandB.get(i) - vec.get(i)));
+    }
+    cout << "Banded solve " << bandErr << "  determinant "
+         << std::fabs(banded.determinant() - band.determinant()) / std::fabs(band.determinant()) << endl;
+
+    const Symmetric_Matrix<double> packed(spd);
+    cout << "Symmetric product " << (packed % rhs - spd % rhs).maxAbs() << "  Cholesky solve "
+         << (spd % packed.cholesky().solve(rhs) - rhs).maxAbs() << endl;
+}
+
 Vector<double> gen_random_vec(const size_t& len, const double& lower, const double& upper)
 {
     Vector<double> outVec(len);
@@ -0,0 +1,340 @@
+/// ------------------------------------------
+/// @file Complex_D.cpp
+///
+/// @brief Source file for dual form complex number structures and associated
+/// functions
+/// ------------------------------------------
+
+#include "../inc/Complex_D.h"
+
+///--------------------------------------------------------
+Complex_D_t::Complex_D_t(const double& real)
+{
+    m_real = real;
+    m_imagine = 0;
+    m_mag = fabs(real);
+    m_arg = (real < 0) ? M_PI : 0;
+    m_form = BOTH;
+}
+
+///--------------------------------------------------------
+Complex_D_t::Complex_D_t(const Complex_C_t& com)
+{
+    m_real = com.m_real;
+    m_imagine = com.m_imagine;
+    m_form = CART;
+}
+
+///--------------------------------------------------------
+Complex_D_t::Complex_D_t(const Complex_P_t& com)
+{
+    *this = polar(com.m_mag, com.m_arg);
+}
+
+///--------------------------------------------------------
+Complex_D_t Complex_D_t::cartesian(const double& real, const double& imagine)
+{
+    return Complex_D_t{Complex_C_t{real, imagine}};
+}
+
+///--------------------------------------------------------
+Complex_D_t Complex_D_t::polar(const double& mag, const double& arg)
+{
+    Complex_D_t com;
+    com.m_mag = fabs(mag);
+    com.m_arg = (mag < 0) ? arg + M_PI : arg;
+    com.m_form = POLAR;
+    return com;
+}
+
+///--------------------------------------------------------
+double Complex_D_t::real() const
+{
+    return hasCartesian() ? m_real : m_mag * cos(m_arg);
+}
+
+///--------------------------------------------------------
+double Complex_D_t::imaginary() const
+{
+    return hasCartesian() ? m_imagine : m_mag * sin(m_arg);
+}
+
+///--------------------------------------------------------
+double Complex_D_t::absolute() const
+{
+    return hasPolar() ? m_mag : hypot(m_real, m_imagine);
+}
+
+///--------------------------------------------------------
+double Complex_D_t::argument() const
+{
+    return hasPolar() ? remainder(m_arg, 2 * M_PI) : atan2(m_imagine, m_real);
+}
+
+///--------------------------------------------------------
+Complex_D_t Complex_D_t::conjugate() const
+{
+    Complex_D_t com = *this;
+    com.m_imagine = -m_imagine;
+    com.m_arg = -m_arg;
+    return com;
+}
+
+///--------------------------------------------------------
+Complex_C_t Complex_D_t::toCartesian() const
+{
+    return Complex_C_t{real(), imaginary()};
+}
+
+///--------------------------------------------------------
+Complex_P_t Complex_D_t::toPolar() const
+{
+    return Complex_P_t{absolute(), argument()};
+}
+
+///--------------------------------------------------------
+void Complex_D_t::cacheCartesian()
+{
+    if (!hasCartesian())
+    {
+        m_real = real();
+        m_imagine = imaginary();
+        m_form = BOTH;
+    }
+}
+
+///--------------------------------------------------------
+void Complex_D_t::cachePolar()
+{
+    if (!hasPolar())
+    {
+        m_mag = absolute();
+        m_arg = argument();
+        m_form = BOTH;
+    }
+}
+
+///--------------------------------------------------------
+Complex_D_t operator+(const Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    return Complex_D_t::cartesian(lcom.real() + rcom.real(), lcom.imaginary() + rcom.imaginary());
+}
+
+///--------------------------------------------------------
+Complex_D_t operator+(const Complex_D_t& lcom, const double& rreal)
+{
+    return Complex_D_t::cartesian(lcom.real() + rreal, lcom.imaginary());
+}
+
+///--------------------------------------------------------
+Complex_D_t operator+(const double& lreal, const Complex_D_t& rcom)
+{
+    // + is commutative so use the other arragement
+    return rcom + lreal;
+}
+
+///--------------------------------------------------------
+void operator+=(Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    lcom = lcom + rcom;
+}
+
+///--------------------------------------------------------
+void operator+=(Complex_D_t& lcom, const double& rreal)
+{
+    lcom = lcom + rreal;
+}
+
+///--------------------------------------------------------
+Complex_D_t operator-(const Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    return Complex_D_t::cartesian(lcom.real() - rcom.real(), lcom.imaginary() - rcom.imaginary());
+}
+
+///--------------------------------------------------------
+Complex_D_t operator-(const Complex_D_t& lcom, const double& rreal)
+{
+    return Complex_D_t::cartesian(lcom.real() - rreal, lcom.imaginary());
+}
+
+///--------------------------------------------------------
+Complex_D_t operator-(const double& lreal, const Complex_D_t& rcom)
+{
+    return Complex_D_t::cartesian(lreal - rcom.real(), -rcom.imaginary());
+}
+
+///--------------------------------------------------------
+Complex_D_t operator-(const Complex_D_t& com)
+{
+    Complex_D_t outCom = com;
+    outCom.m_real = -com.m_real;
+    outCom.m_imagine = -com.m_imagine;
+    outCom.m_arg = com.m_arg + M_PI;
+    return outCom;
+}
+
+///--------------------------------------------------------
+void operator-=(Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    lcom = lcom - rcom;
+}
+
+///--------------------------------------------------------
+void operator-=(Complex_D_t& lcom, const double& rreal)
+{
+    lcom = lcom - rreal;
+}
+
+///--------------------------------------------------------
+Complex_D_t operator*(const Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    if (lcom.hasPolar() && rcom.hasPolar())
+    {
+        return Complex_D_t::polar(lcom.m_mag * rcom.m_mag, lcom.m_arg + rcom.m_arg);
+    }
+
+    // at most one operand needs converting, cartesian multiply is cheap
+    const double lr = lcom.real();
+    const double li = lcom.imaginary();
+    const double rr = rcom.real();
+    const double ri = rcom.imaginary();
+    return Complex_D_t::cartesian(lr * rr - li * ri, lr * ri + li * rr);
+}
+
+///--------------------------------------------------------
+Complex_D_t operator*(const Complex_D_t& lcom, const double& rreal)
+{
+    Complex_D_t outCom = lcom;
+    outCom.m_real = lcom.m_real * rreal;
+    outCom.m_imagine = lcom.m_imagine * rreal;
+    outCom.m_mag = lcom.m_mag * fabs(rreal);
+    outCom.m_arg = (rreal < 0) ? lcom.m_arg + M_PI : lcom.m_arg;
+    return outCom;
+}
+
+///--------------------------------------------------------
+Complex_D_t operator*(const double& lreal, const Complex_D_t& rcom)
+{
+    // * is commutative so use the other arragement
+    return rcom * lreal;
+}
+
+///--------------------------------------------------------
+void operator*=(Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    lcom = lcom * rcom;
+}
+
+///--------------------------------------------------------
+void operator*=(Complex_D_t& lcom, const double& rreal)
+{
+    lcom = lcom * rreal;
+}
+
+///--------------------------------------------------------
+Complex_D_t operator/(const Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    if (lcom.hasPolar() && rcom.hasPolar())
+    {
+        return Complex_D_t::polar(lcom.m_mag / rcom.m_mag, lcom.m_arg - rcom.m_arg);
+    }
+
+    const double lr = lcom.real();
+    const double li = lcom.imaginary();
+    const double rr = rcom.real();
+    const double ri = rcom.imaginary();
+    const double denom = rr * rr + ri * ri;
+    return Complex_D_t::cartesian((lr * rr + li * ri) / denom, (li * rr - lr * ri) / denom);
+}
+
+///--------------------------------------------------------
+Complex_D_t operator/(const Complex_D_t& lcom, const double& rreal)
+{
+    Complex_D_t outCom = lcom;
+    outCom.m_real = lcom.m_real / rreal;
+    outCom.m_imagine = lcom.m_imagine / rreal;
+    outCom.m_mag = lcom.m_mag / fabs(rreal);
+    outCom.m_arg = (rreal < 0) ? lcom.m_arg + M_PI : lcom.m_arg;
+    return outCom;
+}
+
+///--------------------------------------------------------
+Complex_D_t operator/(const double& lreal, const Complex_D_t& rcom)
+{
+    return Complex_D_t{lreal} / rcom;
+}
+
+///--------------------------------------------------------
+void operator/=(Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    lcom = lcom / rcom;
+}
+
+///--------------------------------------------------------
+void operator/=(Complex_D_t& lcom, const double& rreal)
+{
+    lcom = lcom / rreal;
+}
+
+///--------------------------------------------------------
+bool operator==(const Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    if (lcom.hasCartesian() && rcom.hasCartesian())
+    {
+        return (lcom.m_real == rcom.m_real) and (lcom.m_imagine == rcom.m_imagine);
+    }
+
+    if (lcom.hasPolar() && rcom.hasPolar())
+    {
+        return (lcom.m_mag == rcom.m_mag) and (lcom.m_mag == 0 or lcom.argument() == rcom.argument());
+    }
+
+    return (lcom.real() == rcom.real()) and (lcom.imaginary() == rcom.imaginary());
+}
+
+///--------------------------------------------------------
+bool operator==(const Complex_D_t& lcom, const double& rreal)
+{
+    return lcom == Complex_D_t{rreal};
+}
+
+///--------------------------------------------------------
+bool operator==(const double& lreal, const Complex_D_t& rcom)
+{
+    return rcom == lreal;
+}
+
+///--------------------------------------------------------
+bool operator!=(const Complex_D_t& lcom, const Complex_D_t& rcom)
+{
+    return !(lcom == rcom);
+}
+
+///--------------------------------------------------------
+bool operator!=(const Complex_D_t& lcom, const double& rreal)
+{
+    return !(lcom == rreal);
+}
+
+///--------------------------------------------------------
+bool operator!=(const double& lreal, const Complex_D_t& rcom)
+{
+    return !(rcom == lreal);
+}
+
+///--------------------------------------------------------
+std::ostream& operator<<(std::ostream& os, const Complex_D_t& com)
+{
+    if (com.hasCartesian())
+    {
+        return os << Complex_C_t{com.m_real, com.m_imagine};
+    }
+
+    return os << Complex_P_t{com.m_mag, com.argument()};
+}
+
+///--------------------------------------------------------
+Complex_D_t powReal(const Complex_D_t& base, const double& raise)
+{
+    return Complex_D_t::polar(pow(base.absolute(), raise), base.argument() * raise);
+}
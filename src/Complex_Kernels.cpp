@@ -0,0 +1,661 @@
+/// ------------------------------------------
+/// @file Complex_Kernels.cpp
+///
+/// @brief Source file for the split complex kernels and their run time dispatch
+/// ------------------------------------------
+
+#include "../inc/Complex_Kernels.h"
+#include "../inc/Thread_Pool.h"
+
+#include <stdexcept>
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define COMPLEX_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define COMPLEX_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    /// @brief One set of kernels, the dispatcher points at one of these
+    struct Complex_Kernel_Set_t
+    {
+        void (*add)(size_t, const double*, const double*, const double*, const double*, double*, double*);
+        void (*mul)(size_t, const double*, const double*, const double*, const double*, double*, double*);
+        void (*fma)(size_t, const double*, const double*, const double*, const double*, double*, double*);
+        void (*axpy)(size_t, double, double, const double*, const double*, double*, double*);
+        void (*dot)(size_t, const double*, const double*, const double*, const double*, double*, double*);
+    };
+
+    // ------------------------------------------ generic
+
+    void generic_add(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            cr[i] = ar[i] + br[i];
+            ci[i] = ai[i] + bi[i];
+        }
+    }
+
+    void generic_mul(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            const double re = ar[i] * br[i] - ai[i] * bi[i];
+            const double im = ar[i] * bi[i] + ai[i] * br[i];
+            cr[i] = re;
+            ci[i] = im;
+        }
+    }
+
+    void generic_fma(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            cr[i] += ar[i] * br[i] - ai[i] * bi[i];
+            ci[i] += ar[i] * bi[i] + ai[i] * br[i];
+        }
+    }
+
+    void generic_axpy(size_t len, double sr, double si, const double* xr, const double* xi, double* yr, double* yi)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            yr[i] += sr * xr[i] - si * xi[i];
+            yi[i] += sr * xi[i] + si * xr[i];
+        }
+    }
+
+    void generic_dot(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* re, double* im)
+    {
+        double sumRe = 0;
+        double sumIm = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            sumRe += ar[i] * br[i] - ai[i] * bi[i];
+            sumIm += ar[i] * bi[i] + ai[i] * br[i];
+        }
+        *re = sumRe;
+        *im = sumIm;
+    }
+
+    const Complex_Kernel_Set_t c_generic_kernels = {generic_add, generic_mul, generic_fma, generic_axpy, generic_dot};
+
+#ifdef COMPLEX_KERNELS_X86
+    // ------------------------------------------ AVX2 + FMA, 4 doubles per register
+
+    __attribute__((target("avx2,fma")))
+    void avx2_add(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            _mm256_storeu_pd(cr + i, _mm256_add_pd(_mm256_loadu_pd(ar + i), _mm256_loadu_pd(br + i)));
+            _mm256_storeu_pd(ci + i, _mm256_add_pd(_mm256_loadu_pd(ai + i), _mm256_loadu_pd(bi + i)));
+        }
+        generic_add(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void avx2_mul(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            const __m256d xr = _mm256_loadu_pd(ar + i);
+            const __m256d xi = _mm256_loadu_pd(ai + i);
+            const __m256d yr = _mm256_loadu_pd(br + i);
+            const __m256d yi = _mm256_loadu_pd(bi + i);
+            _mm256_storeu_pd(cr + i, _mm256_fmsub_pd(xr, yr, _mm256_mul_pd(xi, yi)));
+            _mm256_storeu_pd(ci + i, _mm256_fmadd_pd(xr, yi, _mm256_mul_pd(xi, yr)));
+        }
+        generic_mul(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void avx2_fma(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            const __m256d xr = _mm256_loadu_pd(ar + i);
+            const __m256d xi = _mm256_loadu_pd(ai + i);
+            const __m256d yr = _mm256_loadu_pd(br + i);
+            const __m256d yi = _mm256_loadu_pd(bi + i);
+            __m256d re = _mm256_loadu_pd(cr + i);
+            __m256d im = _mm256_loadu_pd(ci + i);
+            re = _mm256_fnmadd_pd(xi, yi, _mm256_fmadd_pd(xr, yr, re));
+            im = _mm256_fmadd_pd(xi, yr, _mm256_fmadd_pd(xr, yi, im));
+            _mm256_storeu_pd(cr + i, re);
+            _mm256_storeu_pd(ci + i, im);
+        }
+        generic_fma(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void avx2_axpy(size_t len, double sr, double si, const double* xr, const double* xi, double* yr, double* yi)
+    {
+        const __m256d vr = _mm256_set1_pd(sr);
+        const __m256d vi = _mm256_set1_pd(si);
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            const __m256d ar = _mm256_loadu_pd(xr + i);
+            const __m256d ai = _mm256_loadu_pd(xi + i);
+            __m256d re = _mm256_loadu_pd(yr + i);
+            __m256d im = _mm256_loadu_pd(yi + i);
+            re = _mm256_fnmadd_pd(vi, ai, _mm256_fmadd_pd(vr, ar, re));
+            im = _mm256_fmadd_pd(vi, ar, _mm256_fmadd_pd(vr, ai, im));
+            _mm256_storeu_pd(yr + i, re);
+            _mm256_storeu_pd(yi + i, im);
+        }
+        generic_axpy(len - i, sr, si, xr + i, xi + i, yr + i, yi + i);
+    }
+
+    __attribute__((target("avx2,fma")))
+    double avx2_hsum(const __m256d& v)
+    {
+        const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+
+    __attribute__((target("avx2,fma")))
+    void avx2_dot(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* re, double* im)
+    {
+        __m256d sumRe = _mm256_setzero_pd();
+        __m256d sumIm = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            const __m256d xr = _mm256_loadu_pd(ar + i);
+            const __m256d xi = _mm256_loadu_pd(ai + i);
+            const __m256d yr = _mm256_loadu_pd(br + i);
+            const __m256d yi = _mm256_loadu_pd(bi + i);
+            sumRe = _mm256_fnmadd_pd(xi, yi, _mm256_fmadd_pd(xr, yr, sumRe));
+            sumIm = _mm256_fmadd_pd(xi, yr, _mm256_fmadd_pd(xr, yi, sumIm));
+        }
+
+        generic_dot(len - i, ar + i, ai + i, br + i, bi + i, re, im);
+        *re += avx2_hsum(sumRe);
+        *im += avx2_hsum(sumIm);
+    }
+
+    const Complex_Kernel_Set_t c_avx2_kernels = {avx2_add, avx2_mul, avx2_fma, avx2_axpy, avx2_dot};
+
+    // ------------------------------------------ AVX-512F, 8 doubles per register
+
+    __attribute__((target("avx512f")))
+    void avx512_add(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            _mm512_storeu_pd(cr + i, _mm512_add_pd(_mm512_loadu_pd(ar + i), _mm512_loadu_pd(br + i)));
+            _mm512_storeu_pd(ci + i, _mm512_add_pd(_mm512_loadu_pd(ai + i), _mm512_loadu_pd(bi + i)));
+        }
+        generic_add(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    __attribute__((target("avx512f")))
+    void avx512_mul(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            const __m512d xr = _mm512_loadu_pd(ar + i);
+            const __m512d xi = _mm512_loadu_pd(ai + i);
+            const __m512d yr = _mm512_loadu_pd(br + i);
+            const __m512d yi = _mm512_loadu_pd(bi + i);
+            _mm512_storeu_pd(cr + i, _mm512_fmsub_pd(xr, yr, _mm512_mul_pd(xi, yi)));
+            _mm512_storeu_pd(ci + i, _mm512_fmadd_pd(xr, yi, _mm512_mul_pd(xi, yr)));
+        }
+        generic_mul(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    __attribute__((target("avx512f")))
+    void avx512_fma(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            const __m512d xr = _mm512_loadu_pd(ar + i);
+            const __m512d xi = _mm512_loadu_pd(ai + i);
+            const __m512d yr = _mm512_loadu_pd(br + i);
+            const __m512d yi = _mm512_loadu_pd(bi + i);
+            __m512d re = _mm512_loadu_pd(cr + i);
+            __m512d im = _mm512_loadu_pd(ci + i);
+            re = _mm512_fnmadd_pd(xi, yi, _mm512_fmadd_pd(xr, yr, re));
+            im = _mm512_fmadd_pd(xi, yr, _mm512_fmadd_pd(xr, yi, im));
+            _mm512_storeu_pd(cr + i, re);
+            _mm512_storeu_pd(ci + i, im);
+        }
+        generic_fma(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    __attribute__((target("avx512f")))
+    void avx512_axpy(size_t len, double sr, double si, const double* xr, const double* xi, double* yr, double* yi)
+    {
+        const __m512d vr = _mm512_set1_pd(sr);
+        const __m512d vi = _mm512_set1_pd(si);
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            const __m512d ar = _mm512_loadu_pd(xr + i);
+            const __m512d ai = _mm512_loadu_pd(xi + i);
+            __m512d re = _mm512_loadu_pd(yr + i);
+            __m512d im = _mm512_loadu_pd(yi + i);
+            re = _mm512_fnmadd_pd(vi, ai, _mm512_fmadd_pd(vr, ar, re));
+            im = _mm512_fmadd_pd(vi, ar, _mm512_fmadd_pd(vr, ai, im));
+            _mm512_storeu_pd(yr + i, re);
+            _mm512_storeu_pd(yi + i, im);
+        }
+        generic_axpy(len - i, sr, si, xr + i, xi + i, yr + i, yi + i);
+    }
+
+    __attribute__((target("avx512f")))
+    double avx512_hsum(const __m512d& v)
+    {
+        // spilled rather than extracted, the 512 bit extracts trip -Wuninitialized in some GCC headers
+        double lanes[8];
+        _mm512_storeu_pd(lanes, v);
+        return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+    }
+
+    __attribute__((target("avx512f")))
+    void avx512_dot(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* re, double* im)
+    {
+        __m512d sumRe = _mm512_setzero_pd();
+        __m512d sumIm = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            const __m512d xr = _mm512_loadu_pd(ar + i);
+            const __m512d xi = _mm512_loadu_pd(ai + i);
+            const __m512d yr = _mm512_loadu_pd(br + i);
+            const __m512d yi = _mm512_loadu_pd(bi + i);
+            sumRe = _mm512_fnmadd_pd(xi, yi, _mm512_fmadd_pd(xr, yr, sumRe));
+            sumIm = _mm512_fmadd_pd(xi, yr, _mm512_fmadd_pd(xr, yi, sumIm));
+        }
+
+        generic_dot(len - i, ar + i, ai + i, br + i, bi + i, re, im);
+        *re += avx512_hsum(sumRe);
+        *im += avx512_hsum(sumIm);
+    }
+
+    const Complex_Kernel_Set_t c_avx512_kernels = {avx512_add, avx512_mul, avx512_fma, avx512_axpy, avx512_dot};
+#endif
+
+#ifdef COMPLEX_KERNELS_NEON
+    // ------------------------------------------ NEON, 2 doubles per register
+
+    void neon_add(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            vst1q_f64(cr + i, vaddq_f64(vld1q_f64(ar + i), vld1q_f64(br + i)));
+            vst1q_f64(ci + i, vaddq_f64(vld1q_f64(ai + i), vld1q_f64(bi + i)));
+        }
+        generic_add(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    void neon_mul(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            const float64x2_t xr = vld1q_f64(ar + i);
+            const float64x2_t xi = vld1q_f64(ai + i);
+            const float64x2_t yr = vld1q_f64(br + i);
+            const float64x2_t yi = vld1q_f64(bi + i);
+            vst1q_f64(cr + i, vfmsq_f64(vmulq_f64(xr, yr), xi, yi));
+            vst1q_f64(ci + i, vfmaq_f64(vmulq_f64(xr, yi), xi, yr));
+        }
+        generic_mul(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    void neon_fma(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* cr, double* ci)
+    {
+        size_t i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            const float64x2_t xr = vld1q_f64(ar + i);
+            const float64x2_t xi = vld1q_f64(ai + i);
+            const float64x2_t yr = vld1q_f64(br + i);
+            const float64x2_t yi = vld1q_f64(bi + i);
+            vst1q_f64(cr + i, vfmsq_f64(vfmaq_f64(vld1q_f64(cr + i), xr, yr), xi, yi));
+            vst1q_f64(ci + i, vfmaq_f64(vfmaq_f64(vld1q_f64(ci + i), xr, yi), xi, yr));
+        }
+        generic_fma(len - i, ar + i, ai + i, br + i, bi + i, cr + i, ci + i);
+    }
+
+    void neon_axpy(size_t len, double sr, double si, const double* xr, const double* xi, double* yr, double* yi)
+    {
+        const float64x2_t vr = vdupq_n_f64(sr);
+        const float64x2_t vi = vdupq_n_f64(si);
+        size_t i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            const float64x2_t ar = vld1q_f64(xr + i);
+            const float64x2_t ai = vld1q_f64(xi + i);
+            vst1q_f64(yr + i, vfmsq_f64(vfmaq_f64(vld1q_f64(yr + i), vr, ar), vi, ai));
+            vst1q_f64(yi + i, vfmaq_f64(vfmaq_f64(vld1q_f64(yi + i), vr, ai), vi, ar));
+        }
+        generic_axpy(len - i, sr, si, xr + i, xi + i, yr + i, yi + i);
+    }
+
+    void neon_dot(size_t len, const double* ar, const double* ai, const double* br, const double* bi, double* re, double* im)
+    {
+        float64x2_t sumRe = vdupq_n_f64(0);
+        float64x2_t sumIm = vdupq_n_f64(0);
+        size_t i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            const float64x2_t xr = vld1q_f64(ar + i);
+            const float64x2_t xi = vld1q_f64(ai + i);
+            const float64x2_t yr = vld1q_f64(br + i);
+            const float64x2_t yi = vld1q_f64(bi + i);
+            sumRe = vfmsq_f64(vfmaq_f64(sumRe, xr, yr), xi, yi);
+            sumIm = vfmaq_f64(vfmaq_f64(sumIm, xr, yi), xi, yr);
+        }
+
+        generic_dot(len - i, ar + i, ai + i, br + i, bi + i, re, im);
+        *re += vaddvq_f64(sumRe);
+        *im += vaddvq_f64(sumIm);
+    }
+
+    const Complex_Kernel_Set_t c_neon_kernels = {neon_add, neon_mul, neon_fma, neon_axpy, neon_dot};
+#endif
+
+    ///--------------------------------------------------------
+    /// @brief Looks up the kernel set for an instruction set
+    ///
+    /// @return kernel set, nullptr if not supported by this build and CPU
+    const Complex_Kernel_Set_t* kernels_for(const Complex_Isa_t& isa)
+    {
+        switch (isa)
+        {
+#ifdef COMPLEX_KERNELS_X86
+            case Complex_Isa_t::AVX512:
+                return __builtin_cpu_supports("avx512f") ? &c_avx512_kernels : nullptr;
+            case Complex_Isa_t::AVX2:
+                return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? &c_avx2_kernels : nullptr;
+#endif
+#ifdef COMPLEX_KERNELS_NEON
+            case Complex_Isa_t::NEON:
+                return &c_neon_kernels;
+#endif
+            case Complex_Isa_t::GENERIC:
+                return &c_generic_kernels;
+            default:
+                return nullptr;
+        }
+    }
+
+    /// @brief active instruction set and its kernels
+    struct Complex_Dispatch_t
+    {
+        Complex_Isa_t m_isa = Complex_Isa_t::GENERIC;
+        const Complex_Kernel_Set_t* m_kernels = &c_generic_kernels;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, picks the widest supported instruction set
+        Complex_Dispatch_t()
+        {
+            for (Complex_Isa_t isa : {Complex_Isa_t::AVX512, Complex_Isa_t::AVX2, Complex_Isa_t::NEON})
+            {
+                if (const Complex_Kernel_Set_t* set = kernels_for(isa))
+                {
+                    m_isa = isa;
+                    m_kernels = set;
+                    return;
+                }
+            }
+        }
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Returns the dispatch state, selected on first use
+    Complex_Dispatch_t& dispatch()
+    {
+        static Complex_Dispatch_t state;
+        return state;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Splits len interleaved elements into real and imaginary arrays
+    void split(const Complex_C_t* src, const size_t& len, const size_t& stride, double* re, double* im)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            re[i] = src[i * stride].m_real;
+            im[i] = src[i * stride].m_imagine;
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Checks two split arrays have the same size
+    void check_sizes(const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa)
+    {
+        if (lsoa.size() != rsoa.size())
+        {
+            throw std::invalid_argument("Split complex arrays must be of same size");
+        }
+    }
+}
+
+///--------------------------------------------------------
+Complex_Soa_t::Complex_Soa_t(const Complex_C_t* data, const size_t& len, const size_t& stride) :
+    m_real(len), m_imagine(len)
+{
+    split(data, len, stride, m_real.data(), m_imagine.data());
+}
+
+///--------------------------------------------------------
+void Complex_Soa_t::store(Complex_C_t* out, const size_t& stride) const
+{
+    for (size_t i = 0; i < size(); i++)
+    {
+        out[i * stride] = Complex_C_t{m_real[i], m_imagine[i]};
+    }
+}
+
+///--------------------------------------------------------
+Complex_Isa_t complex_kernel_isa()
+{
+    return dispatch().m_isa;
+}
+
+///--------------------------------------------------------
+bool complex_kernel_supported(const Complex_Isa_t& isa)
+{
+    return kernels_for(isa) != nullptr;
+}
+
+///--------------------------------------------------------
+void complex_kernel_set_isa(const Complex_Isa_t& isa)
+{
+    const Complex_Kernel_Set_t* set = kernels_for(isa);
+    if (set == nullptr)
+    {
+        throw std::invalid_argument("Complex kernel instruction set not supported");
+    }
+
+    dispatch().m_isa = isa;
+    dispatch().m_kernels = set;
+}
+
+///--------------------------------------------------------
+void complex_soa_add(const size_t& len, const double* ar, const double* ai,
+                     const double* br, const double* bi, double* cr, double* ci)
+{
+    dispatch().m_kernels->add(len, ar, ai, br, bi, cr, ci);
+}
+
+///--------------------------------------------------------
+void complex_soa_mul(const size_t& len, const double* ar, const double* ai,
+                     const double* br, const double* bi, double* cr, double* ci)
+{
+    dispatch().m_kernels->mul(len, ar, ai, br, bi, cr, ci);
+}
+
+///--------------------------------------------------------
+void complex_soa_fma(const size_t& len, const double* ar, const double* ai,
+                     const double* br, const double* bi, double* cr, double* ci)
+{
+    dispatch().m_kernels->fma(len, ar, ai, br, bi, cr, ci);
+}
+
+///--------------------------------------------------------
+void complex_soa_axpy(const size_t& len, const Complex_C_t& alpha,
+                      const double* xr, const double* xi, double* yr, double* yi)
+{
+    dispatch().m_kernels->axpy(len, alpha.m_real, alpha.m_imagine, xr, xi, yr, yi);
+}
+
+///--------------------------------------------------------
+Complex_C_t complex_soa_dot(const size_t& len, const double* ar, const double* ai,
+                            const double* br, const double* bi)
+{
+    Complex_C_t sum;
+    dispatch().m_kernels->dot(len, ar, ai, br, bi, &sum.m_real, &sum.m_imagine);
+    return sum;
+}
+
+///--------------------------------------------------------
+Complex_Soa_t operator+(const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa)
+{
+    check_sizes(lsoa, rsoa);
+
+    Complex_Soa_t outSoa(lsoa.size());
+    complex_soa_add(lsoa.size(), lsoa.m_real.data(), lsoa.m_imagine.data(), rsoa.m_real.data(), rsoa.m_imagine.data(),
+                    outSoa.m_real.data(), outSoa.m_imagine.data());
+    return outSoa;
+}
+
+///--------------------------------------------------------
+Complex_Soa_t operator*(const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa)
+{
+    check_sizes(lsoa, rsoa);
+
+    Complex_Soa_t outSoa(lsoa.size());
+    complex_soa_mul(lsoa.size(), lsoa.m_real.data(), lsoa.m_imagine.data(), rsoa.m_real.data(), rsoa.m_imagine.data(),
+                    outSoa.m_real.data(), outSoa.m_imagine.data());
+    return outSoa;
+}
+
+///--------------------------------------------------------
+void fma(Complex_Soa_t& acc, const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa)
+{
+    check_sizes(lsoa, rsoa);
+    check_sizes(acc, lsoa);
+
+    complex_soa_fma(lsoa.size(), lsoa.m_real.data(), lsoa.m_imagine.data(), rsoa.m_real.data(), rsoa.m_imagine.data(),
+                    acc.m_real.data(), acc.m_imagine.data());
+}
+
+///--------------------------------------------------------
+Complex_C_t dot(const Complex_Soa_t& lsoa, const Complex_Soa_t& rsoa)
+{
+    check_sizes(lsoa, rsoa);
+
+    return complex_soa_dot(lsoa.size(), lsoa.m_real.data(), lsoa.m_imagine.data(), rsoa.m_real.data(), rsoa.m_imagine.data());
+}
+
+///--------------------------------------------------------
+Complex_C_t complex_dot(const size_t& len, const Complex_C_t* a, const Complex_C_t* b)
+{
+    double ar[COMPLEX_SPLIT_BLOCK];
+    double ai[COMPLEX_SPLIT_BLOCK];
+    double br[COMPLEX_SPLIT_BLOCK];
+    double bi[COMPLEX_SPLIT_BLOCK];
+
+    Complex_C_t sum;
+    for (size_t i = 0; i < len; i += COMPLEX_SPLIT_BLOCK)
+    {
+        const size_t block = std::min<size_t>(COMPLEX_SPLIT_BLOCK, len - i);
+        split(a + i, block, 1, ar, ai);
+        split(b + i, block, 1, br, bi);
+        sum += complex_soa_dot(block, ar, ai, br, bi);
+    }
+
+    return sum;
+}
+
+///--------------------------------------------------------
+void complex_gemm(const size_t& m, const size_t& n, const size_t& k,
+                  const Complex_C_t* A, const size_t& rsa, const size_t& csa,
+                  const Complex_C_t* B, const size_t& rsb, const size_t& csb,
+                  Complex_C_t* C, const size_t& ldc)
+{
+    if (k == 0)
+    {
+        for (size_t i = 0; i < m; i++)
+        {
+            std::fill(C + i * ldc, C + i * ldc + n, Complex_C_t{});
+        }
+        return;
+    }
+
+    const size_t ncMax = std::min<size_t>(COMPLEX_GEMM_BLOCK_NC, n);
+    const size_t kcMax = std::min<size_t>(COMPLEX_GEMM_BLOCK_KC, k);
+
+    // split panel of B, kc rows of nc, shared by all rows of C
+    std::vector<double> bRe(kcMax * ncMax);
+    std::vector<double> bIm(kcMax * ncMax);
+
+    for (size_t jc = 0; jc < n; jc += COMPLEX_GEMM_BLOCK_NC)
+    {
+        const size_t nc = std::min<size_t>(COMPLEX_GEMM_BLOCK_NC, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += COMPLEX_GEMM_BLOCK_KC)
+        {
+            const size_t kc = std::min<size_t>(COMPLEX_GEMM_BLOCK_KC, k - pc);
+            // first depth block overwrites C, the rest accumulate into it
+            const bool accumulate = pc != 0;
+
+            for (size_t p = 0; p < kc; p++)
+            {
+                split(B + (pc + p) * rsb + jc * csb, nc, csb, bRe.data() + p * nc, bIm.data() + p * nc);
+            }
+
+            parallel_for(0, m, parallel_grain(4 * kc * nc), [&](size_t from, size_t to)
+            {
+                std::vector<double> cRe(nc);
+                std::vector<double> cIm(nc);
+
+                for (size_t i = from; i < to; i++)
+                {
+                    Complex_C_t* cRow = C + i * ldc + jc;
+                    if (accumulate)
+                    {
+                        split(cRow, nc, 1, cRe.data(), cIm.data());
+                    }
+                    else
+                    {
+                        std::fill(cRe.begin(), cRe.end(), 0.0);
+                        std::fill(cIm.begin(), cIm.end(), 0.0);
+                    }
+
+                    const Complex_C_t* aRow = A + i * rsa + pc * csa;
+                    for (size_t p = 0; p < kc; p++)
+                    {
+                        complex_soa_axpy(nc, aRow[p * csa], bRe.data() + p * nc, bIm.data() + p * nc,
+                                         cRe.data(), cIm.data());
+                    }
+
+                    for (size_t j = 0; j < nc; j++)
+                    {
+                        cRow[j] = Complex_C_t{cRe[j], cIm[j]};
+                    }
+                }
+            });
+        }
+    }
+}
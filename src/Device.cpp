@@ -0,0 +1,174 @@
+/// ------------------------------------------
+/// @file Device.cpp
+///
+/// @brief Source file for the offload switch and size heuristics, plus the CPU only stubs
+///
+/// The backend itself is src/gpu/Device_Gpu.cpp, only compiled when MATRIX_GPU is set
+/// ------------------------------------------
+
+#include "../inc/Device.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    ///--------------------------------------------------------
+    /// @brief Offload switch, initialized from DEVICE_ENABLE_ENV on first use
+    std::atomic<bool>& enabled_flag()
+    {
+        static std::atomic<bool> flag([]
+        {
+            const char* env = std::getenv(DEVICE_ENABLE_ENV);
+            return env == nullptr || std::strcmp(env, "0") != 0;
+        }());
+        return flag;
+    }
+}
+
+///--------------------------------------------------------
+void device_set_enabled(const bool& enabled)
+{
+    enabled_flag().store(enabled, std::memory_order_relaxed);
+}
+
+///--------------------------------------------------------
+bool device_enabled()
+{
+    return enabled_flag().load(std::memory_order_relaxed);
+}
+
+///--------------------------------------------------------
+bool device_offload_product(const size_t& m, const size_t& n, const size_t& k)
+{
+    // below this the transfers cost more than the CPU gemm
+    return std::min({m, n, k}) >= DEVICE_OFFLOAD_MIN_DIM && device_available();
+}
+
+///--------------------------------------------------------
+bool device_offload_order(const size_t& n)
+{
+    return n >= DEVICE_OFFLOAD_MIN_ORDER && device_available();
+}
+
+#if !defined(MATRIX_GPU_CUDA) && !defined(MATRIX_GPU_HIP)
+
+namespace
+{
+    ///--------------------------------------------------------
+    /// @throws std::runtime_error always
+    [[noreturn]] void no_backend()
+    {
+        throw std::runtime_error("Matrix library was built without a GPU backend, configure with MATRIX_GPU=CUDA or HIP");
+    }
+}
+
+///--------------------------------------------------------
+Device_Backend_t device_backend()
+{
+    return Device_Backend_t::NONE;
+}
+
+///--------------------------------------------------------
+bool device_available()
+{
+    return false;
+}
+
+///--------------------------------------------------------
+void* device_allocate(const size_t&)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_release(void*) noexcept
+{
+}
+
+///--------------------------------------------------------
+void device_upload(void*, const void*, const size_t&, const bool&)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_download(void*, const void*, const size_t&, const bool&)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_copy(void*, const void*, const size_t&)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_synchronize()
+{
+}
+
+///--------------------------------------------------------
+void device_gemm(const size_t&, const size_t&, const size_t&, const float*, const float*, float*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_gemm(const size_t&, const size_t&, const size_t&, const double*, const double*, double*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_axpby(const size_t&, const float&, const float*, const float&, const float*, float*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_axpby(const size_t&, const double&, const double*, const double&, const double*, double*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+bool device_inverse(const size_t&, float*, float*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+bool device_inverse(const size_t&, double*, double*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+float device_determinant(const size_t&, float*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+double device_determinant(const size_t&, double*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_eigenvalues_symmetric(const size_t&, float*, float*)
+{
+    no_backend();
+}
+
+///--------------------------------------------------------
+void device_eigenvalues_symmetric(const size_t&, double*, double*)
+{
+    no_backend();
+}
+
+#endif
@@ -0,0 +1,475 @@
+/// ------------------------------------------
+/// @file Matrix_IO.cpp
+///
+/// @brief Source file for the memory mapped matrix file reader and the positional tile file
+/// ------------------------------------------
+
+#include "../inc/Matrix_IO.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    ///--------------------------------------------------------
+    /// @brief Element size the file must declare for its element type
+    ///
+    /// @param dtype element type tag from the header
+    ///
+    /// @return size in bytes, 0 for an unknown type
+    size_t dtype_size(const uint32_t& dtype)
+    {
+        switch (static_cast<Matrix_Dtype_t>(dtype))
+        {
+            case Matrix_Dtype_t::FLOAT:
+                return sizeof(float);
+            case Matrix_Dtype_t::DOUBLE:
+                return sizeof(double);
+            case Matrix_Dtype_t::COMPLEX_C:
+                return sizeof(Complex_C_t);
+        }
+        return 0;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Size of the payload a header describes
+    ///
+    /// @param header header with a known element type
+    /// @param path file name for the error message
+    ///
+    /// @return payload size in bytes
+    ///
+    /// @throws std::runtime_error if the size overflows
+    uint64_t payload_bytes(const Matrix_File_Header_t& header, const std::string& path)
+    {
+        uint64_t rows = header.m_rows;
+        uint64_t cols = header.m_cols;
+        if (header.m_order == static_cast<uint32_t>(Matrix_Order_t::TILED))
+        {
+            // whole tiles, edges padded
+            rows = (rows + header.m_tile - 1) / header.m_tile * header.m_tile;
+            cols = (cols + header.m_tile - 1) / header.m_tile * header.m_tile;
+        }
+
+        // rows * cols * elemSize without overflowing
+        const uint64_t maxCount = std::numeric_limits<uint64_t>::max() / header.m_elem_size;
+        if (cols != 0 && rows > maxCount / cols)
+        {
+            throw std::runtime_error("Matrix file dimensions overflow: " + path);
+        }
+        return rows * cols * header.m_elem_size;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Checks a header describes a payload this library can read
+    ///
+    /// @param header header to check
+    /// @param path file name for the error message
+    ///
+    /// @throws std::runtime_error if the header is invalid
+    void validate_fields(const Matrix_File_Header_t& header, const std::string& path)
+    {
+        if (std::memcmp(header.m_magic, "MATRIXB", 8) != 0)
+        {
+            throw std::runtime_error("Not a matrix file: " + path);
+        }
+        if (header.m_bom != 0x01020304)
+        {
+            throw std::runtime_error("Matrix file has the wrong byte order: " + path);
+        }
+        if (header.m_version != MATRIX_FILE_VERSION)
+        {
+            throw std::runtime_error("Unsupported matrix file version: " + path);
+        }
+
+        const size_t elemSize = dtype_size(header.m_dtype);
+        if (elemSize == 0 || elemSize != header.m_elem_size)
+        {
+            throw std::runtime_error("Unknown matrix file element type: " + path);
+        }
+        if (header.m_order > static_cast<uint32_t>(Matrix_Order_t::TILED))
+        {
+            throw std::runtime_error("Unknown matrix file storage order: " + path);
+        }
+        if (header.m_order == static_cast<uint32_t>(Matrix_Order_t::TILED) && header.m_tile == 0)
+        {
+            throw std::runtime_error("Tiled matrix file has no tile size: " + path);
+        }
+        if (header.m_offset < sizeof(Matrix_File_Header_t) || header.m_offset % elemSize != 0)
+        {
+            throw std::runtime_error("Misaligned matrix file payload: " + path);
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Checks a header against the size of the file it came from
+    ///
+    /// @param header header read from the file
+    /// @param fileSize size of the whole file in bytes
+    /// @param path file name for the error message
+    ///
+    /// @throws std::runtime_error if the header is invalid or the payload does not fit
+    void validate_header(const Matrix_File_Header_t& header, const uint64_t& fileSize, const std::string& path)
+    {
+        validate_fields(header, path);
+
+        const uint64_t payload = payload_bytes(header, path);
+        if (header.m_offset > fileSize || payload > fileSize - header.m_offset)
+        {
+            throw std::runtime_error("Matrix file is truncated: " + path);
+        }
+    }
+}
+
+Matrix_File_t::Matrix_File_t(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Could not open matrix file: " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Could not read the size of matrix file: " + path);
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    if (m_size >= sizeof(Matrix_File_Header_t))
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            m_map = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw std::runtime_error("Could not open matrix file: " + path);
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0)
+    {
+        close(file);
+        throw std::runtime_error("Could not read the size of matrix file: " + path);
+    }
+    m_size = static_cast<size_t>(info.st_size);
+
+    if (m_size >= sizeof(Matrix_File_Header_t))
+    {
+        void* map = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, file, 0);
+        m_map = (map == MAP_FAILED) ? nullptr : static_cast<const char*>(map);
+    }
+    // the mapping keeps its own reference to the file
+    close(file);
+#endif
+
+    if (m_size < sizeof(Matrix_File_Header_t))
+    {
+        throw std::runtime_error("Matrix file is too small for a header: " + path);
+    }
+    if (m_map == nullptr)
+    {
+        throw std::runtime_error("Could not map matrix file: " + path);
+    }
+
+    std::memcpy(&m_header, m_map, sizeof(m_header));
+    try
+    {
+        validate_header(m_header, m_size, path);
+    }
+    catch (...)
+    {
+        _unmap();
+        throw;
+    }
+}
+
+Matrix_File_t::~Matrix_File_t()
+{
+    _unmap();
+}
+
+Matrix_File_t::Matrix_File_t(Matrix_File_t&& other) noexcept
+    : m_header(other.m_header), m_map(std::exchange(other.m_map, nullptr)), m_size(std::exchange(other.m_size, 0))
+{
+}
+
+Matrix_File_t& Matrix_File_t::operator=(Matrix_File_t&& other) noexcept
+{
+    if (this != &other)
+    {
+        _unmap();
+        m_header = other.m_header;
+        m_map = std::exchange(other.m_map, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+void Matrix_File_t::prefetch() const
+{
+    if (m_map == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<char*>(m_map);
+    range.NumberOfBytes = m_size;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    madvise(const_cast<char*>(m_map), m_size, MADV_WILLNEED);
+#endif
+}
+
+void Matrix_File_t::_unmap() noexcept
+{
+    if (m_map == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_map);
+#else
+    munmap(const_cast<char*>(m_map), m_size);
+#endif
+    m_map = nullptr;
+    m_size = 0;
+}
+
+Tile_File_t::Tile_File_t(const std::string& path, const Matrix_File_Header_t& header) : m_header(header), m_path(path)
+{
+    validate_fields(m_header, m_path);
+    const uint64_t fileSize = m_header.m_offset + payload_bytes(m_header, m_path);
+
+    // header then zero padding up to the payload, the payload itself is left to the file system to zero
+    std::vector<char> head(m_header.m_offset, 0);
+    std::memcpy(head.data(), &m_header, sizeof(m_header));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Could not create matrix file: " + path);
+    }
+    m_handle = reinterpret_cast<intptr_t>(file);
+
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(fileSize);
+    if (!SetFilePointerEx(file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+    {
+        _close();
+        throw std::runtime_error("Could not size matrix file: " + path);
+    }
+#else
+    const int file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0)
+    {
+        throw std::runtime_error("Could not create matrix file: " + path);
+    }
+    m_handle = file;
+
+    if (ftruncate(file, static_cast<off_t>(fileSize)) != 0)
+    {
+        _close();
+        throw std::runtime_error("Could not size matrix file: " + path);
+    }
+#endif
+
+    try
+    {
+        _write_at(0, head.data(), head.size());
+    }
+    catch (...)
+    {
+        _close();
+        throw;
+    }
+}
+
+Tile_File_t::Tile_File_t(const std::string& path) : m_path(path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Could not open matrix file: " + path);
+    }
+    m_handle = reinterpret_cast<intptr_t>(file);
+
+    LARGE_INTEGER size;
+    const bool sized = GetFileSizeEx(file, &size);
+    const uint64_t fileSize = sized ? static_cast<uint64_t>(size.QuadPart) : 0;
+#else
+    const int file = open(path.c_str(), O_RDWR);
+    if (file < 0)
+    {
+        throw std::runtime_error("Could not open matrix file: " + path);
+    }
+    m_handle = file;
+
+    struct stat info;
+    const bool sized = fstat(file, &info) == 0;
+    const uint64_t fileSize = sized ? static_cast<uint64_t>(info.st_size) : 0;
+#endif
+
+    try
+    {
+        if (!sized)
+        {
+            throw std::runtime_error("Could not read the size of matrix file: " + path);
+        }
+        if (fileSize < sizeof(Matrix_File_Header_t))
+        {
+            throw std::runtime_error("Matrix file is too small for a header: " + path);
+        }
+
+        Matrix_File_Header_t header;
+        _read_at(0, &header, sizeof(header));
+        validate_header(header, fileSize, path);
+        m_header = header;
+    }
+    catch (...)
+    {
+        _close();
+        throw;
+    }
+}
+
+Tile_File_t::~Tile_File_t()
+{
+    _close();
+}
+
+Tile_File_t::Tile_File_t(Tile_File_t&& other) noexcept
+    : m_header(other.m_header), m_handle(std::exchange(other.m_handle, -1)), m_path(std::move(other.m_path))
+{
+}
+
+Tile_File_t& Tile_File_t::operator=(Tile_File_t&& other) noexcept
+{
+    if (this != &other)
+    {
+        _close();
+        m_header = other.m_header;
+        m_handle = std::exchange(other.m_handle, -1);
+        m_path = std::move(other.m_path);
+    }
+    return *this;
+}
+
+void Tile_File_t::read(const uint64_t& offset, void* dst, const size_t& bytes) const
+{
+    _read_at(m_header.m_offset + offset, dst, bytes);
+}
+
+void Tile_File_t::write(const uint64_t& offset, const void* src, const size_t& bytes) const
+{
+    _write_at(m_header.m_offset + offset, src, bytes);
+}
+
+void Tile_File_t::_read_at(uint64_t pos, void* dst, const size_t& bytes) const
+{
+    char* out = static_cast<char*>(dst);
+    size_t left = bytes;
+    while (left > 0)
+    {
+#ifdef _WIN32
+        OVERLAPPED at{};
+        at.Offset = static_cast<DWORD>(pos);
+        at.OffsetHigh = static_cast<DWORD>(pos >> 32);
+        DWORD done = 0;
+        const DWORD chunk = static_cast<DWORD>(std::min<size_t>(left, 1u << 30));
+        if (!ReadFile(reinterpret_cast<HANDLE>(m_handle), out, chunk, &done, &at) || done == 0)
+        {
+            throw std::runtime_error("Failed reading matrix file: " + m_path);
+        }
+#else
+        const ssize_t done = pread(static_cast<int>(m_handle), out, left, static_cast<off_t>(pos));
+        if (done <= 0)
+        {
+            if (done < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("Failed reading matrix file: " + m_path);
+        }
+#endif
+        out += done;
+        pos += done;
+        left -= done;
+    }
+}
+
+void Tile_File_t::_write_at(uint64_t pos, const void* src, const size_t& bytes) const
+{
+    const char* in = static_cast<const char*>(src);
+    size_t left = bytes;
+    while (left > 0)
+    {
+#ifdef _WIN32
+        OVERLAPPED at{};
+        at.Offset = static_cast<DWORD>(pos);
+        at.OffsetHigh = static_cast<DWORD>(pos >> 32);
+        DWORD done = 0;
+        const DWORD chunk = static_cast<DWORD>(std::min<size_t>(left, 1u << 30));
+        if (!WriteFile(reinterpret_cast<HANDLE>(m_handle), in, chunk, &done, &at) || done == 0)
+        {
+            throw std::runtime_error("Failed writing matrix file: " + m_path);
+        }
+#else
+        const ssize_t done = pwrite(static_cast<int>(m_handle), in, left, static_cast<off_t>(pos));
+        if (done <= 0)
+        {
+            if (done < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("Failed writing matrix file: " + m_path);
+        }
+#endif
+        in += done;
+        pos += done;
+        left -= done;
+    }
+}
+
+void Tile_File_t::_close() noexcept
+{
+    if (m_handle == -1)
+    {
+        return;
+    }
+#ifdef _WIN32
+    CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+#else
+    close(static_cast<int>(m_handle));
+#endif
+    m_handle = -1;
+}
@@ -5,6 +5,546 @@
 /// ------------------------------------------
 
 #include "../inc/Poly.h"
+#include "../inc/Complex_Kernels.h"
+#include "../inc/Matrix.h"
+#include "../inc/Thread_Pool.h"
+#include "../inc/Profile.h"
+
+namespace
+{
+    ///--------------------------------------------------------
+    /// @brief In place iterative radix 2 FFT of split complex data, len must be a power of two
+    ///
+    /// @param re real parts
+    /// @param im imaginary parts
+    /// @param inverse run the inverse transform (unscaled)
+    void fft(std::vector<double>& re, std::vector<double>& im, const bool inverse)
+    {
+        const size_t len = re.size();
+
+        // bit reversal permutation
+        for (size_t i = 1, j = 0; i < len; i++)
+        {
+            size_t bit = len >> 1;
+            for (; j & bit; bit >>= 1)
+            {
+                j ^= bit;
+            }
+            j ^= bit;
+
+            if (i < j)
+            {
+                std::swap(re[i], re[j]);
+                std::swap(im[i], im[j]);
+            }
+        }
+
+        // twiddles of the full length computed directly, each level strides through them
+        const double sign = inverse ? 1.0 : -1.0;
+        std::vector<double> wr(len / 2), wi(len / 2);
+        for (size_t k = 0; k < len / 2; k++)
+        {
+            const double angle = sign * 2.0 * M_PI * k / len;
+            wr[k] = std::cos(angle);
+            wi[k] = std::sin(angle);
+        }
+
+        for (size_t half = 1; half < len; half <<= 1)
+        {
+            const size_t stride = len / (2 * half);
+            for (size_t start = 0; start < len; start += 2 * half)
+            {
+                for (size_t k = 0; k < half; k++)
+                {
+                    const size_t a = start + k;
+                    const size_t b = a + half;
+                    const double tr = wr[k * stride] * re[b] - wi[k * stride] * im[b];
+                    const double ti = wr[k * stride] * im[b] + wi[k * stride] * re[b];
+                    re[b] = re[a] - tr;
+                    im[b] = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+                }
+            }
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Writes every stride-th factor out in bit reversed order (evens first, recursively)
+    /// For factors sorted by root angle every prefix, and each half, of the output then has
+    /// its roots spread around the whole circle
+    ///
+    /// @param factors first factor
+    /// @param count number of factors to take
+    /// @param stride distance between taken factors
+    /// @param out where to write, advanced past the written factors
+    void spread_order(const Poly_factor_t* factors, const size_t count, const size_t stride, Poly_factor_t*& out)
+    {
+        if (count == 1)
+        {
+            *out++ = factors[0];
+            return;
+        }
+
+        if (count > 1)
+        {
+            spread_order(factors, count - count / 2, 2 * stride, out);
+            spread_order(factors + stride, count / 2, 2 * stride, out);
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Multiplies out a run of factors by (ax + b) one factor at a time in place, O(n^2)
+    /// Each step rounds every coefficient relative to its own size, unlike an FFT product
+    /// whose error is relative to the largest coefficient and swamps the small ones
+    ///
+    /// @note the partial products need roots spread like the whole set (see spread_order),
+    /// otherwise their coefficients grow binomially and cancel in the final product
+    ///
+    /// @param factors first factor
+    /// @param count number of factors
+    ///
+    /// @return count + 1 coefficients
+    Poly_Coeff_t expand_factors(const Poly_factor_t* factors, const size_t count)
+    {
+        Poly_Coeff_t compressedPoly(count + 1, 0);
+        Complex_C_t* coeff = compressedPoly.data();
+        coeff[0] = 1;
+
+        // after k factors coeff[0..k] holds their product, top down so each old value is read before it is replaced
+        for (size_t k = 0; k < count; k++)
+        {
+            const double xCoeff = factors[k].first;
+            const Complex_C_t constCoeff = factors[k].second;
+
+            coeff[k + 1] = coeff[k] * xCoeff;
+            for (size_t i = k; i > 0; i--)
+            {
+                coeff[i] = coeff[i] * constCoeff + coeff[i - 1] * xCoeff;
+            }
+            coeff[0] *= constCoeff;
+        }
+
+        return compressedPoly;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Spreads the starting estimates on a circle sized by the outer coefficients
+    ///
+    /// @param compressedPoly polynomial of rank 2 or above
+    /// @param re real parts out, one per root
+    /// @param im imaginary parts out, one per root
+    /// @param stride distance between consecutive estimates in re and im
+    void initial_estimates(const Poly_Coeff_t& compressedPoly, double* re, double* im, const size_t& stride)
+    {
+        const size_t maxRank = compressedPoly.size() - 1;
+
+        Complex_C_t first_nonzero_coeff;
+        for (auto coeff : compressedPoly)
+        {
+            if (coeff != 0)
+            {
+                first_nonzero_coeff = coeff;
+                break;
+            }
+        }
+
+        // Create a distribution circle for initial values
+        const double radius = pow( first_nonzero_coeff.absolute() / compressedPoly[maxRank].absolute(), (1.0 / maxRank) );
+        const double base_angle = (2 * M_PI) / maxRank;
+        const double offset = M_PI / (2 * maxRank);
+
+        for (size_t i = 0; i < maxRank; i++)
+        {
+            Complex_C_t estimate = polarToCart({radius, (i * base_angle) + offset});
+
+            // Fixes an issue with very small values breaking some math functions
+            if (fabs(estimate.m_real) < SMALLEST_ALLOWED_START_VAL)
+            {
+                estimate.m_real = 0.0;
+            }
+
+            if (fabs(estimate.m_imagine) < SMALLEST_ALLOWED_START_VAL)
+            {
+                estimate.m_imagine = 0.0;
+            }
+
+            re[i * stride] = estimate.m_real;
+            im[i * stride] = estimate.m_imagine;
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Spreads the starting estimates on a circle sized by the outer coefficients
+    ///
+    /// @param compressedPoly polynomial of rank 2 or above
+    ///
+    /// @return one estimate per root
+    Poly_Coeff_t initial_estimates(const Poly_Coeff_t& compressedPoly)
+    {
+        const size_t maxRank = compressedPoly.size() - 1;
+        std::vector<double> re(maxRank), im(maxRank);
+        initial_estimates(compressedPoly, re.data(), im.data(), 1);
+
+        Poly_Coeff_t estimates(maxRank);
+        for (size_t i = 0; i < maxRank; i++)
+        {
+            estimates[i] = Complex_C_t(re[i], im[i]);
+        }
+        return estimates;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Durand-Kerner iteration, every estimate is updated from the previous sweep
+    /// The step is p(z_i) / (a_n * prod(z_i - z_j)) so a non-monic polynomial converges too.
+    /// Iteration stops unconverged as soon as an estimate turns non-finite
+    ///
+    /// @param compressedPoly polynomial of rank 2 or above
+    /// @param result roots, iteration count and convergence filled in
+    void durand_kerner(const Poly_Coeff_t& compressedPoly, Poly_Roots_Result_t& result)
+    {
+        Poly_Coeff_t nextValues = initial_estimates(compressedPoly);
+        Poly_Coeff_t currentValues = nextValues;
+        const size_t count = currentValues.size();
+        const Complex_C_t leading = compressedPoly.back();
+        bool all_converged = false;
+        bool diverged = false;
+
+        while (result.m_iterations < MAX_DK_ITERATIONS && !all_converged && !diverged)
+        {
+            result.m_iterations++;
+
+            // every estimate is updated from the previous iterate, so evaluate them in one batch
+            const Poly_Coeff_t polyVals = getValsCompressedPoly(currentValues, compressedPoly);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                const Complex_C_t curVal = currentValues[i];
+
+                Complex_C_t sub_product = leading;
+                for (size_t j = 0; j < count; j++)
+                {
+                    if (j != i)
+                    {
+                        sub_product *= curVal - currentValues[j];
+                    }
+                }
+
+                nextValues[i] = curVal - (polyVals[i] / sub_product);
+            }
+
+            all_converged = true;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (!std::isfinite(nextValues[i].m_real) || !std::isfinite(nextValues[i].m_imagine))
+                {
+                    all_converged = false;
+                    diverged = true;
+                    break;
+                }
+
+                // if any roots fail this test, continue iterations
+                if (!(std::abs( currentValues[i].absolute() - nextValues[i].absolute() ) < MIN_DIFF_CONV_TEST))
+                {
+                    all_converged = false;
+                }
+            }
+
+            currentValues = nextValues;
+        }
+
+        result.m_roots = nextValues;
+        result.m_converged = all_converged;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Finds the newton step p(z) / p'(z) by Horner's scheme
+    /// Outside the unit circle the reversed polynomial is evaluated at 1/z instead,
+    /// so high degrees do not overflow: p(z) = z^n q(1/z), p/p' = z q / (n q - q'/z)
+    ///
+    /// @param coeffs coefficients, lowest power first
+    /// @param rank number of coefficients
+    /// @param z point to evaluate at
+    /// @param ratio set to p(z) / p'(z)
+    ///
+    /// @return false if p(z) is within the rounding error of evaluating it (POLY_ROOT_EVAL_EPS),
+    /// so no step can improve on z
+    bool newton_ratio(const Complex_C_t* coeffs, const size_t rank, const Complex_C_t& z, Complex_C_t& ratio)
+    {
+        const double zAbs = z.absolute();
+        const bool inside = zAbs <= 1.0;
+        const Complex_C_t w = inside ? z : Complex_C_t(1.0) / z;
+        const double wAbs = inside ? zAbs : 1.0 / zAbs;
+
+        // inside runs from the highest power down, outside the reversed polynomial does
+        Complex_C_t val = inside ? coeffs[rank - 1] : coeffs[0];
+        Complex_C_t deriv = 0;
+        double bound = val.absolute();
+        for (size_t step = 1; step < rank; step++)
+        {
+            const Complex_C_t& coeff = inside ? coeffs[rank - 1 - step] : coeffs[step];
+            deriv = deriv * w + val;
+            val = val * w + coeff;
+            bound = bound * wAbs + coeff.absolute();
+        }
+
+        if (val.absolute() <= POLY_ROOT_EVAL_EPS * bound)
+        {
+            return false;
+        }
+
+        ratio = inside ? val / deriv : z * val / (Complex_C_t((double) (rank - 1)) * val - w * deriv);
+        return true;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Aberth-Ehrlich iteration with frozen converged roots, see FindPolyRoots
+    ///
+    /// @param compressedPoly polynomial of rank 2 or above
+    /// @param result roots, iteration count and convergence filled in
+    void aberth(const Poly_Coeff_t& compressedPoly, Poly_Roots_Result_t& result)
+    {
+        Poly_Coeff_t roots = initial_estimates(compressedPoly);
+        const size_t count = roots.size();
+        const size_t rank = compressedPoly.size();
+        const Complex_C_t* coeffs = compressedPoly.data();
+
+        // previous sweep's values, read by the other threads' blocks
+        Poly_Coeff_t previous = roots;
+        std::vector<char> frozen(count, 0);
+        size_t remaining = count;
+
+        // one block (full Gauss-Seidel) below the threshold
+        const size_t grain = (count < POLY_PARALLEL_ROOTS) ? count : parallel_grain(count + rank);
+
+        while (result.m_iterations < MAX_ABERTH_ITERATIONS && remaining > 0)
+        {
+            result.m_iterations++;
+            previous = roots;
+
+            parallel_for(0, count, grain, [&](size_t from, size_t to)
+            {
+                for (size_t i = from; i < to; i++)
+                {
+                    if (frozen[i])
+                    {
+                        continue;
+                    }
+
+                    const Complex_C_t z = roots[i];
+
+                    Complex_C_t ratio;
+                    if (!newton_ratio(coeffs, rank, z, ratio))
+                    {
+                        frozen[i] = 1;
+                        continue;
+                    }
+
+                    Complex_C_t repulsion = 0;
+                    for (size_t j = 0; j < count; j++)
+                    {
+                        if (j != i)
+                        {
+                            const Complex_C_t other = (j >= from && j < i) ? roots[j] : previous[j];
+                            repulsion += Complex_C_t(1.0) / (z - other);
+                        }
+                    }
+
+                    const Complex_C_t step = ratio / (Complex_C_t(1.0) - ratio * repulsion);
+
+                    // a stationary point (p' = 0) gives no step, leave the estimate for the others to move off
+                    if (!std::isfinite(step.m_real) || !std::isfinite(step.m_imagine))
+                    {
+                        continue;
+                    }
+                    roots[i] = z - step;
+
+                    if (step.absolute() < MIN_DIFF_CONV_TEST * std::max(1.0, z.absolute()))
+                    {
+                        frozen[i] = 1;
+                    }
+                }
+            });
+
+            remaining = std::count(frozen.begin(), frozen.end(), 0);
+        }
+
+        result.m_roots = roots;
+        result.m_converged = remaining == 0;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Roots as the eigenvalues of the companion matrix
+    ///
+    /// @param compressedPoly polynomial of rank 2 or above
+    /// @param result roots, iteration count and convergence filled in
+    void companion(const Poly_Coeff_t& compressedPoly, Poly_Roots_Result_t& result)
+    {
+        const size_t maxRank = compressedPoly.size() - 1;
+        const Complex_C_t lead = compressedPoly[maxRank];
+
+        // ones on the sub diagonal, negated monic coefficients down the last column
+        Matrix<Complex_C_t> comp(maxRank, maxRank);
+        comp.view().fill(Complex_C_t(0.0));
+        for (size_t i = 0; i < maxRank; i++)
+        {
+            if (i > 0)
+            {
+                comp(i, i - 1) = 1.0;
+            }
+            comp(i, maxRank - 1) = -(compressedPoly[i] / lead);
+        }
+
+        const Eigen_Result_t eig = comp.eigen_solve();
+        result.m_roots = eig.m_values;
+        result.m_iterations = eig.m_total_iterations;
+        result.m_converged = eig.m_converged;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Aberth-Ehrlich iteration on a chunk of same rank polynomials, one lane per polynomial
+    /// Every array is root (or coefficient) major with the lanes contiguous, so each step of
+    /// the iteration is one loop over the lanes. Lanes (and roots within a lane) freeze as in
+    /// aberth, the chunk sweeps until every lane has frozen or MAX_ABERTH_ITERATIONS
+    ///
+    /// @param polys first polynomial of the chunk
+    /// @param len polynomials in the chunk
+    /// @param results one result per polynomial, roots, iterations and convergence filled in
+    void aberth_lanes(const Poly_Coeff_t* polys, const size_t& len, Poly_Roots_Result_t* results)
+    {
+        const size_t rank = polys[0].size();
+        const size_t count = rank - 1;
+
+        std::vector<double> cr(rank * len), ci(rank * len), ca(rank * len);
+        std::vector<double> zr(count * len), zi(count * len);
+        std::vector<char> frozen(count * len, 0);
+        for (size_t l = 0; l < len; l++)
+        {
+            for (size_t c = 0; c < rank; c++)
+            {
+                cr[c * len + l] = polys[l][c].m_real;
+                ci[c * len + l] = polys[l][c].m_imagine;
+                ca[c * len + l] = polys[l][c].absolute();
+            }
+            initial_estimates(polys[l], zr.data() + l, zi.data() + l, len);
+        }
+
+        std::vector<double> pr(len), pi(len), dr(len), di(len), bound(len), rr(len), ri(len);
+        std::vector<char> done(len, 0);
+        size_t sweeps = 0;
+        size_t remaining = len;
+
+        while (sweeps < MAX_ABERTH_ITERATIONS && remaining > 0)
+        {
+            sweeps++;
+            for (size_t l = 0; l < len; l++)
+            {
+                results[l].m_iterations += !done[l];
+            }
+
+            for (size_t k = 0; k < count; k++)
+            {
+                const double* zkr = zr.data() + k * len;
+                const double* zki = zi.data() + k * len;
+
+                // Horner for p and p', with the running rounding bound sum |c_i| |z|^i
+                for (size_t l = 0; l < len; l++)
+                {
+                    pr[l] = cr[(rank - 1) * len + l];
+                    pi[l] = ci[(rank - 1) * len + l];
+                    dr[l] = 0;
+                    di[l] = 0;
+                    bound[l] = ca[(rank - 1) * len + l];
+                }
+                for (size_t c = rank - 1; c-- > 0;)
+                {
+                    for (size_t l = 0; l < len; l++)
+                    {
+                        const double ndr = dr[l] * zkr[l] - di[l] * zki[l] + pr[l];
+                        const double ndi = dr[l] * zki[l] + di[l] * zkr[l] + pi[l];
+                        const double npr = pr[l] * zkr[l] - pi[l] * zki[l] + cr[c * len + l];
+                        const double npi = pr[l] * zki[l] + pi[l] * zkr[l] + ci[c * len + l];
+                        dr[l] = ndr;
+                        di[l] = ndi;
+                        pr[l] = npr;
+                        pi[l] = npi;
+                        bound[l] = bound[l] * std::sqrt(zkr[l] * zkr[l] + zki[l] * zki[l]) + ca[c * len + l];
+                    }
+                }
+
+                // repulsion = sum 1 / (z_k - z_j)
+                std::fill(rr.begin(), rr.end(), 0.0);
+                std::fill(ri.begin(), ri.end(), 0.0);
+                for (size_t j = 0; j < count; j++)
+                {
+                    if (j == k)
+                    {
+                        continue;
+                    }
+                    const double* zjr = zr.data() + j * len;
+                    const double* zji = zi.data() + j * len;
+                    for (size_t l = 0; l < len; l++)
+                    {
+                        const double er = zkr[l] - zjr[l];
+                        const double ei = zki[l] - zji[l];
+                        const double mag = er * er + ei * ei;
+                        rr[l] += er / mag;
+                        ri[l] -= ei / mag;
+                    }
+                }
+
+                double* ukr = zr.data() + k * len;
+                double* uki = zi.data() + k * len;
+                char* fk = frozen.data() + k * len;
+                for (size_t l = 0; l < len; l++)
+                {
+                    // ratio = p / p', step = ratio / (1 - ratio * repulsion)
+                    const double dmag = dr[l] * dr[l] + di[l] * di[l];
+                    const double qr = (pr[l] * dr[l] + pi[l] * di[l]) / dmag;
+                    const double qi = (pi[l] * dr[l] - pr[l] * di[l]) / dmag;
+                    const double denr = 1.0 - (qr * rr[l] - qi * ri[l]);
+                    const double deni = -(qr * ri[l] + qi * rr[l]);
+                    const double denmag = denr * denr + deni * deni;
+                    const double sr = (qr * denr + qi * deni) / denmag;
+                    const double si = (qi * denr - qr * deni) / denmag;
+
+                    const double pmag = std::sqrt(pr[l] * pr[l] + pi[l] * pi[l]);
+                    const bool noise = pmag <= POLY_ROOT_EVAL_EPS * bound[l];
+                    const bool finite = std::isfinite(sr) && std::isfinite(si);
+                    const bool move = !fk[l] && !noise && finite;
+                    const double zmag = std::sqrt(ukr[l] * ukr[l] + uki[l] * uki[l]);
+                    const bool small = std::sqrt(sr * sr + si * si) < MIN_DIFF_CONV_TEST * std::max(1.0, zmag);
+
+                    ukr[l] = move ? ukr[l] - sr : ukr[l];
+                    uki[l] = move ? uki[l] - si : uki[l];
+                    fk[l] = fk[l] || noise || (finite && small);
+                }
+            }
+
+            remaining = 0;
+            for (size_t l = 0; l < len; l++)
+            {
+                bool all = true;
+                for (size_t k = 0; k < count; k++)
+                {
+                    all = all && frozen[k * len + l];
+                }
+                done[l] = all;
+                remaining += !all;
+            }
+        }
+
+        for (size_t l = 0; l < len; l++)
+        {
+            results[l].m_roots.resize(count);
+            for (size_t k = 0; k < count; k++)
+            {
+                results[l].m_roots[k] = Complex_C_t(zr[k * len + l], zi[k * len + l]);
+            }
+            results[l].m_converged = done[l];
+        }
+    }
+}
 
 /// ------------------------------------------
 Poly_Coeff_t operator+(const Poly_Coeff_t& coeffL, const Poly_Coeff_t& coeffR)
@@ -69,19 +609,69 @@ Poly_Coeff_t operator-(const Poly_Coeff_t& coeffL, const Poly_Coeff_t& coeffR)
 /// ------------------------------------------
 Poly_Coeff_t operator*(const Poly_Coeff_t& coeffL, const Poly_Coeff_t& coeffR)
 {
+    if (coeffL.empty() || coeffR.empty())
+    {
+        return Poly_Coeff_t();
+    }
+
     Poly_Coeff_t outCoeff(coeffL.size() + coeffR.size() - 1, 0);
 
+    // indices are bounded by the sizes above, skip the checked access
+    const Complex_C_t* left = coeffL.data();
+    const Complex_C_t* right = coeffR.data();
+    Complex_C_t* out = outCoeff.data();
     for (size_t i = 0; i < coeffL.size(); i++)
     {
         for (size_t j = 0; j < coeffR.size(); j++)
         {
-            outCoeff.at(i+j) += coeffL.at(i) * coeffR.at(j);
+            out[i+j] += left[i] * right[j];
         }
     }
 
     return outCoeff;
 }
 
+/// ------------------------------------------
+Poly_Coeff_t MultiplyPolyFFT(const Poly_Coeff_t& coeffL, const Poly_Coeff_t& coeffR)
+{
+    if (coeffL.empty() || coeffR.empty())
+    {
+        return Poly_Coeff_t();
+    }
+
+    const size_t outLen = coeffL.size() + coeffR.size() - 1;
+    size_t len = 1;
+    while (len < outLen)
+    {
+        len <<= 1;
+    }
+
+    std::vector<double> lr(len, 0.0), li(len, 0.0), rr(len, 0.0), ri(len, 0.0);
+    for (size_t i = 0; i < coeffL.size(); i++)
+    {
+        lr[i] = coeffL[i].m_real;
+        li[i] = coeffL[i].m_imagine;
+    }
+    for (size_t i = 0; i < coeffR.size(); i++)
+    {
+        rr[i] = coeffR[i].m_real;
+        ri[i] = coeffR[i].m_imagine;
+    }
+
+    fft(lr, li, false);
+    fft(rr, ri, false);
+    complex_soa_mul(len, lr.data(), li.data(), rr.data(), ri.data(), lr.data(), li.data());
+    fft(lr, li, true);
+
+    Poly_Coeff_t outCoeff(outLen);
+    for (size_t i = 0; i < outLen; i++)
+    {
+        outCoeff[i] = Complex_C_t(lr[i] / len, li[i] / len);
+    }
+
+    return outCoeff;
+}
+
 /// ------------------------------------------
 std::ostream& operator<<(std::ostream& os, const Poly_Coeff_t& poly)
 {
@@ -135,183 +725,202 @@ std::ostream& operator<<(std::ostream& os, const std::vector<Poly_factor_t>& fac
 /// ------------------------------------------
 Poly_Coeff_t CompressFactors(const std::vector<Poly_factor_t>& factorList)
 {
-    // Highest polynomial rank is equal to the number of factors
-    Poly_Coeff_t compressedPoly(factorList.size() + 1);
-
-    for (size_t curPower = 0; curPower < compressedPoly.size(); curPower++)
+    // order by root angle, then spread, so no partial product has its roots bunched on one side
+    std::vector<std::pair<double, size_t>> angles(factorList.size());
+    for (size_t i = 0; i < factorList.size(); i++)
     {
-        // First and last powers are expections, being the product of either the x or non-x factor components
-        if (curPower == 0)
-        {
-            Complex_C_t product = 1;
-            for (auto factor : factorList)
-            {
-                product *= factor.second;
-            }
-
-            compressedPoly.at(curPower) = product;
-            continue;
-        }
-
-        // Last power execption
-        if (curPower == compressedPoly.size() - 1)
-        {
-            Complex_C_t product = 1;
-            for (auto factor : factorList)
-            {
-                product *= factor.first;
-            }
-
-            compressedPoly.at(curPower) = product;
-            continue;
-        }
+        const Poly_factor_t& factor = factorList[i];
+        const Complex_C_t root = (factor.first == 0) ? Complex_C_t(0.0) : -factor.second / factor.first;
+        angles[i] = {std::atan2(root.m_imagine, root.m_real), i};
+    }
+    std::sort(angles.begin(), angles.end());
 
-        Complex_C_t sum_product = 0;
-        for (size_t curFactor = 0; curFactor < factorList.size(); curFactor++)
-        {
-            Complex_C_t product = factorList.at(curFactor).first;
-            size_t x_factors_left = curPower - 1;
-            size_t curIdx = (curFactor + 1 == factorList.size()) ? 0 : curFactor + 1;
+    std::vector<Poly_factor_t> sorted(factorList.size());
+    for (size_t i = 0; i < angles.size(); i++)
+    {
+        sorted[i] = factorList[angles[i].second];
+    }
 
-            while (curIdx != curFactor)
-            {
-                if (x_factors_left > 0)
-                {
-                    product *= factorList.at(curIdx).first;
-                    x_factors_left--;
-                }
-                else
-                {
-                    product *= factorList.at(curIdx).second;
-                }
+    std::vector<Poly_factor_t> spread(sorted.size());
+    Poly_factor_t* out = spread.data();
+    spread_order(sorted.data(), sorted.size(), 1, out);
 
-                curIdx++;
-                if (curIdx == factorList.size()) curIdx = 0;
-            }
-
-            sum_product += product;
-        }
+    // Highest polynomial rank is equal to the number of factors
+    return expand_factors(spread.data(), spread.size());
+}
 
-        compressedPoly.at(curPower) = sum_product;
+/// ------------------------------------------
+Complex_C_t getValCompressedPoly(const Complex_C_t x, const Poly_Coeff_t& compressedPoly)
+{
+    Complex_C_t sum_factors = 0;
+    for (size_t i = compressedPoly.size(); i-- > 0;)
+    {
+        sum_factors = sum_factors * x + compressedPoly[i];
     }
 
-    return compressedPoly;
+    return sum_factors;
 }
 
 /// ------------------------------------------
-Complex_C_t getValCompressedPoly(const Complex_C_t x, const Poly_Coeff_t& compressedPoly)
+Poly_Coeff_t getValsCompressedPoly(const Poly_Coeff_t& xs, const Poly_Coeff_t& compressedPoly)
 {
-    Complex_C_t sum_factors = 0;
-    for (size_t i = 0; i < compressedPoly.size(); i++)
+    const size_t count = xs.size();
+    Complex_Soa_t points(xs.data(), count);
+    Complex_Soa_t sums(count);
+
+    for (size_t i = compressedPoly.size(); i-- > 0;)
     {
-        if (compressedPoly.at(i) != 0.0)
+        complex_soa_mul(count, sums.m_real.data(), sums.m_imagine.data(), points.m_real.data(), points.m_imagine.data(),
+                        sums.m_real.data(), sums.m_imagine.data());
+
+        const double coeffReal = compressedPoly[i].m_real;
+        const double coeffImag = compressedPoly[i].m_imagine;
+        for (size_t j = 0; j < count; j++)
         {
-            sum_factors += compressedPoly.at(i) * powReal(x, i);
+            sums.m_real[j] += coeffReal;
+            sums.m_imagine[j] += coeffImag;
         }
     }
 
-    return sum_factors;
+    Poly_Coeff_t outVals(count);
+    for (size_t j = 0; j < count; j++)
+    {
+        outVals[j] = Complex_C_t(sums.m_real[j], sums.m_imagine[j]);
+    }
+
+    return outVals;
 }
 
 /// ------------------------------------------
-std::vector<Poly_factor_t> FactorizePoly(const Poly_Coeff_t& compressedPoly)
+Poly_Roots_Result_t FindPolyRoots(const Poly_Coeff_t& compressedPoly, const Poly_Root_Method_t& method)
 {
-    size_t maxRank = compressedPoly.size() - 1;
-
-    if (maxRank < 2)
+    if (compressedPoly.size() < 3)
     {
         throw std::invalid_argument("Polynomials below rank 2 have trivial solutions, and also break this algorithm,"
                                     "might implement rank 1 at some point.");
     }
 
-    Complex_C_t first_nonzero_coeff;
-    for (auto coeff : compressedPoly)
+    Profile_Scope_t profile(Profile_Op_t::POLY_ROOTS, 0,
+                            (compressedPoly.size() - 1) * (sizeof(Complex_C_t) + sizeof(double)));
+
+    Poly_Roots_Result_t result;
+    switch (method)
     {
-        if (coeff != 0)
-        {
-            first_nonzero_coeff = coeff;
+        case Poly_Root_Method_t::ABERTH:
+            aberth(compressedPoly, result);
             break;
-        }
+
+        case Poly_Root_Method_t::DURAND_KERNER:
+            durand_kerner(compressedPoly, result);
+            break;
+
+        case Poly_Root_Method_t::COMPANION:
+            companion(compressedPoly, result);
+            break;
+
+        default:
+            throw std::invalid_argument("Unknown root finding method");
     }
 
-    // Create a distribution circle for initial values
-    const double radius = pow( first_nonzero_coeff.absolute() / compressedPoly.at(maxRank).absolute(), (1.0 / maxRank) );
-    const double base_angle = (2 * M_PI) / maxRank;
-    const double offset = M_PI / (2 * maxRank);
+    const Poly_Coeff_t polyVals = getValsCompressedPoly(result.m_roots, compressedPoly);
+    result.m_residuals.resize(polyVals.size());
+    for (size_t i = 0; i < polyVals.size(); i++)
+    {
+        result.m_residuals[i] = polyVals[i].absolute();
+    }
+
+    profile.addIterations(result.m_iterations);
+    profile.setFailed(!result.m_converged);
+    return result;
+}
 
-    // std::cout << "radius: " << radius << ", base angle: " << base_angle << ", offset: " << offset << std::endl;
+/// ------------------------------------------
+std::vector<Poly_factor_t> FactorizePoly(const Poly_Coeff_t& compressedPoly, const Poly_Root_Method_t& method)
+{
+    const Poly_Roots_Result_t result = FindPolyRoots(compressedPoly, method);
 
-    Poly_Coeff_t nextValues(maxRank);
-    for (size_t i = 0; i < nextValues.size(); i++)
+    std::vector< std::pair<double, Complex_C_t> > factors(result.m_roots.size());
+    for(size_t i = 0; i < result.m_roots.size(); i++)
     {
-        nextValues.at(i) = polarToCart({radius, (i * base_angle) + offset});
+        factors[i] = {1, -result.m_roots[i]};
+    }
 
-        // Fixes an issue with very small values breaking some math functions
-        if (fabs(nextValues.at(i).m_real) < SMALLEST_ALLOWED_START_VAL)
-        {
-            nextValues.at(i).m_real = 0.0;
-        }
+    return factors;
+}
 
-        if (fabs(nextValues.at(i).m_imagine) < SMALLEST_ALLOWED_START_VAL)
+/// ------------------------------------------
+std::vector<Poly_Roots_Result_t> FindPolyRootsBatch(const std::vector<Poly_Coeff_t>& polys)
+{
+    if (polys.empty())
+    {
+        return {};
+    }
+
+    const size_t rank = polys[0].size();
+    if (rank < 3)
+    {
+        throw std::invalid_argument("Polynomials below rank 2 have trivial solutions, and also break this algorithm,"
+                                    "might implement rank 1 at some point.");
+    }
+    for (const Poly_Coeff_t& poly : polys)
+    {
+        if (poly.size() != rank)
         {
-            nextValues.at(i).m_imagine = 0.0;
+            throw std::invalid_argument("Batched polynomials must all have the same rank");
         }
     }
 
-    // std::cout << "starting values: " << std::endl;
-    // for(size_t i = 0; i < nextValues.size(); i++)
-    // {
-    //     std::cout << i+1 << ": " << nextValues.at(i) << std::endl;
-    // }
+    Profile_Scope_t profile(Profile_Op_t::POLY_BATCH, 0,
+                            polys.size() * (rank - 1) * (sizeof(Complex_C_t) + sizeof(double)));
 
-    Poly_Coeff_t currentValues = nextValues;
-    size_t iter_count = 0;
-    bool all_converged = false;
-
-    while (iter_count < MAX_DK_ITERATIONS && !all_converged)
+    std::vector<Poly_Roots_Result_t> results(polys.size());
+    const size_t chunks = (polys.size() + POLY_BATCH_CHUNK - 1) / POLY_BATCH_CHUNK;
+    parallel_for(0, chunks, 1, [&](size_t first, size_t last)
     {
-        iter_count++;
-
-        for (size_t i = 0; i < currentValues.size(); i++)
+        for (size_t c = first; c < last; c++)
         {
-            Complex_C_t curVal = currentValues.at(i);
+            const size_t from = c * POLY_BATCH_CHUNK;
+            const size_t len = std::min<size_t>(POLY_BATCH_CHUNK, polys.size() - from);
+            aberth_lanes(polys.data() + from, len, results.data() + from);
 
-            Complex_C_t sub_product = 1.0;
-            for (size_t j = 0; j < currentValues.size(); j++)
+            for (size_t l = from; l < from + len; l++)
             {
-                if (j != i)
+                Poly_Roots_Result_t& result = results[l];
+                result.m_residuals.resize(result.m_roots.size());
+                for (size_t i = 0; i < result.m_roots.size(); i++)
                 {
-                    sub_product *= curVal - currentValues.at(j);
+                    result.m_residuals[i] = getValCompressedPoly(result.m_roots[i], polys[l]).absolute();
                 }
             }
-
-            nextValues.at(i) = curVal - (getValCompressedPoly(curVal, compressedPoly) / sub_product);
-        }
-
-        for (size_t i = 0; i < currentValues.size(); i++)
-        {
-            if (std::abs( currentValues.at(i).absolute() - nextValues.at(i).absolute() ) < MIN_DIFF_CONV_TEST)
-            {
-                all_converged = true;
-            }
-            else
-            {
-                // if any roots fail this test, continue iterations
-                all_converged = false;
-                break;
-            }
         }
+    });
 
-        currentValues = nextValues;
+    // the batch is one call, it fails if any polynomial did not converge
+    bool converged = true;
+    for (const Poly_Roots_Result_t& result : results)
+    {
+        profile.addIterations(result.m_iterations);
+        converged = converged && result.m_converged;
     }
+    profile.setFailed(!converged);
+
+    return results;
+}
 
-    //std::cout << "Completed in " << iter_count << " iterations" << std::endl;
+/// ------------------------------------------
+std::vector<std::vector<Poly_factor_t>> FactorizePolyBatch(const std::vector<Poly_Coeff_t>& polys)
+{
+    const std::vector<Poly_Roots_Result_t> results = FindPolyRootsBatch(polys);
 
-    std::vector< std::pair<double, Complex_C_t> > factors(maxRank);
-    for(size_t i = 0; i < maxRank; i++)
+    std::vector<std::vector<Poly_factor_t>> factors(results.size());
+    for (size_t p = 0; p < results.size(); p++)
     {
-        factors.at(i) = {1, -nextValues.at(i)};
+        factors[p].resize(results[p].m_roots.size());
+        for (size_t i = 0; i < results[p].m_roots.size(); i++)
+        {
+            factors[p][i] = {1, -results[p].m_roots[i]};
+        }
     }
 
     return factors;
-}
\ No newline at end of file
+}
@@ -0,0 +1,253 @@
+/// ------------------------------------------
+/// @file Profile.cpp
+///
+/// @brief Source file for the per thread profiling counters
+///
+/// Each thread owns one block of atomic counters, registered with a process wide list
+/// on its first record. A thread only ever adds to its own block, so the adds never
+/// contend, and a snapshot reads every block without stopping them. Blocks of exiting
+/// threads are folded into a retired total so their counts survive the thread
+/// ------------------------------------------
+
+#include "../inc/Profile.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+    /// @brief Profile_Counter_t as atomics
+    struct Atomic_Counter_t
+    {
+        std::atomic<uint64_t> m_calls{0};
+        std::atomic<uint64_t> m_total_ns{0};
+        std::atomic<uint64_t> m_peak_ns{0};
+        std::atomic<uint64_t> m_flops{0};
+        std::atomic<uint64_t> m_bytes{0};
+        std::atomic<uint64_t> m_iterations{0};
+        std::atomic<uint64_t> m_failures{0};
+
+        ///--------------------------------------------------------
+        /// @brief Adds the current values to out
+        void addTo(Profile_Counter_t& out) const
+        {
+            out.m_calls += m_calls.load(std::memory_order_relaxed);
+            out.m_total_ns += m_total_ns.load(std::memory_order_relaxed);
+            out.m_peak_ns = std::max(out.m_peak_ns, m_peak_ns.load(std::memory_order_relaxed));
+            out.m_flops += m_flops.load(std::memory_order_relaxed);
+            out.m_bytes += m_bytes.load(std::memory_order_relaxed);
+            out.m_iterations += m_iterations.load(std::memory_order_relaxed);
+            out.m_failures += m_failures.load(std::memory_order_relaxed);
+        }
+
+        ///--------------------------------------------------------
+        void clear()
+        {
+            for (std::atomic<uint64_t>* field : {&m_calls, &m_total_ns, &m_peak_ns, &m_flops,
+                                                 &m_bytes, &m_iterations, &m_failures})
+            {
+                field->store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /// @brief Counters of one thread
+    typedef std::array<Atomic_Counter_t, (size_t) Profile_Op_t::COUNT> Thread_Counters_t;
+
+    /// @brief Every live thread's counters plus the totals of exited threads
+    struct Profile_Registry_t
+    {
+        std::mutex m_mutex;
+        std::vector<Thread_Counters_t*> m_live;
+        Profile_Snapshot_t m_retired{};
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Adds every counter of src to out
+    void accumulate(const Thread_Counters_t& src, Profile_Snapshot_t& out)
+    {
+        for (size_t op = 0; op < src.size(); op++)
+        {
+            src[op].addTo(out[op]);
+        }
+    }
+
+    /// @brief Writes the totals to the PROFILE_JSON_ENV file at exit
+    struct Profile_Exit_Dump_t
+    {
+        ~Profile_Exit_Dump_t()
+        {
+            const char* path = std::getenv(PROFILE_JSON_ENV);
+            if (path != nullptr && *path != '\0')
+            {
+                std::ofstream file(path);
+                profile_write_json(file, profile_snapshot());
+            }
+        }
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Returns the process wide registry
+    /// Never destroyed, pool threads may still retire their counters during static destruction
+    Profile_Registry_t& registry()
+    {
+        static Profile_Registry_t* reg = new Profile_Registry_t();
+        static Profile_Exit_Dump_t dump;
+        return *reg;
+    }
+
+    /// @brief Registers the owning thread's counters for its lifetime
+    struct Thread_Holder_t
+    {
+        Thread_Counters_t m_counters;
+
+        Thread_Holder_t()
+        {
+            Profile_Registry_t& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.m_mutex);
+            reg.m_live.push_back(&m_counters);
+        }
+
+        ~Thread_Holder_t()
+        {
+            Profile_Registry_t& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.m_mutex);
+            accumulate(m_counters, reg.m_retired);
+            reg.m_live.erase(std::find(reg.m_live.begin(), reg.m_live.end(), &m_counters));
+        }
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Returns the calling thread's counters
+    Thread_Counters_t& local()
+    {
+        thread_local Thread_Holder_t holder;
+        return holder.m_counters;
+    }
+}
+
+///--------------------------------------------------------
+bool profile_enabled()
+{
+#ifdef MATRIX_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+///--------------------------------------------------------
+const char* profile_op_name(const Profile_Op_t& op)
+{
+    switch (op)
+    {
+        case Profile_Op_t::PRODUCT:    return "product";
+        case Profile_Op_t::LU:         return "lu";
+        case Profile_Op_t::QR:         return "qr";
+        case Profile_Op_t::CHOLESKY:   return "cholesky";
+        case Profile_Op_t::RREF:       return "rref";
+        case Profile_Op_t::EIGEN:      return "eigen";
+        case Profile_Op_t::POLY_ROOTS: return "poly_roots";
+        case Profile_Op_t::POLY_BATCH: return "poly_batch";
+        default:                       return "unknown";
+    }
+}
+
+///--------------------------------------------------------
+void profile_record(const Profile_Op_t& op, const uint64_t& ns, const uint64_t& flops, const uint64_t& bytes,
+                    const uint64_t& iterations, const bool& failed)
+{
+    Atomic_Counter_t& counter = local()[(size_t) op];
+
+    counter.m_calls.fetch_add(1, std::memory_order_relaxed);
+    counter.m_total_ns.fetch_add(ns, std::memory_order_relaxed);
+    counter.m_flops.fetch_add(flops, std::memory_order_relaxed);
+    counter.m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    counter.m_iterations.fetch_add(iterations, std::memory_order_relaxed);
+    counter.m_failures.fetch_add(failed ? 1 : 0, std::memory_order_relaxed);
+
+    // only a reset from another thread can race this, so the loop almost never repeats
+    uint64_t peak = counter.m_peak_ns.load(std::memory_order_relaxed);
+    while (ns > peak && !counter.m_peak_ns.compare_exchange_weak(peak, ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+///--------------------------------------------------------
+Profile_Snapshot_t profile_snapshot()
+{
+    Profile_Registry_t& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.m_mutex);
+
+    Profile_Snapshot_t out = reg.m_retired;
+    for (const Thread_Counters_t* counters : reg.m_live)
+    {
+        accumulate(*counters, out);
+    }
+    return out;
+}
+
+///--------------------------------------------------------
+Profile_Snapshot_t profile_thread_snapshot()
+{
+    Profile_Snapshot_t out{};
+    accumulate(local(), out);
+    return out;
+}
+
+///--------------------------------------------------------
+void profile_reset()
+{
+    Profile_Registry_t& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.m_mutex);
+
+    reg.m_retired = Profile_Snapshot_t{};
+    for (Thread_Counters_t* counters : reg.m_live)
+    {
+        // the owning threads keep adding, the counters themselves are atomic
+        for (Atomic_Counter_t& counter : *counters)
+        {
+            counter.clear();
+        }
+    }
+}
+
+///--------------------------------------------------------
+void profile_write_json(std::ostream& os, const Profile_Snapshot_t& snapshot)
+{
+    os << "{";
+    bool first = true;
+    for (size_t op = 0; op < snapshot.size(); op++)
+    {
+        const Profile_Counter_t& c = snapshot[op];
+        if (c.m_calls == 0)
+        {
+            continue;
+        }
+
+        os << (first ? "\n" : ",\n") << "  \"" << profile_op_name((Profile_Op_t) op) << "\": {"
+           << "\"calls\": " << c.m_calls
+           << ", \"total_ns\": " << c.m_total_ns
+           << ", \"peak_ns\": " << c.m_peak_ns
+           << ", \"flops\": " << c.m_flops
+           << ", \"bytes\": " << c.m_bytes
+           << ", \"iterations\": " << c.m_iterations
+           << ", \"failures\": " << c.m_failures << "}";
+        first = false;
+    }
+    os << (first ? "}" : "\n}") << "\n";
+}
+
+///--------------------------------------------------------
+std::string profile_json()
+{
+    std::ostringstream os;
+    profile_write_json(os, profile_snapshot());
+    return os.str();
+}
@@ -0,0 +1,388 @@
+/// ------------------------------------------
+/// @file Storage.cpp
+///
+/// @brief Source file for the aligned buffer pool and scoped arenas
+/// ------------------------------------------
+
+#include "../inc/Storage.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+/// @brief Comes before every payload, records where the buffer has to go back to
+struct alignas(STORAGE_ALIGNMENT) Storage_Header_t
+{
+    /// @brief size class index, c_unpooled for buffers that bypass the free lists
+    size_t m_class;
+
+    /// @brief arena chunk the buffer was carved from, nullptr if it came from the heap
+    Storage_Chunk_t* m_chunk;
+};
+
+/// @brief Block of memory an arena carves buffers out of, starts with this header
+struct alignas(STORAGE_ALIGNMENT) Storage_Chunk_t
+{
+    /// @brief buffers still carved out of the chunk, plus one while its arena holds it
+    std::atomic<size_t> m_refs;
+
+    /// @brief arena the chunk belongs to, only compared against, never dereferenced
+    const Storage_Arena_t* m_arena;
+};
+
+namespace
+{
+    constexpr size_t c_align = STORAGE_ALIGNMENT;
+    constexpr size_t c_header = sizeof(Storage_Header_t);
+    constexpr size_t c_unpooled = std::numeric_limits<size_t>::max();
+
+    // classes step by c_align up to c_small_classes * c_align, then by quarters of each power of two
+    constexpr size_t c_small_classes = 16;
+    constexpr size_t c_class_count = c_small_classes + 4 * 64;
+
+    ///--------------------------------------------------------
+    /// @brief log2 of the largest small class
+    constexpr size_t small_log()
+    {
+        size_t log = 0;
+        while ((size_t(1) << log) < c_small_classes * c_align)
+        {
+            log++;
+        }
+        return log;
+    }
+
+    constexpr size_t c_small_log = small_log();
+
+    static_assert((c_align & (c_align - 1)) == 0, "STORAGE_ALIGNMENT must be a power of two");
+    static_assert(c_header % c_align == 0, "Storage header must keep the payload aligned");
+
+    std::atomic<Storage_Policy_t> g_policy{Storage_Policy_t::POOL};
+
+    thread_local Storage_Arena_t* t_arena = nullptr;
+
+    ///--------------------------------------------------------
+    /// @brief Finds the size class of a request
+    ///
+    /// @param bytes requested size
+    /// @param classBytes set to the payload size of the class
+    ///
+    /// @return class index
+    size_t size_class(size_t bytes, size_t& classBytes)
+    {
+        if (bytes <= c_small_classes * c_align)
+        {
+            const size_t idx = (bytes == 0) ? 0 : (bytes - 1) / c_align;
+            classBytes = (idx + 1) * c_align;
+            return idx;
+        }
+
+        // 2^e < bytes <= 2^(e+1), split into four steps of 2^(e-2)
+        size_t e = c_small_log;
+        while ((size_t(2) << e) < bytes)
+        {
+            e++;
+        }
+
+        const size_t base = size_t(1) << e;
+        const size_t step = base / 4;
+        const size_t k = (bytes - base + step - 1) / step;
+        classBytes = base + k * step;
+        return c_small_classes + (e - c_small_log) * 4 + (k - 1);
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Aligned heap allocation, bytes must be a multiple of c_align
+    void* heap_allocate(size_t bytes)
+    {
+#ifdef _WIN32
+        void* ptr = _aligned_malloc(bytes, c_align);
+#else
+        void* ptr = std::aligned_alloc(c_align, bytes);
+#endif
+        if (ptr == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Frees memory from heap_allocate
+    void heap_release(void* ptr)
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Drops a reference to a chunk, freeing it with the last one
+    void chunk_unref(Storage_Chunk_t* chunk)
+    {
+        if (chunk->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            chunk->~Storage_Chunk_t();
+            heap_release(chunk);
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Makes a chunk of the given size owned by arena, holding refs references
+    Storage_Chunk_t* chunk_create(size_t bytes, const Storage_Arena_t* arena, size_t refs)
+    {
+        Storage_Chunk_t* chunk = new (heap_allocate(bytes)) Storage_Chunk_t;
+        chunk->m_refs.store(refs, std::memory_order_relaxed);
+        chunk->m_arena = arena;
+        return chunk;
+    }
+
+    /// @brief Lifetime of a thread's free lists, readable even after they are destroyed
+    enum class Pool_State_t : unsigned char
+    {
+        UNUSED,
+        LIVE,
+        DEAD
+    };
+
+    thread_local Pool_State_t t_pool_state = Pool_State_t::UNUSED;
+
+    /// @brief Released heap buffers of the calling thread, by size class
+    struct Storage_Pool_t
+    {
+        std::vector<void*> m_free[c_class_count];
+
+        Storage_Pool_t()
+        {
+            t_pool_state = Pool_State_t::LIVE;
+        }
+
+        ~Storage_Pool_t()
+        {
+            trim();
+            t_pool_state = Pool_State_t::DEAD;
+        }
+
+        void trim()
+        {
+            for (std::vector<void*>& list : m_free)
+            {
+                for (void* header : list)
+                {
+                    heap_release(header);
+                }
+                list.clear();
+            }
+        }
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Returns the calling thread's free lists
+    ///
+    /// @return free lists, nullptr once the thread has started tearing down
+    Storage_Pool_t* pool()
+    {
+        if (t_pool_state == Pool_State_t::DEAD)
+        {
+            return nullptr;
+        }
+
+        thread_local Storage_Pool_t t_pool;
+        return &t_pool;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Writes the header in front of a payload and returns the payload
+    void* stamp(void* header, size_t cls, Storage_Chunk_t* chunk)
+    {
+        Storage_Header_t* head = new (header) Storage_Header_t;
+        head->m_class = cls;
+        head->m_chunk = chunk;
+        return static_cast<char*>(header) + c_header;
+    }
+}
+
+///--------------------------------------------------------
+void* storage_allocate(const size_t& bytes)
+{
+    size_t classBytes = 0;
+    const size_t cls = size_class(bytes, classBytes);
+
+    if (Storage_Arena_t* arena = t_arena)
+    {
+        if (cls < arena->m_free.size() && !arena->m_free[cls].empty())
+        {
+            void* ptr = arena->m_free[cls].back();
+            arena->m_free[cls].pop_back();
+            return ptr;
+        }
+        return arena->_carve(cls, classBytes);
+    }
+
+    if (classBytes > STORAGE_POOL_MAX_BLOCK)
+    {
+        // too big to be worth keeping, skip the rounding up as well
+        const size_t exact = (bytes + c_align - 1) / c_align * c_align;
+        return stamp(heap_allocate(c_header + exact), c_unpooled, nullptr);
+    }
+
+    if (Storage_Pool_t* threadPool = pool())
+    {
+        std::vector<void*>& list = threadPool->m_free[cls];
+        if (!list.empty())
+        {
+            void* header = list.back();
+            list.pop_back();
+            return static_cast<char*>(header) + c_header;
+        }
+    }
+
+    return stamp(heap_allocate(c_header + classBytes), cls, nullptr);
+}
+
+///--------------------------------------------------------
+void storage_release(void* ptr) noexcept
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    void* header = static_cast<char*>(ptr) - c_header;
+    Storage_Header_t* head = static_cast<Storage_Header_t*>(header);
+
+    if (Storage_Chunk_t* chunk = head->m_chunk)
+    {
+        // back onto the owning arena's free list if it is the one serving this thread
+        Storage_Arena_t* arena = t_arena;
+        if (arena != nullptr && chunk->m_arena == arena)
+        {
+            try
+            {
+                if (arena->m_free.size() <= head->m_class)
+                {
+                    arena->m_free.resize(head->m_class + 1);
+                }
+                arena->m_free[head->m_class].push_back(ptr);
+                return;
+            }
+            catch (...)
+            {
+                // out of memory growing the list, just let the buffer go
+            }
+        }
+
+        chunk_unref(chunk);
+        return;
+    }
+
+    if (head->m_class != c_unpooled && g_policy.load(std::memory_order_relaxed) == Storage_Policy_t::POOL)
+    {
+        if (Storage_Pool_t* threadPool = pool())
+        {
+            std::vector<void*>& list = threadPool->m_free[head->m_class];
+            if (list.size() < STORAGE_POOL_DEPTH)
+            {
+                try
+                {
+                    list.push_back(header);
+                    return;
+                }
+                catch (...)
+                {
+                }
+            }
+        }
+    }
+
+    heap_release(header);
+}
+
+///--------------------------------------------------------
+void storage_set_policy(const Storage_Policy_t& policy)
+{
+    g_policy.store(policy, std::memory_order_relaxed);
+}
+
+///--------------------------------------------------------
+Storage_Policy_t storage_policy()
+{
+    return g_policy.load(std::memory_order_relaxed);
+}
+
+///--------------------------------------------------------
+void storage_trim()
+{
+    if (Storage_Pool_t* threadPool = pool())
+    {
+        threadPool->trim();
+    }
+}
+
+///--------------------------------------------------------
+Storage_Arena_t::Storage_Arena_t() : m_prev(t_arena)
+{
+    t_arena = this;
+}
+
+///--------------------------------------------------------
+Storage_Arena_t::~Storage_Arena_t()
+{
+    t_arena = m_prev;
+
+    // buffers sitting in the free lists are no longer wanted
+    for (std::vector<void*>& list : m_free)
+    {
+        for (void* ptr : list)
+        {
+            Storage_Header_t* head = reinterpret_cast<Storage_Header_t*>(static_cast<char*>(ptr) - c_header);
+            chunk_unref(head->m_chunk);
+        }
+    }
+
+    if (m_chunk != nullptr)
+    {
+        chunk_unref(m_chunk);
+    }
+}
+
+///--------------------------------------------------------
+Storage_Arena_t* Storage_Arena_t::current()
+{
+    return t_arena;
+}
+
+///--------------------------------------------------------
+void* Storage_Arena_t::_carve(const size_t& cls, const size_t& bytes)
+{
+    const size_t need = c_header + bytes;
+    constexpr size_t chunkHead = sizeof(Storage_Chunk_t);
+
+    // large buffers get a chunk of their own, only the buffer holds it
+    if (need > STORAGE_ARENA_CHUNK / 4)
+    {
+        Storage_Chunk_t* own = chunk_create(chunkHead + need, this, 1);
+        m_reserved += chunkHead + need;
+        return stamp(reinterpret_cast<char*>(own) + chunkHead, cls, own);
+    }
+
+    if (m_chunk == nullptr || m_used + need > STORAGE_ARENA_CHUNK)
+    {
+        Storage_Chunk_t* fresh = chunk_create(STORAGE_ARENA_CHUNK, this, 1);
+        m_reserved += STORAGE_ARENA_CHUNK;
+        if (m_chunk != nullptr)
+        {
+            chunk_unref(m_chunk);
+        }
+        m_chunk = fresh;
+        m_used = chunkHead;
+    }
+
+    void* header = reinterpret_cast<char*>(m_chunk) + m_used;
+    m_used += need;
+    m_chunk->m_refs.fetch_add(1, std::memory_order_relaxed);
+    return stamp(header, cls, m_chunk);
+}
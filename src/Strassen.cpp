@@ -0,0 +1,38 @@
+/// ------------------------------------------
+/// @file Strassen.cpp
+///
+/// @brief Source file for the Strassen-Winograd on/off switch
+/// ------------------------------------------
+
+#include "../inc/Strassen.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    ///--------------------------------------------------------
+    /// @brief Fast multiply switch, initialized from STRASSEN_ENABLE_ENV on first use
+    std::atomic<bool>& enabled_flag()
+    {
+        static std::atomic<bool> flag([]
+        {
+            const char* env = std::getenv(STRASSEN_ENABLE_ENV);
+            return env == nullptr || std::strcmp(env, "0") != 0;
+        }());
+        return flag;
+    }
+}
+
+///--------------------------------------------------------
+void strassen_set_enabled(const bool& enabled)
+{
+    enabled_flag().store(enabled, std::memory_order_relaxed);
+}
+
+///--------------------------------------------------------
+bool strassen_enabled()
+{
+    return enabled_flag().load(std::memory_order_relaxed);
+}
@@ -0,0 +1,219 @@
+/// ------------------------------------------
+/// @file Thread_Pool.cpp
+///
+/// @brief Source file for the shared thread pool
+/// ------------------------------------------
+
+#include "../inc/Thread_Pool.h"
+
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <cstdlib>
+
+namespace
+{
+    /// @brief State shared by every thread working on one parallel_for call
+    struct Parallel_Job_t
+    {
+        const std::function<void(size_t, size_t)>* m_body;
+        size_t m_begin;
+        size_t m_end;
+        size_t m_chunk;
+        size_t m_chunkCount;
+
+        /// @brief next chunk to claim
+        std::atomic<size_t> m_next{0};
+
+        /// @brief chunks finished, guarded by m_mutex
+        size_t m_done = 0;
+
+        /// @brief first exception thrown by body, guarded by m_mutex
+        std::exception_ptr m_error;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+
+        ///--------------------------------------------------------
+        /// @brief Claims and runs chunks until none are left
+        /// Stale helpers that arrive after the job finished claim nothing and never touch body
+        void run()
+        {
+            for (size_t idx = m_next++; idx < m_chunkCount; idx = m_next++)
+            {
+                const size_t from = m_begin + idx * m_chunk;
+                const size_t to = std::min(m_end, from + m_chunk);
+
+                std::exception_ptr error;
+                try
+                {
+                    (*m_body)(from, to);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (error && !m_error)
+                {
+                    m_error = error;
+                }
+                if (++m_done == m_chunkCount)
+                {
+                    m_cv.notify_all();
+                }
+            }
+        }
+    };
+}
+
+///--------------------------------------------------------
+Thread_Pool& Thread_Pool::instance()
+{
+    static Thread_Pool pool;
+    return pool;
+}
+
+///--------------------------------------------------------
+Thread_Pool::Thread_Pool()
+{
+    size_t count = 0;
+    if (const char* env = std::getenv(PARALLEL_THREADS_ENV))
+    {
+        count = std::strtoul(env, nullptr, 10);
+    }
+
+    setThreadCount(count);
+}
+
+///--------------------------------------------------------
+Thread_Pool::~Thread_Pool()
+{
+    _stop();
+}
+
+///--------------------------------------------------------
+void Thread_Pool::setThreadCount(size_t count)
+{
+    if (count == 0)
+    {
+        count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    _stop();
+    _start(count);
+}
+
+///--------------------------------------------------------
+size_t Thread_Pool::getThreadCount() const
+{
+    return m_workers.size() + 1;
+}
+
+///--------------------------------------------------------
+void Thread_Pool::parallel_for(const size_t& begin, const size_t& end, const size_t& grain,
+                               const std::function<void(size_t, size_t)>& body)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    const size_t range = end - begin;
+    const size_t minChunk = std::max<size_t>(1, grain);
+    const size_t maxChunks = getThreadCount() * PARALLEL_CHUNKS_PER_THREAD;
+    const size_t chunkCount = std::min((range + minChunk - 1) / minChunk, maxChunks);
+
+    if (chunkCount <= 1 || m_workers.empty())
+    {
+        body(begin, end);
+        return;
+    }
+
+    auto job = std::make_shared<Parallel_Job_t>();
+    job->m_body = &body;
+    job->m_begin = begin;
+    job->m_end = end;
+    job->m_chunk = (range + chunkCount - 1) / chunkCount;
+    job->m_chunkCount = (range + job->m_chunk - 1) / job->m_chunk;
+
+    // one helper per worker that can be useful, the caller takes a share as well
+    const size_t helpers = std::min(m_workers.size(), job->m_chunkCount - 1);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < helpers; i++)
+        {
+            m_tasks.emplace_back([job]() { job->run(); });
+        }
+    }
+    if (helpers == 1)
+    {
+        m_cv.notify_one();
+    }
+    else
+    {
+        m_cv.notify_all();
+    }
+
+    job->run();
+
+    // only chunks already being run by other threads are left, so this cannot deadlock
+    std::unique_lock<std::mutex> lock(job->m_mutex);
+    job->m_cv.wait(lock, [&job]() { return job->m_done == job->m_chunkCount; });
+
+    if (job->m_error)
+    {
+        std::rethrow_exception(job->m_error);
+    }
+}
+
+///--------------------------------------------------------
+void Thread_Pool::_worker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+            if (m_stopping && m_tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+///--------------------------------------------------------
+void Thread_Pool::_start(const size_t& count)
+{
+    m_stopping = false;
+    for (size_t i = 1; i < count; i++)
+    {
+        m_workers.emplace_back(&Thread_Pool::_worker, this);
+    }
+}
+
+///--------------------------------------------------------
+void Thread_Pool::_stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    m_workers.clear();
+}
@@ -0,0 +1,223 @@
+/// ------------------------------------------
+/// @file Transpose.cpp
+///
+/// @brief Source file for the in register transpose kernels and their run time dispatch
+/// ------------------------------------------
+
+#include "../inc/Transpose.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TRANSPOSE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define TRANSPOSE_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    /// @brief Transposes a block of contiguous rows one element at a time
+    template <typename T>
+    void generic_block(size_t rows, size_t cols, const T* src, size_t lds, T* dst, size_t ldd)
+    {
+        for (size_t j = 0; j < cols; j++)
+        {
+            for (size_t i = 0; i < rows; i++)
+            {
+                dst[j * ldd + i] = src[i * lds + j];
+            }
+        }
+    }
+
+    /// @brief Transposes the ragged right and bottom edges left over by a micro tile of mr x nr
+    template <typename T>
+    void edges(size_t rows, size_t cols, size_t mr, size_t nr, const T* src, size_t lds, T* dst, size_t ldd)
+    {
+        const size_t rowsMain = rows - rows % mr;
+        const size_t colsMain = cols - cols % nr;
+
+        // right strip of the tiled rows, then every column of the leftover rows
+        generic_block(rowsMain, cols - colsMain, src + colsMain, lds, dst + colsMain * ldd, ldd);
+        generic_block(rows - rowsMain, cols, src + rowsMain * lds, lds, dst + rowsMain, ldd);
+    }
+
+#ifdef TRANSPOSE_KERNELS_X86
+    // ------------------------------------------ AVX
+
+    __attribute__((target("avx")))
+    void avx_block_double(size_t rows, size_t cols, const double* src, size_t lds, double* dst, size_t ldd)
+    {
+        for (size_t i = 0; i + 4 <= rows; i += 4)
+        {
+            for (size_t j = 0; j + 4 <= cols; j += 4)
+            {
+                const double* s = src + i * lds + j;
+                const __m256d r0 = _mm256_loadu_pd(s);
+                const __m256d r1 = _mm256_loadu_pd(s + lds);
+                const __m256d r2 = _mm256_loadu_pd(s + 2 * lds);
+                const __m256d r3 = _mm256_loadu_pd(s + 3 * lds);
+
+                // pairs within each 128 bit lane, then swap the lanes across
+                const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+                const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+                const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+                const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+                double* d = dst + j * ldd + i;
+                _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+                _mm256_storeu_pd(d + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+                _mm256_storeu_pd(d + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+                _mm256_storeu_pd(d + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+            }
+        }
+
+        edges(rows, cols, 4, 4, src, lds, dst, ldd);
+    }
+
+    __attribute__((target("avx")))
+    void avx_block_float(size_t rows, size_t cols, const float* src, size_t lds, float* dst, size_t ldd)
+    {
+        for (size_t i = 0; i + 8 <= rows; i += 8)
+        {
+            for (size_t j = 0; j + 8 <= cols; j += 8)
+            {
+                const float* s = src + i * lds + j;
+                __m256 r[8];
+                for (size_t k = 0; k < 8; k++)
+                {
+                    r[k] = _mm256_loadu_ps(s + k * lds);
+                }
+
+                const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+                const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+                const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+                const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+                const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+                const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+                const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+                const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+                const __m256 u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+                const __m256 u1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+                const __m256 u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+                const __m256 u3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+                const __m256 u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+                const __m256 u5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+                const __m256 u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+                const __m256 u7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+                float* d = dst + j * ldd + i;
+                _mm256_storeu_ps(d, _mm256_permute2f128_ps(u0, u4, 0x20));
+                _mm256_storeu_ps(d + ldd, _mm256_permute2f128_ps(u1, u5, 0x20));
+                _mm256_storeu_ps(d + 2 * ldd, _mm256_permute2f128_ps(u2, u6, 0x20));
+                _mm256_storeu_ps(d + 3 * ldd, _mm256_permute2f128_ps(u3, u7, 0x20));
+                _mm256_storeu_ps(d + 4 * ldd, _mm256_permute2f128_ps(u0, u4, 0x31));
+                _mm256_storeu_ps(d + 5 * ldd, _mm256_permute2f128_ps(u1, u5, 0x31));
+                _mm256_storeu_ps(d + 6 * ldd, _mm256_permute2f128_ps(u2, u6, 0x31));
+                _mm256_storeu_ps(d + 7 * ldd, _mm256_permute2f128_ps(u3, u7, 0x31));
+            }
+        }
+
+        edges(rows, cols, 8, 8, src, lds, dst, ldd);
+    }
+#endif
+
+#ifdef TRANSPOSE_KERNELS_NEON
+    // ------------------------------------------ NEON
+
+    void neon_block_double(size_t rows, size_t cols, const double* src, size_t lds, double* dst, size_t ldd)
+    {
+        for (size_t i = 0; i + 2 <= rows; i += 2)
+        {
+            for (size_t j = 0; j + 2 <= cols; j += 2)
+            {
+                const double* s = src + i * lds + j;
+                const float64x2_t r0 = vld1q_f64(s);
+                const float64x2_t r1 = vld1q_f64(s + lds);
+
+                double* d = dst + j * ldd + i;
+                vst1q_f64(d, vzip1q_f64(r0, r1));
+                vst1q_f64(d + ldd, vzip2q_f64(r0, r1));
+            }
+        }
+
+        edges(rows, cols, 2, 2, src, lds, dst, ldd);
+    }
+
+    void neon_block_float(size_t rows, size_t cols, const float* src, size_t lds, float* dst, size_t ldd)
+    {
+        for (size_t i = 0; i + 4 <= rows; i += 4)
+        {
+            for (size_t j = 0; j + 4 <= cols; j += 4)
+            {
+                const float* s = src + i * lds + j;
+                const float32x4_t r0 = vld1q_f32(s);
+                const float32x4_t r1 = vld1q_f32(s + lds);
+                const float32x4_t r2 = vld1q_f32(s + 2 * lds);
+                const float32x4_t r3 = vld1q_f32(s + 3 * lds);
+
+                // 2x2 blocks of pairs, then 2x2 blocks of 64 bit halves
+                const float32x4_t t0 = vtrn1q_f32(r0, r1);
+                const float32x4_t t1 = vtrn2q_f32(r0, r1);
+                const float32x4_t t2 = vtrn1q_f32(r2, r3);
+                const float32x4_t t3 = vtrn2q_f32(r2, r3);
+
+                float* d = dst + j * ldd + i;
+                vst1q_f32(d, vreinterpretq_f32_f64(vzip1q_f64(vreinterpretq_f64_f32(t0), vreinterpretq_f64_f32(t2))));
+                vst1q_f32(d + ldd, vreinterpretq_f32_f64(vzip1q_f64(vreinterpretq_f64_f32(t1), vreinterpretq_f64_f32(t3))));
+                vst1q_f32(d + 2 * ldd, vreinterpretq_f32_f64(vzip2q_f64(vreinterpretq_f64_f32(t0), vreinterpretq_f64_f32(t2))));
+                vst1q_f32(d + 3 * ldd, vreinterpretq_f32_f64(vzip2q_f64(vreinterpretq_f64_f32(t1), vreinterpretq_f64_f32(t3))));
+            }
+        }
+
+        edges(rows, cols, 4, 4, src, lds, dst, ldd);
+    }
+#endif
+
+    /// @brief Kernels for the widest instruction set the CPU supports
+    struct Transpose_Dispatch_t
+    {
+        void (*m_double)(size_t, size_t, const double*, size_t, double*, size_t) = generic_block<double>;
+        void (*m_float)(size_t, size_t, const float*, size_t, float*, size_t) = generic_block<float>;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, picks the kernels once
+        Transpose_Dispatch_t()
+        {
+#if defined(TRANSPOSE_KERNELS_X86)
+            if (__builtin_cpu_supports("avx"))
+            {
+                m_double = avx_block_double;
+                m_float = avx_block_float;
+            }
+#elif defined(TRANSPOSE_KERNELS_NEON)
+            m_double = neon_block_double;
+            m_float = neon_block_float;
+#endif
+        }
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Returns the dispatch state, selected on first use
+    const Transpose_Dispatch_t& dispatch()
+    {
+        static const Transpose_Dispatch_t state;
+        return state;
+    }
+}
+
+///--------------------------------------------------------
+void transpose_block(const size_t& rows, const size_t& cols, const double* src, const size_t& lds,
+                     double* dst, const size_t& ldd)
+{
+    dispatch().m_double(rows, cols, src, lds, dst, ldd);
+}
+
+///--------------------------------------------------------
+void transpose_block(const size_t& rows, const size_t& cols, const float* src, const size_t& lds,
+                     float* dst, const size_t& ldd)
+{
+    dispatch().m_float(rows, cols, src, lds, dst, ldd);
+}
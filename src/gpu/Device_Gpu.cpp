@@ -0,0 +1,380 @@
+/// ------------------------------------------
+/// @file Device_Gpu.cpp
+///
+/// @brief Source file for the CUDA/HIP backend behind Device.h
+///
+/// The vendor libraries are column major, a row major (m,n) buffer is read by them as
+/// its (n,m) transpose. Products are therefore issued as C^T = B^T A^T, and the LU is
+/// taken of A^T: its determinant is A's, and solving A^T X = I leaves X = A^-T in
+/// column major order, which read back row major is A^-1
+///
+/// Every thread gets its own stream and library handles, created on first use
+/// ------------------------------------------
+
+#include "../../inc/Device.h"
+#include "Gpu_Runtime.h"
+
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <vector>
+
+namespace
+{
+    ///--------------------------------------------------------
+    /// @throws std::runtime_error naming the call if err is not success
+    void check(const gpuError_t& err, const char* call)
+    {
+        if (err != gpuSuccess)
+        {
+            throw std::runtime_error(std::string(call) + " failed: " + gpuGetErrorString(err));
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @throws std::runtime_error naming the call if status is not success
+    void check_blas(const gpublasStatus_t& status, const char* call)
+    {
+        if (status != GPUBLAS_STATUS_SUCCESS)
+        {
+            throw std::runtime_error(std::string(call) + " failed with status " + std::to_string((int) status));
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @throws std::runtime_error naming the call if status is not success
+    void check_solver(const gpusolverStatus_t& status, const char* call)
+    {
+        if (status != GPUSOLVER_STATUS_SUCCESS)
+        {
+            throw std::runtime_error(std::string(call) + " failed with status " + std::to_string((int) status));
+        }
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Narrows a dimension to the int the libraries take
+    ///
+    /// @throws std::runtime_error if it does not fit
+    int to_int(const size_t& val)
+    {
+        if (val > (size_t) INT_MAX)
+        {
+            throw std::runtime_error("Matrix dimension too large for the GPU libraries");
+        }
+        return (int) val;
+    }
+
+    /// @brief Stream and library handles of one thread
+    struct Device_Context_t
+    {
+        gpuStream_t m_stream = nullptr;
+        gpublasHandle_t m_blas = nullptr;
+        gpusolverHandle_t m_solver = nullptr;
+
+        Device_Context_t()
+        {
+            check(gpuStreamCreateWithFlags(&m_stream, gpuStreamNonBlocking), "stream create");
+            check_blas(gpublasCreate(&m_blas), "blas create");
+            check_blas(gpublasSetStream(m_blas, m_stream), "blas set stream");
+            check_solver(gpusolverCreate(&m_solver), "solver create");
+            check_solver(gpusolverSetStream(m_solver, m_stream), "solver set stream");
+        }
+
+        ~Device_Context_t()
+        {
+            // errors are ignored, the runtime may already be shutting down at thread exit
+            if (m_solver != nullptr)
+            {
+                gpusolverDestroy(m_solver);
+            }
+            if (m_blas != nullptr)
+            {
+                gpublasDestroy(m_blas);
+            }
+            if (m_stream != nullptr)
+            {
+                gpuStreamDestroy(m_stream);
+            }
+        }
+
+        Device_Context_t(const Device_Context_t&) = delete;
+        Device_Context_t& operator=(const Device_Context_t&) = delete;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Returns the calling thread's context
+    Device_Context_t& context()
+    {
+        thread_local Device_Context_t ctx;
+        return ctx;
+    }
+
+    /// @brief Scratch device buffer released on scope exit
+    template <typename T>
+    struct Device_Buffer_t
+    {
+        T* m_ptr;
+
+        explicit Device_Buffer_t(const size_t& count)
+            : m_ptr(static_cast<T*>(device_allocate(std::max<size_t>(count, 1) * sizeof(T))))
+        {
+        }
+
+        ~Device_Buffer_t()
+        {
+            device_release(m_ptr);
+        }
+
+        Device_Buffer_t(const Device_Buffer_t&) = delete;
+        Device_Buffer_t& operator=(const Device_Buffer_t&) = delete;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief LU factorizes the (column major) n x n matrix at a in place
+    ///
+    /// @param pivots device buffer of n pivots, 1 based
+    ///
+    /// @return info, > 0 if U has an exactly zero diagonal
+    template <typename T>
+    int getrf(const size_t& n, T* a, int* pivots)
+    {
+        Device_Context_t& ctx = context();
+        const int len = to_int(n);
+
+        int lwork = 0;
+        check_solver(gpu_getrf_buffer(ctx.m_solver, len, len, a, len, &lwork), "getrf buffer size");
+
+        Device_Buffer_t<T> work(lwork);
+        Device_Buffer_t<int> info(1);
+        check_solver(gpu_getrf(ctx.m_solver, len, len, a, len, work.m_ptr, pivots, info.m_ptr), "getrf");
+
+        int hostInfo = 0;
+        device_download(&hostInfo, info.m_ptr, sizeof(int), false);
+        return hostInfo;
+    }
+
+    ///--------------------------------------------------------
+    template <typename T>
+    void gemm(const size_t& m, const size_t& n, const size_t& k, const T* a, const T* b, T* c)
+    {
+        const T one = 1;
+        const T zero = 0;
+        check_blas(gpu_gemm(context().m_blas, to_int(n), to_int(m), to_int(k),
+                            &one, b, to_int(n), a, to_int(k), &zero, c, to_int(n)), "gemm");
+    }
+
+    ///--------------------------------------------------------
+    template <typename T>
+    void axpby(const size_t& count, const T& alpha, const T* a, const T& beta, const T* b, T* c)
+    {
+        // one column of count elements, geam allows c to alias a or b at the same leading dimension
+        const int len = to_int(count);
+        check_blas(gpu_geam(context().m_blas, len, 1, &alpha, a, len, &beta, b, len, c, len), "geam");
+    }
+
+    ///--------------------------------------------------------
+    template <typename T>
+    bool inverse(const size_t& n, T* a, T* inv)
+    {
+        Device_Context_t& ctx = context();
+        Device_Buffer_t<int> pivots(n);
+        if (getrf(n, a, pivots.m_ptr) > 0)
+        {
+            return false;
+        }
+
+        // identity, the diagonal is written from n uploaded ones through a stride of n + 1
+        const std::vector<T> ones(n, (T) 1);
+        Device_Buffer_t<T> diag(n);
+        check(gpuMemsetAsync(inv, 0, n * n * sizeof(T), ctx.m_stream), "memset");
+        device_upload(diag.m_ptr, ones.data(), n * sizeof(T), false);
+        check_blas(gpu_copy(ctx.m_blas, to_int(n), diag.m_ptr, 1, inv, to_int(n + 1)), "copy");
+
+        const int len = to_int(n);
+        Device_Buffer_t<int> info(1);
+        check_solver(gpu_getrs(ctx.m_solver, len, len, a, len, pivots.m_ptr, inv, len, info.m_ptr), "getrs");
+        device_synchronize();
+        return true;
+    }
+
+    ///--------------------------------------------------------
+    template <typename T>
+    T determinant(const size_t& n, T* a)
+    {
+        Device_Context_t& ctx = context();
+        Device_Buffer_t<int> pivots(n);
+        getrf(n, a, pivots.m_ptr);
+
+        // only the diagonal and the pivots come back
+        Device_Buffer_t<T> diag(n);
+        check_blas(gpu_copy(ctx.m_blas, to_int(n), a, to_int(n + 1), diag.m_ptr, 1), "copy");
+
+        std::vector<T> hostDiag(n);
+        std::vector<int> hostPivots(n);
+        device_download(hostDiag.data(), diag.m_ptr, n * sizeof(T), true);
+        device_download(hostPivots.data(), pivots.m_ptr, n * sizeof(int), false);
+
+        T det = 1;
+        for (size_t i = 0; i < n; i++)
+        {
+            det *= (hostPivots[i] != (int) i + 1) ? -hostDiag[i] : hostDiag[i];
+        }
+        return det;
+    }
+
+    ///--------------------------------------------------------
+    template <typename T>
+    void eigenvalues_symmetric(const size_t& n, T* a, T* values)
+    {
+        Device_Context_t& ctx = context();
+        const int len = to_int(n);
+        Device_Buffer_t<T> w(n);
+
+        // the row major lower triangle is the column major upper one
+        int lwork = 0;
+        check_solver(gpu_syevd_buffer(ctx.m_solver, len, a, len, w.m_ptr, &lwork), "syevd buffer size");
+
+        Device_Buffer_t<T> work(lwork);
+        Device_Buffer_t<int> info(1);
+        check_solver(gpu_syevd(ctx.m_solver, len, a, len, w.m_ptr, work.m_ptr, lwork, info.m_ptr), "syevd");
+
+        int hostInfo = 0;
+        device_download(values, w.m_ptr, n * sizeof(T), true);
+        device_download(&hostInfo, info.m_ptr, sizeof(int), false);
+        if (hostInfo != 0)
+        {
+            throw std::runtime_error("syevd did not converge");
+        }
+    }
+}
+
+///--------------------------------------------------------
+Device_Backend_t device_backend()
+{
+#if defined(MATRIX_GPU_CUDA)
+    return Device_Backend_t::CUDA;
+#else
+    return Device_Backend_t::HIP;
+#endif
+}
+
+///--------------------------------------------------------
+bool device_available()
+{
+    static const bool present = []
+    {
+        int count = 0;
+        return gpuGetDeviceCount(&count) == gpuSuccess && count > 0;
+    }();
+    return present && device_enabled();
+}
+
+///--------------------------------------------------------
+void* device_allocate(const size_t& bytes)
+{
+    void* ptr = nullptr;
+    check(gpuMalloc(&ptr, bytes), "device allocate");
+    return ptr;
+}
+
+///--------------------------------------------------------
+void device_release(void* ptr) noexcept
+{
+    // free waits for the device to finish with the buffer
+    if (ptr != nullptr)
+    {
+        gpuFree(ptr);
+    }
+}
+
+///--------------------------------------------------------
+void device_upload(void* dst, const void* src, const size_t& bytes, const bool& async)
+{
+    check(gpuMemcpyAsync(dst, src, bytes, gpuMemcpyHostToDevice, context().m_stream), "upload");
+    if (!async)
+    {
+        device_synchronize();
+    }
+}
+
+///--------------------------------------------------------
+void device_download(void* dst, const void* src, const size_t& bytes, const bool& async)
+{
+    check(gpuMemcpyAsync(dst, src, bytes, gpuMemcpyDeviceToHost, context().m_stream), "download");
+    if (!async)
+    {
+        device_synchronize();
+    }
+}
+
+///--------------------------------------------------------
+void device_copy(void* dst, const void* src, const size_t& bytes)
+{
+    check(gpuMemcpyAsync(dst, src, bytes, gpuMemcpyDeviceToDevice, context().m_stream), "device copy");
+}
+
+///--------------------------------------------------------
+void device_synchronize()
+{
+    check(gpuStreamSynchronize(context().m_stream), "synchronize");
+}
+
+///--------------------------------------------------------
+void device_gemm(const size_t& m, const size_t& n, const size_t& k, const float* a, const float* b, float* c)
+{
+    gemm(m, n, k, a, b, c);
+}
+
+///--------------------------------------------------------
+void device_gemm(const size_t& m, const size_t& n, const size_t& k, const double* a, const double* b, double* c)
+{
+    gemm(m, n, k, a, b, c);
+}
+
+///--------------------------------------------------------
+void device_axpby(const size_t& count, const float& alpha, const float* a, const float& beta, const float* b, float* c)
+{
+    axpby(count, alpha, a, beta, b, c);
+}
+
+///--------------------------------------------------------
+void device_axpby(const size_t& count, const double& alpha, const double* a, const double& beta, const double* b, double* c)
+{
+    axpby(count, alpha, a, beta, b, c);
+}
+
+///--------------------------------------------------------
+bool device_inverse(const size_t& n, float* a, float* inv)
+{
+    return inverse(n, a, inv);
+}
+
+///--------------------------------------------------------
+bool device_inverse(const size_t& n, double* a, double* inv)
+{
+    return inverse(n, a, inv);
+}
+
+///--------------------------------------------------------
+float device_determinant(const size_t& n, float* a)
+{
+    return determinant(n, a);
+}
+
+///--------------------------------------------------------
+double device_determinant(const size_t& n, double* a)
+{
+    return determinant(n, a);
+}
+
+///--------------------------------------------------------
+void device_eigenvalues_symmetric(const size_t& n, float* a, float* values)
+{
+    eigenvalues_symmetric(n, a, values);
+}
+
+///--------------------------------------------------------
+void device_eigenvalues_symmetric(const size_t& n, double* a, double* values)
+{
+    eigenvalues_symmetric(n, a, values);
+}
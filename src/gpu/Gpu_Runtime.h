@@ -0,0 +1,162 @@
+/// ------------------------------------------
+/// @file Gpu_Runtime.h
+///
+/// @brief Maps the CUDA and HIP runtime, BLAS and solver names used by Device_Gpu.cpp onto one set
+///
+/// hipBLAS and hipSOLVER's Dn compatibility API mirror cuBLAS and cuSOLVER call for call,
+/// so only the names differ. The precision overloads let the kernels be written once
+/// ------------------------------------------
+#pragma once
+
+#if defined(MATRIX_GPU_CUDA)
+
+#include <cuda_runtime.h>
+#include <cublas_v2.h>
+#include <cusolverDn.h>
+
+typedef cudaError_t gpuError_t;
+typedef cudaStream_t gpuStream_t;
+typedef cublasHandle_t gpublasHandle_t;
+typedef cublasStatus_t gpublasStatus_t;
+typedef cusolverDnHandle_t gpusolverHandle_t;
+typedef cusolverStatus_t gpusolverStatus_t;
+
+#define gpuSuccess cudaSuccess
+#define gpuGetErrorString cudaGetErrorString
+#define gpuGetDeviceCount cudaGetDeviceCount
+#define gpuMalloc cudaMalloc
+#define gpuFree cudaFree
+#define gpuMemcpyAsync cudaMemcpyAsync
+#define gpuMemsetAsync cudaMemsetAsync
+#define gpuMemcpyHostToDevice cudaMemcpyHostToDevice
+#define gpuMemcpyDeviceToHost cudaMemcpyDeviceToHost
+#define gpuMemcpyDeviceToDevice cudaMemcpyDeviceToDevice
+#define gpuStreamCreateWithFlags cudaStreamCreateWithFlags
+#define gpuStreamNonBlocking cudaStreamNonBlocking
+#define gpuStreamDestroy cudaStreamDestroy
+#define gpuStreamSynchronize cudaStreamSynchronize
+
+#define GPUBLAS_STATUS_SUCCESS CUBLAS_STATUS_SUCCESS
+#define GPUBLAS_OP_N CUBLAS_OP_N
+#define gpublasCreate cublasCreate
+#define gpublasDestroy cublasDestroy
+#define gpublasSetStream cublasSetStream
+
+#define GPUSOLVER_STATUS_SUCCESS CUSOLVER_STATUS_SUCCESS
+#define GPUSOLVER_OP_N CUBLAS_OP_N
+#define GPUSOLVER_FILL_MODE_UPPER CUBLAS_FILL_MODE_UPPER
+#define GPUSOLVER_EIG_MODE_NOVECTOR CUSOLVER_EIG_MODE_NOVECTOR
+#define gpusolverCreate cusolverDnCreate
+#define gpusolverDestroy cusolverDnDestroy
+#define gpusolverSetStream cusolverDnSetStream
+
+#define GPU_GEMM(p) cublas##p##gemm
+#define GPU_GEAM(p) cublas##p##geam
+#define GPU_COPY(p) cublas##p##copy
+#define GPU_GETRF_BUFFER(p) cusolverDn##p##getrf_bufferSize
+#define GPU_GETRF(p) cusolverDn##p##getrf
+#define GPU_GETRS(p) cusolverDn##p##getrs
+#define GPU_SYEVD_BUFFER(p) cusolverDn##p##syevd_bufferSize
+#define GPU_SYEVD(p) cusolverDn##p##syevd
+
+#elif defined(MATRIX_GPU_HIP)
+
+#include <hip/hip_runtime.h>
+#include <hipblas/hipblas.h>
+#include <hipsolver/hipsolver.h>
+
+typedef hipError_t gpuError_t;
+typedef hipStream_t gpuStream_t;
+typedef hipblasHandle_t gpublasHandle_t;
+typedef hipblasStatus_t gpublasStatus_t;
+typedef hipsolverDnHandle_t gpusolverHandle_t;
+typedef hipsolverStatus_t gpusolverStatus_t;
+
+#define gpuSuccess hipSuccess
+#define gpuGetErrorString hipGetErrorString
+#define gpuGetDeviceCount hipGetDeviceCount
+#define gpuMalloc hipMalloc
+#define gpuFree hipFree
+#define gpuMemcpyAsync hipMemcpyAsync
+#define gpuMemsetAsync hipMemsetAsync
+#define gpuMemcpyHostToDevice hipMemcpyHostToDevice
+#define gpuMemcpyDeviceToHost hipMemcpyDeviceToHost
+#define gpuMemcpyDeviceToDevice hipMemcpyDeviceToDevice
+#define gpuStreamCreateWithFlags hipStreamCreateWithFlags
+#define gpuStreamNonBlocking hipStreamNonBlocking
+#define gpuStreamDestroy hipStreamDestroy
+#define gpuStreamSynchronize hipStreamSynchronize
+
+#define GPUBLAS_STATUS_SUCCESS HIPBLAS_STATUS_SUCCESS
+#define GPUBLAS_OP_N HIPBLAS_OP_N
+#define gpublasCreate hipblasCreate
+#define gpublasDestroy hipblasDestroy
+#define gpublasSetStream hipblasSetStream
+
+#define GPUSOLVER_STATUS_SUCCESS HIPSOLVER_STATUS_SUCCESS
+#define GPUSOLVER_OP_N HIPSOLVER_OP_N
+#define GPUSOLVER_FILL_MODE_UPPER HIPSOLVER_FILL_MODE_UPPER
+#define GPUSOLVER_EIG_MODE_NOVECTOR HIPSOLVER_EIG_MODE_NOVECTOR
+#define gpusolverCreate hipsolverDnCreate
+#define gpusolverDestroy hipsolverDnDestroy
+#define gpusolverSetStream hipsolverDnSetStream
+
+#define GPU_GEMM(p) hipblas##p##gemm
+#define GPU_GEAM(p) hipblas##p##geam
+#define GPU_COPY(p) hipblas##p##copy
+#define GPU_GETRF_BUFFER(p) hipsolverDn##p##getrf_bufferSize
+#define GPU_GETRF(p) hipsolverDn##p##getrf
+#define GPU_GETRS(p) hipsolverDn##p##getrs
+#define GPU_SYEVD_BUFFER(p) hipsolverDn##p##syevd_bufferSize
+#define GPU_SYEVD(p) hipsolverDn##p##syevd
+
+#else
+#error "Gpu_Runtime.h needs MATRIX_GPU_CUDA or MATRIX_GPU_HIP"
+#endif
+
+/// @brief Declares the float (S) and double (D) overload of one library call
+#define GPU_OVERLOADS(name, status, macro, float_args, double_args, call_args) \
+    inline status name float_args { return macro(S) call_args; }                \
+    inline status name double_args { return macro(D) call_args; }
+
+GPU_OVERLOADS(gpu_gemm, gpublasStatus_t, GPU_GEMM,
+    (gpublasHandle_t h, int m, int n, int k, const float* alpha, const float* a, int lda, const float* b, int ldb, const float* beta, float* c, int ldc),
+    (gpublasHandle_t h, int m, int n, int k, const double* alpha, const double* a, int lda, const double* b, int ldb, const double* beta, double* c, int ldc),
+    (h, GPUBLAS_OP_N, GPUBLAS_OP_N, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))
+
+GPU_OVERLOADS(gpu_geam, gpublasStatus_t, GPU_GEAM,
+    (gpublasHandle_t h, int m, int n, const float* alpha, const float* a, int lda, const float* beta, const float* b, int ldb, float* c, int ldc),
+    (gpublasHandle_t h, int m, int n, const double* alpha, const double* a, int lda, const double* beta, const double* b, int ldb, double* c, int ldc),
+    (h, GPUBLAS_OP_N, GPUBLAS_OP_N, m, n, alpha, a, lda, beta, b, ldb, c, ldc))
+
+GPU_OVERLOADS(gpu_copy, gpublasStatus_t, GPU_COPY,
+    (gpublasHandle_t h, int n, const float* x, int incx, float* y, int incy),
+    (gpublasHandle_t h, int n, const double* x, int incx, double* y, int incy),
+    (h, n, x, incx, y, incy))
+
+GPU_OVERLOADS(gpu_getrf_buffer, gpusolverStatus_t, GPU_GETRF_BUFFER,
+    (gpusolverHandle_t h, int m, int n, float* a, int lda, int* lwork),
+    (gpusolverHandle_t h, int m, int n, double* a, int lda, int* lwork),
+    (h, m, n, a, lda, lwork))
+
+GPU_OVERLOADS(gpu_getrf, gpusolverStatus_t, GPU_GETRF,
+    (gpusolverHandle_t h, int m, int n, float* a, int lda, float* work, int* ipiv, int* info),
+    (gpusolverHandle_t h, int m, int n, double* a, int lda, double* work, int* ipiv, int* info),
+    (h, m, n, a, lda, work, ipiv, info))
+
+GPU_OVERLOADS(gpu_getrs, gpusolverStatus_t, GPU_GETRS,
+    (gpusolverHandle_t h, int n, int nrhs, const float* a, int lda, const int* ipiv, float* b, int ldb, int* info),
+    (gpusolverHandle_t h, int n, int nrhs, const double* a, int lda, const int* ipiv, double* b, int ldb, int* info),
+    (h, GPUSOLVER_OP_N, n, nrhs, a, lda, ipiv, b, ldb, info))
+
+GPU_OVERLOADS(gpu_syevd_buffer, gpusolverStatus_t, GPU_SYEVD_BUFFER,
+    (gpusolverHandle_t h, int n, const float* a, int lda, const float* w, int* lwork),
+    (gpusolverHandle_t h, int n, const double* a, int lda, const double* w, int* lwork),
+    (h, GPUSOLVER_EIG_MODE_NOVECTOR, GPUSOLVER_FILL_MODE_UPPER, n, a, lda, w, lwork))
+
+GPU_OVERLOADS(gpu_syevd, gpusolverStatus_t, GPU_SYEVD,
+    (gpusolverHandle_t h, int n, float* a, int lda, float* w, float* work, int lwork, int* info),
+    (gpusolverHandle_t h, int n, double* a, int lda, double* w, double* work, int lwork, int* info),
+    (h, GPUSOLVER_EIG_MODE_NOVECTOR, GPUSOLVER_FILL_MODE_UPPER, n, a, lda, w, work, lwork, info))
+
+#undef GPU_OVERLOADS